@@ -0,0 +1,583 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "bench.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../engine/audio.h"
+#include "../engine/private/audio.h"
+
+#include "../runtime/asset.h"
+#include "../runtime/error.h"
+#include "../runtime/stats.h"
+#include "../runtime/stream.h"
+#include "../runtime/time.h"
+
+#define DEFAULT_OGG_ASSET "ost/title/title_theme.ogg"
+#define DECODE_CHUNK_SIZE 65536
+
+#define MIX_SECONDS       10 /* how much audio to render per mix run */
+#define VOICE_PCM_SECONDS 5  /* how much PCM each mixed voice holds */
+#define STREAM_SECONDS    30 /* how much audio to render when streaming */
+
+static const size_t MIX_VOICE_COUNTS[] = { 1, 16, 64 };
+
+typedef RBTK_AUDIO_SOURCE *(*source_fun)(RBTK_IN_STREAM *in);
+
+/*
+ * An audio source which reads PCM data already in memory. This lets the
+ * mixing benchmark create many voices without decoding each of them.
+ */
+typedef struct pcm_source {
+    const unsigned char *pcm;
+    size_t size;
+    size_t offset;
+    size_t frame_size;
+} pcm_source;
+
+static unsigned char *
+load_stream(RBTK_IN_STREAM *in, size_t *size)
+{
+    if (!in) {
+        return NULL;
+    }
+    unsigned char *data = rbtk_buffer_remaining(in, size);
+    rbtk_close_in_stream(in);
+    return data;
+}
+
+static unsigned char *
+load_encoded(const char *path, const char *asset_name, size_t *size)
+{
+    if (path) {
+        return load_stream(rbtk_open_file_in_stream(path), size);
+    }
+
+    RBTK_ASSET *asset = rbtk_get_asset(asset_name);
+    if (!asset) {
+        return NULL;
+    }
+    return load_stream(rbtk_open_asset_in_stream(asset), size);
+}
+
+/*!
+ * @brief Decodes an entire audio file which is in memory.
+ *
+ * @param[in]  open     The function to open the audio source with.
+ * @param[in]  data     The encoded audio file.
+ * @param[in]  size     The length of `data` in bytes.
+ * @param[out] info     Where to write the format of the PCM data.
+ * @param[out] pcm      Where to write the decoded PCM data. This may be
+ *                      `NULL` if the data is not needed.
+ * @param[out] pcm_size Where to write the length of the PCM data.
+ * @return `true` on success, `false` on failure.
+ */
+static bool
+decode_all(source_fun open, unsigned char *data, size_t size,
+    rbtk_audio_source_info *info, unsigned char **pcm, size_t *pcm_size)
+{
+    RBTK_IN_STREAM *in = rbtk_open_memory_in_stream(data, size);
+    if (!in) {
+        return false;
+    }
+
+    RBTK_AUDIO_SOURCE *src = open(in);
+    if (!src) {
+        rbtk_close_in_stream(in);
+        return false;
+    }
+    *info = *rbtk_get_audio_source_info(src);
+
+    static unsigned char chunk[DECODE_CHUNK_SIZE];
+    unsigned char *out = NULL;
+    size_t out_size = 0;
+    bool decoded = true;
+
+    int read = rbtk_read_pcm(src, out_size, chunk, sizeof(chunk));
+    while (read != EOF) {
+        if (pcm) {
+            unsigned char *grown = realloc(out, out_size + read);
+            if (!grown) {
+                decoded = false;
+                break;
+            }
+            memcpy(grown + out_size, chunk, read);
+            out = grown;
+        }
+        out_size += read;
+        read = rbtk_read_pcm(src, out_size, chunk, sizeof(chunk));
+    }
+
+    rbtk_close_audio_source(src);
+    rbtk_close_in_stream(in);
+
+    if (!decoded) {
+        free(out);
+        return false;
+    }
+    if (pcm) {
+        *pcm = out;
+    }
+    *pcm_size = out_size;
+    return true;
+}
+
+static long double
+get_pcm_seconds(const rbtk_audio_source_info *info, size_t pcm_size)
+{
+    size_t frame_size = info->channel_count * (info->bits_per_sample / 8);
+    return (long double) pcm_size / frame_size / info->frequency_hz;
+}
+
+static void
+bench_decode(const char *name, source_fun open,
+    unsigned char *data, size_t size)
+{
+    long double mb_per_sec[BENCH_MAX_REPETITIONS];
+    long double realtime[BENCH_MAX_REPETITIONS];
+
+    size_t warmup = bench_get_warmup();
+    size_t reps = bench_get_repetitions();
+    for (size_t i = 0; i < warmup + reps; i++) {
+        rbtk_audio_source_info info;
+        size_t pcm_size = 0;
+
+        long double begin = rbtk_time(RBTK_SECS);
+        if (!decode_all(open, data, size, &info, NULL, &pcm_size)) {
+            bench_skip(name, "could not decode");
+            return;
+        }
+        long double secs = rbtk_time(RBTK_SECS) - begin;
+
+        if (i >= warmup) {
+            mb_per_sec[i - warmup] = pcm_size / 1000000.0L / secs;
+            realtime[i - warmup] = get_pcm_seconds(&info, pcm_size) / secs;
+        }
+    }
+
+    char report[64];
+    snprintf(report, sizeof(report), "decode.%s.throughput", name);
+    bench_report_samples(report, mb_per_sec, reps, "MB/s (PCM)");
+    snprintf(report, sizeof(report), "decode.%s.speed", name);
+    bench_report_samples(report, realtime, reps, "x realtime");
+}
+
+/*
+ * How much data is asked for in each read changes how often the decoder is
+ * entered, and how many samples are converted to PCM each time.
+ */
+static const size_t PCM_CHUNK_SIZES[] = { 1024, 16384, DECODE_CHUNK_SIZE };
+
+typedef struct pcm_read_args {
+    source_fun open;
+    unsigned char *data;
+    size_t size;
+    size_t chunk_size;
+} pcm_read_args;
+
+static void
+run_pcm_reads(void *args)
+{
+    pcm_read_args *reads = args;
+    RBTK_IN_STREAM *in = rbtk_open_memory_in_stream(reads->data, reads->size);
+    if (!in) {
+        return;
+    }
+    RBTK_AUDIO_SOURCE *src = reads->open(in);
+    if (!src) {
+        rbtk_close_in_stream(in);
+        return;
+    }
+
+    static unsigned char chunk[DECODE_CHUNK_SIZE];
+    size_t off = 0;
+    int read = rbtk_read_pcm(src, off, chunk, reads->chunk_size);
+    while (read != EOF) {
+        off += read;
+        read = rbtk_read_pcm(src, off, chunk, reads->chunk_size);
+    }
+
+    rbtk_close_audio_source(src);
+    rbtk_close_in_stream(in);
+}
+
+static void
+bench_pcm_reads(const char *name, source_fun open,
+    unsigned char *data, size_t size, size_t pcm_size)
+{
+    pcm_read_args args = {
+        .open = open,
+        .data = data,
+        .size = size,
+    };
+
+    /* each operation is one KiB of PCM, whatever the chunk size */
+    size_t kib = pcm_size / 1024 > 0 ? pcm_size / 1024 : 1;
+    size_t num_sizes = sizeof(PCM_CHUNK_SIZES) / sizeof(PCM_CHUNK_SIZES[0]);
+    for (size_t i = 0; i < num_sizes; i++) {
+        args.chunk_size = PCM_CHUNK_SIZES[i];
+
+        char report[64];
+        snprintf(report, sizeof(report), "pcm.%s.chunk_%zu",
+            name, args.chunk_size);
+        bench_measure(report, run_pcm_reads, &args, kib);
+    }
+}
+
+static void
+put_le16(unsigned char *buf, unsigned int value)
+{
+    buf[0] = (unsigned char) ((value >> 0) & 0xFF);
+    buf[1] = (unsigned char) ((value >> 8) & 0xFF);
+}
+
+static void
+put_le32(unsigned char *buf, unsigned long value)
+{
+    put_le16(buf + 0, (unsigned int) ((value >> 0)  & 0xFFFF));
+    put_le16(buf + 2, (unsigned int) ((value >> 16) & 0xFFFF));
+}
+
+/*!
+ * @brief Wraps PCM data in a WAV file, for when none was given.
+ */
+static unsigned char *
+make_wav(const rbtk_audio_source_info *info,
+    const unsigned char *pcm, size_t pcm_size, size_t *wav_size)
+{
+    unsigned int block_align = info->channel_count
+        * (info->bits_per_sample / 8);
+
+    *wav_size = 44 + pcm_size;
+    unsigned char *wav = malloc(*wav_size);
+    if (!wav) {
+        return NULL;
+    }
+
+    memcpy(wav + 0, "RIFF", 4);
+    put_le32(wav + 4, (unsigned long) (*wav_size - 8));
+    memcpy(wav + 8, "WAVE", 4);
+    memcpy(wav + 12, "fmt ", 4);
+    put_le32(wav + 16, 16);
+    put_le16(wav + 20, 1); /* PCM */
+    put_le16(wav + 22, info->channel_count);
+    put_le32(wav + 24, info->frequency_hz);
+    put_le32(wav + 28, info->frequency_hz * block_align);
+    put_le16(wav + 32, block_align);
+    put_le16(wav + 34, info->bits_per_sample);
+    memcpy(wav + 36, "data", 4);
+    put_le32(wav + 40, (unsigned long) pcm_size);
+    memcpy(wav + 44, pcm, pcm_size);
+
+    return wav;
+}
+
+static RBTK_NO_DISCARD bool
+close_pcm_source(RBTK_UNUSED RBTK_AUDIO_SOURCE *src, pcm_source *pcm)
+{
+    free(pcm);
+    return true;
+}
+
+static RBTK_NO_DISCARD int
+read_pcm_source(RBTK_UNUSED RBTK_AUDIO_SOURCE *src, pcm_source *pcm,
+    RBTK_UNUSED size_t off, void *buf, size_t len)
+{
+    size_t remaining = pcm->size - pcm->offset;
+    if (remaining == 0) {
+        return EOF;
+    }
+    size_t read = len < remaining ? len : remaining;
+    read -= read % pcm->frame_size; /* only read whole frames */
+    memcpy(buf, pcm->pcm + pcm->offset, read);
+    pcm->offset += read;
+    return (int) read;
+}
+
+static RBTK_AUDIO_SOURCE *
+source_pcm(const rbtk_audio_source_info *info,
+    const unsigned char *data, size_t size)
+{
+    pcm_source *pcm = malloc(sizeof(*pcm));
+    if (!pcm) {
+        return NULL;
+    }
+    pcm->pcm = data;
+    pcm->size = size;
+    pcm->offset = 0;
+    pcm->frame_size = info->channel_count * (info->bits_per_sample / 8);
+
+    rbtk_audio_source_funs funs = {
+            .close    = (rbtk_close_audio_source_fun) close_pcm_source,
+            .read_pcm = (rbtk_read_pcm_fun)           read_pcm_source
+    };
+
+    RBTK_AUDIO_SOURCE *src = rbtk_source_audio(funs, *info, pcm);
+    if (!src) {
+        free(pcm);
+    }
+    return src;
+}
+
+static long double
+time_render(long double seconds)
+{
+    long double samples[BENCH_MAX_REPETITIONS];
+    size_t warmup = bench_get_warmup();
+    size_t reps = bench_get_repetitions();
+    for (size_t i = 0; i < warmup + reps; i++) {
+        long double begin = rbtk_time(RBTK_MILLIS);
+        if (!rbtk_render_audio(RBTK_SECS, seconds)) {
+            return -1.0L;
+        }
+        if (i >= warmup) {
+            samples[i - warmup] = rbtk_time(RBTK_MILLIS) - begin;
+        }
+    }
+    return bench_median(samples, reps);
+}
+
+static bool
+bench_mix(const rbtk_audio_source_info *info,
+    const unsigned char *pcm, size_t pcm_size)
+{
+    size_t frame_size = info->channel_count * (info->bits_per_sample / 8);
+    size_t voice_size = VOICE_PCM_SECONDS * info->frequency_hz * frame_size;
+    if (voice_size > pcm_size) {
+        voice_size = pcm_size;
+    }
+
+    /*
+     * Rendering nothing still has a cost. Subtracting it from the rest of
+     * the runs leaves only the cost of mixing the voices themselves.
+     */
+    long double idle_ms = time_render(MIX_SECONDS);
+    if (idle_ms < 0.0L) {
+        return false;
+    }
+    bench_report("mix.idle", idle_ms / MIX_SECONDS, "ms per second");
+
+    size_t num_counts = sizeof(MIX_VOICE_COUNTS) / sizeof(MIX_VOICE_COUNTS[0]);
+    for (size_t c = 0; c < num_counts; c++) {
+        size_t count = MIX_VOICE_COUNTS[c];
+
+        RBTK_AUDIO_SOURCE **srcs = calloc(count, sizeof(*srcs));
+        RBTK_SOUND **sounds = calloc(count, sizeof(*sounds));
+        if (!srcs || !sounds) {
+            free(srcs);
+            free(sounds);
+            return false;
+        }
+
+        size_t playing = 0;
+        for (size_t i = 0; i < count; i++) {
+            srcs[i] = source_pcm(info, pcm, voice_size);
+            if (!srcs[i]) {
+                break;
+            }
+            sounds[i] = rbtk_buffer_sound(srcs[i]);
+            if (!sounds[i]) {
+                break;
+            }
+            rbtk_loop_sound(sounds[i], true);
+            rbtk_play_sound(sounds[i]);
+            playing += 1;
+        }
+
+        long double mix_ms = playing == count
+            ? time_render(MIX_SECONDS) : -1.0L;
+
+        char report[64];
+        if (mix_ms < 0.0L) {
+            snprintf(report, sizeof(report), "mix.voices_%zu", count);
+            bench_skip(report, "could not play every voice");
+        }
+        else {
+            snprintf(report, sizeof(report), "mix.voices_%zu.cost", count);
+            bench_report(report, (mix_ms - idle_ms) / count / MIX_SECONDS,
+                "ms per voice per second");
+            snprintf(report, sizeof(report), "mix.voices_%zu.speed", count);
+            bench_report(report, MIX_SECONDS * 1000.0L / mix_ms,
+                "x realtime");
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            if (sounds[i]) {
+                rbtk_close_sound(sounds[i]);
+            }
+            if (srcs[i]) {
+                rbtk_close_audio_source(srcs[i]);
+            }
+        }
+        free(srcs);
+        free(sounds);
+    }
+
+    return true;
+}
+
+static bool
+bench_stream(unsigned char *ogg, size_t ogg_size)
+{
+    RBTK_IN_STREAM *in = rbtk_open_memory_in_stream(ogg, ogg_size);
+    if (!in) {
+        return false;
+    }
+    RBTK_AUDIO_SOURCE *src = rbtk_source_ogg(in);
+    if (!src) {
+        rbtk_close_in_stream(in);
+        return false;
+    }
+
+    RBTK_STAT *refill_ms = rbtk_get_stat("audio.stream_refill_ms",
+        RBTK_STAT_TYPE_SAMPLE);
+    RBTK_STAT *underruns = rbtk_get_stat("audio.underruns",
+        RBTK_STAT_TYPE_COUNTER);
+    if (refill_ms) {
+        rbtk_reset_stat(refill_ms);
+    }
+    if (underruns) {
+        rbtk_reset_stat(underruns);
+    }
+
+    bool streamed = false;
+    RBTK_SOUND *sound = rbtk_stream_sound(src);
+    if (sound) {
+        rbtk_play_sound(sound);
+
+        long double begin = rbtk_time(RBTK_MILLIS);
+        streamed = rbtk_render_audio(RBTK_SECS, STREAM_SECONDS);
+        long double elapsed_ms = rbtk_time(RBTK_MILLIS) - begin;
+
+        if (streamed) {
+            bench_report("stream.speed",
+                STREAM_SECONDS * 1000.0L / elapsed_ms, "x realtime");
+        }
+        rbtk_close_sound(sound);
+    }
+
+    if (streamed && refill_ms) {
+        bench_report("stream.refill.p50",
+            rbtk_get_stat_percentile(refill_ms, 50.0L), "ms");
+        bench_report("stream.refill.p99",
+            rbtk_get_stat_percentile(refill_ms, 99.0L), "ms");
+        bench_report("stream.refill.max",
+            rbtk_get_stat_max(refill_ms), "ms");
+    }
+    if (streamed && underruns) {
+        bench_report("stream.underruns",
+            rbtk_get_stat_value(underruns), "underruns");
+    }
+
+    rbtk_close_audio_source(src);
+    rbtk_close_in_stream(in);
+    return streamed;
+}
+
+bool
+bench_audio(int argc, const char *argv[])
+{
+    size_t ogg_size = 0;
+    unsigned char *ogg = load_encoded(bench_get_option(argc, argv, "ogg"),
+        DEFAULT_OGG_ASSET, &ogg_size);
+    if (!ogg) {
+        fprintf(stderr, "Failed to load Ogg Vorbis file.\n");
+        return false;
+    }
+
+    /*
+     * The decoded Ogg Vorbis file is used by the rest of the benchmarks.
+     * It is also wrapped into a WAV file if one was not given, so there
+     * is always something to measure WAV decoding with.
+     */
+    rbtk_audio_source_info info;
+    unsigned char *pcm = NULL;
+    size_t pcm_size = 0;
+    if (!decode_all(rbtk_source_ogg, ogg, ogg_size,
+            &info, &pcm, &pcm_size)) {
+        fprintf(stderr, "Failed to decode Ogg Vorbis file.\n");
+        free(ogg);
+        return false;
+    }
+
+    size_t wav_size = 0;
+    const char *wav_path = bench_get_option(argc, argv, "wav");
+    unsigned char *wav = wav_path
+        ? load_encoded(wav_path, NULL, &wav_size)
+        : make_wav(&info, pcm, pcm_size, &wav_size);
+
+    size_t mp3_size = 0;
+    const char *mp3_path = bench_get_option(argc, argv, "mp3");
+    unsigned char *mp3 = mp3_path
+        ? load_encoded(mp3_path, NULL, &mp3_size) : NULL;
+
+    bench_decode("ogg", rbtk_source_ogg, ogg, ogg_size);
+    bench_pcm_reads("ogg", rbtk_source_ogg, ogg, ogg_size, pcm_size);
+    if (wav) {
+        bench_decode("wav", rbtk_source_wav, wav, wav_size);
+        rbtk_audio_source_info wav_info;
+        size_t wav_pcm_size = 0;
+        if (decode_all(rbtk_source_wav, wav, wav_size,
+                &wav_info, NULL, &wav_pcm_size)) {
+            bench_pcm_reads("wav", rbtk_source_wav, wav, wav_size,
+                wav_pcm_size);
+        }
+    }
+    else {
+        bench_skip("decode.wav", "could not load WAV file");
+    }
+    if (mp3) {
+        bench_decode("mp3", rbtk_source_mp3, mp3, mp3_size);
+    }
+    else {
+        bench_skip("decode.mp3", "no MP3 file, use --mp3 PATH");
+    }
+
+    /*
+     * Only the audio module is initialized, as the rest of the engine
+     * requires a display. Audio is rendered offline, so these benchmarks
+     * can run on machines without an audio device.
+     */
+    const char *wave_out = bench_get_option(argc, argv, "wave-out");
+    bool ran = rbtk_set_audio_output(wave_out
+            ? RBTK_AUDIO_OUTPUT_WAVE : RBTK_AUDIO_OUTPUT_NULL, wave_out)
+        && priv_rbtk_audio_init();
+    if (!ran) {
+        fprintf(stderr, "Failed to initialize offline audio.\n");
+    }
+    else {
+        ran &= bench_mix(&info, pcm, pcm_size);
+        ran &= bench_stream(ogg, ogg_size);
+        ran &= priv_rbtk_audio_terminate();
+    }
+
+    free(mp3);
+    free(wav);
+    free(pcm);
+    free(ogg);
+    return ran;
+}
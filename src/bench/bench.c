@@ -0,0 +1,302 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../runtime/runtime.h"
+#include "../runtime/time.h"
+
+#define MAX_NAME_LENGTH 64
+
+/*
+ * Every result is kept, so it can be written to a JSON file at the end.
+ * Comparing these files is how the results of two commits are compared.
+ */
+typedef struct bench_result {
+    char name[MAX_NAME_LENGTH];
+    char unit[MAX_NAME_LENGTH];
+    long double value;
+    long double p99;
+    bool has_p99;
+    bool skipped;
+    char skip_reason[MAX_NAME_LENGTH];
+} bench_result;
+
+static struct {
+    size_t warmup;
+    size_t repetitions;
+    const char *json_path;
+    const char *label;
+    bench_result *results;
+    size_t result_count;
+    size_t result_capacity;
+} bench = {
+    .warmup = BENCH_DEFAULT_WARMUP,
+    .repetitions = BENCH_DEFAULT_REPETITIONS,
+};
+
+void
+bench_init(int argc, const char *argv[])
+{
+    const char *warmup = bench_get_option(argc, argv, "warmup");
+    if (warmup) {
+        bench.warmup = strtoul(warmup, NULL, 10);
+    }
+
+    const char *reps = bench_get_option(argc, argv, "reps");
+    if (reps) {
+        bench.repetitions = strtoul(reps, NULL, 10);
+    }
+    if (bench.repetitions < 1) {
+        bench.repetitions = 1;
+    }
+    else if (bench.repetitions > BENCH_MAX_REPETITIONS) {
+        bench.repetitions = BENCH_MAX_REPETITIONS;
+    }
+
+    bench.json_path = bench_get_option(argc, argv, "json");
+    bench.label = bench_get_option(argc, argv, "label");
+}
+
+static void
+write_json_string(FILE *file, const char *str)
+{
+    fputc('"', file);
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\') {
+            fputc('\\', file);
+        }
+        fputc(*str, file);
+    }
+    fputc('"', file);
+}
+
+bool
+bench_finish(void)
+{
+    bool written = true;
+    if (bench.json_path) {
+        FILE *file = fopen(bench.json_path, "w");
+        if (!file) {
+            fprintf(stderr, "Failed to open %s.\n", bench.json_path);
+            written = false;
+        }
+        else {
+            fprintf(file, "{\n  \"label\": ");
+            write_json_string(file, bench.label ? bench.label : "");
+            fprintf(file, ",\n  \"warmup\": %zu,\n", bench.warmup);
+            fprintf(file, "  \"repetitions\": %zu,\n", bench.repetitions);
+            fprintf(file, "  \"results\": [");
+
+            for (size_t i = 0; i < bench.result_count; i++) {
+                bench_result *result = &bench.results[i];
+                fprintf(file, "%s\n    { \"name\": ", i > 0 ? "," : "");
+                write_json_string(file, result->name);
+                if (result->skipped) {
+                    fprintf(file, ", \"skipped\": ");
+                    write_json_string(file, result->skip_reason);
+                }
+                else {
+                    fprintf(file, ", \"unit\": ");
+                    write_json_string(file, result->unit);
+                    fprintf(file, ", \"value\": %.6Lg", result->value);
+                    if (result->has_p99) {
+                        fprintf(file, ", \"p99\": %.6Lg", result->p99);
+                    }
+                }
+                fprintf(file, " }");
+            }
+
+            fprintf(file, "\n  ]\n}\n");
+            written = !ferror(file);
+            written &= !fclose(file);
+        }
+    }
+
+    free(bench.results);
+    bench.results = NULL;
+    bench.result_count = 0;
+    bench.result_capacity = 0;
+    return written;
+}
+
+size_t
+bench_get_warmup(void)
+{
+    return bench.warmup;
+}
+
+size_t
+bench_get_repetitions(void)
+{
+    return bench.repetitions;
+}
+
+const char *
+bench_get_option(int argc, const char *argv[], const char *name)
+{
+    for (int i = 1; i + 1 < argc; i++) {
+        if (!strncmp(argv[i], "--", 2) && !strcmp(argv[i] + 2, name)) {
+            return argv[i + 1];
+        }
+    }
+    return NULL;
+}
+
+static int
+compare_samples(const void *a, const void *b)
+{
+    long double lhs = *(const long double *) a;
+    long double rhs = *(const long double *) b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+long double
+bench_median(long double samples[], size_t count)
+{
+    if (count == 0) {
+        return 0.0L;
+    }
+    qsort(samples, count, sizeof(samples[0]), compare_samples);
+    if (count % 2) {
+        return samples[count / 2];
+    }
+    return (samples[count / 2 - 1] + samples[count / 2]) / 2.0L;
+}
+
+long double
+bench_percentile(long double samples[], size_t count,
+    long double percentile)
+{
+    if (count == 0) {
+        return 0.0L;
+    }
+    qsort(samples, count, sizeof(samples[0]), compare_samples);
+
+    size_t rank = (size_t) ceill(percentile / 100.0L * count);
+    return samples[rank > 0 ? rank - 1 : 0];
+}
+
+static bench_result *
+add_result(const char *name)
+{
+    if (bench.result_count >= bench.result_capacity) {
+        size_t capacity = bench.result_capacity
+            ? bench.result_capacity * 2 : 64;
+        bench_result *grown = realloc(bench.results,
+            capacity * sizeof(*grown));
+        if (!grown) {
+            return NULL; /* still printed, just not written */
+        }
+        bench.results = grown;
+        bench.result_capacity = capacity;
+    }
+
+    bench_result *result = &bench.results[bench.result_count++];
+    memset(result, 0x00, sizeof(*result));
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    return result;
+}
+
+void
+bench_report(const char *name, long double value, const char *unit)
+{
+    printf("%-40s %14.3Lf %s\n", name, value, unit);
+
+    bench_result *result = add_result(name);
+    if (result) {
+        snprintf(result->unit, sizeof(result->unit), "%s", unit);
+        result->value = value;
+    }
+}
+
+void
+bench_report_samples(const char *name, long double samples[], size_t count,
+    const char *unit)
+{
+    long double median = bench_median(samples, count);
+    long double p99 = bench_percentile(samples, count, 99.0L);
+    printf("%-40s %14.3Lf %s (p99 %.3Lf)\n", name, median, unit, p99);
+
+    bench_result *result = add_result(name);
+    if (result) {
+        snprintf(result->unit, sizeof(result->unit), "%s", unit);
+        result->value = median;
+        result->p99 = p99;
+        result->has_p99 = true;
+    }
+}
+
+void
+bench_skip(const char *name, const char *reason)
+{
+    printf("%-40s %14s (%s)\n", name, "skipped", reason);
+
+    bench_result *result = add_result(name);
+    if (result) {
+        snprintf(result->skip_reason, sizeof(result->skip_reason),
+            "%s", reason);
+        result->skipped = true;
+    }
+}
+
+void
+bench_measure(const char *name, bench_fun fun, void *args, size_t ops)
+{
+    for (size_t i = 0; i < bench.warmup; i++) {
+        fun(args);
+    }
+
+    long double samples[BENCH_MAX_REPETITIONS];
+    for (size_t i = 0; i < bench.repetitions; i++) {
+        long double begin = rbtk_time(RBTK_NANOS);
+        fun(args);
+        samples[i] = (rbtk_time(RBTK_NANOS) - begin) / ops;
+    }
+
+    bench_report_samples(name, samples, bench.repetitions, "ns/op");
+}
+
+RBTK_NO_DISCARD int
+rbtk_runtime_main(int argc, const char *argv[])
+{
+    bool passed = true;
+    bench_init(argc, argv);
+
+    printf("== runtime ==\n");
+    passed &= bench_runtime(argc, argv);
+
+    printf("== engine ==\n");
+    passed &= bench_engine(argc, argv);
+
+    printf("== audio ==\n");
+    passed &= bench_audio(argc, argv);
+
+    passed &= bench_finish();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
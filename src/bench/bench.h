@@ -0,0 +1,230 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef BENCH_H_
+#define BENCH_H_
+
+/*!
+ * @file
+ * @brief The harness for the engine's benchmarks.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Each measurement is repeated, with the median being the reported result.
+ * This keeps one unlucky run from skewing the results. A few runs are done
+ * beforehand and thrown away, so caches and the allocator are warmed up.
+ */
+#define BENCH_DEFAULT_WARMUP      2
+#define BENCH_DEFAULT_REPETITIONS 15
+#define BENCH_MAX_REPETITIONS     1000
+
+/*!
+ * @brief A piece of work to measure.
+ *
+ * @param[in] args The arguments given when measuring.
+ */
+typedef void (*bench_fun)(void *args);
+
+/*!
+ * @brief Sets up the harness.
+ *
+ * @par Options
+ * - `--warmup N` How many runs to throw away before measuring.
+ * - `--reps N` How many runs to measure.
+ * - `--json PATH` Also write every result to a JSON file.
+ * - `--label TEXT` A label to put in the JSON file, such as the commit
+ *   which was measured.
+ *
+ * @param[in] argc The number of command line arguments.
+ * @param[in] argv The command line arguments.
+ */
+void
+bench_init(int argc, const char *argv[]);
+
+/*!
+ * @brief Writes the results, if asked to.
+ *
+ * @return `true` on success, `false` if the results could not be written.
+ */
+bool
+bench_finish(void);
+
+/*!
+ * @brief Returns how many runs to throw away before measuring.
+ *
+ * @return How many runs to throw away before measuring.
+ */
+size_t
+bench_get_warmup(void);
+
+/*!
+ * @brief Returns how many runs to measure.
+ *
+ * @return How many runs to measure. This is never greater than
+ * #BENCH_MAX_REPETITIONS.
+ */
+size_t
+bench_get_repetitions(void);
+
+/*!
+ * @brief Returns the value of a command line option.
+ *
+ * Options are given as `--name value`.
+ *
+ * @param[in] argc The number of command line arguments.
+ * @param[in] argv The command line arguments.
+ * @param[in] name The name of the option, without the leading dashes.
+ * @return The value of the option, or `NULL` if it was not given.
+ */
+const char *
+bench_get_option(int argc, const char *argv[], const char *name);
+
+/*!
+ * @brief Returns the median of a set of samples.
+ *
+ * @note This sorts `samples` in place.
+ *
+ * @param[in] samples The samples.
+ * @param[in] count   The number of samples.
+ * @return The median of `samples`.
+ */
+long double
+bench_median(long double samples[], size_t count);
+
+/*!
+ * @brief Returns a percentile of a set of samples.
+ *
+ * The nearest rank is used, so the result is always one of the samples.
+ *
+ * @note This sorts `samples` in place.
+ *
+ * @param[in] samples    The samples.
+ * @param[in] count      The number of samples.
+ * @param[in] percentile The percentile, from `0.0` to `100.0`.
+ * @return The percentile of `samples`.
+ */
+long double
+bench_percentile(long double samples[], size_t count,
+    long double percentile);
+
+/*!
+ * @brief Reports the result of a benchmark.
+ *
+ * @param[in] name  The name of the benchmark.
+ * @param[in] value The measured value.
+ * @param[in] unit  The unit of `value`.
+ */
+void
+bench_report(const char *name, long double value, const char *unit);
+
+/*!
+ * @brief Reports the median and 99th percentile of a benchmark.
+ *
+ * @note This sorts `samples` in place.
+ *
+ * @param[in] name    The name of the benchmark.
+ * @param[in] samples The measured values.
+ * @param[in] count   The number of samples.
+ * @param[in] unit    The unit of `samples`.
+ */
+void
+bench_report_samples(const char *name, long double samples[], size_t count,
+    const char *unit);
+
+/*!
+ * @brief Reports that a benchmark was skipped.
+ *
+ * @param[in] name   The name of the benchmark.
+ * @param[in] reason Why the benchmark was skipped.
+ */
+void
+bench_skip(const char *name, const char *reason);
+
+/*!
+ * @brief Measures how long a piece of work takes.
+ *
+ * The work is run once for each warmup, then once for each repetition.
+ * The time per operation of each repetition is reported.
+ *
+ * @param[in] name The name of the benchmark.
+ * @param[in] fun  The work to measure.
+ * @param[in] args Passed to `fun`.
+ * @param[in] ops  How many operations `fun` does each time it is run.
+ */
+void
+bench_measure(const char *name, bench_fun fun, void *args, size_t ops);
+
+/*!
+ * @brief Runs the audio benchmarks.
+ *
+ * @par Options
+ * - `--ogg PATH` An Ogg Vorbis file to use instead of the title theme.
+ * - `--wav PATH` A WAV file to use instead of the decoded Ogg Vorbis file.
+ * - `--mp3 PATH` An MP3 file to use. The MP3 benchmark is skipped without
+ *   one, as there are no MP3 assets.
+ * - `--wave-out PATH` Write all rendered audio to a WAV file, rather than
+ *   discarding it.
+ *
+ * @param[in] argc The number of command line arguments.
+ * @param[in] argv The command line arguments.
+ * @return `true` if the benchmarks ran, `false` otherwise.
+ */
+bool
+bench_audio(int argc, const char *argv[]);
+
+/*!
+ * @brief Runs the runtime benchmarks.
+ *
+ * These cover reading from streams, looking up assets, and the thread
+ * pool.
+ *
+ * @par Options
+ * - `--scratch PATH` Where to write the file used to measure file reads.
+ *   It is deleted afterwards.
+ *
+ * @param[in] argc The number of command line arguments.
+ * @param[in] argv The command line arguments.
+ * @return `true` if the benchmarks ran, `false` otherwise.
+ */
+bool
+bench_runtime(int argc, const char *argv[]);
+
+/*!
+ * @brief Runs the engine benchmarks.
+ *
+ * These cover animations, sprite transforms, the matrices built for each
+ * sprite drawn, and particles. Nothing is drawn, as that requires a
+ * display. As such, how sprites are batched into draw calls is not
+ * covered.
+ *
+ * @param[in] argc The number of command line arguments.
+ * @param[in] argv The command line arguments.
+ * @return `true` if the benchmarks ran, `false` otherwise.
+ */
+bool
+bench_engine(int argc, const char *argv[]);
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,214 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "bench.h"
+
+#include <string.h>
+
+#include "../engine/graphics.h"
+#include "../engine/particles.h"
+#include "../engine/private/graphics.h"
+
+#include "../runtime/time.h"
+
+#define ANIME_FRAMES    8
+#define ANIME_UPDATES   10000
+#define SPRITE_COUNT    1024
+#define SCREEN_WIDTH    320.0f
+#define SCREEN_HEIGHT   224.0f
+#define PARTICLE_COUNT  4096
+#define PARTICLE_STEPS  60
+
+/*
+ * There is no display to create real sprites with. Nothing here is drawn,
+ * so sprites with no texture behind them are enough. The same goes for
+ * the scene the matrices of each sprite are built for.
+ */
+static RBTK_SPRITE sprites[SPRITE_COUNT];
+static RBTK_CAMERA camera;
+static RBTK_GRAPHICS scene;
+
+static void
+run_anime_updates(void *args)
+{
+    RBTK_SPRITE_ANIME *anime = args;
+    for (size_t i = 0; i < ANIME_UPDATES; i++) {
+        rbtk_update_sprite_anime(anime, 1000.0L / 60, RBTK_MILLIS);
+    }
+}
+
+static bool
+bench_anime(void)
+{
+    RBTK_SPRITE_ANIME *anime = rbtk_create_sprite_anime(ANIME_FRAMES);
+    if (!anime) {
+        bench_skip("anime.update", "could not create animation");
+        return false;
+    }
+
+    for (size_t i = 0; i < ANIME_FRAMES; i++) {
+        if (!rbtk_add_sprite_to_anime(anime, &sprites[i],
+                50.0L, RBTK_MILLIS)) {
+            rbtk_destroy_sprite_anime(anime, false);
+            bench_skip("anime.update", "could not add frames");
+            return false;
+        }
+    }
+    rbtk_loop_sprite_anime(anime, true, false);
+    bench_measure("anime.update", run_anime_updates, anime, ANIME_UPDATES);
+
+    rbtk_loop_sprite_anime(anime, true, true);
+    bench_measure("anime.update_ping_pong", run_anime_updates,
+        anime, ANIME_UPDATES);
+
+    rbtk_destroy_sprite_anime(anime, false);
+    return true;
+}
+
+static void
+run_sprite_transforms(RBTK_UNUSED void *args)
+{
+    for (size_t i = 0; i < SPRITE_COUNT; i++) {
+        RBTK_SPRITE *sprite = &sprites[i];
+        float angle = (float) i * 7.5f;
+        rbtk_set_sprite_offset(sprite, (float) i, (float) i / 2, 0.0f);
+        rbtk_rotate_sprite_to(sprite, 0.0f, 0.0f, angle);
+        rbtk_scale_sprite(sprite, 1.0f, 1.0f, 1.0f);
+    }
+}
+
+static void
+run_sprite_matrices(RBTK_UNUSED void *args)
+{
+    for (size_t i = 0; i < SPRITE_COUNT; i++) {
+        mat4 model_matrix = GLM_MAT4_IDENTITY_INIT;
+        mat4 view_matrix = GLM_MAT4_IDENTITY_INIT;
+        mat4 proj_matrix = GLM_MAT4_IDENTITY_INIT;
+        priv_rbtk_get_sprite_matrices(&scene, &sprites[i],
+            (float) i, (float) i / 2, 0.0f,
+            model_matrix, view_matrix, proj_matrix);
+    }
+}
+
+/*
+ * This is the work done on the CPU for each sprite drawn. Only uploading
+ * the matrices and the draw call itself are left out, as they need a
+ * display.
+ */
+static bool
+bench_sprite_matrices(void)
+{
+    RBTK_PROJECTION *proj = rbtk_create_greek_matrix(
+        SCREEN_WIDTH, SCREEN_HEIGHT, 1000.0f);
+    if (!proj) {
+        bench_skip("sprite.matrices", "could not create projection");
+        return false;
+    }
+
+    memset(&camera, 0x00, sizeof(camera));
+    memset(&scene, 0x00, sizeof(scene));
+    scene.proj = proj;
+    scene.camera = &camera;
+
+    bench_measure("sprite.matrices", run_sprite_matrices,
+        NULL, SPRITE_COUNT);
+
+    rbtk_destroy_projection(proj);
+    return true;
+}
+
+static void
+run_particle_updates(void *args)
+{
+    RBTK_PARTICLES *particles = args;
+    for (size_t i = 0; i < PARTICLE_STEPS; i++) {
+        rbtk_update_particles(particles, 1.0f / 60);
+    }
+}
+
+static void
+run_particle_bursts(void *args)
+{
+    RBTK_PARTICLES *particles = args;
+    rbtk_clear_particles(particles);
+    size_t emitted = rbtk_emit_particle_burst(particles, 0.0f, 0.0f,
+        PARTICLE_COUNT, 120.0f, 1.0f);
+    (void) emitted; /* only the emitting is measured */
+}
+
+static bool
+bench_particles(void)
+{
+    RBTK_PARTICLES *particles = rbtk_create_particles(PARTICLE_COUNT);
+    if (!particles) {
+        bench_skip("particles", "could not create particles");
+        return false;
+    }
+
+    bench_measure("particles.emit", run_particle_bursts,
+        particles, PARTICLE_COUNT);
+
+    /*
+     * The particles must outlive every run, or later runs would update
+     * fewer of them. Each operation is one particle for one step.
+     */
+    rbtk_clear_particles(particles);
+    rbtk_set_particle_gravity(particles, 0.0f, 400.0f);
+    size_t emitted = rbtk_emit_particle_burst(particles, 0.0f, 0.0f,
+        PARTICLE_COUNT, 120.0f, 1000000.0f);
+    if (emitted > 0) {
+        bench_measure("particles.update", run_particle_updates,
+            particles, emitted * PARTICLE_STEPS);
+    }
+    else {
+        bench_skip("particles.update", "could not emit particles");
+    }
+
+    rbtk_destroy_particles(particles);
+    return true;
+}
+
+bool
+bench_engine(RBTK_UNUSED int argc, RBTK_UNUSED const char *argv[])
+{
+    bool passed = true;
+
+    memset(sprites, 0x00, sizeof(sprites));
+    for (size_t i = 0; i < SPRITE_COUNT; i++) {
+        sprites[i].width = 32;
+        sprites[i].height = 32;
+        sprites[i].section.width = 32;
+        sprites[i].section.height = 32;
+        sprites[i].scale.x = 1.0f;
+        sprites[i].scale.y = 1.0f;
+        sprites[i].scale.z = 1.0f;
+    }
+
+    passed &= bench_anime();
+    bench_measure("sprite.transform", run_sprite_transforms,
+        NULL, SPRITE_COUNT);
+    passed &= bench_sprite_matrices();
+    passed &= bench_particles();
+
+    return passed;
+}
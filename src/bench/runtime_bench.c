@@ -0,0 +1,270 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../runtime/asset.h"
+#include "../runtime/stream.h"
+#include "../runtime/thread.h"
+
+#define DEFAULT_SCRATCH_PATH "kleitor_bench.tmp"
+#define SCRATCH_SIZE         (4 * 1024 * 1024)
+#define READ_CHUNK_SIZE      4096
+
+#define ASSET_COUNT     256
+#define ROUND_TRIPS     100
+#define FAN_OUT_JOBS    64
+
+typedef RBTK_IN_STREAM *(*open_fun)(void *args);
+
+typedef struct stream_args {
+    open_fun open;
+    void *src;
+} stream_args;
+
+typedef struct memory_src {
+    unsigned char *data;
+    size_t size;
+} memory_src;
+
+static RBTK_IN_STREAM *
+open_file(void *args)
+{
+    return rbtk_open_file_in_stream(args);
+}
+
+static RBTK_IN_STREAM *
+open_memory(void *args)
+{
+    memory_src *src = args;
+    return rbtk_open_memory_in_stream(src->data, src->size);
+}
+
+static void
+run_read_byte(void *args)
+{
+    stream_args *stream = args;
+    RBTK_IN_STREAM *in = stream->open(stream->src);
+    if (!in) {
+        return;
+    }
+    while (rbtk_read_byte(in) != EOF) {
+        /* only the read itself is measured */
+    }
+    rbtk_close_in_stream(in);
+}
+
+static void
+run_read_chunks(void *args)
+{
+    stream_args *stream = args;
+    RBTK_IN_STREAM *in = stream->open(stream->src);
+    if (!in) {
+        return;
+    }
+    static unsigned char chunk[READ_CHUNK_SIZE];
+    while (rbtk_read_bytes(in, chunk, 0, sizeof(chunk)) > 0) {
+        /* only the read itself is measured */
+    }
+    rbtk_close_in_stream(in);
+}
+
+static void
+run_buffer_remaining(void *args)
+{
+    stream_args *stream = args;
+    RBTK_IN_STREAM *in = stream->open(stream->src);
+    if (!in) {
+        return;
+    }
+    size_t size = 0;
+    free(rbtk_buffer_remaining(in, &size));
+    rbtk_close_in_stream(in);
+}
+
+/*!
+ * @brief Writes the file used to measure file reads.
+ *
+ * @param[in] path The path of the file.
+ * @param[in] data The contents of the file.
+ * @param[in] size The length of `data` in bytes.
+ * @return `true` on success, `false` on failure.
+ */
+static bool
+write_scratch(const char *path, const unsigned char *data, size_t size)
+{
+    RBTK_OUT_STREAM *out = rbtk_open_file_out_stream(path);
+    if (!out) {
+        return false;
+    }
+    size_t written = rbtk_write_bytes(out, data, 0, size);
+    bool closed = rbtk_close_out_stream(out);
+    return written == size && closed;
+}
+
+static void
+bench_streams(const char *name, stream_args *args)
+{
+    char report[64];
+
+    /* each operation is one byte */
+    snprintf(report, sizeof(report), "stream.%s.read_byte", name);
+    bench_measure(report, run_read_byte, args, SCRATCH_SIZE);
+
+    /* each operation is one call to read */
+    snprintf(report, sizeof(report), "stream.%s.read_4k", name);
+    bench_measure(report, run_read_chunks, args,
+        SCRATCH_SIZE / READ_CHUNK_SIZE);
+
+    /* each operation is one KiB of the stream */
+    snprintf(report, sizeof(report), "stream.%s.buffer_remaining", name);
+    bench_measure(report, run_buffer_remaining, args, SCRATCH_SIZE / 1024);
+}
+
+/*
+ * The assets keep a pointer to the name they were first looked up with,
+ * so these names must outlive the benchmark.
+ */
+static char asset_names[ASSET_COUNT][32];
+
+static void
+run_asset_lookups(RBTK_UNUSED void *args)
+{
+    for (size_t i = 0; i < ASSET_COUNT; i++) {
+        RBTK_ASSET *asset = rbtk_get_asset(asset_names[i]);
+        (void) asset; /* only the lookup is measured */
+    }
+}
+
+static void
+bench_assets(void)
+{
+    /*
+     * Assets are loaded lazily, so none of these files need to exist. The
+     * warmup runs add them to the list of loaded assets, which means only
+     * the lookup is measured after that.
+     */
+    for (size_t i = 0; i < ASSET_COUNT; i++) {
+        snprintf(asset_names[i], sizeof(asset_names[i]),
+            "bench/asset_%03zu.bin", i);
+    }
+    run_asset_lookups(NULL);
+    bench_measure("asset.lookup", run_asset_lookups, NULL, ASSET_COUNT);
+}
+
+static void
+empty_job(RBTK_UNUSED void *args)
+{
+    /* only the trip through the pool is measured */
+}
+
+static void
+run_round_trips(void *args)
+{
+    RBTK_THREAD_POOL *pool = args;
+    for (size_t i = 0; i < ROUND_TRIPS; i++) {
+        RBTK_JOB *job = rbtk_submit_job(pool, empty_job, NULL);
+        if (job) {
+            rbtk_await_job(job);
+        }
+    }
+}
+
+static void
+run_fan_out(void *args)
+{
+    RBTK_THREAD_POOL *pool = args;
+    RBTK_JOB *jobs[FAN_OUT_JOBS];
+    for (size_t i = 0; i < FAN_OUT_JOBS; i++) {
+        jobs[i] = rbtk_submit_job(pool, empty_job, NULL);
+    }
+    for (size_t i = 0; i < FAN_OUT_JOBS; i++) {
+        if (jobs[i]) {
+            rbtk_await_job(jobs[i]);
+        }
+    }
+}
+
+static bool
+bench_thread_pool(void)
+{
+    /* one worker per processor */
+    RBTK_THREAD_POOL *pool = rbtk_create_thread_pool("bench", 0);
+    if (!pool) {
+        bench_skip("thread_pool", "could not create pool");
+        return false;
+    }
+
+    bench_measure("thread_pool.round_trip", run_round_trips,
+        pool, ROUND_TRIPS);
+    bench_measure("thread_pool.fan_out_64", run_fan_out,
+        pool, FAN_OUT_JOBS);
+
+    return rbtk_destroy_thread_pool(pool);
+}
+
+bool
+bench_runtime(int argc, const char *argv[])
+{
+    bool passed = true;
+
+    const char *scratch_path = bench_get_option(argc, argv, "scratch");
+    if (!scratch_path) {
+        scratch_path = DEFAULT_SCRATCH_PATH;
+    }
+
+    unsigned char *data = malloc(SCRATCH_SIZE);
+    if (!data) {
+        fprintf(stderr, "Failed to allocate stream data.\n");
+        return false;
+    }
+    for (size_t i = 0; i < SCRATCH_SIZE; i++) {
+        data[i] = (unsigned char) (i * 31 + 7); /* anything but zeroes */
+    }
+
+    memory_src memory = { .data = data, .size = SCRATCH_SIZE };
+    stream_args memory_args = { .open = open_memory, .src = &memory };
+    bench_streams("memory", &memory_args);
+
+    if (write_scratch(scratch_path, data, SCRATCH_SIZE)) {
+        stream_args file_args = {
+            .open = open_file,
+            .src = (void *) scratch_path,
+        };
+        bench_streams("file", &file_args);
+        remove(scratch_path);
+    }
+    else {
+        bench_skip("stream.file", "could not write scratch file");
+        passed = false;
+    }
+    free(data);
+
+    bench_assets();
+    passed &= bench_thread_pool();
+
+    return passed;
+}
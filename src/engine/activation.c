@@ -0,0 +1,288 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "activation.h"
+#include "./private/activation.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "entity.h"
+
+#include "../runtime/common.h"
+
+#define BITS_PER_WORD 32
+
+static int
+compare_spawns(const void *a, const void *b)
+{
+    const rbtk_spawn *spawn_a = a;
+    const rbtk_spawn *spawn_b = b;
+    return (spawn_a->x > spawn_b->x) - (spawn_a->x < spawn_b->x);
+}
+
+RBTK_NO_DISCARD RBTK_ACTIVATOR *
+rbtk_create_activator(RBTK_WORLD *world, const rbtk_spawn *spawns,
+    size_t count, float margin, const rbtk_activator_funs *funs,
+    void *args)
+{
+    assert(world);
+    assert(spawns || count == 0);
+    assert(margin >= 0.0f);
+    assert(funs);
+    assert(funs->spawn);
+
+    RBTK_ACTIVATOR *activator = NULL;
+    RBTK_MALLOC_OR_RETURN(&activator, NULL,
+        "could not allocate memory for activator");
+
+    activator->world = world;
+    activator->funs = *funs;
+    activator->args = args;
+    activator->margin = margin;
+    activator->count = count;
+    activator->first = 0;
+    activator->last = 0;
+
+    /* allocate at least one of each, as malloc(0) may return NULL */
+    size_t n = count > 0 ? count : 1;
+    size_t words = (n + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    activator->spawns = malloc(n * sizeof(*activator->spawns));
+    activator->spawn_x = malloc(n * sizeof(*activator->spawn_x));
+    activator->entities = malloc(n * sizeof(*activator->entities));
+    activator->removed = calloc(words, sizeof(*activator->removed));
+    if (!activator->spawns || !activator->spawn_x
+        || !activator->entities || !activator->removed) {
+        rbtk_destroy_activator(activator);
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate memory for spawns");
+        return NULL;
+    }
+
+    if (count > 0) {
+        memcpy(activator->spawns, spawns, count * sizeof(*spawns));
+        qsort(activator->spawns, count, sizeof(*spawns), compare_spawns);
+    }
+    for (size_t i = 0; i < count; i++) {
+        activator->spawn_x[i] = activator->spawns[i].x;
+        activator->entities[i] = RBTK_NO_ENTITY;
+    }
+
+    return activator;
+}
+
+static void
+release_spawn(RBTK_ACTIVATOR *activator, size_t index)
+{
+    rbtk_entity entity = activator->entities[index];
+    if (entity == RBTK_NO_ENTITY) {
+        return; /* never spawned */
+    }
+    activator->entities[index] = RBTK_NO_ENTITY;
+
+    /*
+     * The game may have destroyed the entity itself (e.g., a badnik which
+     * was hit). In that case, there is nothing left to release.
+     */
+    if (!rbtk_entity_exists(activator->world, entity)) {
+        return;
+    }
+
+    if (activator->funs.despawn) {
+        activator->funs.despawn(activator->world, entity, activator->args);
+    }
+    else {
+        rbtk_destroy_entity(activator->world, entity);
+    }
+}
+
+static void
+activate_spawn(RBTK_ACTIVATOR *activator, size_t index)
+{
+    if (rbtk_spawn_is_removed(activator, index)) {
+        return;
+    }
+
+    activator->entities[index] = activator->funs.spawn(activator->world,
+        &activator->spawns[index], activator->args);
+}
+
+static void
+release_range(RBTK_ACTIVATOR *activator, size_t first, size_t last)
+{
+    for (size_t i = first; i < last; i++) {
+        release_spawn(activator, i);
+    }
+}
+
+static void
+activate_range(RBTK_ACTIVATOR *activator, size_t first, size_t last)
+{
+    for (size_t i = first; i < last; i++) {
+        activate_spawn(activator, i);
+    }
+}
+
+void
+rbtk_destroy_activator(RBTK_ACTIVATOR *activator)
+{
+    if (!activator) {
+        return;
+    }
+
+    if (activator->entities) {
+        release_range(activator, activator->first, activator->last);
+    }
+
+    free(activator->spawns);
+    free(activator->spawn_x);
+    free(activator->entities);
+    free(activator->removed);
+    free(activator);
+}
+
+void
+rbtk_update_activator(RBTK_ACTIVATOR *activator, float left, float right)
+{
+    assert(activator);
+    assert(left <= right);
+
+    const float *spawn_x = activator->spawn_x;
+    size_t count = activator->count;
+    float min_x = left - activator->margin;
+    float max_x = right + activator->margin;
+
+    /*
+     * The edges of the window are walked from where they were last time,
+     * rather than searched for. The camera only moves a few pixels each
+     * tick, so this is usually no more than a step or two.
+     */
+    size_t first = activator->first;
+    while (first < count && spawn_x[first] < min_x) {
+        first += 1;
+    }
+    while (first > 0 && spawn_x[first - 1] >= min_x) {
+        first -= 1;
+    }
+
+    size_t last = activator->last;
+    while (last < count && spawn_x[last] <= max_x) {
+        last += 1;
+    }
+    while (last > 0 && spawn_x[last - 1] > max_x) {
+        last -= 1;
+    }
+
+    size_t old_first = activator->first;
+    size_t old_last = activator->last;
+    if (last < first) {
+        last = first; /* the window is between two spawns */
+    }
+
+    /*
+     * Release whatever was in the old window but is not in the new one,
+     * then spawn whatever is in the new window but was not in the old one.
+     * Both windows are ranges, so each difference is at most two ranges.
+     */
+    release_range(activator, old_first,
+        old_last < first ? old_last : first);
+    release_range(activator, old_first > last ? old_first : last,
+        old_last);
+
+    activate_range(activator, first,
+        last < old_first ? last : old_first);
+    activate_range(activator, first > old_last ? first : old_last,
+        last);
+
+    activator->first = first;
+    activator->last = last;
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_get_spawn_count(const RBTK_ACTIVATOR *activator)
+{
+    assert(activator);
+    return activator->count;
+}
+
+RBTK_NO_DISCARD const rbtk_spawn *
+rbtk_get_spawn(const RBTK_ACTIVATOR *activator, size_t index)
+{
+    assert(activator);
+    assert(index < activator->count);
+    return &activator->spawns[index];
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_find_spawn(const RBTK_ACTIVATOR *activator, rbtk_entity entity)
+{
+    assert(activator);
+
+    if (entity == RBTK_NO_ENTITY) {
+        return SIZE_MAX;
+    }
+
+    for (size_t i = activator->first; i < activator->last; i++) {
+        if (activator->entities[i] == entity) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+void
+rbtk_remove_spawn(RBTK_ACTIVATOR *activator, size_t index)
+{
+    assert(activator);
+    assert(index < activator->count);
+
+    release_spawn(activator, index);
+    activator->removed[index / BITS_PER_WORD]
+        |= (uint32_t) 1 << (index % BITS_PER_WORD);
+}
+
+RBTK_NO_DISCARD bool
+rbtk_spawn_is_removed(const RBTK_ACTIVATOR *activator, size_t index)
+{
+    assert(activator);
+    assert(index < activator->count);
+
+    uint32_t word = activator->removed[index / BITS_PER_WORD];
+    return (word >> (index % BITS_PER_WORD)) & 1;
+}
+
+void
+rbtk_restore_spawns(RBTK_ACTIVATOR *activator)
+{
+    assert(activator);
+
+    release_range(activator, activator->first, activator->last);
+    activator->first = 0;
+    activator->last = 0;
+
+    size_t words = (activator->count + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    memset(activator->removed, 0x00, words * sizeof(*activator->removed));
+}
@@ -0,0 +1,271 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_ACTIVATION_H_
+#define RBTK_ENGINE_ACTIVATION_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+ * @file
+ * @brief The public API for the game engine's activation module.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "entity.h"
+
+#include "../runtime/common.h"
+#include "../runtime/error.h"
+
+/*!
+ * @defgroup engine_activation Object Activation
+ * @brief The game engine's activation module.
+ *
+ * A level can place thousands of objects, but only the ones near the
+ * camera matter on any given frame. An activator keeps every object in a
+ * level as a spawn, which is little more than a position and a type. A
+ * spawn is only turned into an entity while it is within a window around
+ * the camera, and the entity is released once the spawn leaves it. As
+ * such, the cost of simulating a level stays about the same no matter how
+ * large it is.
+ *
+ * Spawns are kept sorted by their position on the X-axis. The window only
+ * moves a little each frame, so only the spawns at either edge of it are
+ * looked at to find which ones entered or left.
+ *
+ * Some objects should not come back once they are gone (e.g., a ring which
+ * was collected). Such spawns can be removed, which is remembered until
+ * the spawns are restored (e.g., when the player loses a life).
+ *
+ * @see rbtk_create_activator(RBTK_WORLD *, const rbtk_spawn *, size_t,
+ *      float, const rbtk_activator_funs *, void *)
+ * @see rbtk_update_activator(RBTK_ACTIVATOR *, float, float)
+ *
+ * @{
+ */
+
+/*!
+ * @brief An object placed in a level.
+ */
+typedef struct rbtk_spawn {
+    float x;             /*!< The X-axis position of the object. */
+    float y;             /*!< The Y-axis position of the object. */
+    unsigned int type;   /*!< What kind of object it is.         */
+    unsigned int params; /*!< Any extra data for the object.     */
+} rbtk_spawn;
+
+/*!
+ * @brief Called to turn a spawn into an entity.
+ *
+ * @param[in] world The world to create the entity in.
+ * @param[in] spawn The spawn which entered the window.
+ * @param[in] args  The arguments given to the activator.
+ * @return The created entity, #RBTK_NO_ENTITY if none was created.
+ */
+typedef rbtk_entity (*rbtk_spawn_fun)(RBTK_WORLD *world,
+    const rbtk_spawn *spawn, void *args);
+
+/*!
+ * @brief Called to release the entity of a spawn.
+ *
+ * This is only called if the entity still exists.
+ *
+ * @param[in] world  The world the entity is in.
+ * @param[in] entity The entity of the spawn which left the window.
+ * @param[in] args   The arguments given to the activator.
+ */
+typedef void (*rbtk_despawn_fun)(RBTK_WORLD *world, rbtk_entity entity,
+    void *args);
+
+/*!
+ * @brief The functions an activator calls as spawns enter and leave.
+ */
+typedef struct rbtk_activator_funs {
+    rbtk_spawn_fun spawn;     /*!< Required.                             */
+    rbtk_despawn_fun despawn; /*!< If `NULL`, the entity is destroyed.   */
+} rbtk_activator_funs;
+
+/*!
+ * @brief Turns the spawns of a level into entities near the camera.
+ *
+ * @see rbtk_create_activator(RBTK_WORLD *, const rbtk_spawn *, size_t,
+ *      float, const rbtk_activator_funs *, void *)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_ACTIVATOR RBTK_ACTIVATOR;
+
+/*!
+ * @brief Creates an activator.
+ *
+ * The spawns are copied and sorted by their X-axis position. Nothing is
+ * spawned until the activator is first updated.
+ *
+ * @param[in] world  The world to spawn entities in.
+ * @param[in] spawns The spawns of the level. These can be in any order.
+ * @param[in] count  The number of spawns.
+ * @param[in] margin How far past either side of the camera a spawn can be
+ *                   and still be spawned.
+ * @param[in] funs   The functions to call as spawns enter and leave. This
+ *                   is copied, and as such does not need to outlive the
+ *                   call.
+ * @param[in] args   Passed to each function in `funs`.
+ * @return The created activator, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until it is destroyed
+ * with #rbtk_destroy_activator(RBTK_ACTIVATOR *). The world must outlive
+ * the activator.
+ *
+ * @debugging This function asserts that `world`, `funs`, and `funs->spawn`
+ * are not `NULL`, that `spawns` is not `NULL` if `count` is not `0`, and
+ * that `margin` is not negative.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If memory for the activator could
+ *                                    not be allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD RBTK_ACTIVATOR *
+rbtk_create_activator(RBTK_WORLD *world, const rbtk_spawn *spawns,
+    size_t count, float margin, const rbtk_activator_funs *funs,
+    void *args);
+
+/*!
+ * @brief Destroys an activator.
+ *
+ * The entities of any spawns still in the window are released.
+ *
+ * @param[in] activator The activator to destroy. If `NULL`, this function
+ *                      is a no-op.
+ */
+void
+rbtk_destroy_activator(RBTK_ACTIVATOR *activator);
+
+/*!
+ * @brief Moves the window of an activator.
+ *
+ * Spawns which entered the window are spawned, and the entities of spawns
+ * which left it are released. This should be called once per tick, after
+ * the camera has moved.
+ *
+ * @param[in] activator The activator to update.
+ * @param[in] left      The left edge of the camera.
+ * @param[in] right     The right edge of the camera.
+ *
+ * @debugging This function asserts that `activator` is not `NULL` and that
+ * `left` is not greater than `right`.
+ */
+void
+rbtk_update_activator(RBTK_ACTIVATOR *activator, float left, float right);
+
+/*!
+ * @brief Returns the number of spawns in an activator.
+ *
+ * @param[in] activator The activator to query.
+ * @return The number of spawns.
+ *
+ * @debugging This function asserts that `activator` is not `NULL`.
+ */
+RBTK_NO_DISCARD size_t
+rbtk_get_spawn_count(const RBTK_ACTIVATOR *activator);
+
+/*!
+ * @brief Returns one of the spawns in an activator.
+ *
+ * @param[in] activator The activator to query.
+ * @param[in] index     The index of the spawn, in order of X-axis position.
+ * @return The requested spawn.
+ *
+ * @debugging This function asserts that `activator` is not `NULL` and that
+ * `index` is less than the number of spawns.
+ */
+RBTK_NO_DISCARD const rbtk_spawn *
+rbtk_get_spawn(const RBTK_ACTIVATOR *activator, size_t index);
+
+/*!
+ * @brief Returns which spawn an entity came from.
+ *
+ * Only spawns in the window are searched, which is where any spawned
+ * entity is.
+ *
+ * @param[in] activator The activator to query.
+ * @param[in] entity    The entity to look for.
+ * @return The index of the spawn, `SIZE_MAX` if the entity did not come
+ *         from a spawn in the window.
+ *
+ * @debugging This function asserts that `activator` is not `NULL`.
+ */
+RBTK_NO_DISCARD size_t
+rbtk_find_spawn(const RBTK_ACTIVATOR *activator, rbtk_entity entity);
+
+/*!
+ * @brief Removes a spawn until spawns are restored.
+ *
+ * If the spawn currently has an entity, it is released.
+ *
+ * @param[in] activator The activator to update.
+ * @param[in] index     The index of the spawn to remove.
+ *
+ * @debugging This function asserts that `activator` is not `NULL` and that
+ * `index` is less than the number of spawns.
+ *
+ * @see rbtk_restore_spawns(RBTK_ACTIVATOR *)
+ */
+void
+rbtk_remove_spawn(RBTK_ACTIVATOR *activator, size_t index);
+
+/*!
+ * @brief Returns if a spawn was removed.
+ *
+ * @param[in] activator The activator to query.
+ * @param[in] index     The index of the spawn.
+ * @return `true` if the spawn was removed, `false` otherwise.
+ *
+ * @debugging This function asserts that `activator` is not `NULL` and that
+ * `index` is less than the number of spawns.
+ */
+RBTK_NO_DISCARD bool
+rbtk_spawn_is_removed(const RBTK_ACTIVATOR *activator, size_t index);
+
+/*!
+ * @brief Restores every removed spawn.
+ *
+ * Every entity in the window is released. The window is filled again on
+ * the next update, including with the spawns which were removed.
+ *
+ * @param[in] activator The activator to update.
+ *
+ * @debugging This function asserts that `activator` is not `NULL`.
+ */
+void
+rbtk_restore_spawns(RBTK_ACTIVATOR *activator);
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_ACTIVATION_H_ */
@@ -0,0 +1,317 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "animation.h"
+#include "./private/animation.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "graphics.h"
+
+#include "./private/graphics.h"
+
+#include "../runtime/common.h"
+#include "../runtime/time.h"
+
+/*
+ * These are kept in the same byte as the flags given when an animation is
+ * played, so they must not overlap with any of those.
+ */
+#define FLAG_FINISHED 0x40
+#define FLAG_PLAYING  0x80
+
+/*
+ * Animations which are not waiting on a frame change (because they are
+ * stopped or finished) are given this many ticks remaining. This keeps
+ * them out of the way of the second pass for a very long time.
+ */
+#define IDLE_TICKS INT32_MAX
+
+RBTK_NO_DISCARD RBTK_ANIME_CLIP *
+rbtk_create_anime_clip(const RBTK_SPRITE_ANIME *anime, long double tick,
+    rbtk_time_unit unit)
+{
+    assert(anime);
+    assert(tick > 0);
+
+    if (anime->num_frames == 0) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_ARGUMENT,
+            "animation has no frames");
+        return NULL;
+    }
+
+    RBTK_ANIME_CLIP *clip = NULL;
+    RBTK_MALLOC_OR_RETURN(&clip, NULL,
+        "could not allocate memory for clip");
+
+    size_t num_frames = anime->num_frames;
+    clip->num_frames = num_frames;
+    clip->frames = malloc(num_frames * sizeof(*clip->frames));
+    clip->ticks = malloc(num_frames * sizeof(*clip->ticks));
+    if (!clip->frames || !clip->ticks) {
+        rbtk_destroy_anime_clip(clip);
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate memory for clip frames");
+        return NULL;
+    }
+
+    long double tick_ms = rbtk_convert_time(unit, RBTK_MILLIS, tick);
+    for (size_t i = 0; i < num_frames; i++) {
+        long double ticks = roundl(anime->durations[i] / tick_ms);
+        clip->frames[i] = anime->frames[i];
+        clip->ticks[i] = ticks < 1.0L ? 1
+            : ticks > INT32_MAX ? INT32_MAX : (int32_t) ticks;
+    }
+
+    return clip;
+}
+
+void
+rbtk_destroy_anime_clip(RBTK_ANIME_CLIP *clip)
+{
+    if (clip) {
+        free(clip->frames);
+        free(clip->ticks);
+        free(clip);
+    }
+}
+
+RBTK_NO_DISCARD RBTK_ANIME_SET *
+rbtk_create_anime_set(size_t max_animes)
+{
+    assert(max_animes > 0);
+
+    RBTK_ANIME_SET *set = NULL;
+    RBTK_MALLOC_OR_RETURN(&set, NULL,
+        "could not allocate memory for animation set");
+
+    set->max_animes = max_animes;
+    set->num_slots = 0;
+    set->clips = malloc(max_animes * sizeof(*set->clips));
+    set->remaining = malloc(max_animes * sizeof(*set->remaining));
+    set->frames = malloc(max_animes * sizeof(*set->frames));
+    set->flags = calloc(max_animes, sizeof(*set->flags));
+    if (!set->clips || !set->remaining || !set->frames || !set->flags) {
+        rbtk_destroy_anime_set(set);
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate memory for animation slots");
+        return NULL;
+    }
+
+    return set;
+}
+
+void
+rbtk_destroy_anime_set(RBTK_ANIME_SET *set)
+{
+    if (set) {
+        free((void *) set->clips);
+        free(set->remaining);
+        free(set->frames);
+        free(set->flags);
+        free(set);
+    }
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_play_anime(RBTK_ANIME_SET *set, const RBTK_ANIME_CLIP *clip,
+    unsigned int flags)
+{
+    assert(set);
+    assert(clip);
+
+    /*
+     * Reuse the first free slot. This keeps the animations packed at the
+     * front of the arrays, so advancing the set only goes over as many
+     * slots as have ever been in use at once.
+     */
+    size_t index = 0;
+    while (index < set->num_slots && (set->flags[index] & FLAG_PLAYING)) {
+        index += 1;
+    }
+
+    if (index >= set->max_animes) {
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "max animation count reached");
+        return RBTK_NO_ANIME;
+    }
+    else if (index >= set->num_slots) {
+        set->num_slots = index + 1;
+    }
+
+    flags &= RBTK_ANIME_LOOP | RBTK_ANIME_PING_PONG | RBTK_ANIME_BACKWARDS;
+    uint32_t frame = (flags & RBTK_ANIME_BACKWARDS)
+        ? (uint32_t) (clip->num_frames - 1) : 0;
+
+    set->clips[index] = clip;
+    set->frames[index] = frame;
+    set->remaining[index] = clip->ticks[frame];
+    set->flags[index] = (uint8_t) (flags | FLAG_PLAYING);
+    return index;
+}
+
+void
+rbtk_stop_anime(RBTK_ANIME_SET *set, size_t index)
+{
+    assert(set);
+    assert(index < set->num_slots);
+    assert(set->flags[index] & FLAG_PLAYING);
+
+    set->flags[index] = 0;
+    set->remaining[index] = IDLE_TICKS;
+
+    while (set->num_slots > 0
+        && !(set->flags[set->num_slots - 1] & FLAG_PLAYING)) {
+        set->num_slots -= 1;
+    }
+}
+
+static void
+finish_anime(RBTK_ANIME_SET *set, size_t index)
+{
+    set->flags[index] |= FLAG_FINISHED;
+    set->remaining[index] = IDLE_TICKS;
+}
+
+/*
+ * Moves an animation to its next frame, turning around or starting over
+ * at either end as its flags say. This mirrors how a sprite animation is
+ * updated, so a clip plays the same in a set as it does on its own.
+ */
+static void
+step_anime(RBTK_ANIME_SET *set, size_t index)
+{
+    const RBTK_ANIME_CLIP *clip = set->clips[index];
+    uint8_t flags = set->flags[index];
+    uint32_t last = (uint32_t) (clip->num_frames - 1);
+    uint32_t frame = set->frames[index];
+
+    if (!(flags & RBTK_ANIME_BACKWARDS)) {
+        if (frame < last) {
+            frame += 1;
+        }
+        else if (!(flags & RBTK_ANIME_LOOP)) {
+            finish_anime(set, index);
+            return;
+        }
+        else if (flags & RBTK_ANIME_PING_PONG) {
+            flags |= RBTK_ANIME_BACKWARDS;
+            frame = last > 0 ? last - 1 : 0;
+        }
+        else {
+            frame = 0;
+        }
+    }
+    else {
+        if (frame > 0) {
+            frame -= 1;
+        }
+        else if (!(flags & RBTK_ANIME_LOOP)) {
+            finish_anime(set, index);
+            return;
+        }
+        else if (flags & RBTK_ANIME_PING_PONG) {
+            flags &= (uint8_t) ~RBTK_ANIME_BACKWARDS;
+            frame = last > 0 ? 1 : 0;
+        }
+        else {
+            frame = last;
+        }
+    }
+
+    set->flags[index] = flags;
+    set->frames[index] = frame;
+    set->remaining[index] += clip->ticks[frame];
+}
+
+void
+rbtk_advance_animes(RBTK_ANIME_SET *set, uint32_t ticks)
+{
+    assert(set);
+    assert(ticks <= INT32_MAX);
+
+    size_t num_slots = set->num_slots;
+    int32_t *remaining = set->remaining;
+    int32_t amount = (int32_t) ticks;
+
+    /*
+     * The first pass counts down every animation at once. It has no
+     * branches and touches nothing else, so it is easily vectorized.
+     */
+    for (size_t i = 0; i < num_slots; i++) {
+        remaining[i] -= amount;
+    }
+
+    /*
+     * The second pass only does real work for the animations which ran
+     * out of ticks, which are few on any given tick. Idle slots are given
+     * a fresh count so they never wrap around.
+     */
+    for (size_t i = 0; i < num_slots; i++) {
+        if (remaining[i] > 0) {
+            continue;
+        }
+
+        uint8_t flags = set->flags[i];
+        if (!(flags & FLAG_PLAYING) || (flags & FLAG_FINISHED)) {
+            remaining[i] = IDLE_TICKS;
+            continue;
+        }
+
+        while (remaining[i] <= 0 && !(set->flags[i] & FLAG_FINISHED)) {
+            step_anime(set, i);
+        }
+    }
+}
+
+RBTK_NO_DISCARD bool
+rbtk_anime_is_finished(const RBTK_ANIME_SET *set, size_t index)
+{
+    assert(set);
+    assert(index < set->num_slots);
+    assert(set->flags[index] & FLAG_PLAYING);
+    return (set->flags[index] & FLAG_FINISHED) != 0;
+}
+
+RBTK_NO_DISCARD RBTK_SPRITE *
+rbtk_get_anime_sprite(const RBTK_ANIME_SET *set, size_t index)
+{
+    assert(set);
+    assert(index < set->num_slots);
+    assert(set->flags[index] & FLAG_PLAYING);
+    return set->clips[index]->frames[set->frames[index]];
+}
+
+void
+rbtk_draw_anime(RBTK_GRAPHICS *scene, const RBTK_ANIME_SET *set,
+    size_t index, float x, float y, float z)
+{
+    assert(scene);
+    RBTK_SPRITE *sprite = rbtk_get_anime_sprite(set, index);
+    rbtk_draw_sprite(scene, sprite, x, y, z);
+}
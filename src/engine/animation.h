@@ -0,0 +1,274 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_ANIMATION_H_
+#define RBTK_ENGINE_ANIMATION_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+ * @file
+ * @brief The public API for the game engine's animation module.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "graphics.h"
+
+#include "../runtime/common.h"
+#include "../runtime/error.h"
+#include "../runtime/time.h"
+
+/*!
+ * @defgroup engine_animation Batched Animations
+ * @brief The game engine's animation module.
+ *
+ * A sprite animation is fine for something like a title screen, where only
+ * a few are on screen. However, updating hundreds of them (e.g., one for
+ * every ring in a level) one call at a time is slow. Each one lives in a
+ * different part of memory, and measures time in milliseconds.
+ *
+ * Instead, animations can be played in a set. A set keeps the state of
+ * every animation it plays side by side, and counts time in whole game
+ * ticks. Advancing a set moves every animation forward in one pass, which
+ * the compiler is able to vectorize. Only the animations which change
+ * frames on a given tick are looked at individually.
+ *
+ * What an animation looks like is described by a clip, which is made from
+ * an existing sprite animation. Any number of animations in any number of
+ * sets can play the same clip.
+ *
+ * @see rbtk_create_anime_clip(const RBTK_SPRITE_ANIME *, long double,
+ *      rbtk_time_unit)
+ * @see rbtk_create_anime_set(size_t)
+ * @see rbtk_advance_animes(RBTK_ANIME_SET *, uint32_t)
+ *
+ * @{
+ */
+
+/*!
+ * @brief Returned in place of an animation which could not be played.
+ *
+ * @see rbtk_play_anime(RBTK_ANIME_SET *, const RBTK_ANIME_CLIP *,
+ *      unsigned int)
+ */
+#define RBTK_NO_ANIME SIZE_MAX
+
+/*!
+ * @brief The frames of an animation, and how many ticks each one lasts.
+ *
+ * @see rbtk_create_anime_clip(const RBTK_SPRITE_ANIME *, long double,
+ *      rbtk_time_unit)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_ANIME_CLIP RBTK_ANIME_CLIP;
+
+/*!
+ * @brief A set of animations which are advanced together.
+ *
+ * @see rbtk_create_anime_set(size_t)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_ANIME_SET RBTK_ANIME_SET;
+
+/*!
+ * @brief How an animation in a set is played.
+ *
+ * These can be combined with a bitwise OR.
+ */
+typedef enum rbtk_anime_flag {
+    RBTK_ANIME_LOOP      = 0x01, /*!< Start over once finished.          */
+    RBTK_ANIME_PING_PONG = 0x02, /*!< Turn around at either end to loop. */
+    RBTK_ANIME_BACKWARDS = 0x04, /*!< Start from the last frame.         */
+} rbtk_anime_flag;
+
+/*!
+ * @brief Creates a clip from a sprite animation.
+ *
+ * The clip uses the same sprites as the animation. The duration of each
+ * frame is rounded to the nearest number of ticks, but is never less than
+ * a single tick.
+ *
+ * @param[in] anime The animation whose frames to use.
+ * @param[in] tick  How long a tick is.
+ * @param[in] unit  How to interpret `tick`.
+ * @return The created clip, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until it is destroyed
+ * with #rbtk_destroy_anime_clip(RBTK_ANIME_CLIP *). The sprites of the
+ * animation must remain loaded for this long.
+ *
+ * @debugging This function asserts that `anime` is not `NULL` and that
+ * `tick` is positive.
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_ARGUMENT, If `anime` has no frames.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY,    If memory for the clip could not
+ *                                       be allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD RBTK_ANIME_CLIP *
+rbtk_create_anime_clip(const RBTK_SPRITE_ANIME *anime, long double tick,
+    rbtk_time_unit unit);
+
+/*!
+ * @brief Destroys a clip.
+ *
+ * @attention It is an unchecked runtime error to destroy a clip which is
+ * still being played by a set.
+ *
+ * @param[in] clip The clip to destroy. If `NULL`, this function is a
+ *                 no-op.
+ */
+void
+rbtk_destroy_anime_clip(RBTK_ANIME_CLIP *clip);
+
+/*!
+ * @brief Creates a set of animations.
+ *
+ * @param[in] max_animes The max number of animations which can be playing
+ *                       in the set at once.
+ * @return The created set, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until it is destroyed
+ * with #rbtk_destroy_anime_set(RBTK_ANIME_SET *).
+ *
+ * @debugging This function asserts that `max_animes` is not `0`.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If memory for the set could not be
+ *                                    allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD RBTK_ANIME_SET *
+rbtk_create_anime_set(size_t max_animes);
+
+/*!
+ * @brief Destroys a set of animations.
+ *
+ * @param[in] set The set to destroy. If `NULL`, this function is a no-op.
+ */
+void
+rbtk_destroy_anime_set(RBTK_ANIME_SET *set);
+
+/*!
+ * @brief Plays a clip in a set.
+ *
+ * @param[in] set   The set to play the clip in.
+ * @param[in] clip  The clip to play.
+ * @param[in] flags How to play the clip, a combination of values from
+ *                  #rbtk_anime_flag.
+ * @return The index of the animation in the set, #RBTK_NO_ANIME on
+ *         failure. This stays the same until the animation is stopped.
+ *
+ * @debugging This function asserts that `set` and `clip` are not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If the set is already playing its
+ *                                    max number of animations.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD size_t
+rbtk_play_anime(RBTK_ANIME_SET *set, const RBTK_ANIME_CLIP *clip,
+    unsigned int flags);
+
+/*!
+ * @brief Stops an animation in a set.
+ *
+ * Once stopped, the index of the animation may be reused by the next one
+ * played in the set.
+ *
+ * @param[in] set   The set the animation is playing in.
+ * @param[in] index The index of the animation.
+ *
+ * @debugging This function asserts that `set` is not `NULL`, and that
+ * `index` is an animation playing in the set.
+ */
+void
+rbtk_stop_anime(RBTK_ANIME_SET *set, size_t index);
+
+/*!
+ * @brief Advances every animation in a set.
+ *
+ * @param[in] set   The set to advance.
+ * @param[in] ticks How many ticks to advance by.
+ *
+ * @debugging This function asserts that `set` is not `NULL`, and that
+ * `ticks` is not greater than `INT32_MAX`.
+ */
+void
+rbtk_advance_animes(RBTK_ANIME_SET *set, uint32_t ticks);
+
+/*!
+ * @brief Returns if an animation in a set has finished.
+ *
+ * An animation which loops never finishes.
+ *
+ * @param[in] set   The set the animation is playing in.
+ * @param[in] index The index of the animation.
+ * @return `true` if the animation is finished, `false` otherwise.
+ *
+ * @debugging This function asserts that `set` is not `NULL`, and that
+ * `index` is an animation playing in the set.
+ */
+RBTK_NO_DISCARD bool
+rbtk_anime_is_finished(const RBTK_ANIME_SET *set, size_t index);
+
+/*!
+ * @brief Returns the current frame of an animation in a set.
+ *
+ * @param[in] set   The set the animation is playing in.
+ * @param[in] index The index of the animation.
+ * @return The sprite of the current frame.
+ *
+ * @debugging This function asserts that `set` is not `NULL`, and that
+ * `index` is an animation playing in the set.
+ */
+RBTK_NO_DISCARD RBTK_SPRITE *
+rbtk_get_anime_sprite(const RBTK_ANIME_SET *set, size_t index);
+
+/*!
+ * @brief Draws the current frame of an animation in a set.
+ *
+ * @param[in] scene The scene to draw to.
+ * @param[in] set   The set the animation is playing in.
+ * @param[in] index The index of the animation.
+ * @param[in] x     The X-axis position to draw the sprite at.
+ * @param[in] y     The Y-axis position to draw the sprite at.
+ * @param[in] z     The Z-axis position to draw the sprite at.
+ *
+ * @debugging This function asserts that `scene` and `set` are not `NULL`,
+ * and that `index` is an animation playing in the set.
+ */
+void
+rbtk_draw_anime(RBTK_GRAPHICS *scene, const RBTK_ANIME_SET *set,
+    size_t index, float x, float y, float z);
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_ANIMATION_H_ */
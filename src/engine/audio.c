@@ -26,24 +26,186 @@
 #include "./platform/audio.h"
 
 #include <assert.h>
+#include <limits.h>
 #include <math.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "snapshot.h"
+
 #include "../libraries/stb_vorbis.h"
 #include "../libraries/minimp3_ex.h"
 
 #include "../runtime/common.h"
 #include "../runtime/error.h"
+#include "../runtime/stats.h"
+#include "../runtime/thread.h"
 
 #define MIN_BUFSIZE 4096   /* usually just enough */
 #define MAX_BUFSIZE 176400 /* 1s of 16-bit stereo */
 
+#define WAVE_HEADER_SIZE    44
+#define WAVE_FORMAT_PCM     1
+#define RENDER_SLICE_FRAMES 1024
+
 static struct rbtk_maintained_sounds *maintained_head;
 static struct rbtk_maintained_sounds *maintained_tail;
 static bool initialized;
 
+static rbtk_audio_output audio_output;
+static char *wave_path;
+static FILE *wave_file;
+static size_t wave_data_size;
+static long double unrendered_frames;
+
+static struct {
+    RBTK_STAT *latency_ms;
+    RBTK_STAT *active_voices;
+    RBTK_STAT *stream_update_ms;
+    RBTK_STAT *mix_ms;
+    RBTK_STAT *decode_ms;
+    RBTK_STAT *decoded_bytes;
+    RBTK_STAT *stream_fill_pct;
+    RBTK_STAT *stream_refill_ms;
+    RBTK_STAT *underruns;
+} stats;
+
+static void
+put_le16(unsigned char *buf, unsigned int value)
+{
+    buf[0] = (unsigned char) ((value >> 0) & 0xFF);
+    buf[1] = (unsigned char) ((value >> 8) & 0xFF);
+}
+
+static void
+put_le32(unsigned char *buf, unsigned long value)
+{
+    put_le16(buf + 0, (unsigned int) ((value >> 0)  & 0xFFFF));
+    put_le16(buf + 2, (unsigned int) ((value >> 16) & 0xFFFF));
+}
+
+static unsigned int
+get_le16(const unsigned char *buf)
+{
+    return ((unsigned int) buf[0] << 0) | ((unsigned int) buf[1] << 8);
+}
+
+static unsigned long
+get_le32(const unsigned char *buf)
+{
+    return ((unsigned long) get_le16(buf + 0) << 0)
+        | ((unsigned long) get_le16(buf + 2) << 16);
+}
+
+static RBTK_NO_DISCARD bool
+write_wave_header(FILE *file, size_t data_size)
+{
+    assert(file);
+
+    unsigned int block_align = RBTK_OFFLINE_AUDIO_CHANNEL_COUNT
+        * (RBTK_OFFLINE_AUDIO_BITS_PER_SAMPLE / 8);
+
+    unsigned char header[WAVE_HEADER_SIZE];
+    memcpy(header + 0, "RIFF", 4);
+    put_le32(header + 4, (unsigned long) (WAVE_HEADER_SIZE - 8 + data_size));
+    memcpy(header + 8, "WAVE", 4);
+    memcpy(header + 12, "fmt ", 4);
+    put_le32(header + 16, 16);
+    put_le16(header + 20, WAVE_FORMAT_PCM);
+    put_le16(header + 22, RBTK_OFFLINE_AUDIO_CHANNEL_COUNT);
+    put_le32(header + 24, RBTK_OFFLINE_AUDIO_FREQUENCY_HZ);
+    put_le32(header + 28, RBTK_OFFLINE_AUDIO_FREQUENCY_HZ * block_align);
+    put_le16(header + 32, block_align);
+    put_le16(header + 34, RBTK_OFFLINE_AUDIO_BITS_PER_SAMPLE);
+    memcpy(header + 36, "data", 4);
+    put_le32(header + 40, (unsigned long) data_size);
+
+    return fwrite(header, 1, sizeof(header), file) == sizeof(header);
+}
+
+static RBTK_NO_DISCARD bool
+open_wave_file(void)
+{
+    assert(wave_path);
+
+    wave_file = fopen(wave_path, "wb");
+    if (!wave_file) {
+        rbtk_signal_error(RBTK_ERROR_IO,
+            "could not open %s for writing", wave_path);
+        return false;
+    }
+
+    /*
+     * The size of the audio data is not known until the audio system is
+     * shutdown. For now, the header claims there is no data. It will be
+     * written again with the correct size once the file is closed.
+     */
+    wave_data_size = 0;
+    if (!write_wave_header(wave_file, wave_data_size)) {
+        fclose(wave_file);
+        wave_file = NULL;
+        rbtk_signal_error(RBTK_ERROR_IO,
+            "could not write header to %s", wave_path);
+        return false;
+    }
+
+    return true;
+}
+
+static RBTK_NO_DISCARD bool
+close_wave_file(void)
+{
+    assert(wave_file);
+
+    bool finished = fseek(wave_file, 0, SEEK_SET) == 0
+        && write_wave_header(wave_file, wave_data_size);
+    finished &= fclose(wave_file) == 0;
+    wave_file = NULL;
+
+    if (!finished) {
+        rbtk_signal_error(RBTK_ERROR_IO,
+            "could not finish writing %s", wave_path);
+        return false;
+    }
+    return true;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_set_audio_output(rbtk_audio_output output, const char *path)
+{
+    assert(output != RBTK_AUDIO_OUTPUT_WAVE || path);
+
+    if (initialized) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE,
+            "audio output must be set before initialization");
+        return false;
+    }
+
+    char *path_copy = NULL;
+    if (output == RBTK_AUDIO_OUTPUT_WAVE) {
+        path_copy = malloc(strlen(path) + 1);
+        if (!path_copy) {
+            rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+                "could not allocate memory for WAV path");
+            return false;
+        }
+        strcpy(path_copy, path);
+    }
+
+    free(wave_path);
+    wave_path = path_copy;
+    audio_output = output;
+    return true;
+}
+
+RBTK_NO_DISCARD rbtk_audio_output
+rbtk_get_audio_output(void)
+{
+    return audio_output;
+}
+
 RBTK_PRIVATE RBTK_NO_DISCARD bool
 priv_rbtk_audio_init(void)
 {
@@ -51,12 +213,41 @@ priv_rbtk_audio_init(void)
         return true;
     }
 
-    if (!plat_rbtk_audio_init()) {
+    if (audio_output == RBTK_AUDIO_OUTPUT_WAVE && !open_wave_file()) {
+        return false;
+    }
+
+    if (!plat_rbtk_audio_init(audio_output != RBTK_AUDIO_OUTPUT_DEVICE)) {
+        if (wave_file) {
+            fclose(wave_file);
+            wave_file = NULL;
+        }
         return false;
     }
 
     maintained_head = NULL;
     maintained_tail = NULL;
+    unrendered_frames = 0.0L;
+
+    /* a missing stat is not fatal, it is just not recorded */
+    stats.latency_ms = rbtk_get_stat("audio.latency_ms",
+        RBTK_STAT_TYPE_GAUGE);
+    stats.active_voices = rbtk_get_stat("audio.active_voices",
+        RBTK_STAT_TYPE_GAUGE);
+    stats.stream_update_ms = rbtk_get_stat("audio.stream_update_ms",
+        RBTK_STAT_TYPE_SAMPLE);
+    stats.mix_ms = rbtk_get_stat("audio.mix_ms",
+        RBTK_STAT_TYPE_SAMPLE);
+    stats.decode_ms = rbtk_get_stat("audio.decode_ms",
+        RBTK_STAT_TYPE_SAMPLE);
+    stats.decoded_bytes = rbtk_get_stat("audio.decoded_bytes",
+        RBTK_STAT_TYPE_COUNTER);
+    stats.stream_fill_pct = rbtk_get_stat("audio.stream_fill_pct",
+        RBTK_STAT_TYPE_GAUGE);
+    stats.stream_refill_ms = rbtk_get_stat("audio.stream_refill_ms",
+        RBTK_STAT_TYPE_SAMPLE);
+    stats.underruns = rbtk_get_stat("audio.underruns",
+        RBTK_STAT_TYPE_COUNTER);
 
     initialized = true;
     return true;
@@ -81,6 +272,10 @@ priv_rbtk_audio_terminate(void)
         return false;
     }
 
+    if (wave_file && !close_wave_file()) {
+        return false;
+    }
+
     maintained_head = NULL;
     maintained_tail = NULL;
 
@@ -88,6 +283,221 @@ priv_rbtk_audio_terminate(void)
     return true;
 }
 
+/*!
+ * @brief Fills a stream's chunk with PCM data from its audio source.
+ *
+ * @param[in] sound The streamed sound.
+ * @return The number of bytes written to the chunk. This is zero once the
+ * audio source has run out of data, or if an error occurred.
+ */
+static size_t
+read_stream_chunk(RBTK_SOUND *sound)
+{
+    assert(sound);
+    assert(sound->type == RBTK_SOUND_TYPE_STREAMED);
+
+    size_t len = 0;
+    while (len < RBTK_STREAM_BUFFER_SIZE) {
+        int read = rbtk_read_pcm(sound->src, sound->streamed.offset,
+            sound->streamed.chunk + len, RBTK_STREAM_BUFFER_SIZE - len);
+        if (read == EOF || read == INT_MAX || read == 0) {
+            sound->streamed.eof = true;
+            break; /* nothing more to read */
+        }
+        sound->streamed.offset += read;
+        len += read;
+    }
+    return len;
+}
+
+/*!
+ * @brief Queues new PCM data in place of what a stream has played.
+ *
+ * @param[in] sound The streamed sound.
+ * @return The number of stream buffers which are still unfilled.
+ */
+static size_t
+refill_stream(RBTK_SOUND *sound)
+{
+    assert(sound);
+    assert(sound->type == RBTK_SOUND_TYPE_STREAMED);
+
+    size_t unfilled = plat_rbtk_unqueue_stream_buffers(sound);
+    while (unfilled > 0 && !sound->streamed.eof) {
+        long double begin_ms = rbtk_time(RBTK_MILLIS);
+
+        size_t len = read_stream_chunk(sound);
+        if (len == 0) {
+            break; /* nothing to queue */
+        }
+        plat_rbtk_queue_stream_buffer(sound, len, sound->streamed.chunk);
+        unfilled -= 1;
+
+        if (stats.stream_refill_ms) {
+            rbtk_sample_stat(stats.stream_refill_ms,
+                rbtk_time(RBTK_MILLIS) - begin_ms);
+        }
+    }
+    return unfilled;
+}
+
+static void
+update_streams(void)
+{
+    long double lowest_fill_pct = 100.0L;
+    long double refill_ms = 0.0L;
+    bool streaming = false;
+
+    rbtk_maintained_sounds *cur = maintained_head;
+    while (cur) {
+        RBTK_SOUND *sound = cur->sound;
+        cur = cur->next;
+
+        if (sound->type != RBTK_SOUND_TYPE_STREAMED
+                || !sound->streamed.playing) {
+            continue;
+        }
+
+        /*
+         * How full a stream's buffers are before refilling them tells us
+         * how close it came to running dry. Only the stream which came the
+         * closest is of interest.
+         */
+        size_t unqueued = plat_rbtk_unqueue_stream_buffers(sound);
+        long double fill_pct = 100.0L
+            * (RBTK_STREAM_BUFFER_COUNT - unqueued)
+            / RBTK_STREAM_BUFFER_COUNT;
+        if (fill_pct < lowest_fill_pct) {
+            lowest_fill_pct = fill_pct;
+        }
+        streaming = true;
+
+        long double begin_ms = rbtk_time(RBTK_MILLIS);
+        size_t unfilled = refill_stream(sound);
+        refill_ms += rbtk_time(RBTK_MILLIS) - begin_ms;
+
+        if (plat_rbtk_get_sound_state(sound) != RBTK_SOUND_STATE_STOPPED) {
+            continue;
+        }
+
+        /*
+         * A stream which stops on its own while it still has buffers queued
+         * has played all of them before they could be refilled. This is an
+         * underrun, and the sound must be played again to recover from it.
+         * Otherwise, the stream has simply played to the end.
+         */
+        if (unfilled < RBTK_STREAM_BUFFER_COUNT) {
+            if (stats.underruns) {
+                rbtk_count_stat(stats.underruns, 1.0L);
+            }
+            plat_rbtk_play_sound(sound);
+        }
+        else {
+            sound->streamed.playing = false;
+        }
+    }
+
+    if (streaming && stats.stream_fill_pct) {
+        rbtk_set_stat(stats.stream_fill_pct, lowest_fill_pct);
+    }
+
+    /* the decoding and refilling of every stream, once per update */
+    if (streaming && stats.stream_update_ms) {
+        rbtk_sample_stat(stats.stream_update_ms, refill_ms);
+    }
+}
+
+RBTK_NO_DISCARD bool
+rbtk_render_audio(rbtk_time_unit unit, long double duration)
+{
+    assert(duration >= 0);
+
+    if (!initialized || audio_output == RBTK_AUDIO_OUTPUT_DEVICE) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE,
+            "audio is not being rendered offline");
+        return false;
+    }
+
+    /*
+     * Durations rarely line up with a whole number of frames. The leftover
+     * is carried over to the next render, so rendering in small steps does
+     * not drift away from the time which has actually passed.
+     */
+    unrendered_frames += rbtk_convert_time(unit, RBTK_SECS, duration)
+        * RBTK_OFFLINE_AUDIO_FREQUENCY_HZ;
+    size_t frames = (size_t) unrendered_frames;
+    unrendered_frames -= (long double) frames;
+
+    short slice[RENDER_SLICE_FRAMES * RBTK_OFFLINE_AUDIO_CHANNEL_COUNT];
+    size_t frame_size = sizeof(slice[0]) * RBTK_OFFLINE_AUDIO_CHANNEL_COUNT;
+
+    /*
+     * Audio is rendered in small slices, with streamed sounds refilled in
+     * between each of them. Rendering a long duration all at once would
+     * drain their buffers long before they could be refilled.
+     */
+    while (frames > 0) {
+        size_t slice_frames = frames;
+        if (slice_frames > RENDER_SLICE_FRAMES) {
+            slice_frames = RENDER_SLICE_FRAMES;
+        }
+
+        update_streams();
+
+        /*
+         * Only offline rendering is mixed by us. When playing on a device,
+         * the mixing is done by the platform and cannot be timed here.
+         */
+        long double begin_ms = rbtk_time(RBTK_MILLIS);
+        plat_rbtk_render_audio(slice, slice_frames);
+        if (stats.mix_ms) {
+            rbtk_sample_stat(stats.mix_ms,
+                rbtk_time(RBTK_MILLIS) - begin_ms);
+        }
+
+        if (wave_file) {
+            size_t written = fwrite(slice, frame_size, slice_frames,
+                wave_file);
+            wave_data_size += written * frame_size;
+            if (written != slice_frames) {
+                rbtk_signal_error(RBTK_ERROR_IO,
+                    "could not write audio to %s", wave_path);
+                return false;
+            }
+        }
+
+        frames -= slice_frames;
+    }
+
+    return true;
+}
+
+RBTK_PRIVATE void
+priv_rbtk_audio_update(void)
+{
+    assert(initialized);
+
+    update_streams();
+
+    size_t active_voices = 0;
+    rbtk_maintained_sounds *cur = maintained_head;
+    while (cur) {
+        if (plat_rbtk_get_sound_state(cur->sound)
+                == RBTK_SOUND_STATE_PLAYING) {
+            active_voices += 1;
+        }
+        cur = cur->next;
+    }
+
+    if (stats.active_voices) {
+        rbtk_set_stat(stats.active_voices, (long double) active_voices);
+    }
+    if (stats.latency_ms) {
+        rbtk_set_stat(stats.latency_ms,
+            plat_rbtk_get_audio_latency(RBTK_MILLIS));
+    }
+}
+
 RBTK_PRIVATE bool
 priv_rbtk_audio_maintain(RBTK_SOUND *sound)
 {
@@ -128,6 +538,10 @@ typedef struct RBTK_AUDIO_SOURCE {
     rbtk_audio_source_funs funs;
     rbtk_audio_source_info info;
     void *impl;
+    struct {
+        unsigned char *pcm; /* taken by the sound that buffers it */
+        size_t size;
+    } decoded;
 } RBTK_AUDIO_SOURCE;
 
 static bool
@@ -159,6 +573,8 @@ rbtk_source_audio(rbtk_audio_source_funs funs,
     src->funs = funs;
     src->info = info;
     src->impl = impl;
+    src->decoded.pcm = NULL;
+    src->decoded.size = 0;
 
     return src;
 }
@@ -170,6 +586,7 @@ rbtk_close_audio_source(RBTK_AUDIO_SOURCE *src)
     if (!src->funs.close(src, src->impl)) {
         return false;
     }
+    free(src->decoded.pcm);
     free(src);
     return true;
 }
@@ -192,12 +609,203 @@ rbtk_read_pcm(RBTK_AUDIO_SOURCE *src, size_t off, void *buf, size_t len)
     return read;
 }
 
+#define WAV_RIFF_HEADER_SIZE  12
+#define WAV_CHUNK_HEADER_SIZE 8
+#define WAV_FMT_SIZE          16
+
+static RBTK_NO_DISCARD bool
+read_wav_exactly(RBTK_IN_STREAM *in, unsigned char *buf, size_t len)
+{
+    size_t read = rbtk_read_bytes(in, buf, 0, len);
+    if (read != len) {
+        rbtk_signal_error(RBTK_ERROR_IO,
+            "WAV file ended unexpectedly");
+        return false;
+    }
+    return true;
+}
+
+static RBTK_NO_DISCARD bool
+skip_wav_bytes(RBTK_IN_STREAM *in, size_t amt)
+{
+    if (rbtk_skip_bytes(in, amt) != amt) {
+        rbtk_signal_error(RBTK_ERROR_IO,
+            "WAV file ended unexpectedly");
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * @brief Reads the chunks of a WAV file up to the start of its PCM data.
+ *
+ * @param[in]  in   The input stream to read from.
+ * @param[out] wav  Where to write the size and layout of the PCM data.
+ * @param[out] info Where to write the format of the PCM data.
+ * @return `true` on success, `false` on failure.
+ */
+static RBTK_NO_DISCARD bool
+read_wav_header(RBTK_IN_STREAM *in, rbtk_wav_audio_source *wav,
+    rbtk_audio_source_info *info)
+{
+    assert(in);
+    assert(wav);
+    assert(info);
+
+    unsigned char riff[WAV_RIFF_HEADER_SIZE];
+    if (!read_wav_exactly(in, riff, sizeof(riff))) {
+        return false;
+    }
+    if (memcmp(riff + 0, "RIFF", 4) || memcmp(riff + 8, "WAVE", 4)) {
+        rbtk_signal_error(RBTK_ERROR_IO, "not a WAV file");
+        return false;
+    }
+
+    /*
+     * The format and data of a WAV file are stored in chunks, which may
+     * be accompanied by any number of other chunks we have no use for.
+     * Chunks are padded to an even size, which is not included in the
+     * size written in their header.
+     */
+    bool found_fmt = false;
+    for (;;) {
+        unsigned char chunk[WAV_CHUNK_HEADER_SIZE];
+        if (!read_wav_exactly(in, chunk, sizeof(chunk))) {
+            return false;
+        }
+        size_t chunk_size = get_le32(chunk + 4);
+
+        if (!memcmp(chunk, "data", 4)) {
+            if (!found_fmt) {
+                rbtk_signal_error(RBTK_ERROR_IO,
+                    "WAV data chunk precedes format chunk");
+                return false;
+            }
+            wav->data_size = chunk_size;
+            return true;
+        }
+        else if (memcmp(chunk, "fmt ", 4)) {
+            size_t padded_size = chunk_size + (chunk_size & 1);
+            if (!skip_wav_bytes(in, padded_size)) {
+                return false;
+            }
+            continue; /* not a chunk we need */
+        }
+
+        unsigned char fmt[WAV_FMT_SIZE];
+        if (chunk_size < sizeof(fmt)) {
+            rbtk_signal_error(RBTK_ERROR_IO,
+                "WAV format chunk is too small");
+            return false;
+        }
+        if (!read_wav_exactly(in, fmt, sizeof(fmt))) {
+            return false;
+        }
+        size_t padded_rest = chunk_size - sizeof(fmt) + (chunk_size & 1);
+        if (!skip_wav_bytes(in, padded_rest)) {
+            return false;
+        }
+
+        unsigned int format = get_le16(fmt + 0);
+        info->channel_count = get_le16(fmt + 2);
+        info->frequency_hz = (unsigned int) get_le32(fmt + 4);
+        wav->block_align = get_le16(fmt + 12);
+        info->bits_per_sample = get_le16(fmt + 14);
+
+        if (format != WAVE_FORMAT_PCM || info->bits_per_sample != 16
+                || info->channel_count < 1 || info->channel_count > 2) {
+            rbtk_signal_error(RBTK_ERROR_UNSUPPORTED,
+                "only 16-bit mono or stereo PCM WAV files are supported");
+            return false;
+        }
+        if (wav->block_align != info->channel_count * 2) {
+            rbtk_signal_error(RBTK_ERROR_IO,
+                "WAV block alignment does not match its format");
+            return false;
+        }
+        found_fmt = true;
+    }
+}
+
+static RBTK_NO_DISCARD bool
+close_wav_source(RBTK_UNUSED RBTK_AUDIO_SOURCE *src,
+    rbtk_wav_audio_source *wav)
+{
+    assert(src);
+    assert(wav);
+    free(wav);
+    return true;
+}
+
+static RBTK_NO_DISCARD int
+read_wav_pcm(RBTK_UNUSED RBTK_AUDIO_SOURCE *src,
+    rbtk_wav_audio_source *wav, size_t off,
+    void *buf, size_t len)
+{
+    assert(src);
+    assert(wav);
+    assert(buf);
+
+    if (off != wav->data_offset) {
+        rbtk_signal_error(RBTK_ERROR_UNSUPPORTED,
+            "WAV audio sources can only be read in order");
+        return INT_MAX;
+    }
+
+    size_t remaining = wav->data_size - wav->data_offset;
+    if (remaining == 0) {
+        return EOF; /* no more data left */
+    }
+
+    /*
+     * Only whole frames are read, so that each read begins on the first
+     * channel of a frame. Reads are also capped to what an int can hold,
+     * as that is what must be returned.
+     */
+    size_t to_read = len < remaining ? len : remaining;
+    if (to_read > INT_MAX) {
+        to_read = INT_MAX;
+    }
+    to_read -= to_read % wav->block_align;
+
+    size_t read = rbtk_read_bytes(wav->in, buf, 0, to_read);
+    if (read == SIZE_MAX) {
+        return EOF;
+    }
+    else if (read == 0 && to_read > 0) {
+        return EOF; /* file was cut short */
+    }
+
+    wav->data_offset += read;
+    return (int) read;
+}
+
 RBTK_NO_DISCARD RBTK_AUDIO_SOURCE *
-rbtk_source_wav(RBTK_UNUSED RBTK_IN_STREAM *in) {
+rbtk_source_wav(RBTK_IN_STREAM *in)
+{
     assert(in);
-    rbtk_signal_error(RBTK_ERROR_UNSUPPORTED,
-        "sourcing WAVs not yet implemented");
-    return NULL;
+
+    rbtk_wav_audio_source *wav = NULL;
+    RBTK_MALLOC_OR_RETURN(&wav, NULL,
+        "could not allocate WAV audio source");
+
+    wav->in = in;
+    wav->data_size = 0;
+    wav->data_offset = 0;
+    wav->block_align = 0;
+
+    rbtk_audio_source_info info;
+    if (!read_wav_header(in, wav, &info)) {
+        free(wav);
+        return NULL;
+    }
+
+    rbtk_audio_source_funs funs = {
+            .close    = (rbtk_close_audio_source_fun) close_wav_source,
+            .read_pcm = (rbtk_read_pcm_fun)           read_wav_pcm
+    };
+
+    return rbtk_source_audio(funs, info, wav);
 }
 
 #define VORBIS_BITS_PER_SAMPLE  16
@@ -269,7 +877,7 @@ shift_unconsumed_to_front(void *buf, size_t *read, size_t consumed)
 {
     unsigned char *cbuf = buf;
     size_t unconsumed = *read - consumed;
-    memcpy(cbuf, cbuf + consumed, unconsumed);
+    memmove(cbuf, cbuf + consumed, unconsumed);
     *read = unconsumed;
 }
 
@@ -437,28 +1045,46 @@ read_vorbis_pcm(RBTK_UNUSED RBTK_AUDIO_SOURCE *src,
     size_t read = rbtk_read_bytes(vorbis->in,
         vorbis->buffer + vorbis->buffer_offset, 0,
         vorbis->buffer_size - vorbis->buffer_offset);
+    if (read == SIZE_MAX) {
+        return EOF; /* error already signalled */
+    }
     vorbis->buffer_offset += read;
 
     int samples = 0;
     while (samples == 0) {
         int bytes_used = stb_vorbis_decode_frame_pushdata(
             vorbis->decoder, vorbis->buffer,
-            (int) vorbis->buffer_size, NULL,
+            (int) vorbis->buffer_offset, NULL,
             &vorbis->outputs, &samples);
 
         if (bytes_used == 0) {
-            if (read <= 0) {
+            /*
+             * Only the most recent read tells us if the stream has run
+             * out of data. Without checking it here, the buffer would be
+             * grown again and again once the end has been reached.
+             */
+            if (read <= 0 || read == SIZE_MAX) {
                 return EOF; /* no more data left */
             }
 
-            if (vorbis->buffer_size >= MAX_BUFSIZE) {
-                rbtk_signal_error(RBTK_ERROR_IO,
-                    "Ogg Vorbis exceeded max buffer size");
-                return EOF;
+            if (vorbis->buffer_offset >= vorbis->buffer_size) {
+                if (vorbis->buffer_size >= MAX_BUFSIZE) {
+                    rbtk_signal_error(RBTK_ERROR_IO,
+                        "Ogg Vorbis exceeded max buffer size");
+                    return EOF;
+                }
+                if (double_buffer_size(&vorbis->buffer,
+                        &vorbis->buffer_size) == SIZE_MAX) {
+                    return EOF;
+                }
             }
 
-            size_t remaining = double_buffer_size(&vorbis->buffer, &vorbis->buffer_size);
-            vorbis->buffer_offset += rbtk_read_bytes(vorbis->in, vorbis->buffer, vorbis->buffer_offset, remaining);
+            read = rbtk_read_bytes(vorbis->in, vorbis->buffer,
+                vorbis->buffer_offset,
+                vorbis->buffer_size - vorbis->buffer_offset);
+            if (read != SIZE_MAX) {
+                vorbis->buffer_offset += read;
+            }
             continue; /* more data needed, try reading again */
         }
 
@@ -525,12 +1151,170 @@ rbtk_source_ogg(RBTK_IN_STREAM *in)
     return rbtk_source_audio(funs, info, vorbis);
 }
 
+#define MP3_BYTES_PER_SAMPLE sizeof(mp3d_sample_t)
+
+/*
+ * The MP3 decoder reads from its input through these callbacks. It is
+ * allocated alongside them, as the decoder keeps a pointer to them.
+ */
+typedef struct mp3_decoder {
+    mp3dec_ex_t ex; /* must be first, see close_mp3_source() */
+    mp3dec_io_t io;
+} mp3_decoder;
+
+static size_t
+read_mp3_stream(void *buf, size_t size, void *user_data)
+{
+    RBTK_IN_STREAM *in = user_data;
+    return rbtk_read_bytes(in, buf, 0, size); /* SIZE_MAX on error */
+}
+
+static int
+seek_mp3_stream(uint64_t position, void *user_data)
+{
+    RBTK_IN_STREAM *in = user_data;
+    if (position >= SIZE_MAX) {
+        return -1; /* cannot be represented */
+    }
+    size_t pos = rbtk_seek_to(in, (size_t) position);
+    return pos == SIZE_MAX ? -1 : 0;
+}
+
+static RBTK_NO_DISCARD bool
+close_mp3_source(RBTK_UNUSED RBTK_AUDIO_SOURCE *src,
+    rbtk_mp3_audio_source *mp3)
+{
+    assert(src);
+    assert(mp3);
+
+    mp3dec_ex_close(mp3->decoder);
+    free(mp3->decoder); /* also frees the callbacks */
+    free(mp3);
+
+    return true;
+}
+
+static RBTK_NO_DISCARD int
+read_mp3_pcm(RBTK_UNUSED RBTK_AUDIO_SOURCE *src,
+    rbtk_mp3_audio_source *mp3, size_t off,
+    void *buf, size_t len)
+{
+    assert(src);
+    assert(mp3);
+    assert(buf);
+
+    if (off != mp3->pcm_offset) {
+        rbtk_signal_error(RBTK_ERROR_UNSUPPORTED,
+            "MP3 audio sources can only be read in order");
+        return INT_MAX;
+    }
+
+    mp3dec_ex_t *decoder = mp3->decoder;
+    size_t channels = decoder->info.channels;
+    size_t frame_size = MP3_BYTES_PER_SAMPLE * channels;
+
+    /*
+     * Samples are decoded into a local buffer first, since the buffer we
+     * are given may not be aligned for them. Only whole frames are read,
+     * so that each read begins on the first channel of a frame.
+     */
+    mp3d_sample_t samples[MINIMP3_MAX_SAMPLES_PER_FRAME];
+    unsigned char *cbuf = buf;
+    size_t bytes_written = 0;
+
+    if (len > INT_MAX) {
+        len = INT_MAX;
+    }
+
+    while (bytes_written + frame_size <= len) {
+        size_t wanted = (len - bytes_written) / MP3_BYTES_PER_SAMPLE;
+        if (wanted > MINIMP3_MAX_SAMPLES_PER_FRAME) {
+            wanted = MINIMP3_MAX_SAMPLES_PER_FRAME;
+        }
+        wanted -= wanted % channels;
+
+        size_t decoded = mp3dec_ex_read(decoder, samples, wanted);
+        memcpy(cbuf + bytes_written, samples,
+            decoded * MP3_BYTES_PER_SAMPLE);
+        bytes_written += decoded * MP3_BYTES_PER_SAMPLE;
+
+        if (decoded < wanted) {
+            break; /* end of stream or error */
+        }
+    }
+
+    if (bytes_written > 0) {
+        mp3->pcm_offset += bytes_written;
+        return (int) bytes_written;
+    }
+
+    if (decoder->last_error) {
+        rbtk_signal_error(RBTK_ERROR_IO,
+            "MP3 error %d", decoder->last_error);
+    }
+    return EOF;
+}
+
 RBTK_NO_DISCARD RBTK_AUDIO_SOURCE *
-rbtk_source_mp3(RBTK_UNUSED RBTK_IN_STREAM *in) {
+rbtk_source_mp3(RBTK_IN_STREAM *in)
+{
     assert(in);
-    rbtk_signal_error(RBTK_ERROR_UNSUPPORTED,
-        "sourcing MP3s not yet implemented");
-    return NULL;
+
+    if (!rbtk_supports_seek(in)) {
+        rbtk_signal_error(RBTK_ERROR_UNSUPPORTED,
+            "MP3 audio sources require a seekable stream");
+        return NULL;
+    }
+
+    rbtk_mp3_audio_source *mp3 = NULL;
+    RBTK_MALLOC_OR_RETURN(&mp3, NULL,
+        "could not allocate MP3 audio source");
+
+    mp3_decoder *decoder = malloc(sizeof(*decoder));
+    if (!decoder) {
+        free(mp3);
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate MP3 decoder");
+        return NULL;
+    }
+
+    decoder->io.read = read_mp3_stream;
+    decoder->io.read_data = in;
+    decoder->io.seek = seek_mp3_stream;
+    decoder->io.seek_data = in;
+
+    /*
+     * Without this flag, the decoder would decode the entire stream just
+     * to find its length when it is opened. We don't need the length, so
+     * that time would be wasted.
+     */
+    int mp3_error = mp3dec_ex_open_cb(&decoder->ex, &decoder->io,
+        MP3D_SEEK_TO_BYTE | MP3D_DO_NOT_SCAN);
+    if (mp3_error || !decoder->ex.info.channels) {
+        mp3dec_ex_close(&decoder->ex);
+        free(decoder);
+        free(mp3);
+        rbtk_signal_error(RBTK_ERROR_IO,
+            "could not open MP3 decoder (error %d)", mp3_error);
+        return NULL;
+    }
+
+    mp3->in = in;
+    mp3->decoder = &decoder->ex;
+    mp3->pcm_offset = 0;
+
+    rbtk_audio_source_funs funs = {
+            .close    = (rbtk_close_audio_source_fun) close_mp3_source,
+            .read_pcm = (rbtk_read_pcm_fun)           read_mp3_pcm
+    };
+
+    rbtk_audio_source_info info = {
+            .frequency_hz = decoder->ex.info.hz,
+            .channel_count = decoder->ex.info.channels,
+            .bits_per_sample = MP3_BYTES_PER_SAMPLE * 8
+    };
+
+    return rbtk_source_audio(funs, info, mp3);
 }
 
 #define PCM_BUFFER_CHUNK_SIZE 1024
@@ -556,6 +1340,8 @@ buffer_pcm_data(RBTK_AUDIO_SOURCE *src, size_t *pcm_buffer_size)
     size_t size = 0;
     unsigned char data[PCM_BUFFER_CHUNK_SIZE];
 
+    long double begin_ms = rbtk_time(RBTK_MILLIS);
+
     /*
      * Before we can load the entire buffer into memory, we must first
      * get the PCM data in chunks. This will allow us to read all data
@@ -646,13 +1432,67 @@ buffer_pcm_data(RBTK_AUDIO_SOURCE *src, size_t *pcm_buffer_size)
 
     assert(pcm_offset == size);
     *pcm_buffer_size = size;
+
+    if (stats.decode_ms) {
+        rbtk_sample_stat(stats.decode_ms,
+            rbtk_time(RBTK_MILLIS) - begin_ms);
+    }
+    if (stats.decoded_bytes) {
+        rbtk_count_stat(stats.decoded_bytes, (long double) size);
+    }
+
     return pcm_buffer;
 }
 
-RBTK_NO_DISCARD RBTK_SOUND *
-rbtk_buffer_sound(RBTK_AUDIO_SOURCE *src)
+static unsigned char *
+take_pcm_data(RBTK_AUDIO_SOURCE *src, size_t *pcm_buffer_size)
 {
     assert(src);
+    assert(pcm_buffer_size);
+
+    if (!src->decoded.pcm) {
+        return buffer_pcm_data(src, pcm_buffer_size);
+    }
+
+    unsigned char *pcm_buffer = src->decoded.pcm;
+    *pcm_buffer_size = src->decoded.size;
+    src->decoded.pcm = NULL;
+    src->decoded.size = 0;
+    return pcm_buffer;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_decode_audio_source(RBTK_AUDIO_SOURCE *src)
+{
+    assert(src);
+    if (src->decoded.pcm) {
+        return true; /* already decoded */
+    }
+
+    size_t size = 0;
+    unsigned char *pcm = buffer_pcm_data(src, &size);
+    if (!pcm) {
+        return false;
+    }
+
+    src->decoded.pcm = pcm;
+    src->decoded.size = size;
+    return true;
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_get_decoded_audio_size(const RBTK_AUDIO_SOURCE *src)
+{
+    assert(src);
+    return src->decoded.size;
+}
+
+static RBTK_SOUND *
+create_buffered_sound(RBTK_AUDIO_SOURCE *src,
+    size_t pcm_buffer_size, void *pcm_buffer)
+{
+    assert(src);
+    assert(pcm_buffer);
 
     RBTK_SOUND *sound = NULL;
     RBTK_MALLOC_OR_RETURN(&sound, NULL,
@@ -666,41 +1506,199 @@ rbtk_buffer_sound(RBTK_AUDIO_SOURCE *src)
         return NULL;
     }
 
+    sound->plat = plat_sound;
+    sound->src = src;
+    sound->type = RBTK_SOUND_TYPE_BUFFERED;
+    sound->looping = false;
+    sound->closed = false;
+    sound->maintained = NULL;
+    sound->streamed.chunk = NULL;
+    sound->streamed.offset = 0;
+    sound->streamed.eof = false;
+    sound->streamed.playing = false;
+
+    plat_rbtk_buffer_sound(sound, pcm_buffer_size, pcm_buffer);
+    priv_rbtk_audio_maintain(sound);
+
+    return sound;
+}
+
+RBTK_NO_DISCARD RBTK_SOUND *
+rbtk_buffer_sound(RBTK_AUDIO_SOURCE *src)
+{
+    assert(src);
+
     /*
-     * Now that we have our sound memory allocated, we must buffer all
-     * of the PCM data into memory. This will be taken in by a platform
-     * specific implementation which will use the buffered data. This
-     * PCM buffer will then be freed immediately afterwards.
+     * Before we can create the sound, we must buffer all of the PCM data
+     * into memory. This will be taken in by a platform specific
+     * implementation which will use the buffered data. This PCM buffer
+     * will then be freed immediately afterwards.
      */
     size_t pcm_buffer_size = 0;
-    void *pcm_buffer = buffer_pcm_data(src, &pcm_buffer_size);
+    void *pcm_buffer = take_pcm_data(src, &pcm_buffer_size);
     if (!pcm_buffer) {
+        return NULL;
+    }
+
+    RBTK_SOUND *sound = create_buffered_sound(src,
+        pcm_buffer_size, pcm_buffer);
+    free(pcm_buffer); /* we don't need this anymore */
+    return sound;
+}
+
+typedef struct decode_job {
+    RBTK_AUDIO_SOURCE *src;
+    unsigned char *pcm_buffer;
+    size_t pcm_buffer_size;
+    RBTK_ERROR_CODE error;
+    char error_msg[RBTK_ERROR_MESSAGE_MAX_LENGTH];
+    RBTK_JOB *job;
+} decode_job;
+
+static void
+run_decode_job(void *args)
+{
+    decode_job *decode = args;
+    decode->pcm_buffer = take_pcm_data(decode->src,
+        &decode->pcm_buffer_size);
+
+    /*
+     * Errors are signalled on the thread which they occurred. Since this
+     * is a worker thread, the caller would never see them. As such, they
+     * are taken here and signalled again by the caller once it is done
+     * waiting on this job.
+     */
+    if (!decode->pcm_buffer) {
+        const char *msg = NULL;
+        decode->error = rbtk_get_last_error(&msg);
+        if (!decode->error) {
+            decode->error = RBTK_ERROR_UNEXPECTED_STATE;
+        }
+        snprintf(decode->error_msg, sizeof(decode->error_msg),
+            "%s", msg ? msg : "failed to decode audio source");
+    }
+}
+
+RBTK_NO_DISCARD bool
+rbtk_buffer_sounds(RBTK_AUDIO_SOURCE *srcs[], size_t count,
+    RBTK_SOUND *out[])
+{
+    assert(srcs);
+    assert(out);
+
+    for (size_t i = 0; i < count; i++) {
+        out[i] = NULL;
+    }
+
+    if (count == 0) {
+        return true; /* nothing to buffer */
+    }
+
+    decode_job *decodes = calloc(count, sizeof(*decodes));
+    if (!decodes) {
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate decode jobs for %zu sounds", count);
+        return false;
+    }
+
+    size_t thread_count = rbtk_get_processor_count();
+    if (thread_count > count) {
+        thread_count = count;
+    }
+
+    RBTK_THREAD_POOL *pool = rbtk_create_thread_pool("audio-decode",
+        thread_count);
+    if (!pool) {
+        free(decodes);
+        return false;
+    }
+
+    /*
+     * Each source has its own decoder and stream, so they can be decoded
+     * independently of each other. However, the platform may not allow
+     * for its buffers to be filled from multiple threads at once. As such,
+     * only the decoding is done on the pool, while the platform buffering
+     * is done here on the calling thread once each job is complete.
+     */
+    for (size_t i = 0; i < count; i++) {
+        assert(srcs[i]);
+        decodes[i].src = srcs[i];
+        decodes[i].job = rbtk_submit_job(pool, run_decode_job, &decodes[i]);
+        if (!decodes[i].job) {
+            run_decode_job(&decodes[i]); /* fallback to calling thread */
+        }
+    }
+
+    bool buffered_all = true;
+    for (size_t i = 0; i < count; i++) {
+        decode_job *decode = &decodes[i];
+        if (decode->job) {
+            rbtk_await_job(decode->job);
+        }
+
+        if (!decode->pcm_buffer) {
+            rbtk_suggest_error(decode->error, "%s", decode->error_msg);
+            buffered_all = false;
+            continue;
+        }
+
+        out[i] = create_buffered_sound(decode->src,
+            decode->pcm_buffer_size, decode->pcm_buffer);
+        free(decode->pcm_buffer); /* we don't need this anymore */
+        if (!out[i]) {
+            buffered_all = false;
+        }
+    }
+
+    rbtk_destroy_thread_pool(pool);
+    free(decodes);
+    return buffered_all;
+}
+
+RBTK_NO_DISCARD RBTK_SOUND *
+rbtk_stream_sound(RBTK_AUDIO_SOURCE *src)
+{
+    assert(src);
+
+    RBTK_SOUND *sound = NULL;
+    RBTK_MALLOC_OR_RETURN(&sound, NULL,
+        "could not allocate sound for audio source");
+
+    unsigned char *chunk = malloc(RBTK_STREAM_BUFFER_SIZE);
+    if (!chunk) {
+        free(sound);
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate stream buffer");
+        return NULL;
+    }
+
+    PLAT_RBTK_SOUND *plat_sound = plat_rbtk_alloc_sound();
+    if (!plat_sound) {
+        free(chunk);
         free(sound);
-        free(plat_sound);
+        rbtk_suggest_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate platform specific memory");
         return NULL;
     }
 
     sound->plat = plat_sound;
     sound->src = src;
-    sound->type = RBTK_SOUND_TYPE_BUFFERED;
+    sound->type = RBTK_SOUND_TYPE_STREAMED;
     sound->looping = false;
     sound->closed = false;
     sound->maintained = NULL;
+    sound->streamed.chunk = chunk;
+    sound->streamed.offset = 0;
+    sound->streamed.eof = false;
+    sound->streamed.playing = false;
 
-    plat_rbtk_buffer_sound(sound, pcm_buffer_size, pcm_buffer);
-    free(pcm_buffer); /* we don't need this anymore */
+    plat_rbtk_stream_sound(sound);
     priv_rbtk_audio_maintain(sound);
 
-    return sound;
-}
+    /* fill every buffer now, so the sound can be played right away */
+    refill_stream(sound);
 
-RBTK_NO_DISCARD RBTK_SOUND *
-rbtk_stream_sound(RBTK_UNUSED RBTK_AUDIO_SOURCE *src)
-{
-    assert(src);
-    rbtk_signal_error(RBTK_ERROR_UNSUPPORTED,
-        "streamed sounds not yet implemented");
-    return NULL;
+    return sound;
 }
 
 void
@@ -708,8 +1706,11 @@ rbtk_close_sound(RBTK_SOUND *sound)
 {
     assert(sound);
     if (!sound->closed) {
+        rbtk_remove_snapshot_sound(sound);
         plat_rbtk_close_sound(sound);
         priv_rbtk_audio_abandon(sound);
+        free(sound->streamed.chunk);
+        sound->streamed.chunk = NULL;
         sound->closed = true;
     }
 }
@@ -756,6 +1757,16 @@ void
 rbtk_play_sound(RBTK_SOUND *sound)
 {
     assert(sound);
+
+    /*
+     * When a streamed sound is stopped, all of its buffers are marked as
+     * played. Refilling them first keeps the sound from playing what it
+     * has already played once more.
+     */
+    if (sound->type == RBTK_SOUND_TYPE_STREAMED) {
+        refill_stream(sound);
+        sound->streamed.playing = true;
+    }
     plat_rbtk_play_sound(sound);
 }
 
@@ -763,6 +1774,7 @@ void
 rbtk_pause_sound(RBTK_SOUND *sound)
 {
     assert(sound);
+    sound->streamed.playing = false;
     plat_rbtk_pause_sound(sound);
 }
 
@@ -770,6 +1782,7 @@ void
 rbtk_stop_sound(RBTK_SOUND *sound)
 {
     assert(sound);
+    sound->streamed.playing = false;
     plat_rbtk_stop_sound(sound);
 }
 
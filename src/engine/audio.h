@@ -94,13 +94,30 @@ typedef struct rbtk_vorbis_audio_source {
     size_t outputs_size;    /*!< The number of decoded samples.     */
 } rbtk_vorbis_audio_source;
 
+/*!
+ * @brief Represents a WAV audio source.
+ *
+ * This data structure is used in the implementation for the WAV
+ * audio format. Only uncompressed 16-bit PCM data is supported.
+ *
+ * @see rbtk_source_wav(RBTK_IN_STREAM *)
+ * @see RBTK_SOUND
+ */
+typedef struct rbtk_wav_audio_source {
+    RBTK_IN_STREAM *in;       /*!< The input stream being read from. */
+    size_t data_size;         /*!< The length of the PCM data.       */
+    size_t data_offset;       /*!< The number of PCM bytes read.     */
+    unsigned int block_align; /*!< The size of one frame in bytes.   */
+} rbtk_wav_audio_source;
+
 /*!
  * @brief Represents an MP3 audio source.
  *
  * This data structure is used in the implementation for the MP3
  * audio codec.
  *
- * @attention This audio source is currently not fully implemented.
+ * @note The input stream must support seeking, as the decoder seeks
+ * over the stream's tags and headers when it is opened.
  *
  * @see rbtk_source_mp3(RBTK_IN_STREAM *)
  * @see RBTK_SOUND
@@ -108,6 +125,7 @@ typedef struct rbtk_vorbis_audio_source {
 typedef struct rbtk_mp3_audio_source {
     RBTK_IN_STREAM *in;   /*!< The input stream being read from. */
     mp3dec_ex_t *decoder; /*!< The MP3 decoder handle.           */	
+    size_t pcm_offset;    /*!< The number of PCM bytes read.     */
 } rbtk_mp3_audio_source;
 
 /*!
@@ -196,6 +214,102 @@ typedef enum rbtk_sound_state {
     RBTK_SOUND_STATE_PAUSED,  /*!< The sound is paused.  */
 } rbtk_sound_state;
 
+/*!
+ * @brief Where the audio system sends its output.
+ *
+ * By default, audio is played on the default device of the machine. The
+ * other outputs render audio offline, meaning it is only mixed when it is
+ * explicitly requested. This allows audio to be mixed faster than it would
+ * play, and on machines which have no audio device at all.
+ *
+ * @see rbtk_set_audio_output(rbtk_audio_output, const char *)
+ * @see rbtk_render_audio(rbtk_time_unit, long double)
+ */
+typedef enum rbtk_audio_output {
+    RBTK_AUDIO_OUTPUT_DEVICE, /*!< Played on the default device.    */
+    RBTK_AUDIO_OUTPUT_NULL,   /*!< Rendered offline and discarded.  */
+    RBTK_AUDIO_OUTPUT_WAVE,   /*!< Rendered offline to a WAV file.  */
+} rbtk_audio_output;
+
+/*!
+ * @brief The frequency of audio rendered offline, in hertz.
+ *
+ * @see rbtk_render_audio(rbtk_time_unit, long double)
+ */
+#define RBTK_OFFLINE_AUDIO_FREQUENCY_HZ 44100
+
+/*!
+ * @brief The number of channels in audio rendered offline.
+ *
+ * @see rbtk_render_audio(rbtk_time_unit, long double)
+ */
+#define RBTK_OFFLINE_AUDIO_CHANNEL_COUNT 2
+
+/*!
+ * @brief The number of bits in a sample of audio rendered offline.
+ *
+ * @see rbtk_render_audio(rbtk_time_unit, long double)
+ */
+#define RBTK_OFFLINE_AUDIO_BITS_PER_SAMPLE 16
+
+/*!
+ * @brief Sets where the audio system sends its output.
+ *
+ * @attention This must be called before the audio system is initialized,
+ * which happens when the engine is initialized.
+ *
+ * @param[in] output The output to use.
+ * @param[in] path   The path of the WAV file to write. This is only used
+ *                   by #RBTK_AUDIO_OUTPUT_WAVE, and may be `NULL` for any
+ *                   other output.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `path` is not `NULL` when
+ * `output` is #RBTK_AUDIO_OUTPUT_WAVE.
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE, If the audio system is already
+ *                                    initialized.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
+ * @enderrors
+ *
+ * @see rbtk_render_audio(rbtk_time_unit, long double)
+ */
+RBTK_NO_DISCARD bool
+rbtk_set_audio_output(rbtk_audio_output output, const char *path);
+
+/*!
+ * @brief Returns where the audio system sends its output.
+ *
+ * @return The current audio output.
+ */
+RBTK_NO_DISCARD rbtk_audio_output
+rbtk_get_audio_output(void);
+
+/*!
+ * @brief Renders audio when the audio system is rendering offline.
+ *
+ * All playing sounds are mixed as if the given amount of time has passed.
+ * This includes refilling the buffers of streamed sounds. The output is
+ * either discarded or written to a WAV file, depending on the output.
+ *
+ * @param[in] unit     The unit of `duration`.
+ * @param[in] duration How much audio to render.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `duration` is not negative.
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE, If the audio system is not
+ *                                    initialized, or is not rendering
+ *                                    offline.}
+ * @signal{#RBTK_ERROR_IO,            If the WAV file could not be
+ *                                    written to.}
+ * @enderrors
+ *
+ * @see rbtk_set_audio_output(rbtk_audio_output, const char *)
+ */
+RBTK_NO_DISCARD bool
+rbtk_render_audio(rbtk_time_unit unit, long double duration);
+
 /*!
  * @brief Creates an audio source.
  *
@@ -275,6 +389,9 @@ rbtk_read_pcm(RBTK_AUDIO_SOURCE *src, size_t off, void *buf, size_t len);
 /*!
  * @brief Creates an audio source from a WAV file.
  *
+ * The PCM data can only be read in order. Reading it at any offset other
+ * than the number of bytes already read signals #RBTK_ERROR_UNSUPPORTED.
+ *
  * @param[in] in The input stream to read from.
  * @return The opened audio source or `NULL` on error.
  *
@@ -284,7 +401,10 @@ rbtk_read_pcm(RBTK_AUDIO_SOURCE *src, size_t off, void *buf, size_t len);
  *
  * @debugging This function asserts that `in` is not `NULL`.
  * @errors
- * @signal{#RBTK_ERROR_IO, If an I/O error occurs.}
+ * @signal{#RBTK_ERROR_IO,            If an I/O error occurs.}
+ * @signal{#RBTK_ERROR_UNSUPPORTED,   If the WAV file does not contain
+ *                                    16-bit PCM data.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
  * @enderrors
  *
  * @see rbtk_open_file_in_stream(const char *)
@@ -317,6 +437,8 @@ rbtk_source_ogg(RBTK_IN_STREAM *in);
 /*!
  * @brief Creates an audio source from an MP3 file.
  *
+ * Like WAV sources, the PCM data can only be read in order.
+ *
  * @param[in] in The input stream to read from.
  * @return The opened audio source or `NULL` on error.
  *
@@ -326,7 +448,9 @@ rbtk_source_ogg(RBTK_IN_STREAM *in);
  *
  * @debugging This function asserts that `in` is not `NULL`.
  * @errors
- * @signal{#RBTK_ERROR_IO, If an I/O error occurs.}
+ * @signal{#RBTK_ERROR_IO,            If an I/O error occurs.}
+ * @signal{#RBTK_ERROR_UNSUPPORTED,   If `in` does not support seeking.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
  * @enderrors
  *
  * @see rbtk_open_file_in_stream(const char *)
@@ -335,6 +459,48 @@ rbtk_source_ogg(RBTK_IN_STREAM *in);
 RBTK_NO_DISCARD RBTK_AUDIO_SOURCE *
 rbtk_source_mp3(RBTK_IN_STREAM *in);
 
+/*!
+ * @brief Decodes all of the audio data of a source ahead of time.
+ *
+ * Decoding is the bulk of the work done when buffering a sound. When a
+ * sound is buffered from a source that has already been decoded, the data
+ * decoded here is used instead. Unlike buffering, this does not involve
+ * the audio system at all. As such, it can be done on a worker thread to
+ * keep the calling thread from stalling later on.
+ *
+ * @attention No other thread may use `src` while it is being decoded.
+ *
+ * @note If the source is closed instead of buffered, the decoded data is
+ * simply freed along with it.
+ *
+ * @param[in] src The audio source to decode.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `src` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
+ * @enderrors
+ *
+ * @see rbtk_buffer_sound(RBTK_AUDIO_SOURCE *)
+ * @see rbtk_buffer_sounds(RBTK_AUDIO_SOURCE *[], size_t, RBTK_SOUND *[])
+ */
+RBTK_NO_DISCARD bool
+rbtk_decode_audio_source(RBTK_AUDIO_SOURCE *src);
+
+/*!
+ * @brief Returns how much memory the decoded audio of a source takes up.
+ *
+ * @param[in] src The audio source.
+ * @return The size of the decoded audio data in bytes, or zero if the
+ *         source has not been decoded.
+ *
+ * @debugging This function asserts that `src` is not `NULL`.
+ *
+ * @see rbtk_decode_audio_source(RBTK_AUDIO_SOURCE *)
+ */
+RBTK_NO_DISCARD size_t
+rbtk_get_decoded_audio_size(const RBTK_AUDIO_SOURCE *src);
+
 /*!
  * @brief Buffers a sound from an audio source.
  *
@@ -359,20 +525,65 @@ rbtk_source_mp3(RBTK_IN_STREAM *in);
  * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
  * @enderrors
  *
+ * @see rbtk_decode_audio_source(RBTK_AUDIO_SOURCE *)
  * @see rbtk_stream_sound(RBTK_AUDIO_SOURCE *)
  * @see rbtk_close_sound(RBTK_SOUND *)
  */
 RBTK_NO_DISCARD RBTK_SOUND *
 rbtk_buffer_sound(RBTK_AUDIO_SOURCE *src);
 
+/*!
+ * @brief Buffers multiple sounds from audio sources at once.
+ *
+ * This behaves like #rbtk_buffer_sound(RBTK_AUDIO_SOURCE *) for each of
+ * the given sources. However, the sources are decoded concurrently on a
+ * pool of worker threads. Only handing the decoded audio data over to the
+ * platform is done on the calling thread. This makes buffering a batch of
+ * sounds take about as long as decoding the longest one.
+ *
+ * @attention Each created sound will take ownership of its source. If a
+ * sound fails to buffer, the caller retains ownership of its source.
+ *
+ * @param[in]  srcs  The audio sources to read from.
+ * @param[in]  count The number of audio sources.
+ * @param[out] out   Where to write the buffered sounds. Each entry is the
+ *                   sound for the source at the same index, or `NULL` if
+ *                   that source failed to buffer.
+ * @return `true` if every sound was buffered, `false` otherwise.
+ *
+ * @pointer_lifetime The pointers written to `out` are valid until each
+ * sound is closed via #rbtk_close_sound(RBTK_SOUND *) or until the audio
+ * system is shutdown.
+ *
+ * @debugging This function asserts that `srcs`, `out`, and each of the
+ * sources are not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
+ * @signal{#RBTK_ERROR_PLATFORM,      If the worker threads could not be
+ *                                started.}
+ * @enderrors
+ *
+ * @see rbtk_buffer_sound(RBTK_AUDIO_SOURCE *)
+ */
+RBTK_NO_DISCARD bool
+rbtk_buffer_sounds(RBTK_AUDIO_SOURCE *srcs[], size_t count,
+    RBTK_SOUND *out[]);
+
 /*!
  * @brief Streams a sound from an audio source.
  *
  * These have their audio data buffered into memory as they are playing.
- * Streamed sounds should be used to play small sound files, such as
+ * Streamed sounds should not be used to play small sound files, such as
  * SFX. They are intended for larger audio samples, such as music or
  * narration. For smaller audio files, buffered sounds are recommended.
  *
+ * The buffers of a streamed sound are refilled each time the engine is
+ * updated, or each time audio is rendered offline.
+ *
+ * @note Streamed sounds cannot loop or be rewound, as audio sources do not
+ * yet support seeking. Stopping a streamed sound and playing it again will
+ * have it resume from where it was stopped.
+ *
  * @attention The created sound will take ownership of `src`. It can
  * not be used with another sound after calling this. Furthermore, it
  * will be closed by the sound when the sound itself is closed.
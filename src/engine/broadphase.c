@@ -0,0 +1,441 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "broadphase.h"
+#include "./private/broadphase.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "entity.h"
+
+#include "../runtime/common.h"
+
+#define NO_NODE   UINT32_MAX
+#define SLOT_MASK ((uint32_t) RBTK_MAX_ENTITIES - 1)
+
+/*
+ * How many nodes to start with for each entity. Most entities are smaller
+ * than a cell, and so touch at most four of them. More nodes are allocated
+ * if entities end up touching more cells than this.
+ */
+#define INITIAL_NODES_PER_ENTITY 4
+
+static size_t
+hash_cell(const RBTK_BROADPHASE *broadphase, int32_t cell_x, int32_t cell_y)
+{
+    uint32_t hash = ((uint32_t) cell_x * 73856093U)
+        ^ ((uint32_t) cell_y * 19349663U);
+    return hash & broadphase->bucket_mask;
+}
+
+static rbtk_cell_range
+get_cells(const RBTK_BROADPHASE *broadphase, const rbtk_box *box)
+{
+    float cell_size = broadphase->cell_size;
+    rbtk_cell_range cells;
+    cells.min_x = (int32_t) floorf(box->min_x / cell_size);
+    cells.min_y = (int32_t) floorf(box->min_y / cell_size);
+    cells.max_x = (int32_t) floorf(box->max_x / cell_size);
+    cells.max_y = (int32_t) floorf(box->max_y / cell_size);
+    return cells;
+}
+
+static size_t
+count_cells(const rbtk_cell_range *cells)
+{
+    return (size_t) ((int64_t) cells->max_x - cells->min_x + 1)
+        * (size_t) ((int64_t) cells->max_y - cells->min_y + 1);
+}
+
+static bool
+same_cells(const rbtk_cell_range *a, const rbtk_cell_range *b)
+{
+    return a->min_x == b->min_x && a->min_y == b->min_y
+        && a->max_x == b->max_x && a->max_y == b->max_y;
+}
+
+static bool
+boxes_overlap(const rbtk_box *a, const rbtk_box *b)
+{
+    return a->min_x <= b->max_x && b->min_x <= a->max_x
+        && a->min_y <= b->max_y && b->min_y <= a->max_y;
+}
+
+/*
+ * Two ranges of cells can share many cells. To report an overlap only
+ * once, it is only reported from the first cell they share, which is the
+ * top left corner of where the two ranges meet.
+ */
+static bool
+is_first_shared_cell(const rbtk_cell_range *a, const rbtk_cell_range *b,
+    int32_t cell_x, int32_t cell_y)
+{
+    int32_t first_x = a->min_x > b->min_x ? a->min_x : b->min_x;
+    int32_t first_y = a->min_y > b->min_y ? a->min_y : b->min_y;
+    return cell_x == first_x && cell_y == first_y;
+}
+
+RBTK_NO_DISCARD RBTK_BROADPHASE *
+rbtk_create_broadphase(size_t max_entities, float cell_size)
+{
+    assert(max_entities > 0);
+    assert(max_entities <= RBTK_MAX_ENTITIES);
+    assert(cell_size > 0.0f);
+
+    RBTK_BROADPHASE *broadphase = NULL;
+    RBTK_MALLOC_OR_RETURN(&broadphase, NULL,
+        "could not allocate memory for broadphase");
+
+    RBTK_ZERO_MEMORY(broadphase);
+    broadphase->cell_size = cell_size;
+    broadphase->max_entities = max_entities;
+
+    /*
+     * There are at least twice as many buckets as entities, and always a
+     * power of two so a hash can be masked rather than divided.
+     */
+    size_t bucket_count = 1;
+    while (bucket_count < max_entities * 2) {
+        bucket_count <<= 1;
+    }
+    broadphase->bucket_mask = bucket_count - 1;
+
+    size_t node_capacity = max_entities * INITIAL_NODES_PER_ENTITY;
+    broadphase->node_capacity = node_capacity;
+    broadphase->free_nodes = NO_NODE;
+
+    broadphase->proxies = calloc(max_entities,
+        sizeof(*broadphase->proxies));
+    broadphase->active = malloc(max_entities * sizeof(*broadphase->active));
+    broadphase->buckets = malloc(bucket_count * sizeof(*broadphase->buckets));
+    broadphase->nodes = malloc(node_capacity * sizeof(*broadphase->nodes));
+    if (!broadphase->proxies || !broadphase->active
+        || !broadphase->buckets || !broadphase->nodes) {
+        rbtk_destroy_broadphase(broadphase);
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate memory for broadphase cells");
+        return NULL;
+    }
+
+    for (size_t i = 0; i < bucket_count; i++) {
+        broadphase->buckets[i] = NO_NODE;
+    }
+
+    return broadphase;
+}
+
+void
+rbtk_destroy_broadphase(RBTK_BROADPHASE *broadphase)
+{
+    if (broadphase) {
+        free(broadphase->proxies);
+        free(broadphase->active);
+        free(broadphase->buckets);
+        free(broadphase->nodes);
+        free(broadphase);
+    }
+}
+
+/*
+ * Makes sure there are enough nodes to link an entity into its cells. This
+ * is done ahead of time, so linking never fails halfway through.
+ */
+static bool
+reserve_nodes(RBTK_BROADPHASE *broadphase, size_t count)
+{
+    size_t unused = broadphase->free_node_count
+        + (broadphase->node_capacity - broadphase->node_count);
+    if (count <= unused) {
+        return true;
+    }
+
+    size_t capacity = broadphase->node_capacity;
+    while (capacity - broadphase->node_count
+        + broadphase->free_node_count < count) {
+        capacity *= 2;
+    }
+
+    rbtk_cell_node *nodes = NULL;
+    if (capacity < NO_NODE) {
+        nodes = realloc(broadphase->nodes, capacity * sizeof(*nodes));
+    }
+    if (!nodes) {
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate memory for more broadphase cells");
+        return false;
+    }
+
+    broadphase->nodes = nodes;
+    broadphase->node_capacity = capacity;
+    return true;
+}
+
+static uint32_t
+take_node(RBTK_BROADPHASE *broadphase)
+{
+    uint32_t node = broadphase->free_nodes;
+    if (node != NO_NODE) {
+        broadphase->free_nodes = broadphase->nodes[node].next;
+        broadphase->free_node_count -= 1;
+        return node;
+    }
+
+    assert(broadphase->node_count < broadphase->node_capacity);
+    node = (uint32_t) broadphase->node_count;
+    broadphase->node_count += 1;
+    return node;
+}
+
+static void
+link_cells(RBTK_BROADPHASE *broadphase, uint32_t slot,
+    const rbtk_cell_range *cells)
+{
+    for (int32_t y = cells->min_y; y <= cells->max_y; y++) {
+        for (int32_t x = cells->min_x; x <= cells->max_x; x++) {
+            size_t bucket = hash_cell(broadphase, x, y);
+            uint32_t node = take_node(broadphase);
+            broadphase->nodes[node].slot = slot;
+            broadphase->nodes[node].cell_x = x;
+            broadphase->nodes[node].cell_y = y;
+            broadphase->nodes[node].next = broadphase->buckets[bucket];
+            broadphase->buckets[bucket] = node;
+        }
+    }
+}
+
+static void
+unlink_cells(RBTK_BROADPHASE *broadphase, uint32_t slot,
+    const rbtk_cell_range *cells)
+{
+    rbtk_cell_node *nodes = broadphase->nodes;
+    for (int32_t y = cells->min_y; y <= cells->max_y; y++) {
+        for (int32_t x = cells->min_x; x <= cells->max_x; x++) {
+            uint32_t *link = &broadphase->buckets[hash_cell(broadphase, x, y)];
+            while (*link != NO_NODE) {
+                rbtk_cell_node *node = &nodes[*link];
+                if (node->slot == slot
+                    && node->cell_x == x && node->cell_y == y) {
+                    uint32_t freed = *link;
+                    *link = node->next;
+                    node->next = broadphase->free_nodes;
+                    broadphase->free_nodes = freed;
+                    broadphase->free_node_count += 1;
+                    break;
+                }
+                link = &node->next;
+            }
+        }
+    }
+}
+
+static void
+remove_proxy(RBTK_BROADPHASE *broadphase, uint32_t slot)
+{
+    rbtk_proxy *proxy = &broadphase->proxies[slot];
+    assert(proxy->entity != RBTK_NO_ENTITY);
+
+    unlink_cells(broadphase, slot, &proxy->cells);
+
+    size_t last = broadphase->active_count - 1;
+    uint32_t moved = broadphase->active[last];
+    broadphase->active[proxy->active_index] = moved;
+    broadphase->proxies[moved].active_index = proxy->active_index;
+    broadphase->active_count -= 1;
+
+    proxy->entity = RBTK_NO_ENTITY;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_update_broadphase_entity(RBTK_BROADPHASE *broadphase,
+    rbtk_entity entity, const rbtk_box *box)
+{
+    assert(broadphase);
+    assert(box);
+    assert(entity != RBTK_NO_ENTITY);
+    assert(box->min_x <= box->max_x && box->min_y <= box->max_y);
+
+    uint32_t slot = entity & SLOT_MASK;
+    if (slot >= broadphase->max_entities) {
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_BOUNDS,
+            "entity slot %u out of bounds", (unsigned int) slot);
+        return false;
+    }
+
+    rbtk_proxy *proxy = &broadphase->proxies[slot];
+    rbtk_cell_range cells = get_cells(broadphase, box);
+
+    /*
+     * The common case, an entity which moved but still touches the same
+     * cells. Nothing needs to be relinked.
+     */
+    if (proxy->entity == entity && same_cells(&proxy->cells, &cells)) {
+        proxy->box = *box;
+        return true;
+    }
+
+    if (!reserve_nodes(broadphase, count_cells(&cells))) {
+        return false;
+    }
+
+    if (proxy->entity == RBTK_NO_ENTITY) {
+        proxy->active_index = broadphase->active_count;
+        broadphase->active[broadphase->active_count] = slot;
+        broadphase->active_count += 1;
+    }
+    else {
+        /* a moved entity, or a destroyed one which was never removed */
+        unlink_cells(broadphase, slot, &proxy->cells);
+    }
+
+    link_cells(broadphase, slot, &cells);
+    proxy->entity = entity;
+    proxy->box = *box;
+    proxy->cells = cells;
+    proxy->synced = broadphase->sync_count;
+    return true;
+}
+
+void
+rbtk_remove_broadphase_entity(RBTK_BROADPHASE *broadphase,
+    rbtk_entity entity)
+{
+    assert(broadphase);
+
+    uint32_t slot = entity & SLOT_MASK;
+    if (entity == RBTK_NO_ENTITY || slot >= broadphase->max_entities
+        || broadphase->proxies[slot].entity != entity) {
+        return; /* not in broadphase */
+    }
+
+    remove_proxy(broadphase, slot);
+}
+
+RBTK_NO_DISCARD bool
+rbtk_sync_broadphase(RBTK_BROADPHASE *broadphase, RBTK_WORLD *world)
+{
+    assert(broadphase);
+    assert(world);
+
+    broadphase->sync_count += 1;
+    unsigned int sync_count = broadphase->sync_count;
+
+    rbtk_entity_arrays arrays = rbtk_get_entity_arrays(world);
+    for (size_t i = 0; i < arrays.count; i++) {
+        if (!(arrays.components[i] & RBTK_COMPONENT_COLLIDER)) {
+            continue;
+        }
+
+        rbtk_box box;
+        box.min_x = arrays.x[i] - arrays.half_width[i];
+        box.min_y = arrays.y[i] - arrays.half_height[i];
+        box.max_x = arrays.x[i] + arrays.half_width[i];
+        box.max_y = arrays.y[i] + arrays.half_height[i];
+
+        rbtk_entity entity = arrays.entities[i];
+        if (!rbtk_update_broadphase_entity(broadphase, entity, &box)) {
+            return false;
+        }
+        broadphase->proxies[entity & SLOT_MASK].synced = sync_count;
+    }
+
+    /*
+     * Anything which was not just updated is either gone from the world,
+     * or no longer has a collider. This goes backwards, since removing a
+     * proxy moves the last one in the list into its place.
+     */
+    for (size_t i = broadphase->active_count; i > 0; i--) {
+        uint32_t slot = broadphase->active[i - 1];
+        if (broadphase->proxies[slot].synced != sync_count) {
+            remove_proxy(broadphase, slot);
+        }
+    }
+
+    return true;
+}
+
+void
+rbtk_query_broadphase(RBTK_BROADPHASE *broadphase, const rbtk_box *box,
+    rbtk_overlap_fun fun, void *args)
+{
+    assert(broadphase);
+    assert(box);
+    assert(fun);
+
+    rbtk_cell_range cells = get_cells(broadphase, box);
+    const rbtk_cell_node *nodes = broadphase->nodes;
+
+    for (int32_t y = cells.min_y; y <= cells.max_y; y++) {
+        for (int32_t x = cells.min_x; x <= cells.max_x; x++) {
+            uint32_t node = broadphase->buckets[hash_cell(broadphase, x, y)];
+            for (; node != NO_NODE; node = nodes[node].next) {
+                if (nodes[node].cell_x != x || nodes[node].cell_y != y) {
+                    continue; /* another cell in the same bucket */
+                }
+
+                uint32_t slot = nodes[node].slot;
+                const rbtk_proxy *proxy = &broadphase->proxies[slot];
+                if (is_first_shared_cell(&proxy->cells, &cells, x, y)
+                    && boxes_overlap(&proxy->box, box)) {
+                    fun(proxy->entity, args);
+                }
+            }
+        }
+    }
+}
+
+void
+rbtk_find_broadphase_pairs(RBTK_BROADPHASE *broadphase, rbtk_pair_fun fun,
+    void *args)
+{
+    assert(broadphase);
+    assert(fun);
+
+    const rbtk_cell_node *nodes = broadphase->nodes;
+    const rbtk_proxy *proxies = broadphase->proxies;
+
+    for (size_t i = 0; i <= broadphase->bucket_mask; i++) {
+        uint32_t a = broadphase->buckets[i];
+        for (; a != NO_NODE; a = nodes[a].next) {
+            int32_t x = nodes[a].cell_x;
+            int32_t y = nodes[a].cell_y;
+            const rbtk_proxy *pa = &proxies[nodes[a].slot];
+
+            uint32_t b = nodes[a].next;
+            for (; b != NO_NODE; b = nodes[b].next) {
+                if (nodes[b].cell_x != x || nodes[b].cell_y != y) {
+                    continue; /* another cell in the same bucket */
+                }
+
+                const rbtk_proxy *pb = &proxies[nodes[b].slot];
+                if (is_first_shared_cell(&pa->cells, &pb->cells, x, y)
+                    && boxes_overlap(&pa->box, &pb->box)) {
+                    fun(pa->entity, pb->entity, args);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,239 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_BROADPHASE_H_
+#define RBTK_ENGINE_BROADPHASE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+ * @file
+ * @brief The public API for the game engine's broadphase module.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "entity.h"
+
+#include "../runtime/common.h"
+#include "../runtime/error.h"
+
+/*!
+ * @defgroup engine_broadphase Broadphase
+ * @brief The game engine's broadphase module.
+ *
+ * Checking every entity against every other one for collisions does not
+ * scale past a few dozen entities. A broadphase narrows this down, by
+ * only checking entities which are near each other.
+ *
+ * The broadphase divides the world into square cells. Each entity is put
+ * into every cell its box touches, and only entities which share a cell
+ * are checked against each other. Since a level can be far wider than it
+ * is tall (and is mostly empty space), the cells are kept in a hash table
+ * rather than a grid covering the whole level. This way, memory is only
+ * used for cells which hold something.
+ *
+ * Entities are only moved between cells when their box touches different
+ * cells than before. As such, updating an entity which moved a little is
+ * cheap.
+ *
+ * @see rbtk_create_broadphase(size_t, float)
+ * @see rbtk_sync_broadphase(RBTK_BROADPHASE *, RBTK_WORLD *)
+ *
+ * @{
+ */
+
+/*!
+ * @brief A box, aligned with the axes.
+ */
+typedef struct rbtk_box {
+    float min_x; /*!< The left edge of the box.   */
+    float min_y; /*!< The top edge of the box.    */
+    float max_x; /*!< The right edge of the box.  */
+    float max_y; /*!< The bottom edge of the box. */
+} rbtk_box;
+
+/*!
+ * @brief Called for each entity found by a query.
+ *
+ * @param[in] entity The entity which was found.
+ * @param[in] args   The arguments given to the query.
+ *
+ * @see rbtk_query_broadphase(RBTK_BROADPHASE *, const rbtk_box *,
+ *      rbtk_overlap_fun, void *)
+ */
+typedef void (*rbtk_overlap_fun)(rbtk_entity entity, void *args);
+
+/*!
+ * @brief Called for each pair of overlapping entities.
+ *
+ * @param[in] a    The first entity in the pair.
+ * @param[in] b    The second entity in the pair.
+ * @param[in] args The arguments given when finding pairs.
+ *
+ * @see rbtk_find_broadphase_pairs(RBTK_BROADPHASE *, rbtk_pair_fun,
+ *      void *)
+ */
+typedef void (*rbtk_pair_fun)(rbtk_entity a, rbtk_entity b, void *args);
+
+/*!
+ * @brief A spatial hash of entity boxes.
+ *
+ * @see rbtk_create_broadphase(size_t, float)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_BROADPHASE RBTK_BROADPHASE;
+
+/*!
+ * @brief Creates a broadphase.
+ *
+ * The size of a cell should be around the size of a typical entity. If
+ * it is much smaller, entities are put into many cells. If it is much
+ * larger, many entities end up in the same cell.
+ *
+ * @param[in] max_entities The max number of entities in the world the
+ *                         broadphase is used with.
+ * @param[in] cell_size    The width and height of each cell.
+ * @return The created broadphase, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until it is destroyed
+ * with #rbtk_destroy_broadphase(RBTK_BROADPHASE *).
+ *
+ * @debugging This function asserts that `max_entities` is not `0` and is
+ * not greater than #RBTK_MAX_ENTITIES, and that `cell_size` is positive.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If memory for the broadphase could
+ *                                    not be allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD RBTK_BROADPHASE *
+rbtk_create_broadphase(size_t max_entities, float cell_size);
+
+/*!
+ * @brief Destroys a broadphase.
+ *
+ * @param[in] broadphase The broadphase to destroy. If `NULL`, this
+ *                       function is a no-op.
+ */
+void
+rbtk_destroy_broadphase(RBTK_BROADPHASE *broadphase);
+
+/*!
+ * @brief Adds an entity to a broadphase, or moves it.
+ *
+ * @param[in] broadphase The broadphase to update.
+ * @param[in] entity     The entity to add or move.
+ * @param[in] box        The box of the entity.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `broadphase` and `box` are not
+ * `NULL`, and that `entity` is not #RBTK_NO_ENTITY.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_BOUNDS, If the slot of `entity` is not less
+ *                                    than the max number of entities.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If memory for more cells could not
+ *                                    be allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD bool
+rbtk_update_broadphase_entity(RBTK_BROADPHASE *broadphase,
+    rbtk_entity entity, const rbtk_box *box);
+
+/*!
+ * @brief Removes an entity from a broadphase.
+ *
+ * @note If the entity is not in the broadphase, this function is a no-op.
+ *
+ * @param[in] broadphase The broadphase to update.
+ * @param[in] entity     The entity to remove.
+ *
+ * @debugging This function asserts that `broadphase` is not `NULL`.
+ */
+void
+rbtk_remove_broadphase_entity(RBTK_BROADPHASE *broadphase,
+    rbtk_entity entity);
+
+/*!
+ * @brief Brings a broadphase up to date with a world.
+ *
+ * Every entity in the world with a collider is added or moved. Any entity
+ * which no longer exists, or no longer has a collider, is removed. This
+ * should be called once per tick, after entities have moved.
+ *
+ * @param[in] broadphase The broadphase to update.
+ * @param[in] world      The world to update from.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `broadphase` and `world` are not
+ * `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If memory for more cells could not
+ *                                    be allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD bool
+rbtk_sync_broadphase(RBTK_BROADPHASE *broadphase, RBTK_WORLD *world);
+
+/*!
+ * @brief Finds every entity in a broadphase which overlaps a box.
+ *
+ * Each entity is reported once, even if it shares many cells with the box.
+ *
+ * @param[in] broadphase The broadphase to query.
+ * @param[in] box        The box to check for overlaps with.
+ * @param[in] fun        Called for each overlapping entity.
+ * @param[in] args       Passed to `fun`.
+ *
+ * @debugging This function asserts that `broadphase`, `box`, and `fun`
+ * are not `NULL`.
+ */
+void
+rbtk_query_broadphase(RBTK_BROADPHASE *broadphase, const rbtk_box *box,
+    rbtk_overlap_fun fun, void *args);
+
+/*!
+ * @brief Finds every pair of overlapping entities in a broadphase.
+ *
+ * Each pair is reported once, even if its entities share many cells.
+ *
+ * @param[in] broadphase The broadphase to query.
+ * @param[in] fun        Called for each overlapping pair.
+ * @param[in] args       Passed to `fun`.
+ *
+ * @debugging This function asserts that `broadphase` and `fun` are not
+ * `NULL`.
+ */
+void
+rbtk_find_broadphase_pairs(RBTK_BROADPHASE *broadphase, rbtk_pair_fun fun,
+    void *args);
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_BROADPHASE_H_ */
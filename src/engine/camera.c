@@ -0,0 +1,303 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "camera.h"
+#include "./private/camera.h"
+#include "./private/graphics.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "broadphase.h"
+#include "graphics.h"
+#include "tilemap.h"
+
+#include "../runtime/common.h"
+
+/*
+ * The original game was made for a screen this wide. This is unrelated to
+ * the width of the screen a game using these rules renders at, which is
+ * what the rules are adapted to.
+ */
+#define ORIGINAL_SCREEN_WIDTH 320.0f
+#define ORIGINAL_LOOK_AHEAD   64.0f
+
+void
+rbtk_get_sonic_camera_rules(rbtk_camera_rules *rules, float width)
+{
+    assert(rules);
+
+    float middle = width / 2.0f;
+    rules->border_left = middle - 16.0f;
+    rules->border_right = middle;
+    rules->border_top = 64.0f;
+    rules->border_bottom = 128.0f;
+    rules->focus_y = 96.0f;
+    rules->max_scroll = 16.0f;
+    rules->ground_scroll = 6.0f;
+    rules->fast_speed = 8.0f;
+    rules->look_ahead = ORIGINAL_LOOK_AHEAD * (width / ORIGINAL_SCREEN_WIDTH);
+    rules->look_ahead_speed = 6.0f;
+    rules->pan_speed = 2.0f;
+    rules->activation_margin = 128.0f;
+}
+
+static float
+get_view_width(const RBTK_CAMERA_CONTROLLER *controller)
+{
+    const rbtk_projection_specs *specs = &controller->scene->proj->specs;
+    return fabsf(specs->ortho.right - specs->ortho.left);
+}
+
+static float
+get_view_height(const RBTK_CAMERA_CONTROLLER *controller)
+{
+    const rbtk_projection_specs *specs = &controller->scene->proj->specs;
+    return fabsf(specs->ortho.bottom - specs->ortho.top);
+}
+
+static float
+approach(float value, float target, float step)
+{
+    if (value < target) {
+        return fminf(value + step, target);
+    }
+    return fmaxf(value - step, target);
+}
+
+/*
+ * Returns how far to scroll to bring a position back between two borders,
+ * no further than the given limit.
+ */
+static float
+scroll_into(float pos, float min, float max, float limit)
+{
+    if (pos < min) {
+        return fmaxf(pos - min, -limit);
+    }
+    else if (pos > max) {
+        return fminf(pos - max, limit);
+    }
+    return 0.0f;
+}
+
+static void
+clamp_to_bounds(RBTK_CAMERA_CONTROLLER *controller)
+{
+    if (!controller->bounded) {
+        return;
+    }
+
+    /* if the bounds are smaller than the view, the top left wins */
+    const rbtk_box *bounds = &controller->bounds;
+    float max_x = bounds->max_x - get_view_width(controller);
+    float max_y = bounds->max_y - get_view_height(controller);
+    controller->x = fmaxf(fminf(controller->x, max_x), bounds->min_x);
+    controller->y = fmaxf(fminf(controller->y, max_y), bounds->min_y);
+}
+
+/*
+ * This is the only place the projection is looked at. Everything else
+ * reads the view worked out here.
+ */
+static void
+apply_camera(RBTK_CAMERA_CONTROLLER *controller)
+{
+    const rbtk_projection_specs *specs = &controller->scene->proj->specs;
+    float left = floorf(controller->x);
+    float top = floorf(controller->y);
+    float width = get_view_width(controller);
+    float height = get_view_height(controller);
+
+    float z;
+    RBTK_CAMERA *camera = controller->scene->camera;
+    rbtk_get_camera_pos(camera, NULL, NULL, &z);
+    rbtk_set_camera_pos(camera,
+        fminf(specs->ortho.left, specs->ortho.right) - left,
+        fminf(specs->ortho.top, specs->ortho.bottom) - top, z);
+
+    rbtk_camera_view *view = &controller->view;
+    view->rect.min_x = left;
+    view->rect.min_y = top;
+    view->rect.max_x = left + width;
+    view->rect.max_y = top + height;
+
+    float margin = controller->rules.activation_margin;
+    view->active.min_x = view->rect.min_x - margin;
+    view->active.min_y = view->rect.min_y - margin;
+    view->active.max_x = view->rect.max_x + margin;
+    view->active.max_y = view->rect.max_y + margin;
+
+    /* the max edges are exclusive, so the last tile is one pixel back */
+    view->first_tile_x = (int32_t) floorf(left / RBTK_TILE_SIZE);
+    view->first_tile_y = (int32_t) floorf(top / RBTK_TILE_SIZE);
+    view->last_tile_x =
+        (int32_t) floorf((view->rect.max_x - 1.0f) / RBTK_TILE_SIZE);
+    view->last_tile_y =
+        (int32_t) floorf((view->rect.max_y - 1.0f) / RBTK_TILE_SIZE);
+}
+
+RBTK_NO_DISCARD RBTK_CAMERA_CONTROLLER *
+rbtk_create_camera_controller(RBTK_GRAPHICS *scene,
+    const rbtk_camera_rules *rules)
+{
+    assert(scene);
+    assert(rules);
+    assert(scene->proj->specs.type == RBTK_PROJECTION_ORTHO);
+
+    RBTK_CAMERA_CONTROLLER *controller = NULL;
+    RBTK_MALLOC_OR_RETURN(&controller, NULL,
+        "could not allocate memory for camera controller");
+
+    RBTK_ZERO_MEMORY(controller);
+    controller->scene = scene;
+    controller->rules = *rules;
+
+    apply_camera(controller);
+    return controller;
+}
+
+void
+rbtk_destroy_camera_controller(RBTK_CAMERA_CONTROLLER *controller)
+{
+    free(controller);
+}
+
+void
+rbtk_set_camera_bounds(RBTK_CAMERA_CONTROLLER *controller,
+    const rbtk_box *bounds)
+{
+    assert(controller);
+
+    controller->bounded = bounds != NULL;
+    if (bounds) {
+        controller->bounds = *bounds;
+    }
+
+    clamp_to_bounds(controller);
+    apply_camera(controller);
+}
+
+void
+rbtk_center_camera_on(RBTK_CAMERA_CONTROLLER *controller, float x, float y)
+{
+    assert(controller);
+
+    controller->x = x - get_view_width(controller) / 2.0f;
+    controller->y = y - get_view_height(controller) / 2.0f;
+
+    clamp_to_bounds(controller);
+    apply_camera(controller);
+}
+
+void
+rbtk_lag_camera(RBTK_CAMERA_CONTROLLER *controller, unsigned int ticks)
+{
+    assert(controller);
+    controller->lag_ticks = ticks;
+}
+
+void
+rbtk_pan_camera(RBTK_CAMERA_CONTROLLER *controller, float offset)
+{
+    assert(controller);
+    controller->pan_target = offset;
+}
+
+void
+rbtk_update_camera_controller(RBTK_CAMERA_CONTROLLER *controller,
+    const rbtk_camera_target *target)
+{
+    assert(controller);
+    assert(target);
+
+    const rbtk_camera_rules *rules = &controller->rules;
+
+    /*
+     * Looking ahead and panning shift the borders, rather than the camera
+     * itself. This way, the camera still follows the usual scroll limits
+     * while it catches up with the shift.
+     */
+    float look_ahead = 0.0f;
+    if (fabsf(target->x_speed) >= rules->look_ahead_speed) {
+        look_ahead = copysignf(rules->look_ahead, target->x_speed);
+    }
+    controller->look_ahead = approach(controller->look_ahead,
+        look_ahead, rules->pan_speed);
+    controller->pan = approach(controller->pan,
+        controller->pan_target, rules->pan_speed);
+
+    if (controller->lag_ticks > 0) {
+        controller->lag_ticks--;
+    }
+    else {
+        float screen_x = target->x - controller->x + controller->look_ahead;
+        controller->x += scroll_into(screen_x, rules->border_left,
+            rules->border_right, rules->max_scroll);
+    }
+
+    /*
+     * On the ground, the camera keeps the target at the same height. The
+     * camera only scrolls quickly if the target is moving quickly, so small
+     * bumps in the ground do not shake it. In the air, the target can move
+     * up and down a little before the camera follows.
+     */
+    float screen_y = target->y - controller->y + controller->pan;
+    if (target->grounded) {
+        float limit = rules->ground_scroll;
+        if (fabsf(target->ground_speed) >= rules->fast_speed) {
+            limit = rules->max_scroll;
+        }
+        controller->y += scroll_into(screen_y, rules->focus_y,
+            rules->focus_y, limit);
+    }
+    else {
+        controller->y += scroll_into(screen_y, rules->border_top,
+            rules->border_bottom, rules->max_scroll);
+    }
+
+    clamp_to_bounds(controller);
+    apply_camera(controller);
+}
+
+RBTK_NO_DISCARD const rbtk_camera_view *
+rbtk_get_camera_view(const RBTK_CAMERA_CONTROLLER *controller)
+{
+    assert(controller);
+    return &controller->view;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_camera_can_see(const RBTK_CAMERA_CONTROLLER *controller,
+    const rbtk_box *box)
+{
+    assert(controller);
+    assert(box);
+
+    const rbtk_box *rect = &controller->view.rect;
+    return box->max_x > rect->min_x && box->min_x < rect->max_x
+        && box->max_y > rect->min_y && box->min_y < rect->max_y;
+}
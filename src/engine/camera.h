@@ -0,0 +1,313 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_CAMERA_H_
+#define RBTK_ENGINE_CAMERA_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+ * @file
+ * @brief The public API for the game engine's camera module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "broadphase.h"
+#include "graphics.h"
+
+#include "../runtime/common.h"
+#include "../runtime/error.h"
+
+/*!
+ * @defgroup engine_camera Camera
+ * @brief The game engine's camera module.
+ *
+ * A camera controller moves the camera of a scene to follow a target,
+ * the way the camera of a Sonic game does. The target can move freely
+ * within a small box on the screen before the camera starts to follow.
+ * How fast the camera can scroll is limited, so it lags behind a target
+ * which moves too quickly.
+ *
+ * Each tick, the controller also works out what part of the world can
+ * be seen. This is kept as a box in world space, the range of tiles it
+ * covers, and a wider window for activating objects. Every system which
+ * needs to know what is on screen should read these, rather than working
+ * them out again from the projection of the scene.
+ *
+ * Only orthographic projections are supported. Positions are in pixels,
+ * and speeds are in pixels per tick.
+ *
+ * @see rbtk_create_camera_controller(RBTK_GRAPHICS *,
+ *      const rbtk_camera_rules *)
+ * @see rbtk_update_camera_controller(RBTK_CAMERA_CONTROLLER *,
+ *      const rbtk_camera_target *)
+ * @see rbtk_get_camera_view(const RBTK_CAMERA_CONTROLLER *)
+ *
+ * @{
+ */
+
+/*!
+ * @brief How a camera controller follows its target.
+ *
+ * Borders are relative to the top left of the screen. While the target
+ * is between them, the camera does not scroll on that axis.
+ *
+ * @see rbtk_get_sonic_camera_rules(rbtk_camera_rules *, float)
+ */
+typedef struct rbtk_camera_rules {
+    float border_left;       /*!< The left border of the box.          */
+    float border_right;      /*!< The right border of the box.         */
+    float border_top;        /*!< The top border of the box, used when
+                                  the target is in the air.            */
+    float border_bottom;     /*!< The bottom border of the box, used
+                                  when the target is in the air.       */
+    float focus_y;           /*!< Where the target is kept on the
+                                  Y-axis while it is on the ground.    */
+    float max_scroll;        /*!< How fast the camera can scroll.      */
+    float ground_scroll;     /*!< How fast the camera can scroll on the
+                                  Y-axis while the target is on the
+                                  ground and moving slowly.            */
+    float fast_speed;        /*!< How fast the target must move on the
+                                  ground for the camera to use
+                                  `max_scroll` on the Y-axis.          */
+    float look_ahead;        /*!< How far the camera looks ahead of a
+                                  fast moving target.                  */
+    float look_ahead_speed;  /*!< How fast the target must move for the
+                                  camera to look ahead.                */
+    float pan_speed;         /*!< How fast the camera pans when looking
+                                  ahead, up, or down.                  */
+    float activation_margin; /*!< How far past the edges of the screen
+                                  objects are activated.               */
+} rbtk_camera_rules;
+
+/*!
+ * @brief What a camera controller follows.
+ */
+typedef struct rbtk_camera_target {
+    float x;            /*!< The X-axis position of the target.      */
+    float y;            /*!< The Y-axis position of the target.      */
+    float x_speed;      /*!< The speed of the target along the
+                             X-axis.                                 */
+    float ground_speed; /*!< The speed of the target along the
+                             ground. Only used when `grounded`.      */
+    bool grounded;      /*!< If the target is on the ground.         */
+} rbtk_camera_target;
+
+/*!
+ * @brief What a camera can see.
+ *
+ * @see rbtk_get_camera_view(const RBTK_CAMERA_CONTROLLER *)
+ */
+typedef struct rbtk_camera_view {
+    rbtk_box rect;        /*!< What can be seen, in world space.       */
+    rbtk_box active;      /*!< The rect, widened by the activation
+                               margin of the rules.                    */
+    int32_t first_tile_x; /*!< The first column of tiles in view.      */
+    int32_t first_tile_y; /*!< The first row of tiles in view.         */
+    int32_t last_tile_x;  /*!< The last column of tiles in view.       */
+    int32_t last_tile_y;  /*!< The last row of tiles in view.          */
+} rbtk_camera_view;
+
+/*!
+ * @brief Moves the camera of a scene to follow a target.
+ *
+ * @see rbtk_create_camera_controller(RBTK_GRAPHICS *,
+ *      const rbtk_camera_rules *)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_CAMERA_CONTROLLER RBTK_CAMERA_CONTROLLER;
+
+/*!
+ * @brief Gets the camera rules used by Sonic.
+ *
+ * The original game was made for a screen 320 pixels wide. The borders
+ * are moved so they keep the same place relative to the middle of the
+ * screen, whatever its width. The look ahead distance is scaled with the
+ * width, so it covers the same share of the screen (e.g., 64 pixels on a
+ * screen 320 pixels wide, but 51.2 pixels on one 256 pixels wide).
+ *
+ * @param[out] rules The rules to fill in.
+ * @param[in]  width The width of the screen, in pixels.
+ *
+ * @debugging This function asserts that `rules` is not `NULL`.
+ */
+void
+rbtk_get_sonic_camera_rules(rbtk_camera_rules *rules, float width);
+
+/*!
+ * @brief Creates a camera controller.
+ *
+ * The camera starts at the top left of the world, with no scroll bounds.
+ *
+ * @param[in] scene The scene whose camera to control.
+ * @param[in] rules How to follow the target. These are copied.
+ * @return The created camera controller, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until it is destroyed
+ * with #rbtk_destroy_camera_controller(RBTK_CAMERA_CONTROLLER *).
+ *
+ * @debugging This function asserts that `scene` and `rules` are not
+ * `NULL`, and that the projection of `scene` is orthographic.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If memory for the controller could
+ *                                    not be allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD RBTK_CAMERA_CONTROLLER *
+rbtk_create_camera_controller(RBTK_GRAPHICS *scene,
+    const rbtk_camera_rules *rules);
+
+/*!
+ * @brief Destroys a camera controller.
+ *
+ * @note The camera of the scene is left where it is.
+ *
+ * @param[in] controller The controller to destroy. If `NULL`, this
+ *                       function is a no-op.
+ */
+void
+rbtk_destroy_camera_controller(RBTK_CAMERA_CONTROLLER *controller);
+
+/*!
+ * @brief Sets how far a camera can scroll.
+ *
+ * The camera never shows anything outside of these bounds. If they are
+ * smaller than the screen, the camera is kept at their top left.
+ *
+ * @param[in] controller The controller to update.
+ * @param[in] bounds     The bounds, in world space. If `NULL`, the camera
+ *                       can scroll anywhere.
+ *
+ * @debugging This function asserts that `controller` is not `NULL`.
+ */
+void
+rbtk_set_camera_bounds(RBTK_CAMERA_CONTROLLER *controller,
+    const rbtk_box *bounds);
+
+/*!
+ * @brief Moves a camera so a point is in the middle of the screen.
+ *
+ * This skips any scrolling, and is meant for when a level starts or the
+ * target is teleported.
+ *
+ * @param[in] controller The controller to update.
+ * @param[in] x          The X-axis position of the point.
+ * @param[in] y          The Y-axis position of the point.
+ *
+ * @debugging This function asserts that `controller` is not `NULL`.
+ */
+void
+rbtk_center_camera_on(RBTK_CAMERA_CONTROLLER *controller, float x, float y);
+
+/*!
+ * @brief Stops a camera from scrolling along the X-axis for a while.
+ *
+ * This is used when the target is suddenly launched, such as by a spin
+ * dash, so it gets ahead of the camera for a moment.
+ *
+ * @param[in] controller The controller to update.
+ * @param[in] ticks      How many ticks to stop scrolling for.
+ *
+ * @debugging This function asserts that `controller` is not `NULL`.
+ */
+void
+rbtk_lag_camera(RBTK_CAMERA_CONTROLLER *controller, unsigned int ticks);
+
+/*!
+ * @brief Pans a camera up or down.
+ *
+ * The camera pans at the speed given by its rules, and stays there until
+ * it is told to pan again.
+ *
+ * @param[in] controller The controller to update.
+ * @param[in] offset     How far to pan. Negative values pan up, positive
+ *                       values pan down, and `0.0f` pans back.
+ *
+ * @debugging This function asserts that `controller` is not `NULL`.
+ */
+void
+rbtk_pan_camera(RBTK_CAMERA_CONTROLLER *controller, float offset);
+
+/*!
+ * @brief Moves a camera forward by a single tick.
+ *
+ * The camera of the scene is moved, and what it can see is worked out
+ * again. This should be called once per tick, after the target has moved
+ * and before anything reads the view.
+ *
+ * @param[in] controller The controller to update.
+ * @param[in] target     What the camera is following.
+ *
+ * @debugging This function asserts that `controller` and `target` are
+ * not `NULL`.
+ */
+void
+rbtk_update_camera_controller(RBTK_CAMERA_CONTROLLER *controller,
+    const rbtk_camera_target *target);
+
+/*!
+ * @brief Returns what a camera can see.
+ *
+ * The activation window of the view can be passed straight to an
+ * activator, and the rect to #rbtk_draw_entities() for culling.
+ *
+ * @param[in] controller The controller to query.
+ * @return What the camera could see as of the last update.
+ *
+ * @pointer_lifetime The returned pointer is valid until the controller is
+ * destroyed. Its contents change when the controller is updated.
+ *
+ * @debugging This function asserts that `controller` is not `NULL`.
+ *
+ * @see rbtk_update_activator(RBTK_ACTIVATOR *, float, float)
+ * @see rbtk_draw_entities(RBTK_GRAPHICS *, RBTK_WORLD *,
+ *      const RBTK_ANIME_SET *, const rbtk_box *, float)
+ */
+RBTK_NO_DISCARD const rbtk_camera_view *
+rbtk_get_camera_view(const RBTK_CAMERA_CONTROLLER *controller);
+
+/*!
+ * @brief Returns if a camera can see a box.
+ *
+ * @param[in] controller The controller to query.
+ * @param[in] box        The box to check, in world space.
+ * @return `true` if any part of `box` can be seen, `false` otherwise.
+ *
+ * @debugging This function asserts that `controller` and `box` are not
+ * `NULL`.
+ */
+RBTK_NO_DISCARD bool
+rbtk_camera_can_see(const RBTK_CAMERA_CONTROLLER *controller,
+    const rbtk_box *box);
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_CAMERA_H_ */
@@ -25,21 +25,31 @@
 #include "./private/engine.h"
 #include "./platform/engine.h"
 
+#include <math.h>
 #include <stdbool.h>
 
 #include "audio.h"
 #include "game.h"
 #include "graphics.h"
+#include "hitch.h"
 #include "input.h"
+#include "overlay.h"
+#include "snapshot.h"
 
 #include "./private/audio.h"
 #include "./private/game.h"
 #include "./private/graphics.h"
+#include "./private/hitch.h"
 #include "./private/input.h"
+#include "./private/overlay.h"
+#include "./private/snapshot.h"
 
 static RBTK_GAME *current_game;
 static bool initialized;
 
+static size_t headless_frames;
+static rbtk_headless_report headless_report;
+
 bool
 rbtk_engine_is_initialized(void)
 {
@@ -70,11 +80,26 @@ rbtk_engine_init(void)
             "graphics module failed to initialize");
         return false;
     }
+    if (!priv_rbtk_overlay_init()) {
+        rbtk_suggest_error(RBTK_ERROR_STARTUP,
+            "overlay module failed to initialize");
+        return false;
+    }
     if (!priv_rbtk_input_init()) {
         rbtk_suggest_error(RBTK_ERROR_STARTUP,
             "input module failed to initialize");
         return false;
     }
+    if (!priv_rbtk_hitch_init()) {
+        rbtk_suggest_error(RBTK_ERROR_STARTUP,
+            "hitch module failed to initialize");
+        return false;
+    }
+    if (!priv_rbtk_snapshot_init()) {
+        rbtk_suggest_error(RBTK_ERROR_STARTUP,
+            "snapshot module failed to initialize");
+        return false;
+    }
     if (!plat_rbtk_engine_post_init()) {
         rbtk_suggest_error(RBTK_ERROR_PLATFORM,
             "platform specific error during post-initailization");
@@ -108,6 +133,11 @@ rbtk_engine_terminate(void)
             "audio module failed to terminate");
         return false;
     }
+    if (!priv_rbtk_overlay_terminate()) {
+        rbtk_suggest_error(RBTK_ERROR_SHUTDOWN,
+            "overlay module failed to terminate");
+        return false;
+    }
     if (!priv_rbtk_audio_terminate()) {
         rbtk_suggest_error(RBTK_ERROR_SHUTDOWN,
             "graphics module failed to terminate");
@@ -118,6 +148,16 @@ rbtk_engine_terminate(void)
             "input module failed to terminate");
         return false;
     }
+    if (!priv_rbtk_hitch_terminate()) {
+        rbtk_suggest_error(RBTK_ERROR_SHUTDOWN,
+            "hitch module failed to terminate");
+        return false;
+    }
+    if (!priv_rbtk_snapshot_terminate()) {
+        rbtk_suggest_error(RBTK_ERROR_SHUTDOWN,
+            "snapshot module failed to terminate");
+        return false;
+    }
     if (!plat_rbtk_engine_post_terminate()) {
         rbtk_suggest_error(RBTK_ERROR_PLATFORM,
             "platform specific error during post-termination");
@@ -128,6 +168,37 @@ rbtk_engine_terminate(void)
     return true;
 }
 
+RBTK_NO_DISCARD bool
+rbtk_set_engine_headless(size_t frames)
+{
+    if (initialized) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE,
+            "headless mode must be set before initialization");
+        return false;
+    }
+
+    rbtk_audio_output output = frames > 0
+        ? RBTK_AUDIO_OUTPUT_NULL : RBTK_AUDIO_OUTPUT_DEVICE;
+    if (!rbtk_set_audio_output(output, NULL)) {
+        return false;
+    }
+
+    headless_frames = frames;
+    return true;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_engine_is_headless(void)
+{
+    return headless_frames > 0;
+}
+
+RBTK_NO_DISCARD rbtk_headless_report
+rbtk_get_headless_report(void)
+{
+    return headless_report;
+}
+
 RBTK_NO_DISCARD bool
 rbtk_game_is_running(const RBTK_GAME *game)
 {
@@ -156,6 +227,7 @@ stop_game(void)
 
     RBTK_GAME *game = current_game;
 
+    priv_rbtk_cancel_game_preload(game);
     rbtk_exit_game_state(game);
     for (size_t i = 0; i < game->state_count; i++) {
         RBTK_GAME_STATE *state = game->states[i];
@@ -169,6 +241,23 @@ stop_game(void)
     }
 }
 
+static void
+tick_game(RBTK_GAME *game, long double delta)
+{
+    if (game->funs.pre_update) {
+        game->funs.pre_update(game, delta);
+    }
+
+    RBTK_GAME_STATE *state = game->current_state;
+    if (state && state->funs.update) {
+        state->funs.update(game, state, delta);
+    }
+
+    if (game->funs.post_update) {
+        game->funs.post_update(game, delta);
+    }
+}
+
 static void
 update_engine(void)
 {
@@ -181,19 +270,54 @@ update_engine(void)
     long double delta = current_time - game->last_update;
     game->last_update = current_time;
 
-    plat_rbtk_engine_pre_update();
-    if (game->funs.pre_update) {
-        game->funs.pre_update(game, delta);
+    /*
+     * A headless game does not care how much time has actually passed.
+     * Every frame is exactly one tick long, and audio is rendered for it
+     * by hand since nothing is playing it back.
+     */
+    if (headless_frames > 0) {
+        delta = game->tick_ms > 0.0L
+            ? game->tick_ms : 1000.0L / RBTK_HEADLESS_TICK_RATE;
+        if (!rbtk_render_audio(RBTK_MILLIS, delta)) {
+            rbtk_stop_game(game);
+        }
     }
 
-    RBTK_GAME_STATE *state = game->current_state;
-    if (state && state->funs.update) {
-        state->funs.update(game, state, delta);
+    /*
+     * When headless, the game must run the same every time. As such, it
+     * cannot enter a preloaded state on whichever frame the worker thread
+     * happens to finish on.
+     */
+    plat_rbtk_engine_pre_update();
+    priv_rbtk_audio_update();
+    priv_rbtk_update_game_preload(game, headless_frames > 0);
+
+    if (game->tick_ms <= 0.0L) {
+        tick_game(game, delta);
+        game->alpha = 1.0f;
+        plat_rbtk_engine_post_update();
+        return;
     }
 
-    if (game->funs.post_update) {
-        game->funs.post_update(game, delta);
+    /*
+     * Run as many fixed updates as fit in the time that has passed. Any
+     * leftover time is kept for the next frame, and tells the renderer
+     * how far the game is between this update and the next one.
+     */
+    game->unsimulated_ms += delta;
+    unsigned int ticks = 0;
+    while (game->running && game->unsimulated_ms >= game->tick_ms) {
+        if (ticks >= RBTK_MAX_GAME_TICKS) {
+            game->unsimulated_ms = fmodl(game->unsimulated_ms,
+                game->tick_ms);
+            break; /* fell too far behind, drop the rest */
+        }
+        tick_game(game, game->tick_ms);
+        game->unsimulated_ms -= game->tick_ms;
+        ticks += 1;
     }
+    game->alpha = (float) (game->unsimulated_ms / game->tick_ms);
+
     plat_rbtk_engine_post_update();
 }
 
@@ -204,23 +328,61 @@ render_engine(void)
     assert(current_game);
 
     RBTK_GAME *game = current_game;
+    float alpha = game->alpha;
 
     plat_rbtk_engine_pre_render();
     if (game->funs.pre_render) {
-        game->funs.pre_render(game);
+        game->funs.pre_render(game, alpha);
     }
 
+    priv_rbtk_render_suspended_game_states(game, alpha);
     RBTK_GAME_STATE *state = game->current_state;
     if (state && state->funs.render) {
-        state->funs.render(game, state);
+        state->funs.render(game, state, alpha);
     }
 
     if (game->funs.post_render) {
-        game->funs.post_render(game);
+        game->funs.post_render(game, alpha);
     }
     plat_rbtk_engine_post_render();
 }
 
+static void
+run_frame(long double *update_ms, long double *render_ms)
+{
+    long double update_start = rbtk_time(RBTK_MILLIS);
+    update_engine();
+    long double render_start = rbtk_time(RBTK_MILLIS);
+    render_engine();
+    long double render_end = rbtk_time(RBTK_MILLIS);
+
+    priv_rbtk_record_frame(update_start, render_start, render_end);
+
+    if (update_ms) {
+        *update_ms = render_start - update_start;
+    }
+    if (render_ms) {
+        *render_ms = render_end - render_start;
+    }
+}
+
+static void
+run_headless(RBTK_GAME *game)
+{
+    RBTK_ZERO_MEMORY(&headless_report);
+
+    while (game->running && headless_report.frames < headless_frames) {
+        long double update_ms, render_ms;
+        run_frame(&update_ms, &render_ms);
+
+        headless_report.update_ms += update_ms;
+        headless_report.render_ms += render_ms;
+        headless_report.frames += 1;
+    }
+
+    rbtk_stop_game(game);
+}
+
 bool
 rbtk_start_game(RBTK_GAME *game)
 {
@@ -245,9 +407,13 @@ rbtk_start_game(RBTK_GAME *game)
     current_game = game;
 
     start_game();
-    while (game->running) {
-        update_engine();
-        render_engine();
+    if (headless_frames > 0) {
+        run_headless(game);
+    }
+    else {
+        while (game->running) {
+            run_frame(NULL, NULL);
+        }
     }
     stop_game();
 
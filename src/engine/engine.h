@@ -103,6 +103,80 @@ rbtk_engine_init(void);
 bool
 rbtk_engine_terminate(void);
 
+/*!
+ * @brief The rate a headless game is updated when it has no tick rate.
+ *
+ * @see rbtk_set_engine_headless(size_t)
+ */
+#define RBTK_HEADLESS_TICK_RATE 60.0L
+
+/*!
+ * @brief The results of running a game headless.
+ *
+ * @see rbtk_get_headless_report(void)
+ */
+typedef struct rbtk_headless_report {
+    size_t frames;         /*!< The number of frames that were run.     */
+    long double update_ms; /*!< The time spent updating, in total.      */
+    long double render_ms; /*!< The time spent rendering, in total.     */
+} rbtk_headless_report;
+
+/*!
+ * @brief Sets the engine to run games headless.
+ *
+ * A headless game runs for a set number of frames, as fast as it can. Its
+ * windows are never shown or presented to, and audio is rendered to the
+ * #RBTK_AUDIO_OUTPUT_NULL output. Each frame advances the game by exactly
+ * one tick rather than by the time that has passed. As such, a game fed
+ * the same input (e.g., by replaying a recording) runs the same every
+ * time, regardless of how fast the machine is.
+ *
+ * This is meant for measuring the cost of game logic, independent of the
+ * GPU and V-sync. Once the game stops, the time it spent updating and
+ * rendering can be queried.
+ *
+ * No display server or monitor is needed, so this can run on a build
+ * server. Sprites and scenes are still OpenGL objects, so contexts are
+ * created with the null platform of GLFW and the surfaceless platform of
+ * EGL. This requires a driver which supports the latter, such as Mesa.
+ *
+ * @attention This must be called before the engine is initialized.
+ *
+ * @param[in] frames The number of frames to run, `0` to run normally.
+ * @return `true` on success, `false` on failure.
+ *
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE, If the engine is already
+ *                                    initialized.}
+ * @enderrors
+ *
+ * @see rbtk_get_headless_report(void)
+ * @see rbtk_set_game_tick_rate(RBTK_GAME *, long double)
+ */
+RBTK_NO_DISCARD bool
+rbtk_set_engine_headless(size_t frames);
+
+/*!
+ * @brief Returns if the engine runs games headless.
+ *
+ * @return `true` if games are run headless, `false` otherwise.
+ *
+ * @see rbtk_set_engine_headless(size_t)
+ */
+RBTK_NO_DISCARD bool
+rbtk_engine_is_headless(void);
+
+/*!
+ * @brief Returns the results of the last game run headless.
+ *
+ * @return The results of the last game run headless. If no game has been
+ * run headless, every field is zero.
+ *
+ * @see rbtk_set_engine_headless(size_t)
+ */
+RBTK_NO_DISCARD rbtk_headless_report
+rbtk_get_headless_report(void);
+
 /*!
  * @brief Returns if a game is running.
  *
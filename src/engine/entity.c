@@ -0,0 +1,458 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "entity.h"
+#include "./private/entity.h"
+#include "./private/graphics.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "animation.h"
+#include "broadphase.h"
+#include "graphics.h"
+
+#include "../runtime/common.h"
+
+#define SLOT_MASK      ((uint32_t) RBTK_MAX_ENTITIES - 1)
+#define MAX_GENERATION (UINT32_MAX >> RBTK_ENTITY_SLOT_BITS)
+
+#define HANDLE(_slot, _generation) \
+    ((rbtk_entity) (((_generation) << RBTK_ENTITY_SLOT_BITS) | (_slot)))
+
+RBTK_NO_DISCARD RBTK_WORLD *
+rbtk_create_world(size_t max_entities)
+{
+    assert(max_entities > 0);
+    assert(max_entities <= RBTK_MAX_ENTITIES);
+
+    RBTK_WORLD *world = NULL;
+    RBTK_MALLOC_OR_RETURN(&world, NULL,
+        "could not allocate memory for world");
+
+    RBTK_ZERO_MEMORY(world);
+    world->max_entities = max_entities;
+
+    size_t n = max_entities;
+    world->generations = calloc(n, sizeof(*world->generations));
+    world->dense = calloc(n, sizeof(*world->dense));
+    world->free_slots = calloc(n, sizeof(*world->free_slots));
+    world->entities = calloc(n, sizeof(*world->entities));
+    world->components = calloc(n, sizeof(*world->components));
+    world->x = calloc(n, sizeof(*world->x));
+    world->y = calloc(n, sizeof(*world->y));
+    world->prev_x = calloc(n, sizeof(*world->prev_x));
+    world->prev_y = calloc(n, sizeof(*world->prev_y));
+    world->vel_x = calloc(n, sizeof(*world->vel_x));
+    world->vel_y = calloc(n, sizeof(*world->vel_y));
+    world->sprites = calloc(n, sizeof(*world->sprites));
+    world->animes = calloc(n, sizeof(*world->animes));
+    world->half_width = calloc(n, sizeof(*world->half_width));
+    world->half_height = calloc(n, sizeof(*world->half_height));
+
+    if (!world->generations || !world->dense || !world->free_slots
+        || !world->entities || !world->components
+        || !world->x || !world->y || !world->prev_x || !world->prev_y
+        || !world->vel_x || !world->vel_y
+        || !world->sprites || !world->animes
+        || !world->half_width || !world->half_height) {
+        rbtk_destroy_world(world);
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate memory for entity components");
+        return NULL;
+    }
+
+    /*
+     * Slots are pushed in reverse, so the first entities created take the
+     * lowest slots. Generations start at one, so no handle is ever equal
+     * to RBTK_NO_ENTITY.
+     */
+    for (size_t i = 0; i < n; i++) {
+        world->generations[i] = 1;
+        world->free_slots[i] = (uint32_t) (n - 1 - i);
+    }
+    world->free_count = n;
+
+    return world;
+}
+
+void
+rbtk_destroy_world(RBTK_WORLD *world)
+{
+    if (!world) {
+        return;
+    }
+
+    free(world->generations);
+    free(world->dense);
+    free(world->free_slots);
+    free(world->entities);
+    free(world->components);
+    free(world->x);
+    free(world->y);
+    free(world->prev_x);
+    free(world->prev_y);
+    free(world->vel_x);
+    free(world->vel_y);
+    free(world->sprites);
+    free(world->animes);
+    free(world->half_width);
+    free(world->half_height);
+    free(world);
+}
+
+RBTK_NO_DISCARD rbtk_entity
+rbtk_create_entity(RBTK_WORLD *world, float x, float y)
+{
+    assert(world);
+
+    if (world->free_count == 0) {
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "max entity count reached");
+        return RBTK_NO_ENTITY;
+    }
+
+    world->free_count -= 1;
+    uint32_t slot = world->free_slots[world->free_count];
+    rbtk_entity entity = HANDLE(slot, world->generations[slot]);
+
+    size_t index = world->count;
+    world->dense[slot] = (uint32_t) index;
+    world->count += 1;
+
+    world->entities[index] = entity;
+    world->components[index] = 0;
+    world->x[index] = x;
+    world->y[index] = y;
+    world->prev_x[index] = x;
+    world->prev_y[index] = y;
+    world->vel_x[index] = 0.0f;
+    world->vel_y[index] = 0.0f;
+    world->sprites[index] = NULL;
+    world->animes[index] = RBTK_NO_ANIME;
+    world->half_width[index] = 0.0f;
+    world->half_height[index] = 0.0f;
+
+    return entity;
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_get_entity_index(const RBTK_WORLD *world, rbtk_entity entity)
+{
+    assert(world);
+
+    uint32_t slot = entity & SLOT_MASK;
+    uint32_t generation = entity >> RBTK_ENTITY_SLOT_BITS;
+    if (entity == RBTK_NO_ENTITY || slot >= world->max_entities
+        || world->generations[slot] != generation) {
+        return SIZE_MAX;
+    }
+
+    /*
+     * A matching generation is not enough on its own. A slot which has
+     * never been used also has a generation of one, so a forged handle
+     * could match it. The entity at the index must be the same handle.
+     */
+    uint32_t index = world->dense[slot];
+    if (index >= world->count || world->entities[index] != entity) {
+        return SIZE_MAX;
+    }
+    return index;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_entity_exists(const RBTK_WORLD *world, rbtk_entity entity)
+{
+    return rbtk_get_entity_index(world, entity) != SIZE_MAX;
+}
+
+static void
+move_entity(RBTK_WORLD *world, size_t from, size_t to)
+{
+    rbtk_entity entity = world->entities[from];
+    world->dense[entity & SLOT_MASK] = (uint32_t) to;
+
+    world->entities[to] = entity;
+    world->components[to] = world->components[from];
+    world->x[to] = world->x[from];
+    world->y[to] = world->y[from];
+    world->prev_x[to] = world->prev_x[from];
+    world->prev_y[to] = world->prev_y[from];
+    world->vel_x[to] = world->vel_x[from];
+    world->vel_y[to] = world->vel_y[from];
+    world->sprites[to] = world->sprites[from];
+    world->animes[to] = world->animes[from];
+    world->half_width[to] = world->half_width[from];
+    world->half_height[to] = world->half_height[from];
+}
+
+void
+rbtk_destroy_entity(RBTK_WORLD *world, rbtk_entity entity)
+{
+    assert(world);
+
+    size_t index = rbtk_get_entity_index(world, entity);
+    if (index == SIZE_MAX) {
+        return; /* already destroyed */
+    }
+
+    /*
+     * The last entity is moved into the hole left by this one. This keeps
+     * the arrays packed, at the cost of not keeping entities in order.
+     */
+    size_t last = world->count - 1;
+    if (index != last) {
+        move_entity(world, last, index);
+    }
+    world->count -= 1;
+
+    uint32_t slot = entity & SLOT_MASK;
+    uint32_t generation = world->generations[slot] + 1;
+    world->generations[slot] = generation > MAX_GENERATION ? 1 : generation;
+    world->free_slots[world->free_count] = slot;
+    world->free_count += 1;
+}
+
+RBTK_NO_DISCARD rbtk_entity_arrays
+rbtk_get_entity_arrays(RBTK_WORLD *world)
+{
+    assert(world);
+
+    rbtk_entity_arrays arrays;
+    arrays.count = world->count;
+    arrays.entities = world->entities;
+    arrays.components = world->components;
+    arrays.x = world->x;
+    arrays.y = world->y;
+    arrays.prev_x = world->prev_x;
+    arrays.prev_y = world->prev_y;
+    arrays.vel_x = world->vel_x;
+    arrays.vel_y = world->vel_y;
+    arrays.sprites = world->sprites;
+    arrays.animes = world->animes;
+    arrays.half_width = world->half_width;
+    arrays.half_height = world->half_height;
+    return arrays;
+}
+
+bool
+rbtk_set_entity_velocity(RBTK_WORLD *world, rbtk_entity entity,
+    float vel_x, float vel_y)
+{
+    assert(world);
+
+    size_t index = rbtk_get_entity_index(world, entity);
+    if (index == SIZE_MAX) {
+        return false;
+    }
+
+    world->vel_x[index] = vel_x;
+    world->vel_y[index] = vel_y;
+    world->components[index] |= RBTK_COMPONENT_VELOCITY;
+    return true;
+}
+
+bool
+rbtk_set_entity_sprite(RBTK_WORLD *world, rbtk_entity entity,
+    RBTK_SPRITE *sprite)
+{
+    assert(world);
+    assert(sprite);
+
+    size_t index = rbtk_get_entity_index(world, entity);
+    if (index == SIZE_MAX) {
+        return false;
+    }
+
+    world->sprites[index] = sprite;
+    world->components[index] |= RBTK_COMPONENT_SPRITE;
+    return true;
+}
+
+bool
+rbtk_set_entity_anime(RBTK_WORLD *world, rbtk_entity entity, size_t anime)
+{
+    assert(world);
+    assert(anime != RBTK_NO_ANIME);
+
+    size_t index = rbtk_get_entity_index(world, entity);
+    if (index == SIZE_MAX) {
+        return false;
+    }
+
+    world->animes[index] = anime;
+    world->components[index] |= RBTK_COMPONENT_ANIME;
+    return true;
+}
+
+bool
+rbtk_set_entity_collider(RBTK_WORLD *world, rbtk_entity entity,
+    float half_width, float half_height)
+{
+    assert(world);
+    assert(half_width > 0.0f && half_height > 0.0f);
+
+    size_t index = rbtk_get_entity_index(world, entity);
+    if (index == SIZE_MAX) {
+        return false;
+    }
+
+    world->half_width[index] = half_width;
+    world->half_height[index] = half_height;
+    world->components[index] |= RBTK_COMPONENT_COLLIDER;
+    return true;
+}
+
+bool
+rbtk_remove_entity_components(RBTK_WORLD *world, rbtk_entity entity,
+    unsigned int components)
+{
+    assert(world);
+
+    size_t index = rbtk_get_entity_index(world, entity);
+    if (index == SIZE_MAX) {
+        return false;
+    }
+
+    /*
+     * The data of a removed component is cleared, so systems which go
+     * over every entity without checking its components (such as moving
+     * them) have nothing to act on.
+     */
+    if (components & RBTK_COMPONENT_VELOCITY) {
+        world->vel_x[index] = 0.0f;
+        world->vel_y[index] = 0.0f;
+    }
+    if (components & RBTK_COMPONENT_SPRITE) {
+        world->sprites[index] = NULL;
+    }
+    if (components & RBTK_COMPONENT_ANIME) {
+        world->animes[index] = RBTK_NO_ANIME;
+    }
+    if (components & RBTK_COMPONENT_COLLIDER) {
+        world->half_width[index] = 0.0f;
+        world->half_height[index] = 0.0f;
+    }
+
+    world->components[index] &= (uint8_t) ~components;
+    return true;
+}
+
+void
+rbtk_move_entities(RBTK_WORLD *world)
+{
+    assert(world);
+
+    size_t count = world->count;
+    float *x = world->x;
+    float *y = world->y;
+    const float *vel_x = world->vel_x;
+    const float *vel_y = world->vel_y;
+
+    /*
+     * Entities without a velocity have one of zero, so every entity can be
+     * moved without checking its components first.
+     */
+    memcpy(world->prev_x, x, count * sizeof(*x));
+    memcpy(world->prev_y, y, count * sizeof(*y));
+    for (size_t i = 0; i < count; i++) {
+        x[i] += vel_x[i];
+        y[i] += vel_y[i];
+    }
+}
+
+/*
+ * This mirrors how the sprite renderer places the section of a sprite, so
+ * nothing which could be seen is skipped.
+ */
+static bool
+sprite_in_view(const RBTK_SPRITE *sprite, float x, float y,
+    const rbtk_box *view)
+{
+    if (sprite->rotation.x != 0.0f || sprite->rotation.y != 0.0f
+        || sprite->rotation.z != 0.0f) {
+        return true;
+    }
+
+    float translate_x = x - sprite->section.x;
+    float translate_y = y - sprite->section.y;
+    float scale_x = sprite->scale.x;
+    float scale_y = sprite->scale.y;
+    if (sprite->flipped.horizontally) {
+        scale_x *= -1.0f;
+        translate_x += sprite->section.width;
+    }
+    if (sprite->flipped.vertically) {
+        scale_y *= -1.0f;
+        translate_y += sprite->section.height;
+    }
+
+    float left = translate_x + scale_x * sprite->section.x;
+    float top = translate_y + scale_y * sprite->section.y;
+    float right = left + scale_x * sprite->section.width;
+    float bottom = top + scale_y * sprite->section.height;
+
+    return fmaxf(left, right) > view->min_x
+        && fminf(left, right) < view->max_x
+        && fmaxf(top, bottom) > view->min_y
+        && fminf(top, bottom) < view->max_y;
+}
+
+void
+rbtk_draw_entities(RBTK_GRAPHICS *scene, RBTK_WORLD *world,
+    const RBTK_ANIME_SET *set, const rbtk_box *view, float alpha)
+{
+    assert(scene);
+    assert(world);
+
+    for (size_t i = 0; i < world->count; i++) {
+        uint8_t components = world->components[i];
+        if (!(components & (RBTK_COMPONENT_SPRITE | RBTK_COMPONENT_ANIME))) {
+            continue;
+        }
+
+        float x = world->prev_x[i]
+            + (world->x[i] - world->prev_x[i]) * alpha;
+        float y = world->prev_y[i]
+            + (world->y[i] - world->prev_y[i]) * alpha;
+
+        if (components & RBTK_COMPONENT_SPRITE) {
+            RBTK_SPRITE *sprite = world->sprites[i];
+            if (!view || sprite_in_view(sprite, x, y, view)) {
+                rbtk_draw_sprite(scene, sprite, x, y, 0.0f);
+            }
+        }
+        else {
+            assert(set);
+            size_t anime = world->animes[i];
+            RBTK_SPRITE *sprite = rbtk_get_anime_sprite(set, anime);
+            if (!view || sprite_in_view(sprite, x, y, view)) {
+                rbtk_draw_anime(scene, set, anime, x, y, 0.0f);
+            }
+        }
+    }
+}
@@ -0,0 +1,371 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_ENTITY_H_
+#define RBTK_ENGINE_ENTITY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+ * @file
+ * @brief The public API for the game engine's entity module.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "animation.h"
+#include "graphics.h"
+
+#include "../runtime/common.h"
+#include "../runtime/error.h"
+
+/* from broadphase.h, which includes this header */
+RBTK_FORWARD_DECLARATION
+typedef struct rbtk_box rbtk_box;
+
+/*!
+ * @defgroup engine_entity Entities
+ * @brief The game engine's entity module.
+ *
+ * An entity is an object in a game world, such as a ring or a badnik. A
+ * world does not store entities as structs. Rather, each component of an
+ * entity (e.g., its position) is stored in its own array, with the data
+ * for every entity packed together at the front. Code which goes over
+ * every entity (a system) only touches the arrays it needs, one after the
+ * other. This keeps hundreds of entities cheap to update each frame.
+ *
+ * Since entities are moved around in these arrays as others are destroyed,
+ * they are referred to by handles rather than by index. A handle holds the
+ * slot of the entity, and a generation which changes every time the slot
+ * is reused. As such, a handle to a destroyed entity never refers to a new
+ * one by accident.
+ *
+ * @see rbtk_create_world(size_t)
+ * @see rbtk_get_entity_arrays(RBTK_WORLD *)
+ *
+ * @{
+ */
+
+/*!
+ * @brief The number of bits in an entity handle used for its slot.
+ *
+ * The rest of the bits are used for its generation.
+ */
+#define RBTK_ENTITY_SLOT_BITS 20
+
+/*!
+ * @brief The maximum number of entities in a world.
+ */
+#define RBTK_MAX_ENTITIES ((size_t) 1 << RBTK_ENTITY_SLOT_BITS)
+
+/*!
+ * @brief A handle which never refers to an entity.
+ */
+#define RBTK_NO_ENTITY ((rbtk_entity) 0)
+
+/*!
+ * @brief A handle to an entity.
+ *
+ * @see rbtk_create_entity(RBTK_WORLD *, float, float)
+ */
+typedef uint32_t rbtk_entity;
+
+/*!
+ * @brief A collection of entities.
+ *
+ * @see rbtk_create_world(size_t)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_WORLD RBTK_WORLD;
+
+/*!
+ * @brief The components an entity can have.
+ *
+ * Every entity has a position. The other components are optional, and
+ * can be combined with a bitwise OR.
+ */
+typedef enum rbtk_component {
+    RBTK_COMPONENT_VELOCITY = 0x01, /*!< Moved every tick.              */
+    RBTK_COMPONENT_SPRITE   = 0x02, /*!< Drawn as a sprite.             */
+    RBTK_COMPONENT_ANIME    = 0x04, /*!< Drawn from an animation set.   */
+    RBTK_COMPONENT_COLLIDER = 0x08, /*!< Has a box to collide with.     */
+} rbtk_component;
+
+/*!
+ * @brief The component arrays of a world.
+ *
+ * Index `i` of every array belongs to the same entity. Only the first
+ * `count` elements of each array are in use. The data for a component
+ * which an entity does not have is left at zero (or `NULL`).
+ *
+ * @attention Creating or destroying entities moves them around in these
+ * arrays. A system which destroys entities as it goes should do so while
+ * going over them backwards.
+ *
+ * @see rbtk_get_entity_arrays(RBTK_WORLD *)
+ */
+typedef struct rbtk_entity_arrays {
+    size_t count;                /*!< The number of entities.            */
+    const rbtk_entity *entities; /*!< The handle of each entity.         */
+    const uint8_t *components;   /*!< Which components each one has.     */
+    float *x;                    /*!< The position on the X-axis.        */
+    float *y;                    /*!< The position on the Y-axis.        */
+    float *prev_x;               /*!< The X position before the move.    */
+    float *prev_y;               /*!< The Y position before the move.    */
+    float *vel_x;                /*!< The velocity on the X-axis.        */
+    float *vel_y;                /*!< The velocity on the Y-axis.        */
+    RBTK_SPRITE **sprites;       /*!< The sprite drawn for each one.     */
+    size_t *animes;              /*!< The animation in the drawn set.    */
+    float *half_width;           /*!< Half the width of the collider.    */
+    float *half_height;          /*!< Half the height of the collider.   */
+} rbtk_entity_arrays;
+
+/*!
+ * @brief Creates a world.
+ *
+ * @param[in] max_entities The max number of entities in the world.
+ * @return The created world, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until it is destroyed
+ * with #rbtk_destroy_world(RBTK_WORLD *).
+ *
+ * @debugging This function asserts that `max_entities` is not `0` and
+ * is not greater than #RBTK_MAX_ENTITIES.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If memory for the world could not
+ *                                    be allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD RBTK_WORLD *
+rbtk_create_world(size_t max_entities);
+
+/*!
+ * @brief Destroys a world and every entity in it.
+ *
+ * @param[in] world The world to destroy. If `NULL`, this function is a
+ *                  no-op.
+ */
+void
+rbtk_destroy_world(RBTK_WORLD *world);
+
+/*!
+ * @brief Creates an entity.
+ *
+ * @param[in] world The world to create the entity in.
+ * @param[in] x     The X-axis position of the entity.
+ * @param[in] y     The Y-axis position of the entity.
+ * @return The handle of the entity, #RBTK_NO_ENTITY on failure.
+ *
+ * @debugging This function asserts that `world` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If the world already has its max
+ *                                    number of entities.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD rbtk_entity
+rbtk_create_entity(RBTK_WORLD *world, float x, float y);
+
+/*!
+ * @brief Destroys an entity.
+ *
+ * @note If the entity was already destroyed, this function is a no-op.
+ *
+ * @param[in] world  The world the entity is in.
+ * @param[in] entity The entity to destroy.
+ *
+ * @debugging This function asserts that `world` is not `NULL`.
+ */
+void
+rbtk_destroy_entity(RBTK_WORLD *world, rbtk_entity entity);
+
+/*!
+ * @brief Returns if an entity still exists.
+ *
+ * @param[in] world  The world the entity is in.
+ * @param[in] entity The entity to check.
+ * @return `true` if the entity exists, `false` otherwise.
+ *
+ * @debugging This function asserts that `world` is not `NULL`.
+ */
+RBTK_NO_DISCARD bool
+rbtk_entity_exists(const RBTK_WORLD *world, rbtk_entity entity);
+
+/*!
+ * @brief Returns where an entity is in the component arrays.
+ *
+ * @param[in] world  The world the entity is in.
+ * @param[in] entity The entity to find.
+ * @return The index of the entity, `SIZE_MAX` if it does not exist.
+ *
+ * @debugging This function asserts that `world` is not `NULL`.
+ *
+ * @see rbtk_get_entity_arrays(RBTK_WORLD *)
+ */
+RBTK_NO_DISCARD size_t
+rbtk_get_entity_index(const RBTK_WORLD *world, rbtk_entity entity);
+
+/*!
+ * @brief Returns the component arrays of a world.
+ *
+ * @param[in] world The world to query.
+ * @return The component arrays.
+ *
+ * @pointer_lifetime The arrays are valid until the world is destroyed.
+ * However, the count is not updated as entities are created or destroyed.
+ *
+ * @debugging This function asserts that `world` is not `NULL`.
+ */
+RBTK_NO_DISCARD rbtk_entity_arrays
+rbtk_get_entity_arrays(RBTK_WORLD *world);
+
+/*!
+ * @brief Sets the velocity of an entity.
+ *
+ * @param[in] world  The world the entity is in.
+ * @param[in] entity The entity to update.
+ * @param[in] vel_x  How far to move on the X-axis each tick.
+ * @param[in] vel_y  How far to move on the Y-axis each tick.
+ * @return `true` on success, `false` if the entity does not exist.
+ *
+ * @debugging This function asserts that `world` is not `NULL`.
+ */
+bool
+rbtk_set_entity_velocity(RBTK_WORLD *world, rbtk_entity entity,
+    float vel_x, float vel_y);
+
+/*!
+ * @brief Sets the sprite an entity is drawn as.
+ *
+ * @param[in] world  The world the entity is in.
+ * @param[in] entity The entity to update.
+ * @param[in] sprite The sprite to draw.
+ * @return `true` on success, `false` if the entity does not exist.
+ *
+ * @debugging This function asserts that `world` and `sprite` are not
+ * `NULL`.
+ */
+bool
+rbtk_set_entity_sprite(RBTK_WORLD *world, rbtk_entity entity,
+    RBTK_SPRITE *sprite);
+
+/*!
+ * @brief Sets the animation an entity is drawn as.
+ *
+ * @param[in] world  The world the entity is in.
+ * @param[in] entity The entity to update.
+ * @param[in] anime  The index of the animation in the set the world is
+ *                   drawn with.
+ * @return `true` on success, `false` if the entity does not exist.
+ *
+ * @debugging This function asserts that `world` is not `NULL` and that
+ * `anime` is not #RBTK_NO_ANIME.
+ *
+ * @see rbtk_draw_entities(RBTK_GRAPHICS *, RBTK_WORLD *,
+ *      const RBTK_ANIME_SET *, const rbtk_box *, float)
+ */
+bool
+rbtk_set_entity_anime(RBTK_WORLD *world, rbtk_entity entity, size_t anime);
+
+/*!
+ * @brief Sets the collider of an entity.
+ *
+ * The collider is a box centered on the position of the entity.
+ *
+ * @param[in] world       The world the entity is in.
+ * @param[in] entity      The entity to update.
+ * @param[in] half_width  Half the width of the box.
+ * @param[in] half_height Half the height of the box.
+ * @return `true` on success, `false` if the entity does not exist.
+ *
+ * @debugging This function asserts that `world` is not `NULL` and that
+ * the box has a positive size.
+ */
+bool
+rbtk_set_entity_collider(RBTK_WORLD *world, rbtk_entity entity,
+    float half_width, float half_height);
+
+/*!
+ * @brief Removes components from an entity.
+ *
+ * @param[in] world      The world the entity is in.
+ * @param[in] entity     The entity to update.
+ * @param[in] components The components to remove, a combination of values
+ *                       from #rbtk_component.
+ * @return `true` on success, `false` if the entity does not exist.
+ *
+ * @debugging This function asserts that `world` is not `NULL`.
+ */
+bool
+rbtk_remove_entity_components(RBTK_WORLD *world, rbtk_entity entity,
+    unsigned int components);
+
+/*!
+ * @brief Moves every entity in a world by its velocity.
+ *
+ * This should be called once per tick. The position of every entity from
+ * before the move is kept, so it can be drawn between the two.
+ *
+ * @param[in] world The world to update.
+ *
+ * @debugging This function asserts that `world` is not `NULL`.
+ */
+void
+rbtk_move_entities(RBTK_WORLD *world);
+
+/*!
+ * @brief Draws every entity in a world which has a sprite or animation.
+ *
+ * Each entity is drawn between its position before and after the last
+ * move, according to `alpha` (which is given to the render functions of a
+ * game). Entities whose sprite is entirely outside of `view` are skipped.
+ * A rotated sprite is never skipped, as its size no longer says where it
+ * ends up.
+ *
+ * @param[in] scene The scene to draw to.
+ * @param[in] world The world to draw.
+ * @param[in] set   The set the animations of entities are in. This may be
+ *                  `NULL` if no entity has an animation.
+ * @param[in] view  What can be seen, in world space (e.g., the rect of a
+ *                  camera view). If `NULL`, every entity is drawn.
+ * @param[in] alpha How far the game is between the last tick and the next.
+ *
+ * @debugging This function asserts that `scene` and `world` are not
+ * `NULL`.
+ *
+ * @see rbtk_get_camera_view(const RBTK_CAMERA_CONTROLLER *)
+ */
+void
+rbtk_draw_entities(RBTK_GRAPHICS *scene, RBTK_WORLD *world,
+    const RBTK_ANIME_SET *set, const rbtk_box *view, float alpha);
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_ENTITY_H_ */
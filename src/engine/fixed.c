@@ -0,0 +1,185 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "fixed.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "../runtime/common.h"
+
+/*
+ * The sine of every angle, as 16.16 fixed-point. The cosine is the same
+ * table, a quarter turn ahead.
+ */
+static const rbtk_fixed sin_table[256] = {
+          0,    1608,    3216,    4821,    6424,    8022,    9616,   11204,
+      12785,   14359,   15924,   17479,   19024,   20557,   22078,   23586,
+      25080,   26558,   28020,   29466,   30893,   32303,   33692,   35062,
+      36410,   37736,   39040,   40320,   41576,   42806,   44011,   45190,
+      46341,   47464,   48559,   49624,   50660,   51665,   52639,   53581,
+      54491,   55368,   56212,   57022,   57798,   58538,   59244,   59914,
+      60547,   61145,   61705,   62228,   62714,   63162,   63572,   63944,
+      64277,   64571,   64827,   65043,   65220,   65358,   65457,   65516,
+      65536,   65516,   65457,   65358,   65220,   65043,   64827,   64571,
+      64277,   63944,   63572,   63162,   62714,   62228,   61705,   61145,
+      60547,   59914,   59244,   58538,   57798,   57022,   56212,   55368,
+      54491,   53581,   52639,   51665,   50660,   49624,   48559,   47464,
+      46341,   45190,   44011,   42806,   41576,   40320,   39040,   37736,
+      36410,   35062,   33692,   32303,   30893,   29466,   28020,   26558,
+      25080,   23586,   22078,   20557,   19024,   17479,   15924,   14359,
+      12785,   11204,    9616,    8022,    6424,    4821,    3216,    1608,
+          0,   -1608,   -3216,   -4821,   -6424,   -8022,   -9616,  -11204,
+     -12785,  -14359,  -15924,  -17479,  -19024,  -20557,  -22078,  -23586,
+     -25080,  -26558,  -28020,  -29466,  -30893,  -32303,  -33692,  -35062,
+     -36410,  -37736,  -39040,  -40320,  -41576,  -42806,  -44011,  -45190,
+     -46341,  -47464,  -48559,  -49624,  -50660,  -51665,  -52639,  -53581,
+     -54491,  -55368,  -56212,  -57022,  -57798,  -58538,  -59244,  -59914,
+     -60547,  -61145,  -61705,  -62228,  -62714,  -63162,  -63572,  -63944,
+     -64277,  -64571,  -64827,  -65043,  -65220,  -65358,  -65457,  -65516,
+     -65536,  -65516,  -65457,  -65358,  -65220,  -65043,  -64827,  -64571,
+     -64277,  -63944,  -63572,  -63162,  -62714,  -62228,  -61705,  -61145,
+     -60547,  -59914,  -59244,  -58538,  -57798,  -57022,  -56212,  -55368,
+     -54491,  -53581,  -52639,  -51665,  -50660,  -49624,  -48559,  -47464,
+     -46341,  -45190,  -44011,  -42806,  -41576,  -40320,  -39040,  -37736,
+     -36410,  -35062,  -33692,  -32303,  -30893,  -29466,  -28020,  -26558,
+     -25080,  -23586,  -22078,  -20557,  -19024,  -17479,  -15924,  -14359,
+     -12785,  -11204,   -9616,   -8022,   -6424,   -4821,   -3216,   -1608,};
+
+/*
+ * The arctangent of every ratio from 0/256 to 256/256, in 256ths of a turn.
+ * Only the first eighth of a turn is stored, as the rest can be found by
+ * swapping and mirroring the vector.
+ */
+static const uint8_t atan_table[257] = {
+      0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,   4,   5,   5,   5,
+      5,   5,   5,   6,   6,   6,   6,   6,   6,   6,   7,   7,   7,   7,   7,   7,
+      8,   8,   8,   8,   8,   8,   8,   9,   9,   9,   9,   9,   9,  10,  10,  10,
+     10,  10,  10,  10,  11,  11,  11,  11,  11,  11,  11,  12,  12,  12,  12,  12,
+     12,  12,  13,  13,  13,  13,  13,  13,  13,  14,  14,  14,  14,  14,  14,  14,
+     15,  15,  15,  15,  15,  15,  15,  16,  16,  16,  16,  16,  16,  16,  17,  17,
+     17,  17,  17,  17,  17,  17,  18,  18,  18,  18,  18,  18,  18,  19,  19,  19,
+     19,  19,  19,  19,  19,  20,  20,  20,  20,  20,  20,  20,  20,  21,  21,  21,
+     21,  21,  21,  21,  21,  21,  22,  22,  22,  22,  22,  22,  22,  22,  23,  23,
+     23,  23,  23,  23,  23,  23,  23,  24,  24,  24,  24,  24,  24,  24,  24,  24,
+     25,  25,  25,  25,  25,  25,  25,  25,  25,  25,  26,  26,  26,  26,  26,  26,
+     26,  26,  26,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  28,  28,  28,
+     28,  28,  28,  28,  28,  28,  28,  28,  29,  29,  29,  29,  29,  29,  29,  29,
+     29,  29,  29,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  31,  31,
+     31,  31,  31,  31,  31,  31,  31,  31,  31,  31,  32,  32,  32,  32,  32,  32,
+     32,};
+
+/*
+ * Shifting a negative number right is implementation-defined in C. This
+ * always rounds down, which is what the original hardware did.
+ */
+static int64_t
+shift_right(int64_t value, unsigned bits)
+{
+    return value < 0 ? ~(~value >> bits) : value >> bits;
+}
+
+RBTK_NO_DISCARD rbtk_fixed
+rbtk_int_to_fixed(int32_t whole)
+{
+    assert(whole >= INT16_MIN && whole <= INT16_MAX);
+    return (rbtk_fixed) (whole * RBTK_FIXED_ONE);
+}
+
+RBTK_NO_DISCARD int32_t
+rbtk_fixed_to_int(rbtk_fixed value)
+{
+    return (int32_t) shift_right(value, RBTK_FIXED_SHIFT);
+}
+
+RBTK_NO_DISCARD float
+rbtk_fixed_to_float(rbtk_fixed value)
+{
+    return (float) value / (float) RBTK_FIXED_ONE;
+}
+
+RBTK_NO_DISCARD rbtk_fixed
+rbtk_fixed_mul(rbtk_fixed a, rbtk_fixed b)
+{
+    int64_t product = (int64_t) a * (int64_t) b;
+    return (rbtk_fixed) (uint32_t) shift_right(product, RBTK_FIXED_SHIFT);
+}
+
+RBTK_NO_DISCARD rbtk_fixed
+rbtk_fixed_div(rbtk_fixed a, rbtk_fixed b)
+{
+    assert(b != 0);
+    int64_t quotient = ((int64_t) a * RBTK_FIXED_ONE) / b;
+    return (rbtk_fixed) (uint32_t) quotient;
+}
+
+RBTK_NO_DISCARD rbtk_fixed
+rbtk_fixed_abs(rbtk_fixed value)
+{
+    if (value == INT32_MIN) {
+        return INT32_MAX; /* the negation does not fit */
+    }
+    return value < 0 ? -value : value;
+}
+
+RBTK_NO_DISCARD rbtk_fixed
+rbtk_fixed_sin(rbtk_fixed_angle angle)
+{
+    return sin_table[angle];
+}
+
+RBTK_NO_DISCARD rbtk_fixed
+rbtk_fixed_cos(rbtk_fixed_angle angle)
+{
+    return sin_table[(uint8_t) (angle + 0x40)];
+}
+
+RBTK_NO_DISCARD rbtk_fixed_angle
+rbtk_fixed_atan2(rbtk_fixed y, rbtk_fixed x)
+{
+    if (x == 0 && y == 0) {
+        return 0x00;
+    }
+
+    int64_t abs_x = x < 0 ? -(int64_t) x : x;
+    int64_t abs_y = y < 0 ? -(int64_t) y : y;
+
+    /* find the angle within the first eighth, then mirror it out */
+    uint8_t angle;
+    if (abs_y <= abs_x) {
+        angle = atan_table[(abs_y * 256) / abs_x];
+    }
+    else {
+        angle = (uint8_t) (0x40 - atan_table[(abs_x * 256) / abs_y]);
+    }
+
+    if (x < 0) {
+        angle = (uint8_t) (0x80 - angle);
+    }
+    if (y < 0) {
+        angle = (uint8_t) (0x100 - angle);
+    }
+
+    return angle;
+}
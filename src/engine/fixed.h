@@ -0,0 +1,188 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_FIXED_H_
+#define RBTK_ENGINE_FIXED_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+ * @file
+ * @brief The public API for the game engine's fixed-point module.
+ */
+
+#include <stdint.h>
+
+#include "../runtime/common.h"
+
+/*!
+ * @defgroup engine_fixed Fixed-Point Math
+ * @brief The game engine's fixed-point math module.
+ *
+ * The physics of the original games was done entirely with integers.
+ * Positions were stored in pixels with sixteen bits of subpixels, and
+ * speeds in pixels with eight bits of subpixels. This module provides the
+ * same arithmetic, so that movement works out exactly as it did there.
+ *
+ * Since every result is an integer, it is also the same on every machine
+ * and with every compiler. This is not the case for floating point, and
+ * is what allows a replay, or a rollback, to play out the same way twice.
+ * The trigonometric functions use lookup tables that are built into the
+ * engine, rather than being worked out at startup, for the same reason.
+ *
+ * All values are 16.16 fixed-point. A speed of `0x0C` in 8.8, such as the
+ * acceleration of Sonic, is `0x0C00` here.
+ *
+ * @see rbtk_fixed
+ *
+ * @{
+ */
+
+/*!
+ * @brief A number with 16 bits of whole part and 16 bits of fraction.
+ */
+typedef int32_t rbtk_fixed;
+
+/*!
+ * @brief The number of bits in the fraction of an #rbtk_fixed.
+ */
+#define RBTK_FIXED_SHIFT 16
+
+/*!
+ * @brief The #rbtk_fixed for one.
+ */
+#define RBTK_FIXED_ONE ((rbtk_fixed) 0x10000)
+
+/*!
+ * @brief An angle, in 256ths of a full turn.
+ *
+ * An angle of `0x00` points along the positive X-axis, and `0x40` points
+ * along the positive Y-axis. This is the same as #rbtk_tile_angle, which
+ * can be passed for it directly.
+ */
+typedef uint8_t rbtk_fixed_angle;
+
+/*!
+ * @brief Converts a whole number to fixed-point.
+ *
+ * @param[in] whole The whole number to convert. This must fit in 16 bits.
+ * @return The number as fixed-point.
+ */
+RBTK_NO_DISCARD rbtk_fixed
+rbtk_int_to_fixed(int32_t whole);
+
+/*!
+ * @brief Gets the whole part of a fixed-point number.
+ *
+ * @param[in] value The number.
+ * @return The largest whole number that is not greater than @p value.
+ *         That is, this always rounds down, even for negative numbers.
+ */
+RBTK_NO_DISCARD int32_t
+rbtk_fixed_to_int(rbtk_fixed value);
+
+/*!
+ * @brief Converts a fixed-point number to floating point.
+ *
+ * @param[in] value The number to convert.
+ * @return The number as a `float`.
+ * @note This is meant for drawing. The result should never be fed back
+ *       into anything which has to be deterministic.
+ */
+RBTK_NO_DISCARD float
+rbtk_fixed_to_float(rbtk_fixed value);
+
+/*!
+ * @brief Multiplies two fixed-point numbers.
+ *
+ * @param[in] a The first number.
+ * @param[in] b The second number.
+ * @return The product of @p a and @p b, rounded down. If this does not
+ *         fit in an #rbtk_fixed, only its lower 32 bits are kept.
+ */
+RBTK_NO_DISCARD rbtk_fixed
+rbtk_fixed_mul(rbtk_fixed a, rbtk_fixed b);
+
+/*!
+ * @brief Divides two fixed-point numbers.
+ *
+ * @param[in] a The dividend.
+ * @param[in] b The divisor. This must not be zero.
+ * @return The quotient of @p a and @p b, rounded towards zero. If this
+ *         does not fit in an #rbtk_fixed, only its lower 32 bits are kept.
+ */
+RBTK_NO_DISCARD rbtk_fixed
+rbtk_fixed_div(rbtk_fixed a, rbtk_fixed b);
+
+/*!
+ * @brief Gets the absolute value of a fixed-point number.
+ *
+ * @param[in] value The number.
+ * @return The absolute value of @p value. As the absolute value of the
+ *         lowest number does not fit in an #rbtk_fixed, it is saturated to
+ *         the highest number instead.
+ */
+RBTK_NO_DISCARD rbtk_fixed
+rbtk_fixed_abs(rbtk_fixed value);
+
+/*!
+ * @brief Gets the sine of an angle.
+ *
+ * @param[in] angle The angle.
+ * @return The sine of @p angle, between `-RBTK_FIXED_ONE` and
+ *         `RBTK_FIXED_ONE`.
+ */
+RBTK_NO_DISCARD rbtk_fixed
+rbtk_fixed_sin(rbtk_fixed_angle angle);
+
+/*!
+ * @brief Gets the cosine of an angle.
+ *
+ * @param[in] angle The angle.
+ * @return The cosine of @p angle, between `-RBTK_FIXED_ONE` and
+ *         `RBTK_FIXED_ONE`.
+ */
+RBTK_NO_DISCARD rbtk_fixed
+rbtk_fixed_cos(rbtk_fixed_angle angle);
+
+/*!
+ * @brief Gets the angle of a vector.
+ *
+ * @param[in] y The Y-axis component of the vector.
+ * @param[in] x The X-axis component of the vector.
+ * @return The angle between the positive X-axis and the vector, rounded
+ *         to the nearest 256th of a turn. If both @p x and @p y are zero,
+ *         this is zero.
+ */
+RBTK_NO_DISCARD rbtk_fixed_angle
+rbtk_fixed_atan2(rbtk_fixed y, rbtk_fixed x);
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_FIXED_H_ */
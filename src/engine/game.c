@@ -46,7 +46,18 @@ rbtk_create_game(rbtk_game_funs funs)
     game->funs = funs;
     game->state_count = 0;
     game->current_state = NULL;
+    game->suspended_count = 0;
+    game->suspended_frame.scene = NULL;
+    game->suspended_frame.cache = NULL;
+    game->suspended_frame.valid = false;
     game->last_update = 0;
+    game->tick_ms = 0;
+    game->unsimulated_ms = 0;
+    game->alpha = 1.0f;
+    game->preload.pool = NULL;
+    game->preload.job = NULL;
+    game->preload.state = NULL;
+    game->preload.args = NULL;
     game->running = false;
     game->stopped = false;
 
@@ -78,6 +89,30 @@ rbtk_destroy_game(RBTK_GAME *game)
     return true;
 }
 
+bool
+rbtk_set_game_tick_rate(RBTK_GAME *game, long double rate_hz)
+{
+    assert(game);
+
+    if (rate_hz < 0.0L) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_ARGUMENT,
+            "tick rate cannot be negative");
+        return false;
+    }
+
+    game->tick_ms = rate_hz > 0.0L ? 1000.0L / rate_hz : 0.0L;
+    game->unsimulated_ms = 0;
+    game->alpha = 1.0f;
+    return true;
+}
+
+RBTK_NO_DISCARD long double
+rbtk_get_game_tick_rate(const RBTK_GAME *game)
+{
+    assert(game);
+    return game->tick_ms > 0.0L ? 1000.0L / game->tick_ms : 0.0L;
+}
+
 RBTK_NO_DISCARD RBTK_GAME_STATE *
 rbtk_create_game_state(rbtk_game_state_funs funs)
 {
@@ -134,6 +169,27 @@ rbtk_add_game_state(RBTK_GAME *game, RBTK_GAME_STATE *state)
     return true;
 }
 
+static bool
+game_state_is_suspended(const RBTK_GAME *game, const RBTK_GAME_STATE *state)
+{
+    for (size_t i = 0; i < game->suspended_count; i++) {
+        if (game->suspended[i] == state) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void
+drop_suspended_frame(RBTK_GAME *game)
+{
+    game->suspended_frame.valid = false;
+    if (game->suspended_frame.cache) {
+        rbtk_destroy_scene(game->suspended_frame.cache);
+        game->suspended_frame.cache = NULL;
+    }
+}
+
 bool
 rbtk_enter_game_state(RBTK_GAME *game, RBTK_GAME_STATE *state, void *args)
 {
@@ -144,6 +200,11 @@ rbtk_enter_game_state(RBTK_GAME *game, RBTK_GAME_STATE *state, void *args)
             "game state not a part of game");
         return false;
     }
+    else if (game_state_is_suspended(game, state)) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE,
+            "game state is suspended");
+        return false;
+    }
 
     rbtk_exit_game_state(game);
     if (state->funs.enter) {
@@ -154,18 +215,257 @@ rbtk_enter_game_state(RBTK_GAME *game, RBTK_GAME_STATE *state, void *args)
     return true;
 }
 
+static void
+run_preload_job(void *args)
+{
+    RBTK_GAME *game = args;
+    RBTK_GAME_STATE *state = game->preload.state;
+    state->funs.preload(game, state, game->preload.args);
+}
+
+bool
+rbtk_preload_game_state(RBTK_GAME *game, RBTK_GAME_STATE *state,
+    void *args)
+{
+    assert(game && state);
+
+    if (!rbtk_game_has_game_state(game, state)) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_ARGUMENT,
+            "game state not a part of game");
+        return false;
+    }
+    else if (game->preload.state) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE,
+            "game is already preloading a game state");
+        return false;
+    }
+
+    game->preload.state = state;
+    game->preload.args = args;
+    if (!state->funs.preload) {
+        return true; /* nothing to load, enter on next update */
+    }
+
+    /*
+     * The pool is only created once it is first needed, and kept around
+     * for the next preload. If a job cannot be submitted, the game state
+     * is preloaded on the calling thread instead. This is a stall, but it
+     * is better than never entering the state at all.
+     */
+    if (!game->preload.pool) {
+        game->preload.pool = rbtk_create_thread_pool("game-preload", 1);
+    }
+    if (game->preload.pool) {
+        game->preload.job = rbtk_submit_job(game->preload.pool,
+            run_preload_job, game);
+    }
+    if (!game->preload.job) {
+        run_preload_job(game);
+    }
+
+    return true;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_game_is_preloading(const RBTK_GAME *game)
+{
+    assert(game);
+    return game->preload.state != NULL;
+}
+
+RBTK_PRIVATE void
+priv_rbtk_update_game_preload(RBTK_GAME *game, bool wait)
+{
+    assert(game);
+
+    RBTK_GAME_STATE *state = game->preload.state;
+    if (!state) {
+        return; /* nothing being preloaded */
+    }
+
+    if (game->preload.job) {
+        if (!wait && !rbtk_job_is_done(game->preload.job)) {
+            return; /* keep showing the current state */
+        }
+        rbtk_await_job(game->preload.job);
+        game->preload.job = NULL;
+    }
+
+    void *args = game->preload.args;
+    game->preload.state = NULL;
+    game->preload.args = NULL;
+    rbtk_enter_game_state(game, state, args);
+}
+
+RBTK_PRIVATE void
+priv_rbtk_cancel_game_preload(RBTK_GAME *game)
+{
+    assert(game);
+
+    /*
+     * There is no way to stop a job partway through. The best that can be
+     * done is to wait for it to finish, and then not enter the state.
+     */
+    if (game->preload.job) {
+        rbtk_await_job(game->preload.job);
+        game->preload.job = NULL;
+    }
+    game->preload.state = NULL;
+    game->preload.args = NULL;
+
+    if (game->preload.pool) {
+        rbtk_destroy_thread_pool(game->preload.pool);
+        game->preload.pool = NULL;
+    }
+}
+
 void
 rbtk_exit_game_state(RBTK_GAME *game)
 {
     assert(game);
 
     RBTK_GAME_STATE *state = game->current_state;
-    if (!state) {
-        return;
+    if (state && state->funs.exit) {
+        state->funs.exit(game, state);
+    }
+    game->current_state = NULL;
+
+    while (game->suspended_count > 0) {
+        game->suspended_count -= 1;
+        state = game->suspended[game->suspended_count];
+        game->suspended[game->suspended_count] = NULL;
+        if (state->funs.exit) {
+            state->funs.exit(game, state);
+        }
+    }
+    drop_suspended_frame(game);
+}
+
+bool
+rbtk_push_game_state(RBTK_GAME *game, RBTK_GAME_STATE *state, void *args)
+{
+    assert(game && state);
+
+    if (!rbtk_game_has_game_state(game, state)) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_ARGUMENT,
+            "game state not a part of game");
+        return false;
+    }
+    else if (game->current_state == state
+        || game_state_is_suspended(game, state)) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE,
+            "game state is already current or suspended");
+        return false;
+    }
+
+    /*
+     * Each game state can only be on the stack once. Since there are no
+     * more game states than there are slots, the stack cannot overflow.
+     */
+    RBTK_GAME_STATE *current = game->current_state;
+    if (current) {
+        if (current->funs.suspend) {
+            current->funs.suspend(game, current);
+        }
+        game->suspended[game->suspended_count] = current;
+        game->suspended_count += 1;
+        game->suspended_frame.valid = false;
+    }
+
+    if (state->funs.enter) {
+        state->funs.enter(game, state, args);
     }
+    game->current_state = state;
+
+    return true;
+}
+
+bool
+rbtk_pop_game_state(RBTK_GAME *game)
+{
+    assert(game);
 
-    if (state->funs.exit) {
+    if (game->suspended_count == 0) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE,
+            "no suspended game state to return to");
+        return false;
+    }
+
+    RBTK_GAME_STATE *state = game->current_state;
+    if (state && state->funs.exit) {
         state->funs.exit(game, state);
     }
-    game->current_state = NULL;
+
+    game->suspended_count -= 1;
+    RBTK_GAME_STATE *resumed = game->suspended[game->suspended_count];
+    game->suspended[game->suspended_count] = NULL;
+    game->current_state = resumed;
+
+    /* keep the cached frame around only while it could be used */
+    if (game->suspended_count == 0) {
+        drop_suspended_frame(game);
+    }
+    else {
+        game->suspended_frame.valid = false;
+    }
+
+    if (resumed->funs.resume) {
+        resumed->funs.resume(game, resumed);
+    }
+
+    return true;
+}
+
+void
+rbtk_set_game_scene(RBTK_GAME *game, RBTK_GRAPHICS *scene)
+{
+    assert(game);
+    if (game->suspended_frame.scene != scene) {
+        drop_suspended_frame(game);
+        game->suspended_frame.scene = scene;
+    }
+}
+
+RBTK_PRIVATE void
+priv_rbtk_render_suspended_game_states(RBTK_GAME *game, float alpha)
+{
+    assert(game);
+    if (game->suspended_count == 0) {
+        return; /* nothing suspended */
+    }
+
+    RBTK_GRAPHICS *scene = game->suspended_frame.scene;
+    if (scene && game->suspended_frame.valid) {
+        rbtk_copy_scene(scene, game->suspended_frame.cache);
+        return;
+    }
+
+    for (size_t i = 0; i < game->suspended_count; i++) {
+        RBTK_GAME_STATE *state = game->suspended[i];
+        if (state->funs.render) {
+            state->funs.render(game, state, alpha);
+        }
+    }
+
+    if (!scene) {
+        return; /* nowhere to keep the frame */
+    }
+
+    /*
+     * The cache is the same size as the scene, so copying one to the other
+     * is a single blit. It is only created once there is something to keep,
+     * and is destroyed once nothing is suspended anymore.
+     */
+    if (!game->suspended_frame.cache) {
+        unsigned int width, height;
+        rbtk_get_sprite_size(rbtk_get_scene_sprite(scene), &width, &height);
+        game->suspended_frame.cache = rbtk_create_scene(
+            rbtk_get_scene_projection(scene), width, height);
+        if (!game->suspended_frame.cache) {
+            return; /* try again next frame */
+        }
+    }
+
+    game->suspended_frame.valid =
+        rbtk_copy_scene(game->suspended_frame.cache, scene);
 }
@@ -111,6 +111,7 @@ typedef void (*rbtk_game_stop_fun)(RBTK_GAME *game);
  *
  * @see rbtk_game_state_update_fun(RBTK_GAME *game, RBTK_GAME_STATE *,
  *      long double)
+ * @see rbtk_set_game_tick_rate(RBTK_GAME *, long double)
  */
 typedef void (*rbtk_game_update_fun)(RBTK_GAME *game, long double delta_ms);
 
@@ -122,12 +123,16 @@ typedef void (*rbtk_game_update_fun)(RBTK_GAME *game, long double delta_ms);
  * while post-render variant is invoked after.
  *
  * @param[in] game  The game being rendered.
+ * @param[in] alpha How far along the game is between its last update and
+ *                  the next, from `0` to `1`.
  *
  * @implementation This may be an #RBTK_NO_OP.
  *
- * @see rbtk_game_state_render_fun(RBTK_GAME *game, RBTK_GAME_STATE *)
+ * @see rbtk_game_state_render_fun(RBTK_GAME *game, RBTK_GAME_STATE *,
+ *      float)
+ * @see rbtk_set_game_tick_rate(RBTK_GAME *, long double)
  */
-typedef void (*rbtk_game_render_fun)(RBTK_GAME *game);
+typedef void (*rbtk_game_render_fun)(RBTK_GAME *game, float alpha);
 
 /*!
  * @brief Functions for implementing a game.
@@ -151,6 +156,13 @@ typedef struct rbtk_game_funs {
  */
 #define RBTK_MAX_GAME_STATES 16
 
+/*
+ * The most updates a game with a fixed tick rate will run in a single
+ * frame. Any time beyond this is dropped, so a long stall slows the game
+ * down for a moment instead of making it run in place to catch up.
+ */
+#define RBTK_MAX_GAME_TICKS 8
+
 /*!
  * @brief Represents the current state of a game.
  *
@@ -183,6 +195,26 @@ typedef void (*rbtk_game_state_init_fun)(RBTK_GAME *game,
 typedef void (*rbtk_game_state_deinit_fun)(RBTK_GAME *game,
     RBTK_GAME_STATE *state);
 
+/*!
+ * @brief Function that loads a game state in the background.
+ *
+ * This is run on a worker thread while the current game state continues
+ * to be updated and rendered. It should do as much of the work needed to
+ * enter the game state as it can (e.g., decoding audio). Anything which
+ * must be done on the main thread, such as creating sprites, should be
+ * left for when the game state is entered.
+ *
+ * @param[in] game  The owner of the game state.
+ * @param[in] state The game state being preloaded.
+ * @param[in] args  Entrance arguments, may be `NULL`.
+ *
+ * @implementation This may be an #RBTK_NO_OP.
+ *
+ * @see rbtk_preload_game_state(RBTK_GAME *, RBTK_GAME_STATE *, void *)
+ */
+typedef void (*rbtk_game_state_preload_fun)(RBTK_GAME *game,
+    RBTK_GAME_STATE *state, void *args);
+
 /*!
  * @brief Function that is invoked when entering a game state.
  *
@@ -210,6 +242,36 @@ typedef void (*rbtk_game_state_enter_fun)(RBTK_GAME *game,
 typedef void (*rbtk_game_state_exit_fun)(RBTK_GAME *game,
     RBTK_GAME_STATE *state);
 
+/*!
+ * @brief Function that is invoked when a game state is suspended.
+ *
+ * A game state is suspended when another is pushed on top of it. While
+ * suspended, it is neither updated nor rendered. Its last frame is shown
+ * underneath the game states above it instead.
+ *
+ * @param[in] game  The owner of the game state.
+ * @param[in] state The game state being suspended.
+ *
+ * @implementation This may be an #RBTK_NO_OP.
+ *
+ * @see rbtk_push_game_state(RBTK_GAME *, RBTK_GAME_STATE *, void *)
+ */
+typedef void (*rbtk_game_state_suspend_fun)(RBTK_GAME *game,
+    RBTK_GAME_STATE *state);
+
+/*!
+ * @brief Function that is invoked when a game state is resumed.
+ *
+ * @param[in] game  The owner of the game state.
+ * @param[in] state The game state being resumed.
+ *
+ * @implementation This may be an #RBTK_NO_OP.
+ *
+ * @see rbtk_pop_game_state(RBTK_GAME *)
+ */
+typedef void (*rbtk_game_state_resume_fun)(RBTK_GAME *game,
+    RBTK_GAME_STATE *state);
+
 /*!
  * @brief Function that updates a game state.
  *
@@ -219,7 +281,8 @@ typedef void (*rbtk_game_state_exit_fun)(RBTK_GAME *game,
  *
  * @implementation This must be implemented.
  *
- * @see rbtk_game_state_render_fun(RBTK_GAME *, RBTK_GAME_STATE *)
+ * @see rbtk_game_state_render_fun(RBTK_GAME *, RBTK_GAME_STATE *, float)
+ * @see rbtk_set_game_tick_rate(RBTK_GAME *, long double)
  */
 typedef void (*rbtk_game_state_update_fun)(RBTK_GAME *game,
     RBTK_GAME_STATE *state, long double delta_ms);
@@ -229,6 +292,8 @@ typedef void (*rbtk_game_state_update_fun)(RBTK_GAME *game,
  *
  * @param[in] game  The owner of the game stae.
  * @param[in] state The game state being updated.
+ * @param[in] alpha How far along the game is between its last update and
+ *                  the next, from `0` to `1`.
  *
  * @implementation This must be implemented.
  *
@@ -236,7 +301,7 @@ typedef void (*rbtk_game_state_update_fun)(RBTK_GAME *game,
  *      long double)
  */
 typedef void (*rbtk_game_state_render_fun)(RBTK_GAME *game,
-    RBTK_GAME_STATE *state);
+    RBTK_GAME_STATE *state, float alpha);
 
 /*!
  * @brief Functions for implementing a game state.
@@ -246,8 +311,11 @@ typedef void (*rbtk_game_state_render_fun)(RBTK_GAME *game,
 typedef struct rbtk_game_state_funs {
     rbtk_game_state_init_fun init;
     rbtk_game_state_deinit_fun deinit;
+    rbtk_game_state_preload_fun preload;
     rbtk_game_state_enter_fun enter;
     rbtk_game_state_exit_fun exit;
+    rbtk_game_state_suspend_fun suspend;
+    rbtk_game_state_resume_fun resume;
     rbtk_game_state_update_fun update;
     rbtk_game_state_render_fun render;
 } rbtk_game_state_funs;
@@ -289,6 +357,46 @@ rbtk_create_game(rbtk_game_funs funs);
 bool
 rbtk_destroy_game(RBTK_GAME *game);
 
+/*!
+ * @brief Sets the rate at which a game is updated.
+ *
+ * By default, a game is updated once every frame with the time since the
+ * previous frame. This makes anything which depends on time (physics,
+ * animations, etc.) vary with the frame rate. When a tick rate is set,
+ * the game is instead updated zero or more times every frame, each time
+ * with the same delta. Time that has not been simulated yet carries over
+ * to the next frame, and rendering is given how far along it is to the
+ * next update.
+ *
+ * @param[in] game    The game whose tick rate to set.
+ * @param[in] rate_hz The number of updates per second, `0` to update once
+ *                    every frame.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `game` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_ARGUMENT, If `rate_hz` is negative.}
+ * @enderrors
+ *
+ * @see RBTK_MAX_GAME_TICKS
+ */
+bool
+rbtk_set_game_tick_rate(RBTK_GAME *game, long double rate_hz);
+
+/*!
+ * @brief Returns the rate at which a game is updated.
+ *
+ * @param[in] game The game to query.
+ * @return The number of updates per second, `0` if the game is updated
+ * once every frame.
+ *
+ * @debugging This function asserts that `game` is not `NULL`.
+ *
+ * @see rbtk_set_game_tick_rate(RBTK_GAME *, long double)
+ */
+RBTK_NO_DISCARD long double
+rbtk_get_game_tick_rate(const RBTK_GAME *game);
+
 /*!
  * @brief Creates a game state.
  *
@@ -355,14 +463,65 @@ rbtk_add_game_state(RBTK_GAME *game, RBTK_GAME_STATE *state);
  * @errors
  * @signal{#RBTK_ERROR_ILLEGAL_ARGUMENT, If the game state has not been
  *                                       added to the game.}
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE,    If the game state is suspended.}
  * @enderrors
  */
 bool
 rbtk_enter_game_state(RBTK_GAME *game, RBTK_GAME_STATE *state, void *args);
 
+/*!
+ * @brief Preloads a game state, then enters it once it has loaded.
+ *
+ * The game state is preloaded on a worker thread, while the current game
+ * state continues to be updated and rendered. Once preloading finishes,
+ * the game state is entered at the start of the next update, just as if
+ * #rbtk_enter_game_state(RBTK_GAME *, RBTK_GAME_STATE *, void *) were
+ * called. This allows the current game state to act as a loading screen.
+ *
+ * @note If the game state has no preload function, it is entered at the
+ * start of the next update.
+ *
+ * @param[in] game  The game switching states.
+ * @param[in] state The game state to preload and enter.
+ * @param[in] args  Entrance arguments, may be `NULL`. This is given to
+ *                  both the preload and enter functions, and so must stay
+ *                  valid until the game state is entered.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `game` and `state` are not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_ARGUMENT, If the game state has not been
+ *                                       added to the game.}
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE,    If the game is already preloading
+ *                                       a game state.}
+ * @enderrors
+ *
+ * @see rbtk_game_is_preloading(const RBTK_GAME *)
+ */
+bool
+rbtk_preload_game_state(RBTK_GAME *game, RBTK_GAME_STATE *state,
+    void *args);
+
+/*!
+ * @brief Returns if a game is preloading a game state.
+ *
+ * @param[in] game The game to query.
+ * @return `true` if the game is preloading a game state which it has not
+ * entered yet, `false` otherwise.
+ *
+ * @debugging This function asserts that `game` is not `NULL`.
+ *
+ * @see rbtk_preload_game_state(RBTK_GAME *, RBTK_GAME_STATE *, void *)
+ */
+RBTK_NO_DISCARD bool
+rbtk_game_is_preloading(const RBTK_GAME *game);
+
 /*!
  * @brief Exits the current game state of a game, if any.
  *
+ * @note Any game states suspended underneath the current game state are
+ * exited as well, from the top down.
+ *
  * @param[in] game The game whose current state to exit.
  *
  * @debugging This function asserts that `game` is not `NULL`.
@@ -370,6 +529,69 @@ rbtk_enter_game_state(RBTK_GAME *game, RBTK_GAME_STATE *state, void *args);
 void
 rbtk_exit_game_state(RBTK_GAME *game);
 
+/*!
+ * @brief Pushes a game state on top of the current one.
+ *
+ * The current game state is suspended rather than exited, and the given
+ * game state is entered on top of it. This is meant for overlays, such as
+ * a pause menu, which should not lose the state of what is underneath.
+ *
+ * Suspended game states are not updated. If the game has a scene, their
+ * last frame is drawn to it once and kept. Every frame after, that copy
+ * is drawn in their place, rather than rendering them all over again.
+ *
+ * @param[in] game  The game to push the game state onto.
+ * @param[in] state The game state to push.
+ * @param[in] args  Entrance arguments, may be `NULL`.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `game` and `state` are not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_ARGUMENT, If the game state has not been
+ *                                       added to the game.}
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE,    If the game state is already
+ *                                       current or suspended.}
+ * @enderrors
+ *
+ * @see rbtk_pop_game_state(RBTK_GAME *)
+ * @see rbtk_set_game_scene(RBTK_GAME *, RBTK_GRAPHICS *)
+ */
+bool
+rbtk_push_game_state(RBTK_GAME *game, RBTK_GAME_STATE *state, void *args);
+
+/*!
+ * @brief Pops the current game state, resuming the one underneath.
+ *
+ * @param[in] game The game to pop the current game state from.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `game` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE, If no game state was pushed on top
+ *                                    of another.}
+ * @enderrors
+ *
+ * @see rbtk_push_game_state(RBTK_GAME *, RBTK_GAME_STATE *, void *)
+ */
+bool
+rbtk_pop_game_state(RBTK_GAME *game);
+
+/*!
+ * @brief Sets the scene which the game states of a game render to.
+ *
+ * This is used to keep the last frame of suspended game states. Without a
+ * scene, suspended game states are rendered every frame as usual.
+ *
+ * @param[in] game  The game whose scene to set.
+ * @param[in] scene The scene the game renders to, may be `NULL`.
+ *
+ * @debugging This function asserts that `game` is not `NULL`.
+ *
+ * @see rbtk_push_game_state(RBTK_GAME *, RBTK_GAME_STATE *, void *)
+ */
+void
+rbtk_set_game_scene(RBTK_GAME *game, RBTK_GRAPHICS *scene);
+
 /*! @} */
 
 #ifdef __cplusplus
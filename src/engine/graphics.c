@@ -31,11 +31,17 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "engine.h"
+#include "snapshot.h"
+
+#include "./private/input.h"
+
 #include "../libraries/cglm_no_io.h"
 #include "../libraries/stb_image.h"
 
 #include "../runtime/asset.h"
 #include "../runtime/common.h"
+#include "../runtime/stats.h"
 #include "../runtime/time.h"
 
 #define REQUIRE_INITIALIZED_OR_RETURN(_value)       \
@@ -51,6 +57,11 @@ static size_t window_count;
 static RBTK_WINDOW *windows[RBTK_MAX_WINDOW_COUNT];
 static bool initialized;
 
+static struct {
+    RBTK_STAT *draw_calls;
+    RBTK_STAT *upload_bytes;
+} stats;
+
 RBTK_PRIVATE RBTK_NO_DISCARD bool
 priv_rbtk_graphics_init(void)
 {
@@ -72,6 +83,12 @@ priv_rbtk_graphics_init(void)
         return false;
     }
 
+    /* a missing stat is not fatal, it is just not recorded */
+    stats.draw_calls = rbtk_get_stat("graphics.draw_calls",
+        RBTK_STAT_TYPE_COUNTER);
+    stats.upload_bytes = rbtk_get_stat("graphics.upload_bytes",
+        RBTK_STAT_TYPE_COUNTER);
+
     initialized = true;
     return true;
 }
@@ -97,6 +114,8 @@ priv_rbtk_graphics_terminate(void)
         return false;
     }
 
+    RBTK_ZERO_MEMORY(&stats);
+
     initialized = false;
     return true;
 }
@@ -295,8 +314,8 @@ bool
 rbtk_show_window(RBTK_WINDOW *window)
 {
     assert(window);
-    if (window->visible) {
-        return true;
+    if (window->visible || rbtk_engine_is_headless()) {
+        return true; /* headless windows are never shown */
     }
 
     if (!plat_rbtk_show_window(window)) {
@@ -559,6 +578,9 @@ rbtk_render_window_scene(const RBTK_WINDOW *window)
     if (!window->scene) {
         return false;
     }
+    else if (rbtk_engine_is_headless()) {
+        return true; /* nothing to present to */
+    }
 
     if (!plat_rbtk_render_window_scene(window)) {
         rbtk_suggest_error(RBTK_ERROR_PLATFORM,
@@ -566,6 +588,19 @@ rbtk_render_window_scene(const RBTK_WINDOW *window)
         return false;
     }
 
+    /*
+     * The scene has been presented, so any input consumed before now is
+     * on its way to the screen. Waiting on the GPU is opt-in, as it will
+     * stall until all of the work queued for the frame is finished.
+     */
+    long double presented = rbtk_time(RBTK_MILLIS);
+    long double completed = -1.0L;
+    if (priv_rbtk_input_awaits_gpu()) {
+        plat_rbtk_finish_window_frame(window);
+        completed = rbtk_time(RBTK_MILLIS);
+    }
+    priv_rbtk_input_presented(presented, completed);
+
     return true;
 }
 
@@ -909,43 +944,50 @@ rbtk_draw_scene(RBTK_GRAPHICS *dest, RBTK_GRAPHICS *src,
     rbtk_draw_sprite(dest, src->sprite, x, y, z);
 }
 
-RBTK_NO_DISCARD RBTK_SPRITE *
-rbtk_load_sprite(RBTK_ASSET *asset)
+bool
+rbtk_copy_scene(RBTK_GRAPHICS *dest, RBTK_GRAPHICS *src)
 {
-    assert(asset);
+    assert(dest);
+    assert(src);
+    if (dest == src) {
+        return true; /* nothing to copy */
+    }
+
+    if (!plat_rbtk_copy_scene(dest, src)) {
+        rbtk_suggest_error(RBTK_ERROR_PLATFORM,
+            "error copying graphics scene");
+        return false;
+    }
+
+    return true;
+}
 
+static RBTK_SPRITE *
+create_sprite(unsigned int width, unsigned int height,
+    unsigned short channels, unsigned char *pixels)
+{
     RBTK_SPRITE *sprite = NULL;
     RBTK_MALLOC_OR_RETURN(&sprite, NULL,
         "could not allocate memory for sprite");
 
-    RBTK_IN_STREAM *in = rbtk_open_asset_in_stream(asset);
-    size_t buffer_size = 0;
-    unsigned char *buffer = rbtk_buffer_remaining(in, &buffer_size);
-    rbtk_close_in_stream(in);
-    if (!buffer) {
-        free(sprite);
-        return NULL;
-    }
-
-    int width, height, channels;
-    stbi_uc *img = stbi_load_from_memory(buffer, (int) buffer_size,
-        &width, &height, &channels, 0);
-
     sprite->scene = NULL;
     sprite->width = width;
     sprite->height = height;
 
     PLAT_RBTK_SPRITE *plat = plat_rbtk_load_sprite(
-        (unsigned int) width, (unsigned int) height,
-        (unsigned short) channels, img);
+        width, height, channels, pixels);
     if (!plat) {
         free(sprite);
-        stbi_image_free(img);
         rbtk_suggest_error(RBTK_ERROR_PLATFORM,
             "could not load image for current platform");
         return NULL;
     }
 
+    if (stats.upload_bytes) {
+        rbtk_count_stat(stats.upload_bytes,
+            (long double) width * height * channels);
+    }
+
     sprite->flipped.vertically = false;
     sprite->flipped.horizontally = false;
 
@@ -973,11 +1015,50 @@ rbtk_load_sprite(RBTK_ASSET *asset)
 
     glm_mat4_identity(sprite->model);
 
-    stbi_image_free(img);
     sprite->plat = plat;
     return sprite;
 }
 
+RBTK_NO_DISCARD RBTK_SPRITE *
+rbtk_create_sprite(unsigned int width, unsigned int height,
+    const unsigned char *pixels)
+{
+    assert(width > 0);
+    assert(height > 0);
+    assert(pixels);
+
+    /*
+     * The platform is given the pixels as mutable, but it only ever reads
+     * from them. It also copies them into its own memory, so the caller
+     * is free to modify or release them once this returns.
+     */
+    return create_sprite(width, height, 4, (unsigned char *) pixels);
+}
+
+RBTK_NO_DISCARD RBTK_SPRITE *
+rbtk_load_sprite(RBTK_ASSET *asset)
+{
+    assert(asset);
+
+    RBTK_IN_STREAM *in = rbtk_open_asset_in_stream(asset);
+    size_t buffer_size = 0;
+    unsigned char *buffer = rbtk_buffer_remaining(in, &buffer_size);
+    rbtk_close_in_stream(in);
+    if (!buffer) {
+        return NULL;
+    }
+
+    int width, height, channels;
+    stbi_uc *img = stbi_load_from_memory(buffer, (int) buffer_size,
+        &width, &height, &channels, 0);
+
+    RBTK_SPRITE *sprite = create_sprite((unsigned int) width,
+        (unsigned int) height, (unsigned short) channels, img);
+
+    stbi_image_free(img);
+    return sprite;
+}
+
 bool
 rbtk_unload_sprite(RBTK_SPRITE *sprite)
 {
@@ -1185,6 +1266,92 @@ rbtk_set_sprite_alpha(RBTK_SPRITE *sprite, float alpha)
     sprite->color.alpha = rbtk_clamp_f32(alpha, 0.0f, 1.0f);
 }
 
+/*
+ * This does not touch the display, so it lives here rather than in the
+ * platform code. That way, it can be measured without a display.
+ */
+RBTK_PRIVATE void
+priv_rbtk_get_sprite_matrices(RBTK_GRAPHICS *scene, RBTK_SPRITE *sprite,
+    float x, float y, float z,
+    mat4 model_matrix, mat4 view_matrix, mat4 proj_matrix)
+{
+    vec3 model_translate = {
+        x - sprite->section.x,
+        y - sprite->section.y,
+        z
+    };
+    vec3 model_scale = {
+        sprite->scale.x,
+        sprite->scale.y,
+        sprite->scale.z
+    };
+    if (sprite->flipped.horizontally) {
+        model_scale[0] *= -1;
+        model_translate[0] += sprite->section.width;
+    }
+    if (sprite->flipped.vertically) {
+        model_scale[1] *= -1;
+        model_translate[1] += sprite->section.height;
+    }
+
+    RBTK_CAMERA *camera = scene->camera;
+    vec3 camera_pos = {
+        camera->pos[0] * -1.0f,
+        camera->pos[1] * -1.0f,
+        camera->pos[2] * -1.0f,
+    };
+    vec3 camera_target = {
+        camera_pos[0],
+        camera_pos[1],
+        0, /* look to the front */
+    };
+    vec3 camera_up = {
+        0, /* leave X-axis alone */
+        1, /* look upwards       */
+        0, /* leave Z-axis alone */
+    };
+
+    /*
+     * Now that we have all the necessary information, we can calculate the
+     * model view projection matrices, which will determine the final result
+     * of drawing this sprite.
+     *
+     * Note that here we are rendering to a vertically flipped matrix. This
+     * has to due with OpenGL, where it wants to render to the frame buffer
+     * upside down for some reason. Flipping it while rendering here allows
+     * for proper results when rendering to the screen.
+     *
+     * The following steps below (before copying the final result) must be
+     * done in that specific order. The matrix operations used here are not
+     * commutative!
+     */
+
+    /* 1. Translate the sprite to the requested position.     */
+    glm_translate(model_matrix, model_translate);
+
+    /* 2. Apply the specified rotation for each axis.         */
+    vec3 x_axis = { 1, 0, 0 };
+    glm_rotate(model_matrix, sprite->rotation.x, x_axis);
+    vec3 y_axis = { 0, 1, 0 };
+    glm_rotate(model_matrix, sprite->rotation.y, y_axis);
+    vec3 z_axis = { 0, 0, 1 };
+    glm_rotate(model_matrix, sprite->rotation.z, z_axis);
+
+    /* 3. Scale the model to the requested size.              */
+    glm_scale(model_matrix, model_scale);
+
+    /*
+     * All done, we can now copy our results to the matrices.
+     *
+     * Note: We have to cast the projection matrix to a non-const
+     * pointer to silence a warning caused by discarding constness.
+     * This is because the first parameter of glm_mat4_copy() (the
+     * source matrix) is not const. The reason for this is unknown.
+     */
+    glm_mat4_copy(*((mat4 *) &scene->proj->matrix), proj_matrix);
+    glm_lookat(camera_pos, camera_target, camera_up, view_matrix);
+}
+
 void
 rbtk_draw_sprite(RBTK_GRAPHICS *scene, RBTK_SPRITE *sprite,
     float x, float y, float z)
@@ -1197,6 +1364,32 @@ rbtk_draw_sprite(RBTK_GRAPHICS *scene, RBTK_SPRITE *sprite,
     z += sprite->offset.z;
 
     plat_rbtk_draw_sprite(scene, sprite, x, y, z);
+    if (stats.draw_calls) {
+        rbtk_count_stat(stats.draw_calls, 1.0L);
+    }
+}
+
+void
+rbtk_draw_sprite_instances(RBTK_GRAPHICS *scene, RBTK_SPRITE *sprite,
+    size_t count, const float *x, const float *y, const float *alpha,
+    float z)
+{
+    assert(scene);
+    assert(sprite);
+    assert(x);
+    assert(y);
+    assert(alpha);
+
+    if (count == 0) {
+        return; /* nothing to draw */
+    }
+
+    plat_rbtk_draw_sprite_instances(scene, sprite,
+        sprite->offset.x, sprite->offset.y, z + sprite->offset.z,
+        count, x, y, alpha);
+    if (stats.draw_calls) {
+        rbtk_count_stat(stats.draw_calls, 1.0L);
+    }
 }
 
 RBTK_NO_DISCARD RBTK_SPRITE_ANIME *
@@ -1221,13 +1414,14 @@ rbtk_create_sprite_anime(size_t max_frames)
     anime->num_frames = 0;
     anime->frames = frames;
     anime->durations = durations;
-    anime->timer = 0;
 
     anime->loop = true;
     anime->ping_pong = false;
-    anime->backwards = false;
-    anime->finished = false;
-    anime->current_frame = 0;
+
+    anime->playback.timer = 0;
+    anime->playback.backwards = false;
+    anime->playback.finished = false;
+    anime->playback.current_frame = 0;
 
     anime->offset.x = 0;
     anime->offset.y = 0;
@@ -1248,6 +1442,7 @@ rbtk_destroy_sprite_anime(RBTK_SPRITE_ANIME *anime, bool unload_sprites)
         }
     }
 
+    rbtk_remove_snapshot_anime(anime);
     free(anime->frames);
     free(anime->durations);
     free(anime);
@@ -1347,14 +1542,14 @@ rbtk_set_sprite_duration_in_anime(RBTK_SPRITE_ANIME *anime, size_t index,
 RBTK_NO_DISCARD bool
 rbtk_sprite_anime_is_finished(RBTK_SPRITE_ANIME *anime) {
     assert(anime);
-    return anime->finished;
+    return anime->playback.finished;
 }
 
 RBTK_NO_DISCARD size_t
 rbtk_get_current_sprite_anime_index(RBTK_SPRITE_ANIME *anime)
 {
     assert(anime);
-    return anime->current_frame;
+    return anime->playback.current_frame;
 }
 
 bool
@@ -1369,9 +1564,9 @@ rbtk_set_current_sprite_anime_index(RBTK_SPRITE_ANIME *anime, size_t index)
         return false;
     }
 
-    anime->timer = 0;
-    anime->finished = false;
-    anime->current_frame = index;
+    anime->playback.timer = 0;
+    anime->playback.finished = false;
+    anime->playback.current_frame = index;
     return true;
 }
 
@@ -1380,12 +1575,12 @@ rbtk_restart_sprite_anime(RBTK_SPRITE_ANIME *anime)
 {
     assert(anime);
     if (anime->num_frames > 0) {
-        anime->timer = 0;
-        anime->finished = false;
-        if (anime->backwards){
-            anime->current_frame = anime->num_frames - 1;
+        anime->playback.timer = 0;
+        anime->playback.finished = false;
+        if (anime->playback.backwards){
+            anime->playback.current_frame = anime->num_frames - 1;
         } else {
-            anime->current_frame = 0;
+            anime->playback.current_frame = 0;
         }
     }
 }
@@ -1394,7 +1589,7 @@ RBTK_NO_DISCARD RBTK_SPRITE *
 rbtk_get_current_sprite_anime_frame(RBTK_SPRITE_ANIME *anime)
 {
     assert(anime);
-    return anime->frames[anime->current_frame];
+    return anime->frames[anime->playback.current_frame];
 }
 
 bool
@@ -1424,14 +1619,14 @@ bool
 rbtk_sprite_anime_is_playing_backwards(RBTK_SPRITE_ANIME *anime)
 {
     assert(anime);
-    return anime->backwards;
+    return anime->playback.backwards;
 }
 
 void
 rbtk_play_sprite_anime_backwards(RBTK_SPRITE_ANIME *anime, bool backwards)
 {
     assert(anime);
-    anime->backwards = backwards;
+    anime->playback.backwards = backwards;
 }
 
 void
@@ -1481,14 +1676,14 @@ rbtk_update_sprite_anime(RBTK_SPRITE_ANIME *anime, long double delta,
     long double delta_ms = rbtk_convert_time(unit, RBTK_MILLIS, delta);
 
     size_t num_frames = anime->num_frames;
-    long double timer = anime->timer += delta_ms;
-    bool backwards = anime->backwards;
-    bool finished = anime->finished;
-    size_t current_frame = anime->current_frame;
+    long double timer = anime->playback.timer += delta_ms;
+    bool backwards = anime->playback.backwards;
+    bool finished = anime->playback.finished;
+    size_t current_frame = anime->playback.current_frame;
 
     while (timer >= anime->durations[current_frame]) {
         timer -= anime->durations[current_frame];
-        current_frame += anime->backwards ? -1 : 1;
+        current_frame += anime->playback.backwards ? -1 : 1;
 
         /*
          * If the current frame is SIZE_MAX, it means it has gone into
@@ -1570,10 +1765,10 @@ rbtk_update_sprite_anime(RBTK_SPRITE_ANIME *anime, long double delta,
         }
     }
 
-    anime->timer = timer;
-    anime->backwards = backwards;
-    anime->finished = finished;
-    anime->current_frame = current_frame;
+    anime->playback.timer = timer;
+    anime->playback.backwards = backwards;
+    anime->playback.finished = finished;
+    anime->playback.current_frame = current_frame;
 }
 
 void
@@ -1587,6 +1782,6 @@ rbtk_draw_sprite_anime(RBTK_GRAPHICS *scene, RBTK_SPRITE_ANIME *anime,
     y += anime->offset.y;
     z += anime->offset.z;
 
-    RBTK_SPRITE *sprite = anime->frames[anime->current_frame];
+    RBTK_SPRITE *sprite = anime->frames[anime->playback.current_frame];
     rbtk_draw_sprite(scene, sprite, x, y, z);
 }
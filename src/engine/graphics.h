@@ -998,6 +998,31 @@ void
 rbtk_draw_scene(RBTK_GRAPHICS *dest, RBTK_GRAPHICS *src,
     float x, float y, float z);
 
+/*!
+ * @brief Copies the contents of one scene to another.
+ *
+ * Unlike #rbtk_draw_scene(RBTK_GRAPHICS *, RBTK_GRAPHICS *, float, float,
+ * float), this ignores the projection and camera of both scenes. The
+ * contents of `src` are stretched to cover all of `dest`, replacing what
+ * was there before. This makes it a cheap way to save a scene and later
+ * restore it.
+ *
+ * @note If `dest` and `src` are the same graphics scene, then this method
+ * is a no-op.
+ *
+ * @param[in] dest The scene to copy to.
+ * @param[in] src  The scene to copy.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `dest` and `src` are not
+ * `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_PLATFORM, If a platform specific error occurred.}
+ * @enderrors
+ */
+bool
+rbtk_copy_scene(RBTK_GRAPHICS *dest, RBTK_GRAPHICS *src);
+
 /*!
  * @brief Draws a scene using the current offset of its sprite.
  *
@@ -1010,6 +1035,32 @@ rbtk_draw_scene(RBTK_GRAPHICS *dest, RBTK_GRAPHICS *src,
 #define rbtk_draw_scene_at_offset(_dest, _src) \
     rbtk_draw_scene((_dest), (_src), 0.0f, 0.0f, 0.0f)
 
+/*!
+ * @brief Creates a sprite from pixels in memory.
+ *
+ * @param[in] width  The width of the sprite, in pixels.
+ * @param[in] height The height of the sprite, in pixels.
+ * @param[in] pixels The pixels of the sprite, in RGBA order with one byte
+ *                   per channel. These are laid out row by row, starting
+ *                   from the top left.
+ * @return The created sprite, `NULL` on failure.
+ *
+ * @pointer_lifetime The contents of `pixels` are copied by the platform,
+ * and may be modified or freed once this function returns. The returned
+ * sprite is valid until the sprite is unloaded via
+ * #rbtk_unload_sprite(RBTK_SPRITE *) or the graphics module is terminated.
+ *
+ * @debugging This function asserts that `width` and `height` are positive
+ * and that `pixels` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
+ * @signal{#RBTK_ERROR_PLATFORM,      If a platform specific error occurred.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD RBTK_SPRITE *
+rbtk_create_sprite(unsigned int width, unsigned int height,
+    const unsigned char *pixels);
+
 /*!
  * @brief Loads a sprite from an asset.
  *
@@ -1467,6 +1518,34 @@ rbtk_draw_sprite(RBTK_GRAPHICS *scene, RBTK_SPRITE *sprite,
 #define rbtk_draw_sprite_at_offset(_scene, _sprite) \
     rbtk_draw_sprite((_scene), (_sprite), 0.0f, 0.0f, 0.0f)
 
+/*!
+ * @brief Draws many copies of a sprite to the given scene at once.
+ *
+ * This is much faster than calling #rbtk_draw_sprite() for each copy,
+ * since every copy is drawn with a single draw call. Each copy has its
+ * own position and alpha, which is multiplied with that of the sprite.
+ * Everything else (e.g., the section, rotation, and scale) is shared.
+ *
+ * @note The current offset of the sprite is applied to each copy.
+ *
+ * @param[in] scene  The scene to draw to.
+ * @param[in] sprite The sprite to draw.
+ * @param[in] count  The number of copies to draw.
+ * @param[in] x      The X-axis position of each copy.
+ * @param[in] y      The Y-axis position of each copy.
+ * @param[in] alpha  The alpha of each copy.
+ * @param[in] z      The Z-axis position to draw every copy at.
+ *
+ * @debugging This function asserts that `scene`, `sprite`, `x`, `y`,
+ * and `alpha` are not `NULL`.
+ *
+ * @see rbtk_draw_sprite(RBTK_GRAPHICS *, RBTK_SPRITE *, float, float, float)
+ */
+void
+rbtk_draw_sprite_instances(RBTK_GRAPHICS *scene, RBTK_SPRITE *sprite,
+    size_t count, const float *x, const float *y, const float *alpha,
+    float z);
+
 /*!
  * @brief Creates a sprite animation.
  *
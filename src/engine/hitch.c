@@ -0,0 +1,357 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "hitch.h"
+#include "./private/hitch.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "engine.h"
+
+#include "../runtime/common.h"
+#include "../runtime/stats.h"
+
+/*
+ * Sorting the frame time history for its median is not cheap enough to do
+ * every frame. The median hardly moves from one frame to the next, so it
+ * is only found again every so often.
+ */
+#define MEDIAN_REFRESH_FRAMES 30
+
+#define TRACE_NAME_FORMAT "%s/hitch-%s-%zu.csv"
+#define TRACE_STAMP_SIZE  32
+
+struct frame_record {
+    size_t frame;
+    long double start;
+    long double frame_ms;
+    long double update_ms;
+    long double render_ms;
+    size_t stat_count;
+    long double stat_values[RBTK_HITCH_CAPTURE_MAX_STATS];
+};
+
+static long double capture_multiple;
+static char *capture_dir;
+static size_t hitch_count;
+
+/*
+ * The records are kept in a ring. Once full, the oldest record is the one
+ * at the current position, which is overwritten by the next frame.
+ */
+static struct frame_record records[RBTK_HITCH_CAPTURE_FRAMES];
+static size_t records_len;
+static size_t records_pos;
+
+static size_t frame_count;
+static size_t frames_since_capture;
+static long double last_frame_end;
+static long double median_ms;
+
+static struct {
+    RBTK_STAT *frame_ms;
+    RBTK_STAT *update_ms;
+    RBTK_STAT *render_ms;
+} stats;
+
+static bool initialized;
+
+RBTK_PRIVATE RBTK_NO_DISCARD bool
+priv_rbtk_hitch_init(void)
+{
+    if (initialized) {
+        return true;
+    }
+
+    capture_multiple = 0.0L;
+    capture_dir = NULL;
+    hitch_count = 0;
+
+    records_len = 0;
+    records_pos = 0;
+
+    frame_count = 0;
+    frames_since_capture = 0;
+    last_frame_end = 0.0L;
+    median_ms = 0.0L;
+
+    /* without the frame time, hitches are just not detected */
+    stats.frame_ms = rbtk_get_stat("engine.frame_ms",
+        RBTK_STAT_TYPE_SAMPLE);
+    stats.update_ms = rbtk_get_stat("engine.update_ms",
+        RBTK_STAT_TYPE_SAMPLE);
+    stats.render_ms = rbtk_get_stat("engine.render_ms",
+        RBTK_STAT_TYPE_SAMPLE);
+
+    initialized = true;
+    return true;
+}
+
+RBTK_PRIVATE RBTK_NO_DISCARD bool
+priv_rbtk_hitch_terminate(void)
+{
+    if (!initialized) {
+        return true;
+    }
+
+    free(capture_dir);
+    capture_dir = NULL;
+    capture_multiple = 0.0L;
+
+    RBTK_ZERO_MEMORY(&stats);
+
+    initialized = false;
+    return true;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_set_hitch_capture(long double multiple, const char *dir)
+{
+    if (!initialized) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE,
+            "hitch module not initialized");
+        return false;
+    }
+    else if (multiple < 0.0L || (multiple > 0.0L && multiple <= 1.0L)) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_ARGUMENT,
+            "hitch multiple must be zero or greater than one");
+        return false;
+    }
+
+    char *dir_copy = NULL;
+    if (multiple > 0.0L) {
+        const char *path = dir ? dir : ".";
+        size_t path_len = strlen(path);
+        dir_copy = malloc(path_len + 1);
+        if (!dir_copy) {
+            rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+                "failed to allocate memory for hitch directory");
+            return false;
+        }
+        memcpy(dir_copy, path, path_len + 1);
+    }
+
+    free(capture_dir);
+    capture_dir = dir_copy;
+    capture_multiple = multiple;
+
+    /*
+     * Stats are only recorded while capture is enabled. Any records from
+     * before then would be missing them, so they are thrown out.
+     */
+    records_len = 0;
+    records_pos = 0;
+    frames_since_capture = 0;
+    return true;
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_get_hitch_count(void)
+{
+    return hitch_count;
+}
+
+static const struct frame_record *
+get_record(size_t index)
+{
+    assert(index < records_len);
+    size_t oldest = records_len < RBTK_HITCH_CAPTURE_FRAMES
+        ? 0 : records_pos;
+    return &records[(oldest + index) % RBTK_HITCH_CAPTURE_FRAMES];
+}
+
+static void
+write_record(FILE *file, RBTK_STATS all_stats, size_t stat_count,
+    const struct frame_record *record, const struct frame_record *prev)
+{
+    fprintf(file, "%zu,%.3Lf,%.3Lf,%.3Lf,%.3Lf", record->frame,
+        record->start, record->frame_ms, record->update_ms,
+        record->render_ms);
+
+    for (size_t i = 0; i < stat_count; i++) {
+        if (i >= record->stat_count) {
+            fputc(',', file); /* registered after this frame */
+            continue;
+        }
+
+        long double value = record->stat_values[i];
+        if (rbtk_get_stat_type(all_stats[i]) == RBTK_STAT_TYPE_COUNTER) {
+            if (!prev || i >= prev->stat_count) {
+                fputc(',', file); /* nothing to count from */
+                continue;
+            }
+            value -= prev->stat_values[i];
+        }
+        fprintf(file, ",%.3Lf", value);
+    }
+
+    fputc('\n', file);
+}
+
+static bool
+write_trace(const struct frame_record *hitch)
+{
+    assert(capture_dir);
+    assert(hitch);
+
+    char stamp[TRACE_STAMP_SIZE] = "unknown";
+    time_t now = time(NULL);
+    struct tm *local = localtime(&now);
+    if (local) {
+        strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", local);
+    }
+
+    int path_len = snprintf(NULL, 0, TRACE_NAME_FORMAT,
+        capture_dir, stamp, hitch->frame);
+    if (path_len < 0) {
+        return false;
+    }
+
+    char *path = malloc((size_t) path_len + 1);
+    if (!path) {
+        return false;
+    }
+    snprintf(path, (size_t) path_len + 1, TRACE_NAME_FORMAT,
+        capture_dir, stamp, hitch->frame);
+
+    FILE *file = fopen(path, "w");
+    free(path);
+    if (!file) {
+        return false;
+    }
+
+    size_t stat_count = 0;
+    RBTK_STATS all_stats = rbtk_get_stats(&stat_count);
+    if (stat_count > RBTK_HITCH_CAPTURE_MAX_STATS) {
+        stat_count = RBTK_HITCH_CAPTURE_MAX_STATS;
+    }
+
+    fprintf(file, "# hitch at frame %zu: %.3Lf ms, median %.3Lf ms,"
+        " threshold %.2Lfx\n", hitch->frame, hitch->frame_ms, median_ms,
+        capture_multiple);
+
+    fprintf(file, "frame,start_ms,frame_ms,update_ms,render_ms");
+    for (size_t i = 0; i < stat_count; i++) {
+        fprintf(file, ",%s", rbtk_get_stat_name(all_stats[i]));
+    }
+    fputc('\n', file);
+
+    const struct frame_record *prev = NULL;
+    for (size_t i = 0; i < records_len; i++) {
+        const struct frame_record *record = get_record(i);
+        write_record(file, all_stats, stat_count, record, prev);
+        prev = record;
+    }
+
+    bool written = !ferror(file);
+    return fclose(file) == 0 && written;
+}
+
+static void
+record_stats(struct frame_record *record)
+{
+    size_t stat_count = 0;
+    RBTK_STATS all_stats = rbtk_get_stats(&stat_count);
+    if (stat_count > RBTK_HITCH_CAPTURE_MAX_STATS) {
+        stat_count = RBTK_HITCH_CAPTURE_MAX_STATS;
+    }
+
+    for (size_t i = 0; i < stat_count; i++) {
+        record->stat_values[i] = rbtk_get_stat_value(all_stats[i]);
+    }
+    record->stat_count = stat_count;
+}
+
+RBTK_PRIVATE void
+priv_rbtk_record_frame(long double update_start, long double render_start,
+    long double render_end)
+{
+    assert(initialized);
+
+    /*
+     * The time of a frame is from the end of the last one to the end of
+     * this one. This way, any time spent between frames (e.g., waiting on
+     * V-sync) is counted too.
+     */
+    long double frame_ms = frame_count > 0
+        ? render_end - last_frame_end : render_end - update_start;
+    long double update_ms = render_start - update_start;
+    long double render_ms = render_end - render_start;
+    last_frame_end = render_end;
+    frame_count += 1;
+
+    if (stats.update_ms) {
+        rbtk_sample_stat(stats.update_ms, update_ms);
+    }
+    if (stats.render_ms) {
+        rbtk_sample_stat(stats.render_ms, render_ms);
+    }
+    if (!stats.frame_ms) {
+        return; /* cannot detect hitches */
+    }
+    rbtk_sample_stat(stats.frame_ms, frame_ms);
+
+    if (capture_multiple <= 0.0L || rbtk_engine_is_headless()) {
+        return; /* headless frames are not paced, nothing to capture */
+    }
+
+    struct frame_record *record = &records[records_pos];
+    record->frame = frame_count;
+    record->start = update_start;
+    record->frame_ms = frame_ms;
+    record->update_ms = update_ms;
+    record->render_ms = render_ms;
+    record_stats(record);
+
+    records_pos = (records_pos + 1) % RBTK_HITCH_CAPTURE_FRAMES;
+    if (records_len < RBTK_HITCH_CAPTURE_FRAMES) {
+        records_len += 1;
+    }
+    frames_since_capture += 1;
+
+    if (frames_since_capture < RBTK_HITCH_CAPTURE_FRAMES) {
+        return; /* not enough frames for a full trace */
+    }
+    else if (frame_count % MEDIAN_REFRESH_FRAMES == 0 || median_ms <= 0.0L) {
+        median_ms = rbtk_get_stat_percentile(stats.frame_ms, 50.0L);
+    }
+
+    if (frame_ms <= median_ms * capture_multiple) {
+        return;
+    }
+
+    /*
+     * Failing to write a trace is not fatal, the hitch simply goes missed.
+     * Either way, the next hitch is not captured until enough frames have
+     * run to fill another trace.
+     */
+    if (write_trace(record)) {
+        hitch_count += 1;
+    }
+    frames_since_capture = 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_HITCH_H_
+#define RBTK_ENGINE_HITCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+ * @file
+ * @brief The public API for the game engine's hitch module.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../runtime/common.h"
+#include "../runtime/error.h"
+
+/*!
+ * @defgroup engine_hitch Hitch Capture
+ * @brief The game engine's hitch module.
+ *
+ * The hitch module keeps a record of the most recent frames run by the
+ * engine. Each record holds how long the frame took, how long was spent
+ * updating and rendering, and the value of every stat at the end of the
+ * frame. When capture is enabled, a frame which takes much longer than
+ * usual (a hitch) causes these records to be written to a trace file. As
+ * such, the frames leading up to a hitch can be looked at after the fact,
+ * even when the hitch is too rare to catch by hand.
+ *
+ * Trace files are written as CSV, with one line per frame. For counters
+ * (e.g., `graphics.draw_calls`), the amount counted during that frame is
+ * written rather than the running total.
+ *
+ * @see rbtk_set_hitch_capture(long double, const char *)
+ *
+ * @{
+ */
+
+/*!
+ * @brief The number of frames written to a trace file.
+ *
+ * A hitch is only captured once this many frames have been recorded. This
+ * is also the least number of frames between two trace files, so a long
+ * stall does not write a trace for every frame.
+ *
+ * @note This limit is arbitrary. Feel free to increase this value if need
+ * be.
+ */
+#define RBTK_HITCH_CAPTURE_FRAMES 120
+
+/*!
+ * @brief The maximum number of stats recorded for each frame.
+ *
+ * @note This limit is arbitrary. Feel free to increase this value if need
+ * be. Stats past this limit, in the order they were registered, are not
+ * written to trace files.
+ */
+#define RBTK_HITCH_CAPTURE_MAX_STATS 32
+
+/*!
+ * @brief Enables or disables hitch capture.
+ *
+ * When enabled, any frame which takes longer than `multiple` times the
+ * median frame time is captured. Captures are written to the directory
+ * as `hitch-<date>-<time>-<frame>.csv`, where the date and time are the
+ * local time the hitch was captured.
+ *
+ * @note Hitch capture is disabled by default.
+ *
+ * @param[in] multiple How many times longer than the median a frame must
+ *                     take to be captured, `0` to disable capture.
+ * @param[in] dir      The directory to write trace files to. If `NULL`,
+ *                     they are written to the current directory. This
+ *                     string is copied, and as such does not need to
+ *                     outlive the call.
+ * @return `true` on success, `false` on failure.
+ *
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE,    If the engine is not
+ *                                       initialized.}
+ * @signal{#RBTK_ERROR_ILLEGAL_ARGUMENT, If `multiple` is negative, or is
+ *                                       positive but not more than `1`.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY,    If memory for the directory could
+ *                                       not be allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD bool
+rbtk_set_hitch_capture(long double multiple, const char *dir);
+
+/*!
+ * @brief Returns the number of hitches captured so far.
+ *
+ * @return The number of trace files written since the engine was
+ *         initialized.
+ */
+RBTK_NO_DISCARD size_t
+rbtk_get_hitch_count(void);
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_HITCH_H_ */
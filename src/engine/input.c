@@ -25,19 +25,45 @@
 #include "./private/input.h"
 #include "./platform/input.h"
 
+#include <limits.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "../runtime/common.h"
+#include "../runtime/stats.h"
+#include "../runtime/stream.h"
+#include "../runtime/thread.h"
+#include "../runtime/time.h"
 
-#define define_io_button(_name, _id)               \
+/*
+ * Recordings of I/O devices begin with this magic, followed by the format
+ * version, the device type, and the features which were recorded. After
+ * this, each frame contains the time of the update and the state of each
+ * recorded feature. All values are stored in little-endian byte order.
+ */
+#define IO_RECORDING_MAGIC     "RBTKIO"
+#define IO_RECORDING_MAGIC_LEN 6
+#define IO_RECORDING_VERSION   1
+
+#define define_io_feature(_name, _id, _type)       \
     extern PLAT_RBTK_IO_FEATURE *plat_##_name;     \
     static RBTK_IO_FEATURE stat_##_name = {        \
         .plat = &(plat_##_name),                   \
         .id = (_id),                               \
-        .type = RBTK_IO_FEATURE_BUTTON,            \
+        .type = (_type),                           \
+        .index = RBTK_IO_FEATURE_NO_INDEX,         \
     };                                             \
     RBTK_IO_FEATURE *const _name = &(stat_##_name)
 
+#define define_io_button(_name, _id) \
+    define_io_feature(_name, _id, RBTK_IO_FEATURE_BUTTON)
+
+#define define_io_stick(_name, _id) \
+    define_io_feature(_name, _id, RBTK_IO_FEATURE_ANALOG_STICK)
+
+#define define_io_trigger(_name, _id) \
+    define_io_feature(_name, _id, RBTK_IO_FEATURE_ANALOG_TRIGGER)
+
 #define define_io_key(_name, _id) \
     define_io_button(_name, _id)
 
@@ -58,10 +84,43 @@ define_io_key(rbtk_io_key_left, "Left");
 define_io_key(rbtk_io_key_right, "Right");
 define_io_key(rbtk_io_key_space, "Space");
 define_io_key(rbtk_io_key_enter, "Enter");
+define_io_key(rbtk_io_key_f3, "F3");
+
+define_io_button(rbtk_io_xbox_a, "A");
+define_io_button(rbtk_io_xbox_b, "B");
+define_io_button(rbtk_io_xbox_x, "X");
+define_io_button(rbtk_io_xbox_y, "Y");
+define_io_button(rbtk_io_xbox_lb, "LB");
+define_io_button(rbtk_io_xbox_rb, "RB");
+define_io_button(rbtk_io_xbox_back, "Back");
+define_io_button(rbtk_io_xbox_start, "Start");
+define_io_button(rbtk_io_xbox_guide, "Guide");
+define_io_button(rbtk_io_xbox_ls, "LS");
+define_io_button(rbtk_io_xbox_rs, "RS");
+define_io_button(rbtk_io_xbox_up, "D-Pad Up");
+define_io_button(rbtk_io_xbox_down, "D-Pad Down");
+define_io_button(rbtk_io_xbox_left, "D-Pad Left");
+define_io_button(rbtk_io_xbox_right, "D-Pad Right");
+define_io_stick(rbtk_io_xbox_lstick, "Left Stick");
+define_io_stick(rbtk_io_xbox_rstick, "Right Stick");
+define_io_trigger(rbtk_io_xbox_lt, "LT");
+define_io_trigger(rbtk_io_xbox_rt, "RT");
 
 static rbtk_io_keyboard_state_type keyboard_state;
+static RBTK_IO_DEVICE *devices_head;
+static RBTK_IO_DEVICE *devices_tail;
+static size_t num_indexed_features;
 static bool initialized;
 
+static long double unpresented_input_time;
+static bool has_unpresented_input;
+static bool latency_gpu_sync;
+
+static struct {
+    RBTK_STAT *latency_ms;
+    RBTK_STAT *gpu_latency_ms;
+} stats;
+
 static bool
 init_keyboard(void)
 {
@@ -85,6 +144,7 @@ init_keyboard(void)
     keyboard_state.right = add_io_key(rbtk_io_keyboard, rbtk_io_key_right);
     keyboard_state.space = add_io_key(rbtk_io_keyboard, rbtk_io_key_space);
     keyboard_state.enter = add_io_key(rbtk_io_keyboard, rbtk_io_key_enter);
+    keyboard_state.f3 = add_io_key(rbtk_io_keyboard, rbtk_io_key_f3);
 
     return true;
 }
@@ -100,6 +160,13 @@ priv_rbtk_input_init(void)
         return false;
     }
 
+    /* a missing stat is not fatal, it is just not recorded */
+    stats.latency_ms = rbtk_get_stat("input.latency_ms",
+        RBTK_STAT_TYPE_SAMPLE);
+    stats.gpu_latency_ms = rbtk_get_stat("input.gpu_latency_ms",
+        RBTK_STAT_TYPE_SAMPLE);
+    has_unpresented_input = false;
+
     initialized = true;
     return true;
 }
@@ -110,6 +177,7 @@ deinit_keyboard(void)
     if (!rbtk_destroy_io_device(rbtk_io_keyboard)) {
         return false;
     }
+    rbtk_io_keyboard = NULL;
     RBTK_ZERO_MEMORY(&keyboard_state);
     return true;
 }
@@ -125,6 +193,9 @@ priv_rbtk_input_terminate(void)
         return false;
     }
 
+    RBTK_ZERO_MEMORY(&stats);
+    has_unpresented_input = false;
+
     initialized = false;
     return true;
 }
@@ -135,6 +206,7 @@ rbtk_create_io_device(rbtk_io_device_type type, size_t max_features)
     RBTK_IO_DEVICE *device;
     RBTK_MALLOC_OR_RETURN(&device, NULL,
         "could not allocate memory for I/O device");
+    RBTK_ZERO_MEMORY(device);
 
     PLAT_RBTK_IO_DEVICE *plat = plat_rbtk_create_io_device(type);
     if (!plat) {
@@ -144,22 +216,35 @@ rbtk_create_io_device(rbtk_io_device_type type, size_t max_features)
     }
 
     size_t states_size = max_features * sizeof(rbtk_io_feature_state);
-    rbtk_io_feature_state **states = malloc(states_size);
+    rbtk_io_feature_state *states = malloc(states_size);
     if (!states) {
         rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
             "could not create array for I/O device states");
         return NULL;
     }
 
+    for (size_t i = 0; i < RBTK_MAX_IO_FEATURES; i++) {
+        device->slots[i] = RBTK_IO_FEATURE_NO_INDEX;
+    }
+
     device->plat = plat;
     device->type = type;
     device->max_features = max_features;
     device->num_features = 0;
     device->states = states;
 
+    RBTK_DLL_PUSH(devices_head, devices_tail, device);
     return device;
 }
 
+static void
+stop_io_replay(RBTK_IO_DEVICE *device)
+{
+    free(device->replay.features);
+    device->replay.in = NULL;
+    device->replay.num_features = 0;
+    device->replay.features = NULL;
+}
 
 bool
 rbtk_destroy_io_device(RBTK_IO_DEVICE *device)
@@ -172,42 +257,115 @@ rbtk_destroy_io_device(RBTK_IO_DEVICE *device)
         return false;
     }
 
-    for (size_t i = 0; i < device->num_features; i++) {
-        free(device->states[i]);
+    stop_io_replay(device);
+    RBTK_DLL_REMOVE(devices_head, devices_tail, device);
+    free(device->states);
+    free(device);
+    return true;
+}
+
+RBTK_PRIVATE RBTK_NO_DISCARD RBTK_IO_DEVICE *
+priv_rbtk_get_io_devices(void)
+{
+    return devices_head;
+}
+
+/*
+ * This is called by the platform from its input callbacks, which may
+ * run on a different thread than the one updating the device. Only the
+ * tail is written here, and only the head is written when popping.
+ */
+RBTK_PRIVATE bool
+priv_rbtk_push_io_event(RBTK_IO_DEVICE *device, RBTK_IO_FEATURE *feature,
+    bool pressed, long double time)
+{
+    assert(device);
+    assert(feature);
+
+    size_t tail = device->queue.tail;
+    size_t head = rbtk_atomic_load(&device->queue.head);
+    if (tail - head >= RBTK_IO_EVENT_QUEUE_SIZE) {
+        return false; /* queue is full, drop the event */
     }
 
+    size_t slot = tail & (RBTK_IO_EVENT_QUEUE_SIZE - 1);
+    rbtk_io_event *event = &device->queue.events[slot];
+    event->feature = feature;
+    event->pressed = pressed;
+    event->time = time;
+
+    rbtk_atomic_store(&device->queue.tail, tail + 1);
     return true;
 }
 
+static rbtk_io_feature_state *
+find_io_feature_state(RBTK_IO_DEVICE *device, RBTK_IO_FEATURE *feature)
+{
+    if (feature->index >= RBTK_MAX_IO_FEATURES) {
+        return NULL; /* never added to any device */
+    }
+
+    size_t slot = device->slots[feature->index];
+    if (slot == RBTK_IO_FEATURE_NO_INDEX) {
+        return NULL;
+    }
+    return &device->states[slot];
+}
+
 const rbtk_io_feature_state *
 rbtk_add_io_feature(RBTK_IO_DEVICE *device, RBTK_IO_FEATURE *feature)
 {
     assert(device);
     assert(feature);
 
+    rbtk_io_feature_state *state = find_io_feature_state(device, feature);
+    if (state) {
+        return state; /* already added, don't fuss */
+    }
+
     if (device->num_features >= device->max_features) {
         rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
-            "all %d slots for I/O features used", device->max_features);
+            "all %zu slots for I/O features used", device->max_features);
         return NULL;
     }
 
-    for (size_t i = 0; i < device->num_features; i++) {
-        rbtk_io_feature_state *state = device->states[i];
-        if (state->feature == feature) {
-            return state; /* already added, don't fuss */
+    if (feature->index == RBTK_IO_FEATURE_NO_INDEX) {
+        if (num_indexed_features >= RBTK_MAX_IO_FEATURES) {
+            rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+                "all %d indices for I/O features used",
+                RBTK_MAX_IO_FEATURES);
+            return NULL;
         }
+        feature->index = num_indexed_features;
+        num_indexed_features += 1;
     }
 
-    rbtk_io_feature_state *state;
-    RBTK_MALLOC_OR_RETURN(&state, NULL,
-        "could not allocate memory for I/O feature state");
+    size_t slot = device->num_features;
+    state = &device->states[slot];
     RBTK_ZERO_MEMORY(state);
 
     state->device = device;
     state->feature = feature;
+    state->type = feature->type;
+
+    /*
+     * Button states are otherwise only changed by events. If the button
+     * is already held when it is added, the press event has come and
+     * gone. Sample it once here so the eventual release makes sense.
+     */
+    if (feature->type == RBTK_IO_FEATURE_BUTTON) {
+        state->button.is_pressed =
+            plat_rbtk_io_button_is_pressed(device, feature);
+    }
+    else if (feature->type == RBTK_IO_FEATURE_ANALOG_STICK) {
+        plat_rbtk_get_io_stick_pos(device, feature, state->stick.pos);
+    }
+    else if (feature->type == RBTK_IO_FEATURE_ANALOG_TRIGGER) {
+        state->trigger.force =
+            plat_rbtk_get_io_trigger_force(device, feature);
+    }
 
-    size_t next_slot = device->num_features;
-    device->states[next_slot] = state;
+    device->slots[feature->index] = slot;
     device->num_features += 1;
 
     return state;
@@ -218,47 +376,545 @@ rbtk_get_io_feature_state(RBTK_IO_DEVICE *device, RBTK_IO_FEATURE *feature)
 {
     assert(device);
     assert(feature);
-    for (size_t i = 0; i < device->num_features; i++) {
-        rbtk_io_feature_state *state = device->states[i];
-        if (state->feature == feature) {
-            return state;
-        }
-    }
-    return NULL;
+    return find_io_feature_state(device, feature);
 }
 
 static void
-update_io_button(rbtk_io_feature_state *state)
+apply_io_button_event(rbtk_io_feature_state *state,
+    const rbtk_io_event *event)
 {
     assert(state);
     assert(state->feature->type == RBTK_IO_FEATURE_BUTTON);
 
     bool was_pressed = state->button.is_pressed;
-    bool is_pressed = plat_rbtk_io_button_is_pressed(
-        state->device, state->feature);
+    if (event->pressed == was_pressed) {
+        return; /* nothing changed, don't fuss */
+    }
 
-    state->button.is_pressed = is_pressed;
-    state->button.just_pressed = (is_pressed && !was_pressed);
-    state->button.just_released = (!is_pressed && was_pressed);
+    /*
+     * These are only ever set here, and are cleared at the start of each
+     * update. This way, a button pressed and released between two updates
+     * is reported as both just pressed and just released.
+     */
+    if (event->pressed) {
+        state->button.just_pressed = true;
+    }
+    else {
+        state->button.just_released = true;
+    }
+    state->button.is_pressed = event->pressed;
+    state->button.time = event->time;
+
+    /*
+     * Latency is measured from the oldest input that has not yet made it
+     * to the screen. Any input after it is presented in the same frame,
+     * and so it would only make the latency appear shorter than it is.
+     */
+    if (!has_unpresented_input || event->time < unpresented_input_time) {
+        unpresented_input_time = event->time;
+        has_unpresented_input = true;
+    }
 }
 
-bool
-rbtk_update_io_device(RBTK_IO_DEVICE *device)
+static void
+apply_io_event(RBTK_IO_DEVICE *device, const rbtk_io_event *event)
 {
-    assert(device);
+    rbtk_io_feature_state *state =
+        find_io_feature_state(device, event->feature);
+    if (!state) {
+        return; /* feature was never added */
+    }
+
+    switch (state->feature->type) {
+    case RBTK_IO_FEATURE_BUTTON:
+        apply_io_button_event(state, event);
+        break;
+    default:
+        assert(0); /* we forgot one! */
+        break;
+    }
+}
+
+static void
+update_io_stick(rbtk_io_feature_state *state)
+{
+    vec3 pos;
+    plat_rbtk_get_io_stick_pos(state->device, state->feature, pos);
+    glm_vec3_sub(pos, state->stick.pos, state->stick.delta);
+    glm_vec3_copy(pos, state->stick.pos);
+}
+
+static void
+update_io_trigger(rbtk_io_feature_state *state)
+{
+    float force =
+        plat_rbtk_get_io_trigger_force(state->device, state->feature);
+    state->trigger.force_delta = force - state->trigger.force;
+    state->trigger.force = force;
+}
+
+static void
+drain_io_events(RBTK_IO_DEVICE *device, bool apply)
+{
+    size_t head = device->queue.head;
+    size_t tail = rbtk_atomic_load(&device->queue.tail);
+    while (head != tail) {
+        size_t slot = head & (RBTK_IO_EVENT_QUEUE_SIZE - 1);
+        if (apply) {
+            apply_io_event(device, &device->queue.events[slot]);
+        }
+        head += 1;
+    }
+    rbtk_atomic_store(&device->queue.head, head);
+}
+
+static bool
+update_live_io_device(RBTK_IO_DEVICE *device)
+{
+    /*
+     * Some devices (e.g., controllers) have no callbacks to report their
+     * input. For these, the platform takes a snapshot of the device once
+     * per update. Buttons which changed since the last snapshot are then
+     * pushed as events, while analog features are read from it below.
+     */
+    if (!plat_rbtk_poll_io_device(device)) {
+        return false;
+    }
+
     for (size_t i = 0; i < device->num_features; i++) {
-        rbtk_io_feature_state *state = device->states[i];
-        switch (state->feature->type) {
+        rbtk_io_feature_state *state = &device->states[i];
+        switch (state->type) {
         case RBTK_IO_FEATURE_BUTTON:
-            update_io_button(state);
+            state->button.just_pressed = false;
+            state->button.just_released = false;
+            break;
+        case RBTK_IO_FEATURE_ANALOG_STICK:
+            update_io_stick(state);
+            break;
+        case RBTK_IO_FEATURE_ANALOG_TRIGGER:
+            update_io_trigger(state);
             break;
         default:
             assert(0);    /* we forgot one!      */
             return false; /* pacify the compiler */
         }
     }
+
+    drain_io_events(device, true);
+    return true;
+}
+
+static bool
+write_u8(RBTK_OUT_STREAM *out, unsigned value)
+{
+    return rbtk_write_byte(out, (unsigned char) value);
+}
+
+static bool
+write_u16(RBTK_OUT_STREAM *out, unsigned value)
+{
+    unsigned char bytes[2] = {
+        (unsigned char) (value >> 0),
+        (unsigned char) (value >> 8),
+    };
+    return rbtk_write_bytes(out, bytes, 0, sizeof(bytes)) == sizeof(bytes);
+}
+
+static bool
+write_f32(RBTK_OUT_STREAM *out, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    unsigned char bytes[4];
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = (unsigned char) (bits >> (i * 8));
+    }
+    return rbtk_write_bytes(out, bytes, 0, sizeof(bytes)) == sizeof(bytes);
+}
+
+static bool
+write_f64(RBTK_OUT_STREAM *out, double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    unsigned char bytes[8];
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = (unsigned char) (bits >> (i * 8));
+    }
+    return rbtk_write_bytes(out, bytes, 0, sizeof(bytes)) == sizeof(bytes);
+}
+
+static bool
+read_exactly(RBTK_IN_STREAM *in, void *buf, size_t len)
+{
+    return rbtk_read_bytes(in, buf, 0, len) == len;
+}
+
+static bool
+read_u8(RBTK_IN_STREAM *in, unsigned *value)
+{
+    unsigned char byte;
+    if (!read_exactly(in, &byte, sizeof(byte))) {
+        return false;
+    }
+    *value = byte;
+    return true;
+}
+
+static bool
+read_u16(RBTK_IN_STREAM *in, unsigned *value)
+{
+    unsigned char bytes[2];
+    if (!read_exactly(in, bytes, sizeof(bytes))) {
+        return false;
+    }
+    *value = (unsigned) bytes[0] | ((unsigned) bytes[1] << 8);
     return true;
 }
 
+static bool
+read_f32(RBTK_IN_STREAM *in, float *value)
+{
+    unsigned char bytes[4];
+    if (!read_exactly(in, bytes, sizeof(bytes))) {
+        return false;
+    }
+
+    uint32_t bits = 0;
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        bits |= (uint32_t) bytes[i] << (i * 8);
+    }
+    memcpy(value, &bits, sizeof(*value));
+    return true;
+}
+
+static bool
+read_f64(RBTK_IN_STREAM *in, double *value)
+{
+    unsigned char bytes[8];
+    if (!read_exactly(in, bytes, sizeof(bytes))) {
+        return false;
+    }
+
+    uint64_t bits = 0;
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        bits |= (uint64_t) bytes[i] << (i * 8);
+    }
+    memcpy(value, &bits, sizeof(*value));
+    return true;
+}
+
+static bool
+write_io_recording_header(RBTK_IO_DEVICE *device, RBTK_OUT_STREAM *out)
+{
+    size_t magic_len = IO_RECORDING_MAGIC_LEN;
+    if (rbtk_write_bytes(out, IO_RECORDING_MAGIC, 0, magic_len) != magic_len
+        || !write_u8(out, IO_RECORDING_VERSION)
+        || !write_u8(out, device->type)
+        || !write_u16(out, (unsigned) device->num_features)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < device->num_features; i++) {
+        const RBTK_IO_FEATURE *feature = device->states[i].feature;
+        size_t id_len = strlen(feature->id);
+        assert(id_len <= UCHAR_MAX);
+        if (!write_u8(out, feature->type)
+            || !write_u8(out, (unsigned) id_len)
+            || rbtk_write_bytes(out, feature->id, 0, id_len) != id_len) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool
+write_io_frame(RBTK_IO_DEVICE *device, long double time)
+{
+    RBTK_OUT_STREAM *out = device->recording.out;
+    long double start = device->recording.start;
+
+    if (!write_f64(out, (double) (time - start))) {
+        return false;
+    }
+
+    for (size_t i = 0; i < device->recording.num_features; i++) {
+        const rbtk_io_feature_state *state = &device->states[i];
+        bool written = false;
+        switch (state->type) {
+        case RBTK_IO_FEATURE_BUTTON:
+            written = write_u8(out, (state->button.is_pressed << 0)
+                    | (state->button.just_pressed << 1)
+                    | (state->button.just_released << 2))
+                && write_f64(out, (double) (state->button.time - start));
+            break;
+        case RBTK_IO_FEATURE_ANALOG_STICK:
+            written = write_f32(out, state->stick.pos[0])
+                && write_f32(out, state->stick.pos[1])
+                && write_f32(out, state->stick.pos[2])
+                && write_f32(out, state->stick.delta[0])
+                && write_f32(out, state->stick.delta[1])
+                && write_f32(out, state->stick.delta[2]);
+            break;
+        case RBTK_IO_FEATURE_ANALOG_TRIGGER:
+            written = write_f32(out, state->trigger.force)
+                && write_f32(out, state->trigger.force_delta);
+            break;
+        default:
+            assert(0); /* we forgot one! */
+            break;
+        }
+
+        if (!written) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+rbtk_record_io_device(RBTK_IO_DEVICE *device, RBTK_OUT_STREAM *out)
+{
+    assert(device);
+
+    device->recording.out = NULL;
+    if (!out) {
+        return true;
+    }
+
+    if (!write_io_recording_header(device, out)) {
+        rbtk_signal_error(RBTK_ERROR_IO,
+            "failed to write I/O recording header");
+        return false;
+    }
+
+    device->recording.out = out;
+    device->recording.num_features = device->num_features;
+    device->recording.start = rbtk_time(RBTK_MILLIS);
+    return true;
+}
+
+static rbtk_io_feature_state *
+find_io_feature_state_by_id(RBTK_IO_DEVICE *device,
+    rbtk_io_feature_type type, const char *id)
+{
+    for (size_t i = 0; i < device->num_features; i++) {
+        rbtk_io_feature_state *state = &device->states[i];
+        if (state->type == type && !strcmp(state->feature->id, id)) {
+            return state;
+        }
+    }
+    return NULL;
+}
+
+static bool
+read_io_recording_header(RBTK_IO_DEVICE *device, RBTK_IN_STREAM *in)
+{
+    char magic[IO_RECORDING_MAGIC_LEN];
+    unsigned version, type, num_features;
+    if (!read_exactly(in, magic, sizeof(magic))
+        || memcmp(magic, IO_RECORDING_MAGIC, sizeof(magic))
+        || !read_u8(in, &version) || version != IO_RECORDING_VERSION
+        || !read_u8(in, &type) || type != (unsigned) device->type
+        || !read_u16(in, &num_features)) {
+        rbtk_signal_error(RBTK_ERROR_IO,
+            "not an I/O recording for this type of device");
+        return false;
+    }
+
+    rbtk_io_replayed_feature *features =
+        calloc(num_features ? num_features : 1, sizeof(*features));
+    if (!features) {
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate replayed I/O features");
+        return false;
+    }
+
+    for (unsigned i = 0; i < num_features; i++) {
+        char id[UCHAR_MAX + 1];
+        unsigned feature_type, id_len;
+        if (!read_u8(in, &feature_type) || !read_u8(in, &id_len)
+            || !read_exactly(in, id, id_len)) {
+            free(features);
+            rbtk_signal_error(RBTK_ERROR_IO,
+                "I/O recording header is truncated");
+            return false;
+        }
+        id[id_len] = '\0';
+
+        features[i].type = (rbtk_io_feature_type) feature_type;
+        features[i].state =
+            find_io_feature_state_by_id(device, features[i].type, id);
+    }
+
+    device->replay.num_features = num_features;
+    device->replay.features = features;
+    return true;
+}
+
+/*
+ * Returns 1 if a frame was read, 0 at the end of the recording, and -1
+ * if the recording is malformed. The states of recorded features which
+ * the device lacks are still read, and then thrown away.
+ */
+static int
+read_io_frame(RBTK_IO_DEVICE *device)
+{
+    RBTK_IN_STREAM *in = device->replay.in;
+    long double start = device->replay.start;
+
+    double frame_time;
+    if (!read_f64(in, &frame_time)) {
+        return 0; /* end of recording */
+    }
+
+    for (size_t i = 0; i < device->replay.num_features; i++) {
+        rbtk_io_replayed_feature *replayed = &device->replay.features[i];
+        rbtk_io_feature_state dummy;
+        rbtk_io_feature_state *state = replayed->state;
+        if (!state) {
+            state = &dummy;
+        }
+
+        bool read = false;
+        switch (replayed->type) {
+        case RBTK_IO_FEATURE_BUTTON: {
+            unsigned flags;
+            double time;
+            read = read_u8(in, &flags) && read_f64(in, &time);
+            state->button.is_pressed = (flags & 0x01) != 0;
+            state->button.just_pressed = (flags & 0x02) != 0;
+            state->button.just_released = (flags & 0x04) != 0;
+            state->button.time = start + time;
+            break;
+        }
+        case RBTK_IO_FEATURE_ANALOG_STICK:
+            read = read_f32(in, &state->stick.pos[0])
+                && read_f32(in, &state->stick.pos[1])
+                && read_f32(in, &state->stick.pos[2])
+                && read_f32(in, &state->stick.delta[0])
+                && read_f32(in, &state->stick.delta[1])
+                && read_f32(in, &state->stick.delta[2]);
+            break;
+        case RBTK_IO_FEATURE_ANALOG_TRIGGER:
+            read = read_f32(in, &state->trigger.force)
+                && read_f32(in, &state->trigger.force_delta);
+            break;
+        default:
+            break; /* unknown type, can't know its size */
+        }
+
+        if (!read) {
+            return -1;
+        }
+    }
+
+    return 1;
+}
+
+bool
+rbtk_replay_io_device(RBTK_IO_DEVICE *device, RBTK_IN_STREAM *in)
+{
+    assert(device);
+
+    stop_io_replay(device);
+    if (!in) {
+        return true;
+    }
+
+    if (!read_io_recording_header(device, in)) {
+        return false;
+    }
+
+    device->replay.in = in;
+    device->replay.start = rbtk_time(RBTK_MILLIS);
+    return true;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_io_device_is_replaying(const RBTK_IO_DEVICE *device)
+{
+    assert(device);
+    return device->replay.in != NULL;
+}
+
+bool
+rbtk_update_io_device(RBTK_IO_DEVICE *device)
+{
+    assert(device);
+
+    /*
+     * While replaying, input from the platform is thrown away so it does
+     * not leak into the replay. Once the recording ends, the device goes
+     * back to receiving live input on the very same update.
+     */
+    bool replayed = false;
+    if (device->replay.in) {
+        drain_io_events(device, false);
+        int result = read_io_frame(device);
+        if (result < 0) {
+            stop_io_replay(device);
+            rbtk_signal_error(RBTK_ERROR_IO, "I/O recording is truncated");
+            return false;
+        }
+        else if (result == 0) {
+            stop_io_replay(device);
+        }
+        else {
+            replayed = true;
+        }
+    }
+
+    if (!replayed && !update_live_io_device(device)) {
+        return false;
+    }
+
+    if (device->recording.out) {
+        if (!write_io_frame(device, rbtk_time(RBTK_MILLIS))) {
+            device->recording.out = NULL;
+            rbtk_signal_error(RBTK_ERROR_IO,
+                "failed to write I/O recording frame");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void
+rbtk_set_input_latency_gpu_sync(bool enabled)
+{
+    latency_gpu_sync = enabled;
+}
+
+RBTK_NO_DISCARD bool
+priv_rbtk_input_awaits_gpu(void)
+{
+    return latency_gpu_sync && has_unpresented_input;
+}
+
+void
+priv_rbtk_input_presented(long double presented, long double completed)
+{
+    if (!has_unpresented_input) {
+        return; /* nothing new made it to the screen */
+    }
+
+    if (stats.latency_ms) {
+        rbtk_sample_stat(stats.latency_ms,
+            presented - unpresented_input_time);
+    }
+    if (stats.gpu_latency_ms && completed >= presented) {
+        rbtk_sample_stat(stats.gpu_latency_ms,
+            completed - unpresented_input_time);
+    }
+
+    has_unpresented_input = false;
+}
+
 RBTK_IO_DEVICE *rbtk_io_keyboard = NULL;
 const rbtk_io_keyboard_state_type *const rbtk_io_keyboard_state = &keyboard_state;
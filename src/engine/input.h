@@ -33,6 +33,7 @@ extern "C" {
 #include "../libraries/cglm_no_io.h"
 
 #include "../runtime/common.h"
+#include "../runtime/stream.h"
 
 /*!
  * @file
@@ -76,9 +77,10 @@ typedef enum rbtk_io_feature_type {
  * @see rbtk_io_feature_state
  */
 typedef struct rbtk_io_button_state {
-    bool is_pressed;    /*!< If the button is currently pressed. */
-    bool just_pressed;  /*!< If the button was just pressed.     */
-    bool just_released; /*!< If the button was just released.    */
+    bool is_pressed;    /*!< If the button is currently pressed.        */
+    bool just_pressed;  /*!< If the button was just pressed.            */
+    bool just_released; /*!< If the button was just released.           */
+    long double time;   /*!< When the button last changed, in millis.   */
 } rbtk_io_button_state;
 
 /*!
@@ -89,6 +91,9 @@ typedef rbtk_io_button_state rbtk_io_key_state;
 /*!
  * @brief Contains the state of an analog stick.
  *
+ * Each axis of the position ranges from `-1` to `1`, with the stick at
+ * rest being `0`. Only the X and Y axes are used.
+ *
  * @see rbtk_io_feature_state
  */
 typedef struct rbtk_io_analog_stick_state {
@@ -102,8 +107,8 @@ typedef struct rbtk_io_analog_stick_state {
  * @see rbtk_io_feature_state
  */
 typedef struct rbtk_io_analog_trigger_state {
-    float force;       /*!< The force of the analog trigger. */
-    float force_delta; /*!< The change in the force.         */
+    float force;       /*!< The force of the trigger, 0 to 1. */
+    float force_delta; /*!< The change in the force.          */
 } rbtk_io_analog_trigger_state;
 
 /*!
@@ -194,16 +199,110 @@ rbtk_destroy_io_device(RBTK_IO_DEVICE *device);
  * pending output commands. This should be called once every frame for
  * the device.
  *
+ * Button states are derived from the events received since the last
+ * update, rather than by sampling each button once per frame. As such,
+ * a press shorter than a frame is not lost. When this happens, both
+ * `just_pressed` and `just_released` are set for the same update, while
+ * `is_pressed` is not.
+ *
  * @param[in] device The I/O device to update.
  * @return `true` on success, `false` on failure.
  *
  * @debugging This function asserts that `device` is not `NULL`.
  *
  * @see rbtk_get_io_feature_state(RBTK_IO_DEVICE *, RBTK_IO_FEATURE *)
+ * @see rbtk_replay_io_device(RBTK_IO_DEVICE *, RBTK_IN_STREAM *)
  */
 bool
 rbtk_update_io_device(RBTK_IO_DEVICE *device);
 
+/*!
+ * @brief Records the state of an I/O device to an output stream.
+ *
+ * While recording, the state of every feature of the device is written
+ * to the stream each time the device is updated, along with the time of
+ * the update. Only features added before recording begins are recorded.
+ * A recording can be fed back into a device with the same features via
+ * #rbtk_replay_io_device(RBTK_IO_DEVICE *, RBTK_IN_STREAM *).
+ *
+ * @note The stream is not closed when recording stops. It is up to the
+ * caller to close it afterwards.
+ *
+ * @param[in] device The I/O device to record.
+ * @param[in] out    The stream to record to, `NULL` to stop recording.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `device` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO, If an I/O error occurs.}
+ * @enderrors
+ */
+bool
+rbtk_record_io_device(RBTK_IO_DEVICE *device, RBTK_OUT_STREAM *out);
+
+/*!
+ * @brief Replays a recording of an I/O device.
+ *
+ * While replaying, updating the device reads the next frame of the
+ * recording instead of receiving input from the platform. The replay
+ * stops once the end of the recording is reached, after which the
+ * device goes back to receiving input from the platform.
+ *
+ * Recorded features are matched with those of the device by their ID.
+ * Features of the device which were not recorded keep their state, and
+ * recorded features which the device lacks are skipped.
+ *
+ * @note The stream is not closed when replay stops. It is up to the
+ * caller to close it afterwards.
+ *
+ * @param[in] device The I/O device to replay to.
+ * @param[in] in     The recording to replay, `NULL` to stop replaying.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `device` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO,            If an I/O error occurs; If the
+ *                                    recording is malformed or for a
+ *                                    different type of device.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
+ * @enderrors
+ *
+ * @see rbtk_record_io_device(RBTK_IO_DEVICE *, RBTK_OUT_STREAM *)
+ */
+bool
+rbtk_replay_io_device(RBTK_IO_DEVICE *device, RBTK_IN_STREAM *in);
+
+/*!
+ * @brief Returns if an I/O device is replaying a recording.
+ *
+ * @param[in] device The I/O device.
+ * @return `true` if the device is replaying a recording, `false`
+ * otherwise.
+ *
+ * @debugging This function asserts that `device` is not `NULL`.
+ */
+RBTK_NO_DISCARD bool
+rbtk_io_device_is_replaying(const RBTK_IO_DEVICE *device);
+
+/*!
+ * @brief Sets if input latency is measured until the GPU finishes.
+ *
+ * Input latency is always measured from when the platform delivers an
+ * input to when the frame which consumed it is presented. This is given
+ * to the `input.latency_ms` stat. Presenting a frame only queues it for
+ * the GPU, however. When enabled, the engine also waits for the GPU to
+ * finish each frame with new input, and gives the time until then to the
+ * `input.gpu_latency_ms` stat.
+ *
+ * @param[in] enabled `true` to wait for the GPU, `false` otherwise.
+ *
+ * @note Waiting on the GPU keeps it from running ahead of the program,
+ * which by itself lowers latency. This should only be enabled when
+ * measuring, and is disabled by default.
+ */
+void
+rbtk_set_input_latency_gpu_sync(bool enabled);
+
 /*!
  * @brief Adds an I/O feature to a device.
  *
@@ -261,6 +360,27 @@ extern RBTK_IO_FEATURE *const rbtk_io_key_left;  /*!< The left arrow key on the
 extern RBTK_IO_FEATURE *const rbtk_io_key_right; /*!< The right arrow key on the keyboard. */
 extern RBTK_IO_FEATURE *const rbtk_io_key_space; /*!< The space key on the keyboard.       */
 extern RBTK_IO_FEATURE *const rbtk_io_key_enter; /*!< The  enter key on the keyboard.      */
+extern RBTK_IO_FEATURE *const rbtk_io_key_f3;    /*!< The F3 key on the keyboard.          */
+
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_a;      /*!< The A button on a controller.        */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_b;      /*!< The B button on a controller.        */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_x;      /*!< The X button on a controller.        */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_y;      /*!< The Y button on a controller.        */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_lb;     /*!< The left bumper on a controller.     */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_rb;     /*!< The right bumper on a controller.    */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_back;   /*!< The back button on a controller.     */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_start;  /*!< The start button on a controller.    */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_guide;  /*!< The guide button on a controller.    */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_ls;     /*!< Pressing down the left stick.       */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_rs;     /*!< Pressing down the right stick.      */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_up;     /*!< The D-pad up on a controller.        */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_down;   /*!< The D-pad down on a controller.      */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_left;   /*!< The D-pad left on a controller.      */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_right;  /*!< The D-pad right on a controller.     */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_lstick; /*!< The left stick on a controller.      */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_rstick; /*!< The right stick on a controller.     */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_lt;     /*!< The left trigger on a controller.    */
+extern RBTK_IO_FEATURE *const rbtk_io_xbox_rt;     /*!< The right trigger on a controller.   */
 
 /*!
  * @brief Contains the current state of the keyboard.
@@ -283,6 +403,7 @@ typedef struct rbtk_io_keyboard_state_type {
     const rbtk_io_key_state *right; /*!< The state of the right arrow key. */
     const rbtk_io_key_state *space; /*!< The state of the space key.       */
     const rbtk_io_key_state *enter; /*!< The state of the enter key.       */
+    const rbtk_io_key_state *f3;    /*!< The state of the F3 key.          */
 } rbtk_io_keyboard_state_type;
 
 extern const rbtk_io_keyboard_state_type *const rbtk_io_keyboard_state; /*!< The current state of the keyboard. */
@@ -0,0 +1,242 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "overlay.h"
+#include "./private/overlay.h"
+
+#include <assert.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "graphics.h"
+
+#include "../runtime/common.h"
+#include "../runtime/stats.h"
+#include "../runtime/time.h"
+
+#define GLYPH_WIDTH  5
+#define GLYPH_HEIGHT 7
+#define CELL_WIDTH   (GLYPH_WIDTH + 1)
+#define CELL_HEIGHT  (GLYPH_HEIGHT + 1)
+
+/*
+ * Each line is the name of a stat, followed by its value, mean, and max.
+ * The name is cut off so the line fits within a 256 pixel wide scene when
+ * using the built-in font.
+ */
+#define LINE_FORMAT   "%-18.18s %7.2Lf %7.2Lf %7.2Lf"
+#define MAX_COLUMNS   42
+#define MAX_LINES     32
+#define OVERLAY_WIDTH (MAX_COLUMNS * CELL_WIDTH + 1)
+
+#define BACKGROUND_ALPHA 0xA0
+
+/*
+ * A minimal 5x7 font, just enough to display stats. Each glyph is stored
+ * as one byte per row, with the leftmost pixel in the fifth bit. Letters
+ * are only stored in uppercase, as lowercase ones are drawn using them.
+ */
+static const unsigned char FONT[128][GLYPH_HEIGHT] = {
+    ['0'] = { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E },
+    ['1'] = { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E },
+    ['2'] = { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F },
+    ['3'] = { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E },
+    ['4'] = { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 },
+    ['5'] = { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E },
+    ['6'] = { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E },
+    ['7'] = { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },
+    ['8'] = { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E },
+    ['9'] = { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C },
+    ['A'] = { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 },
+    ['B'] = { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E },
+    ['C'] = { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E },
+    ['D'] = { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C },
+    ['E'] = { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F },
+    ['F'] = { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 },
+    ['G'] = { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F },
+    ['H'] = { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 },
+    ['I'] = { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E },
+    ['J'] = { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C },
+    ['K'] = { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 },
+    ['L'] = { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F },
+    ['M'] = { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 },
+    ['N'] = { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 },
+    ['O'] = { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },
+    ['P'] = { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 },
+    ['Q'] = { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D },
+    ['R'] = { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 },
+    ['S'] = { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E },
+    ['T'] = { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },
+    ['U'] = { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },
+    ['V'] = { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 },
+    ['W'] = { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A },
+    ['X'] = { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 },
+    ['Y'] = { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 },
+    ['Z'] = { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F },
+    ['.'] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C },
+    [','] = { 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 },
+    [':'] = { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 },
+    ['_'] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F },
+    ['-'] = { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 },
+    ['+'] = { 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 },
+    ['='] = { 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 },
+    ['/'] = { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 },
+    ['%'] = { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 },
+};
+
+static bool shown;
+static RBTK_SPRITE *sprite;
+static long double last_refresh;
+static bool initialized;
+
+RBTK_PRIVATE RBTK_NO_DISCARD bool
+priv_rbtk_overlay_init(void)
+{
+    if (initialized) {
+        return true;
+    }
+
+    shown = false;
+    sprite = NULL;
+    last_refresh = 0.0L;
+
+    initialized = true;
+    return true;
+}
+
+RBTK_PRIVATE RBTK_NO_DISCARD bool
+priv_rbtk_overlay_terminate(void)
+{
+    if (!initialized) {
+        return true;
+    }
+
+    if (!rbtk_unload_sprite(sprite)) {
+        return false;
+    }
+    sprite = NULL;
+
+    initialized = false;
+    return true;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_stats_overlay_is_shown(void)
+{
+    return shown;
+}
+
+void
+rbtk_show_stats_overlay(bool show)
+{
+    shown = show;
+}
+
+static void
+draw_glyph(unsigned char *pixels, size_t x, size_t y, char c)
+{
+    const unsigned char *glyph = FONT[toupper((unsigned char) c) & 0x7F];
+    for (size_t row = 0; row < GLYPH_HEIGHT; row++) {
+        for (size_t col = 0; col < GLYPH_WIDTH; col++) {
+            if (!(glyph[row] & (0x10 >> col))) {
+                continue; /* pixel not set */
+            }
+            size_t off = ((y + row) * OVERLAY_WIDTH + (x + col)) * 4;
+            pixels[off + 0] = 0xFF;
+            pixels[off + 1] = 0xFF;
+            pixels[off + 2] = 0xFF;
+            pixels[off + 3] = 0xFF;
+        }
+    }
+}
+
+static RBTK_SPRITE *
+create_overlay_sprite(void)
+{
+    size_t num_stats;
+    RBTK_STATS stats = rbtk_get_stats(&num_stats);
+    if (num_stats == 0) {
+        return NULL; /* nothing to display */
+    }
+    if (num_stats > MAX_LINES) {
+        num_stats = MAX_LINES;
+    }
+
+    size_t height = num_stats * CELL_HEIGHT + 1;
+    unsigned char *pixels = malloc(OVERLAY_WIDTH * height * 4);
+    if (!pixels) {
+        return NULL; /* try again next refresh */
+    }
+
+    /* dim whatever is underneath so the text is readable */
+    for (size_t i = 0; i < OVERLAY_WIDTH * height; i++) {
+        pixels[i * 4 + 0] = 0x00;
+        pixels[i * 4 + 1] = 0x00;
+        pixels[i * 4 + 2] = 0x00;
+        pixels[i * 4 + 3] = BACKGROUND_ALPHA;
+    }
+
+    for (size_t i = 0; i < num_stats; i++) {
+        RBTK_STAT *stat = stats[i];
+
+        char line[MAX_COLUMNS + 1];
+        snprintf(line, sizeof(line), LINE_FORMAT,
+            rbtk_get_stat_name(stat), rbtk_get_stat_value(stat),
+            rbtk_get_stat_mean(stat), rbtk_get_stat_max(stat));
+
+        for (size_t col = 0; line[col] != '\0'; col++) {
+            draw_glyph(pixels, col * CELL_WIDTH + 1,
+                i * CELL_HEIGHT + 1, line[col]);
+        }
+    }
+
+    RBTK_SPRITE *created = rbtk_create_sprite(OVERLAY_WIDTH,
+        (unsigned int) height, pixels);
+    free(pixels);
+    return created;
+}
+
+void
+rbtk_draw_stats_overlay(RBTK_GRAPHICS *scene)
+{
+    assert(scene);
+    assert(initialized);
+
+    if (!shown) {
+        return;
+    }
+
+    long double now = rbtk_time(RBTK_MILLIS);
+    if (!sprite || now - last_refresh >= RBTK_STATS_OVERLAY_REFRESH_MS) {
+        rbtk_unload_sprite(sprite);
+        sprite = create_overlay_sprite();
+        last_refresh = now;
+    }
+
+    if (sprite) {
+        rbtk_draw_sprite(scene, sprite, 0.0f, 0.0f, 0.0f);
+    }
+}
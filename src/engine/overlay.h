@@ -0,0 +1,105 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_OVERLAY_H_
+#define RBTK_ENGINE_OVERLAY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+ * @file
+ * @brief The public API for the game engine's overlay module.
+ */
+
+#include <stdbool.h>
+
+#include "graphics.h"
+
+#include "../runtime/common.h"
+
+/*!
+ * @defgroup engine_overlay Debug Overlay
+ * @brief The game engine's overlay module.
+ *
+ * The overlay draws the stats of the program on top of a scene. It is meant
+ * for debugging, and so uses a small built-in font rather than any assets.
+ * Each line shows the name of a stat, its current value, its mean, and its
+ * largest value.
+ *
+ * @see rbtk_draw_stats_overlay(RBTK_GRAPHICS *)
+ *
+ * @{
+ */
+
+/*!
+ * @brief How often the overlay is redrawn, in milliseconds.
+ *
+ * The contents of the overlay are drawn to a sprite, which must be created
+ * again each time the overlay is redrawn. Redrawing less often keeps this
+ * from affecting the stats which it displays.
+ */
+#define RBTK_STATS_OVERLAY_REFRESH_MS 250
+
+/*!
+ * @brief Returns if the stats overlay is shown.
+ *
+ * @return `true` if the overlay is shown, `false` otherwise.
+ */
+RBTK_NO_DISCARD bool
+rbtk_stats_overlay_is_shown(void);
+
+/*!
+ * @brief Shows or hides the stats overlay.
+ *
+ * @note The overlay is hidden by default.
+ *
+ * @param[in] show `true` to show the overlay, `false` to hide it.
+ */
+void
+rbtk_show_stats_overlay(bool show);
+
+/*!
+ * @brief Draws the stats overlay to a scene.
+ *
+ * This should be called after everything else has been drawn to the scene,
+ * so the overlay appears on top. The overlay is drawn at the top left of
+ * the scene.
+ *
+ * @note This function is a no-op if the overlay is hidden.
+ *
+ * @param[in] scene The scene to draw the overlay to.
+ *
+ * @debugging This function asserts that `scene` is not `NULL`.
+ */
+void
+rbtk_draw_stats_overlay(RBTK_GRAPHICS *scene);
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_OVERLAY_H_ */
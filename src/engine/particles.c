@@ -0,0 +1,292 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "particles.h"
+#include "./private/particles.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "graphics.h"
+
+#include "../runtime/common.h"
+
+/*
+ * SSE is always there on x86-64, and MSVC does not define __SSE__ even
+ * when it is. Anywhere else, the plain loop is left to the compiler to
+ * vectorize if it can.
+ */
+#if defined(__SSE__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define USE_SSE
+#include <xmmintrin.h>
+#endif
+
+#define LANES        4
+#define FIELD_COUNT  7
+#define TWO_PI       6.28318530717958647692f
+
+RBTK_NO_DISCARD RBTK_PARTICLES *
+rbtk_create_particles(size_t capacity)
+{
+    assert(capacity > 0);
+
+    RBTK_PARTICLES *particles = NULL;
+    RBTK_MALLOC_OR_RETURN(&particles, NULL,
+        "could not allocate memory for particles");
+
+    RBTK_ZERO_MEMORY(particles);
+    capacity = (capacity + LANES - 1) / LANES * LANES;
+    particles->capacity = capacity;
+
+    /*
+     * The padding past the last particle is still updated along with the
+     * rest of its lane. It is zeroed here so that it never holds garbage,
+     * though nothing ever reads it back.
+     */
+    float *fields = calloc(capacity * FIELD_COUNT, sizeof(*fields));
+    if (!fields) {
+        free(particles);
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate memory for particle fields");
+        return NULL;
+    }
+
+    particles->x = fields + capacity * 0;
+    particles->y = fields + capacity * 1;
+    particles->x_speed = fields + capacity * 2;
+    particles->y_speed = fields + capacity * 3;
+    particles->life = fields + capacity * 4;
+    particles->inv_lifetime = fields + capacity * 5;
+    particles->alpha = fields + capacity * 6;
+
+    return particles;
+}
+
+void
+rbtk_destroy_particles(RBTK_PARTICLES *particles)
+{
+    if (particles) {
+        free(particles->x); /* the start of every field */
+        free(particles);
+    }
+}
+
+void
+rbtk_set_particle_gravity(RBTK_PARTICLES *particles, float x, float y)
+{
+    assert(particles);
+    particles->gravity_x = x;
+    particles->gravity_y = y;
+}
+
+void
+rbtk_fade_particles(RBTK_PARTICLES *particles, bool fade)
+{
+    assert(particles);
+    particles->fade = fade;
+
+    if (!fade) {
+        for (size_t i = 0; i < particles->count; i++) {
+            particles->alpha[i] = 1.0f;
+        }
+    }
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_get_particle_count(const RBTK_PARTICLES *particles)
+{
+    assert(particles);
+    return particles->count;
+}
+
+bool
+rbtk_emit_particle(RBTK_PARTICLES *particles, float x, float y,
+    float x_speed, float y_speed, float life)
+{
+    assert(particles);
+    assert(life > 0.0f);
+
+    if (particles->count >= particles->capacity) {
+        return false; /* dropped, see the docs */
+    }
+
+    size_t i = particles->count++;
+    particles->x[i] = x;
+    particles->y[i] = y;
+    particles->x_speed[i] = x_speed;
+    particles->y_speed[i] = y_speed;
+    particles->life[i] = life;
+    particles->inv_lifetime[i] = 1.0f / life;
+    particles->alpha[i] = 1.0f;
+    return true;
+}
+
+size_t
+rbtk_emit_particle_burst(RBTK_PARTICLES *particles, float x, float y,
+    size_t count, float speed, float life)
+{
+    assert(particles);
+    assert(life > 0.0f);
+
+    for (size_t i = 0; i < count; i++) {
+        float angle = TWO_PI * (float) i / (float) count;
+        if (!rbtk_emit_particle(particles, x, y,
+                cosf(angle) * speed, sinf(angle) * speed, life)) {
+            return i;
+        }
+    }
+    return count;
+}
+
+void
+rbtk_clear_particles(RBTK_PARTICLES *particles)
+{
+    assert(particles);
+    particles->count = 0;
+}
+
+#ifdef USE_SSE
+
+static void
+integrate_particles(RBTK_PARTICLES *particles, size_t count, float delta)
+{
+    __m128 dt = _mm_set1_ps(delta);
+    __m128 gravity_x = _mm_set1_ps(particles->gravity_x * delta);
+    __m128 gravity_y = _mm_set1_ps(particles->gravity_y * delta);
+
+    /*
+     * The fields are only aligned to a float, so unaligned loads are used.
+     * On any processor from the last decade, these are just as fast when
+     * the address happens to be aligned anyway.
+     */
+    for (size_t i = 0; i < count; i += LANES) {
+        __m128 x_speed = _mm_loadu_ps(particles->x_speed + i);
+        __m128 y_speed = _mm_loadu_ps(particles->y_speed + i);
+        x_speed = _mm_add_ps(x_speed, gravity_x);
+        y_speed = _mm_add_ps(y_speed, gravity_y);
+        _mm_storeu_ps(particles->x_speed + i, x_speed);
+        _mm_storeu_ps(particles->y_speed + i, y_speed);
+
+        __m128 x = _mm_loadu_ps(particles->x + i);
+        __m128 y = _mm_loadu_ps(particles->y + i);
+        x = _mm_add_ps(x, _mm_mul_ps(x_speed, dt));
+        y = _mm_add_ps(y, _mm_mul_ps(y_speed, dt));
+        _mm_storeu_ps(particles->x + i, x);
+        _mm_storeu_ps(particles->y + i, y);
+
+        __m128 life = _mm_loadu_ps(particles->life + i);
+        life = _mm_sub_ps(life, dt);
+        _mm_storeu_ps(particles->life + i, life);
+
+        if (particles->fade) {
+            __m128 inv_lifetime = _mm_loadu_ps(particles->inv_lifetime + i);
+            _mm_storeu_ps(particles->alpha + i,
+                _mm_mul_ps(life, inv_lifetime));
+        }
+    }
+}
+
+#else
+
+static void
+integrate_particles(RBTK_PARTICLES *particles, size_t count, float delta)
+{
+    float gravity_x = particles->gravity_x * delta;
+    float gravity_y = particles->gravity_y * delta;
+
+    for (size_t i = 0; i < count; i++) {
+        particles->x_speed[i] += gravity_x;
+        particles->y_speed[i] += gravity_y;
+        particles->x[i] += particles->x_speed[i] * delta;
+        particles->y[i] += particles->y_speed[i] * delta;
+        particles->life[i] -= delta;
+    }
+
+    if (particles->fade) {
+        for (size_t i = 0; i < count; i++) {
+            particles->alpha[i] =
+                particles->life[i] * particles->inv_lifetime[i];
+        }
+    }
+}
+
+#endif /* USE_SSE */
+
+static void
+move_particle(RBTK_PARTICLES *particles, size_t dest, size_t src)
+{
+    particles->x[dest] = particles->x[src];
+    particles->y[dest] = particles->y[src];
+    particles->x_speed[dest] = particles->x_speed[src];
+    particles->y_speed[dest] = particles->y_speed[src];
+    particles->life[dest] = particles->life[src];
+    particles->inv_lifetime[dest] = particles->inv_lifetime[src];
+    particles->alpha[dest] = particles->alpha[src];
+}
+
+void
+rbtk_update_particles(RBTK_PARTICLES *particles, float delta)
+{
+    assert(particles);
+
+    if (particles->count == 0) {
+        return; /* nothing to update */
+    }
+
+    /*
+     * Whole lanes are always updated, even if the last one is only partly
+     * used. This is why the capacity is rounded up when it is created.
+     */
+    size_t lanes = (particles->count + LANES - 1) / LANES * LANES;
+    integrate_particles(particles, lanes, delta);
+
+    /*
+     * Dead particles are replaced by the last particle. The particle which
+     * was moved into the slot has not been checked yet, so the same slot is
+     * checked again before moving on.
+     */
+    size_t i = 0;
+    while (i < particles->count) {
+        if (particles->life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        particles->count--;
+        move_particle(particles, i, particles->count);
+    }
+}
+
+void
+rbtk_draw_particles(RBTK_GRAPHICS *scene, RBTK_PARTICLES *particles,
+    RBTK_SPRITE *sprite, float z)
+{
+    assert(scene);
+    assert(particles);
+    assert(sprite);
+
+    rbtk_draw_sprite_instances(scene, sprite, particles->count,
+        particles->x, particles->y, particles->alpha, z);
+}
@@ -0,0 +1,241 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_PARTICLES_H_
+#define RBTK_ENGINE_PARTICLES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+ * @file
+ * @brief The public API for the game engine's particles module.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "graphics.h"
+
+#include "../runtime/common.h"
+#include "../runtime/error.h"
+
+/*!
+ * @defgroup engine_particles Particles
+ * @brief The game engine's particles module.
+ *
+ * Effects like scattered rings, dust, explosions, and splashes are made
+ * of many small objects which only live for a moment. Creating a sprite
+ * for each of these would be far too slow. Instead, a particle system
+ * keeps a fixed number of particles, all of which look the same.
+ *
+ * The positions, speeds, and lives of the particles are each kept in
+ * their own array, so several particles can be updated at once. When a
+ * particle dies, the last particle is moved into its place. This keeps
+ * the arrays packed, at the cost of particles changing order. All of the
+ * particles are drawn with a single draw call.
+ *
+ * Positions are in pixels, speeds in pixels per second, and lives in
+ * seconds.
+ *
+ * @see rbtk_create_particles(size_t)
+ * @see rbtk_update_particles(RBTK_PARTICLES *, float)
+ * @see rbtk_draw_particles(RBTK_GRAPHICS *, RBTK_PARTICLES *,
+ *      RBTK_SPRITE *, float)
+ *
+ * @{
+ */
+
+/*!
+ * @brief A fixed-size pool of particles.
+ *
+ * @see rbtk_create_particles(size_t)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_PARTICLES RBTK_PARTICLES;
+
+/*!
+ * @brief Creates a particle system.
+ *
+ * @param[in] capacity The max number of particles which can be alive at
+ *                     once.
+ * @return The created particle system, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until it is destroyed
+ * with #rbtk_destroy_particles(RBTK_PARTICLES *).
+ *
+ * @debugging This function asserts that `capacity` is not `0`.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If memory for the particles could
+ *                                    not be allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD RBTK_PARTICLES *
+rbtk_create_particles(size_t capacity);
+
+/*!
+ * @brief Destroys a particle system.
+ *
+ * @param[in] particles The particle system to destroy. If `NULL`, this
+ *                      function is a no-op.
+ */
+void
+rbtk_destroy_particles(RBTK_PARTICLES *particles);
+
+/*!
+ * @brief Sets the gravity of a particle system.
+ *
+ * By default, there is no gravity.
+ *
+ * @param[in] particles The particle system.
+ * @param[in] x         The X-axis gravity, in pixels per second squared.
+ * @param[in] y         The Y-axis gravity, in pixels per second squared.
+ *
+ * @debugging This function asserts that `particles` is not `NULL`.
+ */
+void
+rbtk_set_particle_gravity(RBTK_PARTICLES *particles, float x, float y);
+
+/*!
+ * @brief Sets if particles fade out as they die.
+ *
+ * When enabled, the alpha of each particle is how much of its life it
+ * has left. By default, particles do not fade.
+ *
+ * @param[in] particles The particle system.
+ * @param[in] fade      `true` to fade particles, `false` otherwise.
+ *
+ * @debugging This function asserts that `particles` is not `NULL`.
+ */
+void
+rbtk_fade_particles(RBTK_PARTICLES *particles, bool fade);
+
+/*!
+ * @brief Returns the number of particles which are alive.
+ *
+ * @param[in] particles The particle system.
+ * @return The number of particles which are alive.
+ *
+ * @debugging This function asserts that `particles` is not `NULL`.
+ */
+RBTK_NO_DISCARD size_t
+rbtk_get_particle_count(const RBTK_PARTICLES *particles);
+
+/*!
+ * @brief Emits a particle.
+ *
+ * @note If the particle system is full, the particle is dropped. This is
+ * not an error, as an effect missing a few particles is not noticeable.
+ *
+ * @param[in] particles The particle system.
+ * @param[in] x         The X-axis position of the particle.
+ * @param[in] y         The Y-axis position of the particle.
+ * @param[in] x_speed   The X-axis speed of the particle.
+ * @param[in] y_speed   The Y-axis speed of the particle.
+ * @param[in] life      How long the particle lives for.
+ * @return `true` if the particle was emitted, `false` if the particle
+ * system is full.
+ *
+ * @debugging This function asserts that `particles` is not `NULL` and
+ * that `life` is positive.
+ */
+bool
+rbtk_emit_particle(RBTK_PARTICLES *particles, float x, float y,
+    float x_speed, float y_speed, float life);
+
+/*!
+ * @brief Emits particles in a ring.
+ *
+ * The particles are spread evenly around a circle, each moving away from
+ * its center at the same speed.
+ *
+ * @param[in] particles The particle system.
+ * @param[in] x         The X-axis position of the center.
+ * @param[in] y         The Y-axis position of the center.
+ * @param[in] count     The number of particles to emit.
+ * @param[in] speed     The speed of each particle.
+ * @param[in] life      How long each particle lives for.
+ * @return The number of particles which were emitted. This is less than
+ * `count` if the particle system became full.
+ *
+ * @debugging This function asserts that `particles` is not `NULL` and
+ * that `life` is positive.
+ *
+ * @see rbtk_emit_particle(RBTK_PARTICLES *, float, float, float, float,
+ *      float)
+ */
+size_t
+rbtk_emit_particle_burst(RBTK_PARTICLES *particles, float x, float y,
+    size_t count, float speed, float life);
+
+/*!
+ * @brief Kills every particle.
+ *
+ * @param[in] particles The particle system.
+ *
+ * @debugging This function asserts that `particles` is not `NULL`.
+ */
+void
+rbtk_clear_particles(RBTK_PARTICLES *particles);
+
+/*!
+ * @brief Moves each particle and ages it.
+ *
+ * Particles which have run out of life are removed.
+ *
+ * @param[in] particles The particle system.
+ * @param[in] delta     The time since the last update, in seconds.
+ *
+ * @debugging This function asserts that `particles` is not `NULL`.
+ */
+void
+rbtk_update_particles(RBTK_PARTICLES *particles, float delta);
+
+/*!
+ * @brief Draws each particle.
+ *
+ * Every particle is drawn as the same sprite, with a single draw call.
+ *
+ * @param[in] scene     The scene to draw to.
+ * @param[in] particles The particles to draw.
+ * @param[in] sprite    The sprite to draw each particle as.
+ * @param[in] z         The Z-axis position to draw the particles at.
+ *
+ * @debugging This function asserts that `scene`, `particles`, and
+ * `sprite` are not `NULL`.
+ *
+ * @see rbtk_draw_sprite_instances(RBTK_GRAPHICS *, RBTK_SPRITE *, size_t,
+ *      const float *, const float *, const float *, float)
+ */
+void
+rbtk_draw_particles(RBTK_GRAPHICS *scene, RBTK_PARTICLES *particles,
+    RBTK_SPRITE *sprite, float z);
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_PARTICLES_H_ */
@@ -0,0 +1,416 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "physics.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../runtime/common.h"
+#include "fixed.h"
+#include "tilemap.h"
+
+/*
+ * The furthest the player can be pushed out of (or pulled onto) the ground
+ * in a single tick. Anything further is treated as no ground at all.
+ */
+#define MAX_SNAP_DISTANCE 14
+
+/*
+ * On flat ground, walls are checked a little below the middle of the
+ * player. This makes low steps count as walls.
+ */
+#define FLAT_WALL_OFFSET 8
+
+/*
+ * Which side of the player the ground is on. This is decided by the angle
+ * of the ground, and turns the sensors used to follow it.
+ */
+typedef enum ground_mode {
+    GROUND_FLOOR,
+    GROUND_RIGHT_WALL,
+    GROUND_CEILING,
+    GROUND_LEFT_WALL,
+} ground_mode;
+
+static const rbtk_sensor_dir ground_dirs[] = {
+    [GROUND_FLOOR]      = RBTK_SENSOR_DOWN,
+    [GROUND_RIGHT_WALL] = RBTK_SENSOR_RIGHT,
+    [GROUND_CEILING]    = RBTK_SENSOR_UP,
+    [GROUND_LEFT_WALL]  = RBTK_SENSOR_LEFT,
+};
+
+void
+rbtk_get_sonic_physics(rbtk_physics *physics)
+{
+    assert(physics);
+
+    /* the original values were 8.8, so these have eight extra bits */
+    physics->accel = 0x0C00;
+    physics->decel = 0x8000;
+    physics->friction = 0x0C00;
+    physics->top_speed = 0x60000;
+    physics->slope_factor = 0x2000;
+    physics->air_accel = 0x1800;
+    physics->gravity = 0x3800;
+    physics->max_fall_speed = 0x100000;
+    physics->jump_force = 0x68000;
+    physics->jump_release = 0x40000;
+    physics->slip_speed = 0x28000;
+    physics->width_radius = 9;
+    physics->height_radius = 19;
+    physics->push_radius = 10;
+}
+
+static ground_mode
+get_ground_mode(rbtk_tile_angle angle)
+{
+    if (angle <= 0x20 || angle >= 0xE0) {
+        return GROUND_FLOOR;
+    }
+    else if (angle < 0x60) {
+        return GROUND_RIGHT_WALL;
+    }
+    else if (angle <= 0xA0) {
+        return GROUND_CEILING;
+    }
+    else {
+        return GROUND_LEFT_WALL;
+    }
+}
+
+/*
+ * Moves the player along the way a sensor looks. A negative distance
+ * moves them back the other way, which is how they are pushed out of
+ * the ground.
+ */
+static void
+nudge(rbtk_player_body *body, rbtk_sensor_dir dir, int32_t distance)
+{
+    rbtk_fixed offset = rbtk_int_to_fixed(distance);
+    switch (dir) {
+    case RBTK_SENSOR_DOWN:
+        body->y += offset;
+        break;
+    case RBTK_SENSOR_UP:
+        body->y -= offset;
+        break;
+    case RBTK_SENSOR_RIGHT:
+        body->x += offset;
+        break;
+    case RBTK_SENSOR_LEFT:
+        body->x -= offset;
+        break;
+    }
+}
+
+/*
+ * Casts a pair of sensors on either side of the player, and returns the
+ * nearer of the two hits. The player stands on whichever surface is the
+ * closest to their feet.
+ */
+static rbtk_sensor_hit
+cast_pair(const RBTK_TILEMAP *tilemap, rbtk_sensor_dir dir, int32_t x1,
+    int32_t y1, int32_t x2, int32_t y2)
+{
+    rbtk_sensor sensors[2] = {
+        { .x = x1, .y = y1, .dir = dir },
+        { .x = x2, .y = y2, .dir = dir },
+    };
+    rbtk_sensor_hit hits[2];
+    rbtk_cast_sensors(tilemap, sensors, hits, 2);
+
+    if (!hits[0].found) {
+        return hits[1];
+    }
+    else if (!hits[1].found) {
+        return hits[0];
+    }
+    return hits[1].distance < hits[0].distance ? hits[1] : hits[0];
+}
+
+static rbtk_sensor_hit
+cast_ground(const rbtk_player_body *body, const rbtk_physics *physics,
+    const RBTK_TILEMAP *tilemap, ground_mode mode)
+{
+    int32_t x = rbtk_fixed_to_int(body->x);
+    int32_t y = rbtk_fixed_to_int(body->y);
+    int32_t w = physics->width_radius;
+    int32_t h = physics->height_radius;
+    rbtk_sensor_dir dir = ground_dirs[mode];
+
+    switch (mode) {
+    case GROUND_FLOOR:
+        return cast_pair(tilemap, dir, x - w, y + h, x + w, y + h);
+    case GROUND_RIGHT_WALL:
+        return cast_pair(tilemap, dir, x + h, y + w, x + h, y - w);
+    case GROUND_CEILING:
+        return cast_pair(tilemap, dir, x + w, y - h, x - w, y - h);
+    case GROUND_LEFT_WALL:
+    default:
+        return cast_pair(tilemap, dir, x - h, y - w, x - h, y + w);
+    }
+}
+
+/*
+ * Keeps the player out of the walls on either side of them. Speed is only
+ * lost when moving into a wall, so that the player can still walk away
+ * from one they are touching.
+ */
+static void
+push_walls(rbtk_player_body *body, const rbtk_physics *physics,
+    const RBTK_TILEMAP *tilemap)
+{
+    int32_t x = rbtk_fixed_to_int(body->x);
+    int32_t y = rbtk_fixed_to_int(body->y);
+    if (body->grounded && body->angle == 0x00) {
+        y += FLAT_WALL_OFFSET;
+    }
+
+    rbtk_sensor sensors[2] = {
+        { .x = x, .y = y, .dir = RBTK_SENSOR_RIGHT },
+        { .x = x, .y = y, .dir = RBTK_SENSOR_LEFT },
+    };
+    rbtk_sensor_hit hits[2];
+    rbtk_cast_sensors(tilemap, sensors, hits, 2);
+
+    for (int i = 0; i < 2; i++) {
+        if (!hits[i].found || hits[i].distance >= physics->push_radius) {
+            continue;
+        }
+
+        bool right = sensors[i].dir == RBTK_SENSOR_RIGHT;
+        nudge(body, sensors[i].dir,
+            hits[i].distance - physics->push_radius);
+        if (right ? body->x_speed > 0 : body->x_speed < 0) {
+            body->x_speed = 0;
+            body->ground_speed = 0;
+        }
+    }
+}
+
+static void
+leave_ground(rbtk_player_body *body)
+{
+    body->grounded = false;
+    body->angle = 0x00;
+}
+
+static void
+run(rbtk_player_body *body, const rbtk_physics *physics, unsigned controls)
+{
+    rbtk_fixed speed = body->ground_speed;
+
+    if (controls & RBTK_CONTROL_LEFT) {
+        if (speed > 0) {
+            speed -= physics->decel;
+            if (speed <= 0) {
+                speed = -physics->decel;
+            }
+        }
+        else if (speed > -physics->top_speed) {
+            speed -= physics->accel;
+            if (speed < -physics->top_speed) {
+                speed = -physics->top_speed;
+            }
+        }
+    }
+    else if (controls & RBTK_CONTROL_RIGHT) {
+        if (speed < 0) {
+            speed += physics->decel;
+            if (speed >= 0) {
+                speed = physics->decel;
+            }
+        }
+        else if (speed < physics->top_speed) {
+            speed += physics->accel;
+            if (speed > physics->top_speed) {
+                speed = physics->top_speed;
+            }
+        }
+    }
+    else if (speed > 0) {
+        speed -= physics->friction;
+        speed = speed < 0 ? 0 : speed;
+    }
+    else if (speed < 0) {
+        speed += physics->friction;
+        speed = speed > 0 ? 0 : speed;
+    }
+
+    body->ground_speed = speed;
+}
+
+static void
+step_ground(rbtk_player_body *body, const rbtk_physics *physics,
+    const RBTK_TILEMAP *tilemap, unsigned controls)
+{
+    rbtk_fixed sin = rbtk_fixed_sin(body->angle);
+    rbtk_fixed cos = rbtk_fixed_cos(body->angle);
+
+    body->ground_speed -= rbtk_fixed_mul(physics->slope_factor, sin);
+    run(body, physics, controls);
+
+    body->x_speed = rbtk_fixed_mul(body->ground_speed, cos);
+    body->y_speed = -rbtk_fixed_mul(body->ground_speed, sin);
+
+    if (controls & RBTK_CONTROL_JUMP) {
+        body->x_speed -= rbtk_fixed_mul(physics->jump_force, sin);
+        body->y_speed -= rbtk_fixed_mul(physics->jump_force, cos);
+        body->x += body->x_speed;
+        body->y += body->y_speed;
+        body->jumping = true;
+        leave_ground(body);
+        return;
+    }
+
+    body->x += body->x_speed;
+    body->y += body->y_speed;
+
+    ground_mode mode = get_ground_mode(body->angle);
+    if (mode == GROUND_FLOOR) {
+        push_walls(body, physics, tilemap);
+    }
+
+    /*
+     * How far the ground can drop away before the player runs off of it
+     * depends on how fast they are going. Otherwise, they would stick to
+     * the ground when running off the top of a slope.
+     */
+    rbtk_fixed across = mode == GROUND_FLOOR || mode == GROUND_CEILING
+        ? body->x_speed : body->y_speed;
+    int32_t limit = rbtk_fixed_to_int(rbtk_fixed_abs(across)) + 4;
+    limit = limit > MAX_SNAP_DISTANCE ? MAX_SNAP_DISTANCE : limit;
+
+    rbtk_sensor_hit hit = cast_ground(body, physics, tilemap, mode);
+    if (!hit.found || hit.distance > limit) {
+        leave_ground(body);
+        return;
+    }
+    else if (hit.distance >= -MAX_SNAP_DISTANCE) {
+        nudge(body, ground_dirs[mode], hit.distance);
+        body->angle = hit.angle;
+    }
+
+    /* too slow to stay on walls and ceilings */
+    if (get_ground_mode(body->angle) != GROUND_FLOOR
+        && rbtk_fixed_abs(body->ground_speed) < physics->slip_speed) {
+        body->ground_speed = 0;
+        leave_ground(body);
+    }
+}
+
+static void
+step_air(rbtk_player_body *body, const rbtk_physics *physics,
+    const RBTK_TILEMAP *tilemap, unsigned controls)
+{
+    if (controls & RBTK_CONTROL_LEFT) {
+        if (body->x_speed > -physics->top_speed) {
+            body->x_speed -= physics->air_accel;
+            if (body->x_speed < -physics->top_speed) {
+                body->x_speed = -physics->top_speed;
+            }
+        }
+    }
+    else if (controls & RBTK_CONTROL_RIGHT) {
+        if (body->x_speed < physics->top_speed) {
+            body->x_speed += physics->air_accel;
+            if (body->x_speed > physics->top_speed) {
+                body->x_speed = physics->top_speed;
+            }
+        }
+    }
+
+    /* letting go of jump early makes for a shorter jump */
+    if (body->jumping && !(controls & RBTK_CONTROL_JUMP_HELD)
+        && body->y_speed < -physics->jump_release) {
+        body->y_speed = -physics->jump_release;
+    }
+
+    /*
+     * Near the top of a jump, the player slowly loses speed along the
+     * X-axis. This is one 256th of a pixel for every eighth of a pixel
+     * of speed, as it was in the original games.
+     */
+    if (body->y_speed < 0 && body->y_speed > -rbtk_int_to_fixed(4)) {
+        body->x_speed -= (body->x_speed / 0x2000) * 0x100;
+    }
+
+    body->x += body->x_speed;
+    body->y += body->y_speed;
+
+    body->y_speed += physics->gravity;
+    if (body->y_speed > physics->max_fall_speed) {
+        body->y_speed = physics->max_fall_speed;
+    }
+
+    push_walls(body, physics, tilemap);
+
+    if (body->y_speed < 0) {
+        rbtk_sensor_hit hit = cast_ground(body, physics, tilemap,
+            GROUND_CEILING);
+        if (hit.found && hit.distance < 0) {
+            nudge(body, RBTK_SENSOR_UP, hit.distance);
+            body->y_speed = 0;
+        }
+        return;
+    }
+
+    rbtk_sensor_hit hit = cast_ground(body, physics, tilemap,
+        GROUND_FLOOR);
+    int32_t reach = rbtk_fixed_to_int(body->y_speed) + 8;
+    if (!hit.found || hit.distance >= 0 || hit.distance < -reach) {
+        return;
+    }
+
+    nudge(body, RBTK_SENSOR_DOWN, hit.distance);
+    body->angle = hit.angle;
+    body->grounded = true;
+    body->jumping = false;
+
+    /*
+     * Only the part of the speed which goes along the ground is kept when
+     * landing. The rest is lost to the impact.
+     */
+    rbtk_fixed sin = rbtk_fixed_sin(body->angle);
+    rbtk_fixed cos = rbtk_fixed_cos(body->angle);
+    body->ground_speed = rbtk_fixed_mul(body->x_speed, cos)
+        - rbtk_fixed_mul(body->y_speed, sin);
+}
+
+void
+rbtk_step_player(rbtk_player_body *body, const rbtk_physics *physics,
+    const RBTK_TILEMAP *tilemap, unsigned controls)
+{
+    assert(body);
+    assert(physics);
+    assert(tilemap);
+
+    if (body->grounded) {
+        step_ground(body, physics, tilemap, controls);
+    }
+    else {
+        step_air(body, physics, tilemap, controls);
+    }
+}
@@ -0,0 +1,149 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_PHYSICS_H_
+#define RBTK_ENGINE_PHYSICS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+ * @file
+ * @brief The public API for the game engine's physics module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../runtime/common.h"
+#include "fixed.h"
+#include "tilemap.h"
+
+/*!
+ * @defgroup engine_physics Physics
+ * @brief The game engine's physics module.
+ *
+ * This module moves a player through a tilemap the way the original games
+ * did. While on the ground, the player has a single speed along the slope
+ * they are standing on, which is turned into X and Y speeds by the angle
+ * of the slope. This lets the player run up walls and along ceilings, as
+ * long as they go fast enough. While in the air, the X and Y speeds are
+ * used directly, with gravity pulling the player down.
+ *
+ * Everything is done with fixed-point math, one tick at a time. A player
+ * which is given the same controls, from the same state, in the same
+ * tilemap, will always end up in exactly the same place.
+ *
+ * @see rbtk_step_player(rbtk_player_body *, const rbtk_physics *,
+ *      const RBTK_TILEMAP *, unsigned)
+ *
+ * @{
+ */
+
+/*!
+ * @brief The buttons held by a player during a tick.
+ */
+typedef enum rbtk_player_control {
+    RBTK_CONTROL_LEFT      = 0x01, /*!< Move to the left.            */
+    RBTK_CONTROL_RIGHT     = 0x02, /*!< Move to the right.           */
+    RBTK_CONTROL_JUMP      = 0x04, /*!< Jump was pressed this tick.  */
+    RBTK_CONTROL_JUMP_HELD = 0x08, /*!< Jump is being held down.     */
+} rbtk_player_control;
+
+/*!
+ * @brief The constants used to move a player.
+ *
+ * Speeds are in pixels per tick, and accelerations are in pixels per
+ * tick, per tick.
+ *
+ * @see rbtk_get_sonic_physics(rbtk_physics *)
+ */
+typedef struct rbtk_physics {
+    rbtk_fixed accel;          /*!< Speed gained when running.        */
+    rbtk_fixed decel;          /*!< Speed lost when turning around.   */
+    rbtk_fixed friction;       /*!< Speed lost when not running.      */
+    rbtk_fixed top_speed;      /*!< The most speed from running.      */
+    rbtk_fixed slope_factor;   /*!< How much slopes pull the player.  */
+    rbtk_fixed air_accel;      /*!< Speed gained when in the air.     */
+    rbtk_fixed gravity;        /*!< Speed gained when falling.        */
+    rbtk_fixed max_fall_speed; /*!< The most speed from falling.      */
+    rbtk_fixed jump_force;     /*!< Speed given by jumping.           */
+    rbtk_fixed jump_release;   /*!< Upward speed kept when jump is
+                                    let go of early.                  */
+    rbtk_fixed slip_speed;     /*!< Below this speed, the player falls
+                                    off of walls and ceilings.        */
+    int32_t width_radius;      /*!< Half the width, in pixels.        */
+    int32_t height_radius;     /*!< Half the height, in pixels.       */
+    int32_t push_radius;       /*!< How close walls can get to the
+                                    middle of the player, in pixels.  */
+} rbtk_physics;
+
+/*!
+ * @brief The state of a player moving through a tilemap.
+ *
+ * This is plain data, and can be copied, compared, or added to a snapshot
+ * as a region.
+ *
+ * @see rbtk_add_snapshot_region(void *, size_t)
+ */
+typedef struct rbtk_player_body {
+    rbtk_fixed x;            /*!< The X-axis position of the middle.  */
+    rbtk_fixed y;            /*!< The Y-axis position of the middle.  */
+    rbtk_fixed x_speed;      /*!< The speed along the X-axis.         */
+    rbtk_fixed y_speed;      /*!< The speed along the Y-axis.         */
+    rbtk_fixed ground_speed; /*!< The speed along the ground.         */
+    rbtk_tile_angle angle;   /*!< The angle of the ground.            */
+    bool grounded;           /*!< If the player is on the ground.     */
+    bool jumping;            /*!< If the player is in the air because
+                                  they jumped.                        */
+} rbtk_player_body;
+
+/*!
+ * @brief Gets the physics constants used by Sonic.
+ *
+ * @param[out] physics The constants to fill in.
+ */
+void
+rbtk_get_sonic_physics(rbtk_physics *physics);
+
+/*!
+ * @brief Moves a player forward by a single tick.
+ *
+ * @param[in,out] body The player to move.
+ * @param[in] physics The constants to move the player by.
+ * @param[in] tilemap The tilemap the player is moving through.
+ * @param[in] controls The buttons held by the player this tick. This is
+ *                     made up of #rbtk_player_control flags.
+ */
+void
+rbtk_step_player(rbtk_player_body *body, const rbtk_physics *physics,
+    const RBTK_TILEMAP *tilemap, unsigned controls);
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_PHYSICS_H_ */
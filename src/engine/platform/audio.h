@@ -37,11 +37,17 @@ RBTK_FORWARD_DECLARATION
 typedef struct PLAT_RBTK_SOUND PLAT_RBTK_SOUND;
 
 RBTK_PLATFORM RBTK_NO_DISCARD bool
-plat_rbtk_audio_init(void);
+plat_rbtk_audio_init(bool offline);
 
 RBTK_PLATFORM RBTK_NO_DISCARD bool
 plat_rbtk_audio_terminate(void);
 
+RBTK_PLATFORM RBTK_NO_DISCARD long double
+plat_rbtk_get_audio_latency(rbtk_time_unit unit);
+
+RBTK_PLATFORM void
+plat_rbtk_render_audio(void *buf, size_t frames);
+
 RBTK_PLATFORM RBTK_NO_DISCARD PLAT_RBTK_SOUND *
 plat_rbtk_alloc_sound(void);
 
@@ -49,6 +55,16 @@ RBTK_PLATFORM void
 plat_rbtk_buffer_sound(RBTK_SOUND *sound, size_t pcm_buffer_size,
     void *pcm_buffer);
 
+RBTK_PLATFORM void
+plat_rbtk_stream_sound(RBTK_SOUND *sound);
+
+RBTK_PLATFORM RBTK_NO_DISCARD size_t
+plat_rbtk_unqueue_stream_buffers(RBTK_SOUND *sound);
+
+RBTK_PLATFORM void
+plat_rbtk_queue_stream_buffer(RBTK_SOUND *sound, size_t pcm_buffer_size,
+    void *pcm_buffer);
+
 RBTK_PLATFORM void
 plat_rbtk_close_sound(RBTK_SOUND *sound);
 
@@ -25,8 +25,12 @@
 
 #include "input.h"
 
+#include <string.h>
+
 #include <GLFW/glfw3.h>
 
+#include "../../runtime/time.h"
+
 /* tracked for us by opengl_graphics.c */
 extern GLFWwindow *plat_rbtk_focused_glfw_window;
 
@@ -52,13 +56,95 @@ bind_glfw_key(rbtk_io_key_left, GLFW_KEY_LEFT);
 bind_glfw_key(rbtk_io_key_right, GLFW_KEY_RIGHT);
 bind_glfw_key(rbtk_io_key_space, GLFW_KEY_SPACE);
 bind_glfw_key(rbtk_io_key_enter, GLFW_KEY_ENTER);
+bind_glfw_key(rbtk_io_key_f3, GLFW_KEY_F3);
+
+#define bind_glfw_gamepad_button(_name, _glfw_button)         \
+    static PLAT_RBTK_IO_FEATURE stat_plat_##_name = {         \
+        .joystick = {                                         \
+            .glfw_index = (_glfw_button),                     \
+        },                                                    \
+    };                                                        \
+    PLAT_RBTK_IO_FEATURE *plat_##_name = &(stat_plat_##_name)
+
+#define bind_glfw_gamepad_stick(_name, _glfw_axis_x, _glfw_axis_y) \
+    static PLAT_RBTK_IO_FEATURE stat_plat_##_name = {              \
+        .stick = {                                                 \
+            .glfw_axis_x = (_glfw_axis_x),                         \
+            .glfw_axis_y = (_glfw_axis_y),                         \
+        },                                                         \
+    };                                                             \
+    PLAT_RBTK_IO_FEATURE *plat_##_name = &(stat_plat_##_name)
+
+#define bind_glfw_gamepad_trigger(_name, _glfw_axis)          \
+    static PLAT_RBTK_IO_FEATURE stat_plat_##_name = {         \
+        .trigger = {                                          \
+            .glfw_axis = (_glfw_axis),                        \
+        },                                                    \
+    };                                                        \
+    PLAT_RBTK_IO_FEATURE *plat_##_name = &(stat_plat_##_name)
+
+bind_glfw_gamepad_button(rbtk_io_xbox_a, GLFW_GAMEPAD_BUTTON_A);
+bind_glfw_gamepad_button(rbtk_io_xbox_b, GLFW_GAMEPAD_BUTTON_B);
+bind_glfw_gamepad_button(rbtk_io_xbox_x, GLFW_GAMEPAD_BUTTON_X);
+bind_glfw_gamepad_button(rbtk_io_xbox_y, GLFW_GAMEPAD_BUTTON_Y);
+bind_glfw_gamepad_button(rbtk_io_xbox_lb, GLFW_GAMEPAD_BUTTON_LEFT_BUMPER);
+bind_glfw_gamepad_button(rbtk_io_xbox_rb, GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER);
+bind_glfw_gamepad_button(rbtk_io_xbox_back, GLFW_GAMEPAD_BUTTON_BACK);
+bind_glfw_gamepad_button(rbtk_io_xbox_start, GLFW_GAMEPAD_BUTTON_START);
+bind_glfw_gamepad_button(rbtk_io_xbox_guide, GLFW_GAMEPAD_BUTTON_GUIDE);
+bind_glfw_gamepad_button(rbtk_io_xbox_ls, GLFW_GAMEPAD_BUTTON_LEFT_THUMB);
+bind_glfw_gamepad_button(rbtk_io_xbox_rs, GLFW_GAMEPAD_BUTTON_RIGHT_THUMB);
+bind_glfw_gamepad_button(rbtk_io_xbox_up, GLFW_GAMEPAD_BUTTON_DPAD_UP);
+bind_glfw_gamepad_button(rbtk_io_xbox_down, GLFW_GAMEPAD_BUTTON_DPAD_DOWN);
+bind_glfw_gamepad_button(rbtk_io_xbox_left, GLFW_GAMEPAD_BUTTON_DPAD_LEFT);
+bind_glfw_gamepad_button(rbtk_io_xbox_right, GLFW_GAMEPAD_BUTTON_DPAD_RIGHT);
+bind_glfw_gamepad_stick(rbtk_io_xbox_lstick,
+    GLFW_GAMEPAD_AXIS_LEFT_X, GLFW_GAMEPAD_AXIS_LEFT_Y);
+bind_glfw_gamepad_stick(rbtk_io_xbox_rstick,
+    GLFW_GAMEPAD_AXIS_RIGHT_X, GLFW_GAMEPAD_AXIS_RIGHT_Y);
+bind_glfw_gamepad_trigger(rbtk_io_xbox_lt, GLFW_GAMEPAD_AXIS_LEFT_TRIGGER);
+bind_glfw_gamepad_trigger(rbtk_io_xbox_rt, GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER);
+
+static int next_glfw_joystick;
+
+/*
+ * This is what a gamepad looks like when nothing is touched. Note that
+ * GLFW reports triggers from -1 (released) to 1 (fully pressed), while
+ * sticks are centered at 0.
+ */
+static void
+reset_gamepad_snapshot(PLAT_RBTK_IO_DEVICE *plat)
+{
+    for (int i = 0; i < PLAT_RBTK_GAMEPAD_BUTTON_COUNT; i++) {
+        plat->joystick.buttons[i] = GLFW_RELEASE;
+    }
+    for (int i = 0; i < PLAT_RBTK_GAMEPAD_AXIS_COUNT; i++) {
+        plat->joystick.axes[i] = 0.0f;
+    }
+    plat->joystick.axes[GLFW_GAMEPAD_AXIS_LEFT_TRIGGER] = -1.0f;
+    plat->joystick.axes[GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER] = -1.0f;
+}
 
 RBTK_PLATFORM RBTK_NO_DISCARD PLAT_RBTK_IO_DEVICE *
-plat_rbtk_create_io_device(RBTK_UNUSED rbtk_io_device_type type)
+plat_rbtk_create_io_device(rbtk_io_device_type type)
 {
     PLAT_RBTK_IO_DEVICE *plat = NULL;
     RBTK_MALLOC_OR_RETURN(&plat, NULL,
         "could not allocate memory for IO device on current platform");
+    RBTK_ZERO_MEMORY(plat);
+
+    /*
+     * Controllers are given joysticks in the order they are created. The
+     * first controller uses the first joystick, the second controller the
+     * second joystick, and so on.
+     */
+    if (type == RBTK_IO_DEVICE_XBOX_CONTROLLER) {
+        plat->joystick.glfw_index = next_glfw_joystick;
+        next_glfw_joystick += 1;
+        next_glfw_joystick %= (GLFW_JOYSTICK_LAST + 1);
+        reset_gamepad_snapshot(plat);
+    }
+
     return plat;
 }
 
@@ -70,6 +156,126 @@ plat_rbtk_destroy_io_device(RBTK_IO_DEVICE *device)
     return true;
 }
 
+static int
+get_glfw_code(const RBTK_IO_DEVICE *device,
+    const PLAT_RBTK_IO_FEATURE *binding)
+{
+    switch (device->type) {
+    case RBTK_IO_DEVICE_KEYBOARD:
+        return binding->keyboard.glfw_key;
+    case RBTK_IO_DEVICE_MOUSE:
+        return binding->mouse.glfw_button;
+    case RBTK_IO_DEVICE_XBOX_CONTROLLER:
+        return binding->joystick.glfw_index;
+    default:
+        assert(0); /* we forgot one!      */
+        return -1; /* pacify the compiler */
+    }
+}
+
+static void
+push_glfw_device_event(RBTK_IO_DEVICE *device, int glfw_code,
+    bool pressed, long double time)
+{
+    for (size_t i = 0; i < device->num_features; i++) {
+        RBTK_IO_FEATURE *feature = device->states[i].feature;
+        if (feature->type != RBTK_IO_FEATURE_BUTTON) {
+            continue; /* only buttons are reported by events */
+        }
+
+        PLAT_RBTK_IO_FEATURE *binding = *feature->plat;
+        if (!binding || get_glfw_code(device, binding) != glfw_code) {
+            continue;
+        }
+        priv_rbtk_push_io_event(device, feature, pressed, time);
+    }
+}
+
+static void
+push_glfw_event(rbtk_io_device_type type, int glfw_code, int action)
+{
+    if (action == GLFW_REPEAT) {
+        return; /* button is still pressed, nothing new */
+    }
+
+    long double time = rbtk_time(RBTK_MILLIS);
+    bool pressed = (action == GLFW_PRESS);
+
+    RBTK_IO_DEVICE *device = priv_rbtk_get_io_devices();
+    for (; device; device = device->next) {
+        if (device->type == type) {
+            push_glfw_device_event(device, glfw_code, pressed, time);
+        }
+    }
+}
+
+static void
+glfw_key_callback(RBTK_UNUSED GLFWwindow *glfw_window, int key,
+    RBTK_UNUSED int scancode, int action, RBTK_UNUSED int mods)
+{
+    push_glfw_event(RBTK_IO_DEVICE_KEYBOARD, key, action);
+}
+
+static void
+glfw_mouse_button_callback(RBTK_UNUSED GLFWwindow *glfw_window,
+    int button, int action, RBTK_UNUSED int mods)
+{
+    push_glfw_event(RBTK_IO_DEVICE_MOUSE, button, action);
+}
+
+/* used by opengl_graphics.c */
+void
+plat_rbtk_install_glfw_input(GLFWwindow *glfw_window)
+{
+    assert(glfw_window);
+    glfwSetKeyCallback(glfw_window, glfw_key_callback);
+    glfwSetMouseButtonCallback(glfw_window, glfw_mouse_button_callback);
+}
+
+/*
+ * GLFW has no callbacks for gamepads. Rather than querying the joystick
+ * for every feature bound to it, the gamepad state is fetched once per
+ * update and kept as a snapshot. Buttons which differ from the previous
+ * snapshot are pushed as events. A disconnected joystick, or one with
+ * no gamepad mapping, looks like a gamepad with nothing touched.
+ */
+static void
+poll_glfw_gamepad(RBTK_IO_DEVICE *device)
+{
+    PLAT_RBTK_IO_DEVICE *plat = device->plat;
+    unsigned char previous[PLAT_RBTK_GAMEPAD_BUTTON_COUNT];
+    memcpy(previous, plat->joystick.buttons, sizeof(previous));
+
+    GLFWgamepadstate gamepad;
+    if (glfwGetGamepadState(plat->joystick.glfw_index, &gamepad)) {
+        memcpy(plat->joystick.buttons, gamepad.buttons,
+            sizeof(plat->joystick.buttons));
+        memcpy(plat->joystick.axes, gamepad.axes,
+            sizeof(plat->joystick.axes));
+    }
+    else {
+        reset_gamepad_snapshot(plat);
+    }
+
+    long double time = rbtk_time(RBTK_MILLIS);
+    for (int i = 0; i < PLAT_RBTK_GAMEPAD_BUTTON_COUNT; i++) {
+        unsigned char state = plat->joystick.buttons[i];
+        if (state != previous[i]) {
+            push_glfw_device_event(device, i, state == GLFW_PRESS, time);
+        }
+    }
+}
+
+RBTK_PLATFORM RBTK_NO_DISCARD bool
+plat_rbtk_poll_io_device(RBTK_IO_DEVICE *device)
+{
+    assert(device);
+    if (device->type == RBTK_IO_DEVICE_XBOX_CONTROLLER) {
+        poll_glfw_gamepad(device);
+    }
+    return true; /* keyboards and mice have callbacks */
+}
+
 RBTK_PLATFORM RBTK_NO_DISCARD bool
 plat_rbtk_io_button_is_pressed(const RBTK_IO_DEVICE *device,
     const RBTK_IO_FEATURE *feature)
@@ -83,6 +289,15 @@ plat_rbtk_io_button_is_pressed(const RBTK_IO_DEVICE *device,
         return false;
     }
 
+    /* read from the snapshot, which does not need a window */
+    if (device->type == RBTK_IO_DEVICE_XBOX_CONTROLLER) {
+        int index = binding->joystick.glfw_index;
+        if (index < 0 || index >= PLAT_RBTK_GAMEPAD_BUTTON_COUNT) {
+            return false; /* no such button exists */
+        }
+        return (device->plat->joystick.buttons[index] == GLFW_PRESS);
+    }
+
     GLFWwindow *glfw_window = plat_rbtk_focused_glfw_window;
     if (!glfw_window) {
         return false;
@@ -100,22 +315,54 @@ plat_rbtk_io_button_is_pressed(const RBTK_IO_DEVICE *device,
         return (state == GLFW_PRESS);
     }
 
-    if (device->type == RBTK_IO_DEVICE_XBOX_CONTROLLER) {
-        int glfw_joystick = device->plat->joystick.glfw_index;
-        int glfw_index = binding->joystick.glfw_index;
+    assert(0);    /* we forgot one!      */
+    return false; /* pacify the compiler */
+}
 
-        int button_count = 0;
-        const unsigned char *buttons =
-            glfwGetJoystickButtons(glfw_joystick, &button_count);
-        if (glfw_index < 0 || glfw_index >= button_count) {
-            return false; /* no such button exists */
-        }
+static float
+get_gamepad_axis(const RBTK_IO_DEVICE *device, int glfw_axis)
+{
+    if (glfw_axis < 0 || glfw_axis >= PLAT_RBTK_GAMEPAD_AXIS_COUNT) {
+        return 0.0f; /* no such axis exists */
+    }
+    return device->plat->joystick.axes[glfw_axis];
+}
+
+RBTK_PLATFORM void
+plat_rbtk_get_io_stick_pos(const RBTK_IO_DEVICE *device,
+    const RBTK_IO_FEATURE *feature, vec3 pos)
+{
+    assert(device);
+    assert(feature);
+    assert(feature->type == RBTK_IO_FEATURE_ANALOG_STICK);
+
+    glm_vec3_zero(pos);
 
-        return (buttons[glfw_index] == GLFW_PRESS);
+    PLAT_RBTK_IO_FEATURE *binding = *feature->plat;
+    if (!binding || device->type != RBTK_IO_DEVICE_XBOX_CONTROLLER) {
+        return;
     }
 
-    assert(0);    /* we forgot one!      */
-    return false; /* pacify the compiler */
+    pos[0] = get_gamepad_axis(device, binding->stick.glfw_axis_x);
+    pos[1] = get_gamepad_axis(device, binding->stick.glfw_axis_y);
+}
+
+RBTK_PLATFORM RBTK_NO_DISCARD float
+plat_rbtk_get_io_trigger_force(const RBTK_IO_DEVICE *device,
+    const RBTK_IO_FEATURE *feature)
+{
+    assert(device);
+    assert(feature);
+    assert(feature->type == RBTK_IO_FEATURE_ANALOG_TRIGGER);
+
+    PLAT_RBTK_IO_FEATURE *binding = *feature->plat;
+    if (!binding || device->type != RBTK_IO_DEVICE_XBOX_CONTROLLER) {
+        return 0.0f;
+    }
+
+    /* map from [-1, 1] to [0, 1] */
+    float axis = get_gamepad_axis(device, binding->trigger.glfw_axis);
+    return (axis + 1.0f) / 2.0f;
 }
 
 #endif /* defined (_WIN32) || defined(__linux__) */
@@ -91,6 +91,9 @@ plat_rbtk_set_window_size(RBTK_WINDOW *window,
 RBTK_PLATFORM RBTK_NO_DISCARD bool
 plat_rbtk_render_window_scene(const RBTK_WINDOW *window);
 
+RBTK_PLATFORM void
+plat_rbtk_finish_window_frame(const RBTK_WINDOW *window);
+
 RBTK_PLATFORM RBTK_NO_DISCARD bool
 plat_rbtk_create_scene(RBTK_GRAPHICS *scene,
     unsigned int width, unsigned int height);
@@ -101,6 +104,9 @@ plat_rbtk_destroy_scene(RBTK_GRAPHICS *scene);
 RBTK_PLATFORM void
 plat_rbtk_clear_scene(RBTK_GRAPHICS *scene);
 
+RBTK_PLATFORM RBTK_NO_DISCARD bool
+plat_rbtk_copy_scene(RBTK_GRAPHICS *dest, RBTK_GRAPHICS *src);
+
 RBTK_PLATFORM PLAT_RBTK_SPRITE *
 plat_rbtk_load_sprite(unsigned int width, unsigned int height,
     unsigned short channels, unsigned char *pixels);
@@ -115,6 +121,11 @@ RBTK_PLATFORM void
 plat_rbtk_draw_sprite(RBTK_GRAPHICS *graphics, RBTK_SPRITE *sprite,
     float x, float y, float z);
 
+RBTK_PLATFORM void
+plat_rbtk_draw_sprite_instances(RBTK_GRAPHICS *scene, RBTK_SPRITE *sprite,
+    float x, float y, float z, size_t count,
+    const float *xs, const float *ys, const float *alphas);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -33,10 +33,25 @@ extern "C" {
 
 #include "../../runtime/common.h"
 
+/*
+ * These match the number of buttons and axes of a GLFW gamepad. They are
+ * defined here so this header does not need to include GLFW.
+ */
+#define PLAT_RBTK_GAMEPAD_BUTTON_COUNT 15
+#define PLAT_RBTK_GAMEPAD_AXIS_COUNT   6
+
 typedef struct PLAT_RBTK_IO_DEVICE {
     union {
         struct {
             int glfw_index;
+
+            /*
+             * A snapshot of the gamepad, taken once per update. All of
+             * the buttons, sticks, and triggers of the device are read
+             * from this rather than by querying the joystick again.
+             */
+            unsigned char buttons[PLAT_RBTK_GAMEPAD_BUTTON_COUNT];
+            float axes[PLAT_RBTK_GAMEPAD_AXIS_COUNT];
         } joystick;
     };
 } PLAT_RBTK_IO_DEVICE;
@@ -53,6 +68,13 @@ typedef struct PLAT_RBTK_IO_FEATURE {
         struct {
             int glfw_index;
         } joystick;
+        struct {
+            int glfw_axis_x;
+            int glfw_axis_y;
+        } stick;
+        struct {
+            int glfw_axis;
+        } trigger;
     };
 } PLAT_RBTK_IO_FEATURE;
 
@@ -62,10 +84,21 @@ plat_rbtk_create_io_device(rbtk_io_device_type type);
 RBTK_PLATFORM RBTK_NO_DISCARD bool
 plat_rbtk_destroy_io_device(RBTK_IO_DEVICE *device);
 
+RBTK_PLATFORM RBTK_NO_DISCARD bool
+plat_rbtk_poll_io_device(RBTK_IO_DEVICE *device);
+
 RBTK_PLATFORM RBTK_NO_DISCARD bool
 plat_rbtk_io_button_is_pressed(const RBTK_IO_DEVICE *device,
     const RBTK_IO_FEATURE *button);
 
+RBTK_PLATFORM void
+plat_rbtk_get_io_stick_pos(const RBTK_IO_DEVICE *device,
+    const RBTK_IO_FEATURE *stick, vec3 pos);
+
+RBTK_PLATFORM RBTK_NO_DISCARD float
+plat_rbtk_get_io_trigger_force(const RBTK_IO_DEVICE *device,
+    const RBTK_IO_FEATURE *trigger);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -27,6 +27,7 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -43,30 +44,122 @@ typedef struct PLAT_RBTK_SOUND {
             ALuint al_buffer;
         } buffered;
         struct {
-            ALuint al_buffers[2];
+            ALuint al_buffers[RBTK_STREAM_BUFFER_COUNT];
+            ALuint free_buffers[RBTK_STREAM_BUFFER_COUNT];
+            size_t free_count;
         } streamed;
     };
 } PLAT_RBTK_SOUND;
 
+/*
+ * These come from the ALC_SOFT_device_clock extension of OpenAL Soft. They
+ * are defined here so the extension can be used when available, without
+ * requiring the headers of a specific OpenAL implementation to build.
+ */
+#define ALC_DEVICE_LATENCY_SOFT 0x1601
+typedef int64_t ALCint64SOFT;
+typedef void (*alc_get_integer64v_soft)(ALCdevice *device,
+    ALCenum pname, ALCsizei size, ALCint64SOFT *values);
+
+/*
+ * These come from the ALC_SOFT_loopback extension of OpenAL Soft, which
+ * is used to render audio offline. Like the above, they are defined here
+ * so they do not depend on the headers of a specific implementation.
+ */
+#define ALC_FORMAT_CHANNELS_SOFT 0x1990
+#define ALC_FORMAT_TYPE_SOFT     0x1991
+#define ALC_SHORT_SOFT           0x1402
+#define ALC_STEREO_SOFT          0x1501
+typedef ALCdevice *(*alc_loopback_open_device_soft)(const ALCchar *name);
+typedef void (*alc_render_samples_soft)(ALCdevice *device,
+    ALCvoid *buffer, ALCsizei samples);
+
 static ALCdevice *device;
 static ALCcontext *context;
+static alc_get_integer64v_soft alc_get_integer64v;
+static alc_render_samples_soft alc_render_samples;
 static bool initialized;
 
+/*
+ * ISO C does not allow converting an object pointer to a function
+ * pointer, which is what alcGetProcAddress() returns. Copying it is
+ * the portable way around this, and is what POSIX does for dlsym().
+ */
+static void
+get_alc_proc(ALCdevice *dev, const char *name, void *fun, size_t size)
+{
+    void *proc = alcGetProcAddress(dev, name);
+    assert(size == sizeof(proc));
+    memcpy(fun, &proc, size);
+}
+
+static ALCdevice *
+open_loopback_device(void)
+{
+    if (!alcIsExtensionPresent(NULL, "ALC_SOFT_loopback")) {
+        rbtk_signal_error(RBTK_ERROR_UNSUPPORTED,
+            "AL implementation cannot render audio offline");
+        return NULL;
+    }
+
+    alc_loopback_open_device_soft alc_loopback_open_device = NULL;
+    get_alc_proc(NULL, "alcLoopbackOpenDeviceSOFT",
+        &alc_loopback_open_device, sizeof(alc_loopback_open_device));
+    get_alc_proc(NULL, "alcRenderSamplesSOFT",
+        &alc_render_samples, sizeof(alc_render_samples));
+
+    if (!alc_loopback_open_device || !alc_render_samples) {
+        rbtk_signal_error(RBTK_ERROR_PLATFORM,
+            "failed to load AL loopback functions");
+        return NULL;
+    }
+
+    ALCdevice *loopback = alc_loopback_open_device(NULL);
+    if (!loopback) {
+        rbtk_signal_error(RBTK_ERROR_PLATFORM,
+            "failed to open AL loopback device");
+        return NULL;
+    }
+    return loopback;
+}
+
 RBTK_PLATFORM RBTK_NO_DISCARD bool
-plat_rbtk_audio_init(void)
+plat_rbtk_audio_init(bool offline)
 {
     if (initialized) {
         return true;
     }
 
-    device = alcOpenDevice(NULL);
-    if (!device) {
-        rbtk_signal_error(RBTK_ERROR_PLATFORM,
-            "failed to open AL device");
-        return false;
+    alc_render_samples = NULL;
+
+    /*
+     * A loopback device must be told the format it will render in when
+     * its context is created, as it has no hardware to decide for it.
+     * This is the format promised to users rendering audio offline.
+     */
+    const ALCint loopback_attrs[] = {
+        ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+        ALC_FORMAT_TYPE_SOFT,     ALC_SHORT_SOFT,
+        ALC_FREQUENCY,            RBTK_OFFLINE_AUDIO_FREQUENCY_HZ,
+        0
+    };
+
+    if (offline) {
+        device = open_loopback_device();
+        if (!device) {
+            return false;
+        }
+    }
+    else {
+        device = alcOpenDevice(NULL);
+        if (!device) {
+            rbtk_signal_error(RBTK_ERROR_PLATFORM,
+                "failed to open AL device");
+            return false;
+        }
     }
 
-    context = alcCreateContext(device, NULL);
+    context = alcCreateContext(device, offline ? loopback_attrs : NULL);
     if (!context) {
         rbtk_signal_error(RBTK_ERROR_PLATFORM,
             "failed to create AL context");
@@ -79,6 +172,12 @@ plat_rbtk_audio_init(void)
         return false;
     }
 
+    alc_get_integer64v = NULL;
+    if (alcIsExtensionPresent(device, "ALC_SOFT_device_clock")) {
+        get_alc_proc(device, "alcGetInteger64vSOFT",
+            &alc_get_integer64v, sizeof(alc_get_integer64v));
+    }
+
     initialized = true;
     return true;
 }
@@ -98,6 +197,36 @@ plat_rbtk_audio_terminate(void)
     return true;
 }
 
+RBTK_PLATFORM RBTK_NO_DISCARD long double
+plat_rbtk_get_audio_latency(rbtk_time_unit unit)
+{
+    if (alc_get_integer64v) {
+        ALCint64SOFT latency_ns = 0;
+        alc_get_integer64v(device, ALC_DEVICE_LATENCY_SOFT, 1, &latency_ns);
+        return rbtk_convert_time(RBTK_NANOS, unit, (long double) latency_ns);
+    }
+
+    /*
+     * Without the device clock extension, there is no way to ask for the
+     * actual latency. The best estimate is the length of a single update
+     * of the mixer, as that is how long audio waits before being output.
+     */
+    ALCint refresh_hz = 0;
+    alcGetIntegerv(device, ALC_REFRESH, 1, &refresh_hz);
+    if (refresh_hz <= 0) {
+        return 0.0L;
+    }
+    return rbtk_convert_time(RBTK_SECS, unit, 1.0L / refresh_hz);
+}
+
+RBTK_PLATFORM void
+plat_rbtk_render_audio(void *buf, size_t frames)
+{
+    assert(buf);
+    assert(alc_render_samples); /* only available when offline */
+    alc_render_samples(device, buf, (ALCsizei) frames);
+}
+
 RBTK_PLATFORM RBTK_NO_DISCARD PLAT_RBTK_SOUND *
 plat_rbtk_alloc_sound(void)
 {
@@ -137,6 +266,68 @@ plat_rbtk_buffer_sound(RBTK_SOUND *sound, size_t pcm_buffer_size,
     alSourcei(plat->al_source, AL_BUFFER, plat->buffered.al_buffer);
 }
 
+RBTK_PLATFORM void
+plat_rbtk_stream_sound(RBTK_SOUND *sound)
+{
+    assert(sound);
+
+    PLAT_RBTK_SOUND *plat = sound->plat;
+
+    alGenSources(1, &plat->al_source);
+    alGenBuffers(RBTK_STREAM_BUFFER_COUNT, plat->streamed.al_buffers);
+
+    /* none of the buffers have been queued yet */
+    for (size_t i = 0; i < RBTK_STREAM_BUFFER_COUNT; i++) {
+        plat->streamed.free_buffers[i] = plat->streamed.al_buffers[i];
+    }
+    plat->streamed.free_count = RBTK_STREAM_BUFFER_COUNT;
+}
+
+RBTK_PLATFORM RBTK_NO_DISCARD size_t
+plat_rbtk_unqueue_stream_buffers(RBTK_SOUND *sound)
+{
+    assert(sound);
+    assert(sound->type == RBTK_SOUND_TYPE_STREAMED);
+
+    PLAT_RBTK_SOUND *plat = sound->plat;
+
+    ALint processed = 0;
+    alGetSourcei(plat->al_source, AL_BUFFERS_PROCESSED, &processed);
+    while (processed > 0) {
+        size_t i = plat->streamed.free_count;
+        assert(i < RBTK_STREAM_BUFFER_COUNT);
+        alSourceUnqueueBuffers(plat->al_source, 1,
+            &plat->streamed.free_buffers[i]);
+        plat->streamed.free_count += 1;
+        processed -= 1;
+    }
+
+    return plat->streamed.free_count;
+}
+
+RBTK_PLATFORM void
+plat_rbtk_queue_stream_buffer(RBTK_SOUND *sound, size_t pcm_buffer_size,
+    void *pcm_buffer)
+{
+    assert(sound);
+    assert(sound->type == RBTK_SOUND_TYPE_STREAMED);
+    assert(pcm_buffer);
+
+    PLAT_RBTK_SOUND *plat = sound->plat;
+    assert(plat->streamed.free_count > 0);
+
+    const RBTK_AUDIO_SOURCE *src = sound->src;
+    const rbtk_audio_source_info *info = rbtk_get_audio_source_info(src);
+    ALint al_format = get_al_format(info);
+
+    plat->streamed.free_count -= 1;
+    ALuint al_buffer = plat->streamed.free_buffers[plat->streamed.free_count];
+
+    alBufferData(al_buffer, al_format, pcm_buffer,
+        (ALsizei) pcm_buffer_size, info->frequency_hz);
+    alSourceQueueBuffers(plat->al_source, 1, &al_buffer);
+}
+
 RBTK_PLATFORM void
 plat_rbtk_close_sound(RBTK_SOUND *sound)
 {
@@ -151,7 +342,8 @@ plat_rbtk_close_sound(RBTK_SOUND *sound)
         alDeleteBuffers(1, &al_buffer);
     }
     else if (sound->type == RBTK_SOUND_TYPE_STREAMED) {
-        assert(0); /* TODO: implement this */
+        alDeleteBuffers(RBTK_STREAM_BUFFER_COUNT,
+            plat->streamed.al_buffers);
     }
     else {
         assert(0); /* unexpected type */
@@ -229,6 +421,14 @@ plat_rbtk_loop_sound(RBTK_SOUND *sound, bool looping)
 {
     assert(sound);
     PLAT_RBTK_SOUND *plat = sound->plat;
+
+    /*
+     * Looping a streaming source would only loop the buffers which are
+     * currently queued, rather than the entire sound.
+     */
+    if (sound->type == RBTK_SOUND_TYPE_STREAMED) {
+        return;
+    }
     alSourcei(plat->al_source, AL_LOOPING, looping);
 }
 
@@ -24,6 +24,7 @@
 #if defined(_WIN32) || defined(__linux__)
 
 #include "graphics.h"
+#include "../engine.h"
 
 #include <stdbool.h>
 #include <stdlib.h>
@@ -166,12 +167,82 @@ struct {
     } uniforms;
 } gl_sprite_prog;
 
+/*
+ * The instance program draws the same sprite many times with one draw
+ * call. Each instance has its own position and alpha, which are read from
+ * the instance buffer. Everything else is shared with the sprite program.
+ */
+static const char *instance_vert_src =
+    "#version 330 core                                            \n"
+    "                                                             \n"
+    "layout(location = 0) in vec2 buf_coords;                     \n"
+    "layout(location = 1) in vec2 tex_coords;                     \n"
+    "layout(location = 2) in float inst_x;                        \n"
+    "layout(location = 3) in float inst_y;                        \n"
+    "layout(location = 4) in float inst_alpha;                    \n"
+    "                                                             \n"
+    "out vec2 frag_tex_coords;                                    \n"
+    "out float frag_alpha;                                        \n"
+    "                                                             \n"
+    "uniform mat4 proj;                                           \n"
+    "uniform mat4 view;                                           \n"
+    "uniform mat4 model;                                          \n"
+    "                                                             \n"
+    "void main()                                                  \n"
+    "{                                                            \n"
+    "    frag_tex_coords = tex_coords;                            \n"
+    "    frag_alpha = inst_alpha;                                 \n"
+    "                                                             \n"
+    "    vec4 pos = model * vec4(buf_coords, 0.0, 1.0);           \n"
+    "    pos.xy += vec2(inst_x, inst_y);                          \n"
+    "    gl_Position = proj * view * pos;                         \n"
+    "}                                                            \n";
+
+static const char *instance_frag_src =
+    "#version 330 core                                            \n"
+    "                                                             \n"
+    "uniform sampler2D sampler;                                   \n"
+    "uniform vec4 obj_color;                                      \n"
+    "                                                             \n"
+    "in vec2 frag_tex_coords;                                     \n"
+    "in float frag_alpha;                                         \n"
+    "                                                             \n"
+    "layout(location = 0) out vec4 color;                         \n"
+    "                                                             \n"
+    "void main()                                                  \n"
+    "{                                                            \n"
+    "    color = texture(sampler, frag_tex_coords);               \n"
+    "    color *= obj_color;                                      \n"
+    "    color.a *= frag_alpha;                                   \n"
+    "}                                                            \n";
+
+struct {
+    GLuint id;
+    GLuint instance_vbo;
+    struct {
+        GLuint proj;
+        GLuint view;
+        GLuint model;
+        GLuint sampler;
+        GLuint color;
+    } uniforms;
+} gl_instance_prog;
+
 static RBTK_WINDOW *primary_window;
 static bool initialized;
 
 static bool
 setup_glfw()
 {
+    /*
+     * A headless game may run where there is no display at all, such as
+     * on a build server. The null platform does not need one, and creates
+     * its contexts with Mesa's surfaceless EGL platform instead.
+     */
+    if (rbtk_engine_is_headless()) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+
     if (glfwInit()) {
         return true;
     }
@@ -196,6 +267,9 @@ setup_monitors()
     if (!setup_glfw()) {
         return false;
     }
+    else if (rbtk_engine_is_headless()) {
+        return true; /* there may be no monitors, and none are needed */
+    }
 
     int monitor_count;
     GLFWmonitor **glfw_monitors = glfwGetMonitors(&monitor_count);
@@ -261,6 +335,11 @@ setup_windows()
     glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
     glfwWindowHint(GLFW_SAMPLES, 4);
 
+    /* the null platform can only create contexts with EGL or OSMesa */
+    if (rbtk_engine_is_headless()) {
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+    }
+
     primary_window = priv_rbtk_create_window(800, 600);
     if (!primary_window) {
         return false;
@@ -294,6 +373,33 @@ load_sprite_program()
     return true;
 }
 
+static bool
+load_instance_program()
+{
+    GLuint shaders[2] = { 0 };
+    if (!compile_shader(GL_VERTEX_SHADER, instance_vert_src, &shaders[0])) {
+        return false;
+    }
+    if (!compile_shader(GL_FRAGMENT_SHADER, instance_frag_src,
+            &shaders[1])) {
+        return false;
+    }
+
+    size_t shader_count = sizeof(shaders) / sizeof(GLuint);
+    if (!create_program(shader_count, shaders, true, &gl_instance_prog.id)) {
+        return false;
+    }
+
+    gl_instance_prog.uniforms.proj = glGetUniformLocation(gl_instance_prog.id, "proj");
+    gl_instance_prog.uniforms.view = glGetUniformLocation(gl_instance_prog.id, "view");
+    gl_instance_prog.uniforms.model = glGetUniformLocation(gl_instance_prog.id, "model");
+    gl_instance_prog.uniforms.sampler = glGetUniformLocation(gl_instance_prog.id, "sampler");
+    gl_instance_prog.uniforms.color = glGetUniformLocation(gl_instance_prog.id, "obj_color");
+
+    glGenBuffers(1, &gl_instance_prog.instance_vbo);
+    return true;
+}
+
 static bool
 setup_opengl() {
     /* setup OpenGL on the primary window's context */
@@ -317,6 +423,21 @@ setup_opengl() {
         return false;
     }
 
+    if (!load_instance_program()) {
+        glDeleteProgram(gl_sprite_prog.id);
+        return false;
+    }
+
+    gl_error = glGetError();
+    if (gl_error != GL_NO_ERROR) {
+        glDeleteBuffers(1, &gl_instance_prog.instance_vbo);
+        glDeleteProgram(gl_instance_prog.id);
+        glDeleteProgram(gl_sprite_prog.id);
+        rbtk_signal_error(RBTK_ERROR_PLATFORM,
+            "OpenGL error loading instance program: %d", gl_error);
+        return false;
+    }
+
     return true;
 }
 
@@ -351,9 +472,12 @@ plat_rbtk_graphics_terminate(void)
     glDisable(GL_BLEND);
     glDisable(GL_DEPTH_TEST);
     glDeleteProgram(gl_sprite_prog.id);
+    glDeleteBuffers(1, &gl_instance_prog.instance_vbo);
+    glDeleteProgram(gl_instance_prog.id);
     glfwTerminate();
 
     RBTK_ZERO_MEMORY(&gl_sprite_prog);
+    RBTK_ZERO_MEMORY(&gl_instance_prog);
     primary_window = NULL;
 
     initialized = false;
@@ -379,6 +503,10 @@ glfw_window_size_callback(GLFWwindow *glfw_window, int width, int height)
 /* used by glfw_input.c */
 GLFWwindow *plat_rbtk_focused_glfw_window;
 
+/* implemented in glfw_input.c */
+void
+plat_rbtk_install_glfw_input(GLFWwindow *glfw_window);
+
 /* used by win32_engine.c */
 void
 plat_rbtk_update_glfw(void)
@@ -443,6 +571,7 @@ plat_rbtk_create_window(RBTK_WINDOW *window,
     glfwSetWindowSizeCallback(glfw_window, glfw_window_size_callback);
     glfwSetWindowFocusCallback(glfw_window, glfw_window_focus_callback);
     glfwSetWindowUserPointer(glfw_window, window);
+    plat_rbtk_install_glfw_input(glfw_window);
 
     GLFWwindow *previous_context = glfwGetCurrentContext();
 
@@ -451,6 +580,17 @@ plat_rbtk_create_window(RBTK_WINDOW *window,
     glewExperimental = true; /* required for core profile */
 
     GLenum glew_error = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    /*
+     * GLEW also loads the GLX extensions, which fails when the context was
+     * made with EGL. The OpenGL functions themselves are already loaded by
+     * then, and GLX is never used.
+     */
+    if (glew_error == GLEW_ERROR_NO_GLX_DISPLAY
+            && rbtk_engine_is_headless()) {
+        glew_error = GL_NO_ERROR;
+    }
+#endif /* GLEW_ERROR_NO_GLX_DISPLAY */
     if (glew_error != GL_NO_ERROR) {
         glfwTerminate();
         rbtk_destroy_window(primary_window);
@@ -903,6 +1043,45 @@ plat_rbtk_clear_scene(RBTK_GRAPHICS *scene)
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
+RBTK_PLATFORM RBTK_NO_DISCARD bool
+plat_rbtk_copy_scene(RBTK_GRAPHICS *dest, RBTK_GRAPHICS *src)
+{
+    assert(dest);
+    assert(src);
+
+    /*
+     * Each scene has a frame buffer per context, which is created the
+     * first time it is bound. Rather than looking them up by hand, bind
+     * each scene as usual and ask OpenGL which frame buffer was bound.
+     */
+    GLint src_frame_buffer = 0;
+    if (!bind_scene_for_current_context(src)) {
+        return false;
+    }
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &src_frame_buffer);
+
+    GLint dest_frame_buffer = 0;
+    if (!bind_scene_for_current_context(dest)) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return false;
+    }
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &dest_frame_buffer);
+
+    /*
+     * Blitting is done entirely on the GPU, and only copies the colors.
+     * The depth buffer of the destination is left alone, so anything drawn
+     * on top of the copy afterwards is depth tested as it normally would.
+     */
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint) src_frame_buffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint) dest_frame_buffer);
+    glBlitFramebuffer(0, 0, src->width, src->height,
+        0, 0, dest->width, dest->height,
+        GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    return true;
+}
+
 static void
 draw_sprite_gl(RBTK_SPRITE *sprite,
     const mat4 proj, const mat4 view, const mat4 model)
@@ -955,6 +1134,25 @@ draw_sprite_gl(RBTK_SPRITE *sprite,
     glBindVertexArray(0);            /* prevent accidental changes */
 }
 
+static void
+bind_scene_for_drawing(RBTK_GRAPHICS *scene)
+{
+    /*
+     * Here we switch to the requested scene for rendering. After binding
+     * to the scene's frame buffer for the current context, we must set
+     * the OpenGL viewport. This makes sure OpenGL renders to the entire
+     * frame buffer and not just part of it.
+     */
+    bool bound = bind_scene_for_current_context(scene);
+    if(!bound) {
+        fprintf(stderr, "Failed to bind scene for current context\n");
+        abort(); /* we cannot recover from this */
+    }
+
+    glViewport(0, 0, scene->width, scene->height);
+    glClear(GL_DEPTH_BUFFER_BIT); /* depth testing */
+}
+
 RBTK_PLATFORM void
 plat_rbtk_draw_sprite(RBTK_GRAPHICS *scene, RBTK_SPRITE *sprite,
     float x, float y, float z)
@@ -962,105 +1160,106 @@ plat_rbtk_draw_sprite(RBTK_GRAPHICS *scene, RBTK_SPRITE *sprite,
     assert(scene);
     assert(sprite);
 
-    vec3 model_translate = {
-        x - sprite->section.x,
-        y - sprite->section.y,
-        z
-    };
-    vec3 model_scale = {
-        sprite->scale.x,
-        sprite->scale.y,
-        sprite->scale.z
-    };
-    if (sprite->flipped.horizontally) {
-        model_scale[0] *= -1;
-        model_translate[0] += sprite->section.width;
-    }
-    if (sprite->flipped.vertically) {
-        model_scale[1] *= -1;
-        model_translate[1] += sprite->section.height;
-    }
-
-    RBTK_CAMERA *camera = scene->camera;
-    vec3 camera_pos = {
-        camera->pos[0] * -1.0f,
-        camera->pos[1] * -1.0f,
-        camera->pos[2] * -1.0f,
-    };
-    vec3 camera_target = {
-        camera_pos[0],
-        camera_pos[1],
-        0, /* look to the front */
-    };
-    vec3 camera_up = {
-        0, /* leave X-axis alone */
-        1, /* look upwards       */
-        0, /* leave Z-axis alone */
-    };
-
     /* always initialize to identity just to be safe */
     mat4 model_matrix = GLM_MAT4_IDENTITY_INIT;
     mat4 view_matrix = GLM_MAT4_IDENTITY_INIT;
     mat4 proj_matrix = GLM_MAT4_IDENTITY_INIT;
 
+    priv_rbtk_get_sprite_matrices(scene, sprite, x, y, z,
+        model_matrix, view_matrix, proj_matrix);
+
+    bind_scene_for_drawing(scene);
+    draw_sprite_gl(sprite,
+        *(const mat4 *) &proj_matrix,
+        *(const mat4 *) &view_matrix,
+        *(const mat4 *) &model_matrix);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+RBTK_PLATFORM void
+plat_rbtk_draw_sprite_instances(RBTK_GRAPHICS *scene, RBTK_SPRITE *sprite,
+    float x, float y, float z, size_t count,
+    const float *xs, const float *ys, const float *alphas)
+{
+    assert(scene);
+    assert(sprite);
+    assert(xs && ys && alphas);
+
+    if (count == 0) {
+        return; /* nothing to draw */
+    }
+
     /*
-     * Now that we have all the necessary information, we can calculate the
-     * model view projection matrices, which will determine the final result
-     * of drawing this sprite.
-     *
-     * Note that here we are rendering to a vertically flipped matrix. This
-     * has to due with OpenGL, where it wants to render to the frame buffer
-     * upside down for some reason. Flipping it while rendering here allows
-     * for proper results when rendering to the screen.
-     *
-     * The following steps below (before copying the final result) must be
-     * done in that specific order. The matrix operations used here are not
-     * commutative!
+     * The model matrix is the same for every instance, as if the sprite
+     * were being drawn at the given coordinates. The position of each
+     * instance is added on top of it in the vertex shader.
      */
+    mat4 model_matrix = GLM_MAT4_IDENTITY_INIT;
+    mat4 view_matrix = GLM_MAT4_IDENTITY_INIT;
+    mat4 proj_matrix = GLM_MAT4_IDENTITY_INIT;
 
-    /* 1. Translate the sprite to the requested position.     */
-    glm_translate(model_matrix, model_translate);
+    priv_rbtk_get_sprite_matrices(scene, sprite, x, y, z,
+        model_matrix, view_matrix, proj_matrix);
 
-    /* 2. Apply the specified rotation for each axis.         */
-    vec3 x_axis = { 1, 0, 0 };
-    glm_rotate(model_matrix, sprite->rotation.x, x_axis);
-    vec3 y_axis = { 0, 1, 0 };
-    glm_rotate(model_matrix, sprite->rotation.y, y_axis);
-    vec3 z_axis = { 0, 0, 1 };
-    glm_rotate(model_matrix, sprite->rotation.z, z_axis);
+    bind_scene_for_drawing(scene);
 
-    /* 3. Scale the model to the requested size.              */
-    glm_scale(model_matrix, model_scale);
+    PLAT_RBTK_SPRITE *plat = sprite->plat;
+    glActiveTexture(GL_TEXTURE0);
+    glUseProgram(gl_instance_prog.id);
+
+    glUniform1i(gl_instance_prog.uniforms.sampler, 0);
+    glUniformMatrix4fv(gl_instance_prog.uniforms.proj, 1, GL_FALSE, &proj_matrix[0][0]);
+    glUniformMatrix4fv(gl_instance_prog.uniforms.view, 1, GL_FALSE, &view_matrix[0][0]);
+    glUniformMatrix4fv(gl_instance_prog.uniforms.model, 1, GL_FALSE, &model_matrix[0][0]);
+    glUniform4f(gl_instance_prog.uniforms.color, sprite->color.red,
+        sprite->color.green, sprite->color.blue, sprite->color.alpha);
 
     /*
-     * All done, we can now copy our results to the matrices.
-     *
-     * Note: We have to cast the projection matrix to a non-const
-     * pointer to silence a warning caused by discarding constness.
-     * This is because the first parameter of glm_mat4_copy() (the
-     * source matrix) is not const. The reason for this is unknown.
+     * The instance buffer holds every X position, then every Y position,
+     * then every alpha. This is the same layout the caller keeps them in,
+     * so they are copied as they are without interleaving. The buffer is
+     * orphaned first, so OpenGL does not have to wait for the last draw
+     * to finish before it can be written to.
      */
-    glm_mat4_copy(*((mat4 *) &scene->proj->matrix), proj_matrix);
-    glm_lookat(camera_pos, camera_target, camera_up, view_matrix);
+    GLsizeiptr len = (GLsizeiptr) (count * sizeof(float));
+    glBindBuffer(GL_ARRAY_BUFFER, gl_instance_prog.instance_vbo);
+    glBufferData(GL_ARRAY_BUFFER, len * 3, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, len * 0, len, xs);
+    glBufferSubData(GL_ARRAY_BUFFER, len * 1, len, ys);
+    glBufferSubData(GL_ARRAY_BUFFER, len * 2, len, alphas);
+
+    GLint sprite_vao = get_sprite_vao_for_current_context();
+    glBindVertexArray(sprite_vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, plat->model_vbo);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, NULL);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, plat->uv_vbo);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, NULL);
+    glEnableVertexAttribArray(1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, gl_instance_prog.instance_vbo);
+    for (GLuint i = 0; i < 3; i++) {
+        glVertexAttribPointer(2 + i, 1, GL_FLOAT, GL_FALSE, 0,
+            (const void *) (i * len));
+        glVertexAttribDivisor(2 + i, 1);
+        glEnableVertexAttribArray(2 + i);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, plat->texture);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei) count);
+    glBindTexture(GL_TEXTURE_2D, 0); /* prevent accidental changes */
 
     /*
-     * Here we switch to the requested scene for rendering. After binding
-     * to the scene's frame buffer for the current context, we must set
-     * the OpenGL viewport. This makes sure OpenGL renders to the entire
-     * frame buffer and not just part of it.
+     * The sprite program shares this VAO, but does not read any instance
+     * attributes. They are disabled so that they stay out of its way.
      */
-    bool bound = bind_scene_for_current_context(scene);
-    if(!bound) {
-        fprintf(stderr, "Failed to bind scene for current context\n");
-        abort(); /* we cannot recover from this */
+    for (GLuint i = 0; i < 3; i++) {
+        glDisableVertexAttribArray(2 + i);
     }
-
-    glViewport(0, 0, scene->width, scene->height);
-    glClear(GL_DEPTH_BUFFER_BIT); /* depth testing */
-    draw_sprite_gl(sprite,
-        *(const mat4 *) &proj_matrix,
-        *(const mat4 *) &view_matrix,
-        *(const mat4 *) &model_matrix);
+    glBindVertexArray(0);                /* prevent accidental changes */
+    glBindBuffer(GL_ARRAY_BUFFER, 0);    /* prevent accidental changes */
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
@@ -1103,4 +1302,29 @@ plat_rbtk_render_window_scene(const RBTK_WINDOW *window)
     return true;
 }
 
+RBTK_PLATFORM void
+plat_rbtk_finish_window_frame(const RBTK_WINDOW *window)
+{
+    assert(window);
+
+    PLAT_RBTK_WINDOW *plat = window->plat;
+    GLFWwindow *glfw_window = plat->glfw_window;
+    if (glfwGetCurrentContext() != glfw_window) {
+        glfwMakeContextCurrent(glfw_window);
+    }
+
+    /*
+     * A fence is signaled once every command before it is completed. As
+     * it is placed after the buffers were swapped, this is when the frame
+     * is finished. The timeout is generous, it is only here so a lost GPU
+     * cannot hang the program forever.
+     */
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (!fence) {
+        return; /* nothing to wait on */
+    }
+    glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    glDeleteSync(fence);
+}
+
 #endif /* defined(_WIN32) || defined(__linux__) */
@@ -0,0 +1,65 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_PRIVATE_ACTIVATION_H_
+#define RBTK_ENGINE_PRIVATE_ACTIVATION_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include "../activation.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../entity.h"
+
+#include "../../runtime/common.h"
+
+/*
+ * The X-axis positions of the spawns are also kept on their own, as they
+ * are all that is looked at when moving the window. The window is the
+ * range of spawns from first up to (but not including) last.
+ */
+typedef struct RBTK_ACTIVATOR {
+    RBTK_WORLD *world;
+    rbtk_activator_funs funs;
+    void *args;
+    float margin;
+
+    size_t count;
+    rbtk_spawn *spawns;
+    float *spawn_x;
+    rbtk_entity *entities;
+    uint32_t *removed; /* one bit per spawn */
+
+    size_t first;
+    size_t last;
+} RBTK_ACTIVATOR;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_PRIVATE_ACTIVATION_H_ */
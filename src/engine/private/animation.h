@@ -0,0 +1,64 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_PRIVATE_ANIMATION_H_
+#define RBTK_ENGINE_PRIVATE_ANIMATION_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include "../animation.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../graphics.h"
+
+#include "../../runtime/common.h"
+
+typedef struct RBTK_ANIME_CLIP {
+    size_t num_frames;
+    RBTK_SPRITE **frames;
+    int32_t *ticks;
+} RBTK_ANIME_CLIP;
+
+/*
+ * Each animation is a slot in these arrays, rather than a struct of its
+ * own. Advancing a set only touches the remaining ticks, which are packed
+ * together so the whole set can be advanced in one pass.
+ */
+typedef struct RBTK_ANIME_SET {
+    size_t max_animes;
+    size_t num_slots; /* every slot past this one is free */
+    const RBTK_ANIME_CLIP **clips;
+    int32_t *remaining;
+    uint32_t *frames;
+    uint8_t *flags;
+} RBTK_ANIME_SET;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_PRIVATE_ANIMATION_H_ */
@@ -37,6 +37,15 @@ extern "C" {
 RBTK_FORWARD_DECLARATION
 typedef struct PLAT_RBTK_SOUND PLAT_RBTK_SOUND;
 
+/*
+ * Streamed sounds keep this many buffers queued on the platform at once.
+ * With the size below, each buffer holds about 93ms of 16-bit stereo audio
+ * at 44.1kHz. This is enough to survive a few slow frames before the audio
+ * runs dry.
+ */
+#define RBTK_STREAM_BUFFER_COUNT 4
+#define RBTK_STREAM_BUFFER_SIZE  16384
+
 typedef enum RBTK_SOUND_TYPE {
     RBTK_SOUND_TYPE_BUFFERED,
     RBTK_SOUND_TYPE_STREAMED
@@ -50,11 +59,17 @@ typedef struct rbtk_maintained_sounds {
 
 typedef struct RBTK_SOUND {
     PLAT_RBTK_SOUND *plat;
-    const RBTK_AUDIO_SOURCE *src;
+    RBTK_AUDIO_SOURCE *src;
     RBTK_SOUND_TYPE type;
     bool looping;
     bool closed;
     rbtk_maintained_sounds *maintained;
+    struct {
+        unsigned char *chunk; /* holds PCM data while refilling */
+        size_t offset;        /* read offset of the audio source */
+        bool eof;             /* if the source has run out of data */
+        bool playing;         /* if the sound was asked to play */
+    } streamed;
 } RBTK_SOUND;
 
 RBTK_PRIVATE RBTK_NO_DISCARD bool
@@ -63,6 +78,9 @@ priv_rbtk_audio_init(void);
 RBTK_PRIVATE RBTK_NO_DISCARD bool
 priv_rbtk_audio_terminate(void);
 
+RBTK_PRIVATE void
+priv_rbtk_audio_update(void);
+
 RBTK_PRIVATE bool
 priv_rbtk_audio_maintain(RBTK_SOUND *sound);
 
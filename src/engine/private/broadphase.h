@@ -0,0 +1,96 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_PRIVATE_BROADPHASE_H_
+#define RBTK_ENGINE_PRIVATE_BROADPHASE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include "../broadphase.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../entity.h"
+
+#include "../../runtime/common.h"
+
+typedef struct rbtk_cell_range {
+    int32_t min_x;
+    int32_t min_y;
+    int32_t max_x;
+    int32_t max_y;
+} rbtk_cell_range;
+
+/*
+ * A proxy stands in for an entity, and is found by the slot of its handle.
+ * The proxies in use are also kept packed in a list, so they can be gone
+ * over without going over every slot.
+ */
+typedef struct rbtk_proxy {
+    rbtk_entity entity; /* RBTK_NO_ENTITY when not in use */
+    rbtk_box box;
+    rbtk_cell_range cells;
+    size_t active_index;
+    unsigned int synced;
+} rbtk_proxy;
+
+/*
+ * Each cell an entity touches gets a node, chained into the bucket the
+ * cell hashes to. Cells which hash to the same bucket share its chain, so
+ * nodes remember which cell they are actually in.
+ */
+typedef struct rbtk_cell_node {
+    uint32_t slot;
+    int32_t cell_x;
+    int32_t cell_y;
+    uint32_t next;
+} rbtk_cell_node;
+
+typedef struct RBTK_BROADPHASE {
+    float cell_size;
+    size_t max_entities;
+    unsigned int sync_count;
+
+    rbtk_proxy *proxies;
+    uint32_t *active;
+    size_t active_count;
+
+    uint32_t *buckets;
+    size_t bucket_mask;
+
+    rbtk_cell_node *nodes;
+    size_t node_capacity;
+    size_t node_count;
+    uint32_t free_nodes;
+    size_t free_node_count;
+} RBTK_BROADPHASE;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_PRIVATE_BROADPHASE_H_ */
@@ -0,0 +1,66 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_PRIVATE_CAMERA_H_
+#define RBTK_ENGINE_PRIVATE_CAMERA_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include "../camera.h"
+
+#include <stdbool.h>
+
+#include "../broadphase.h"
+#include "../graphics.h"
+
+#include "../../runtime/common.h"
+
+/*
+ * The position of the controller is the top left of what can be seen,
+ * which is not the same as the position of the camera it controls. This
+ * is kept in floats so slow pans are not lost, and only rounded when it
+ * is given to the camera.
+ */
+typedef struct RBTK_CAMERA_CONTROLLER {
+    RBTK_GRAPHICS *scene;
+    rbtk_camera_rules rules;
+    rbtk_box bounds;
+    bool bounded;
+
+    float x;
+    float y;
+    float look_ahead;
+    float pan;
+    float pan_target;
+    unsigned int lag_ticks;
+
+    rbtk_camera_view view;
+} RBTK_CAMERA_CONTROLLER;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_PRIVATE_CAMERA_H_ */
@@ -0,0 +1,72 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_PRIVATE_ENTITY_H_
+#define RBTK_ENGINE_PRIVATE_ENTITY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include "../entity.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../graphics.h"
+
+#include "../../runtime/common.h"
+
+/*
+ * The slots of a world are sparse, and are what handles refer to. Each
+ * slot knows where its entity is in the dense arrays, which are always
+ * packed at the front. Free slots are kept on a stack.
+ */
+typedef struct RBTK_WORLD {
+    size_t max_entities;
+    size_t count;
+
+    uint32_t *generations; /* by slot */
+    uint32_t *dense;       /* by slot */
+    uint32_t *free_slots;
+    size_t free_count;
+
+    rbtk_entity *entities;
+    uint8_t *components;
+    float *x;
+    float *y;
+    float *prev_x;
+    float *prev_y;
+    float *vel_x;
+    float *vel_y;
+    RBTK_SPRITE **sprites;
+    size_t *animes;
+    float *half_width;
+    float *half_height;
+} RBTK_WORLD;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_PRIVATE_ENTITY_H_ */
@@ -33,13 +33,30 @@ extern "C" {
 #include <stdbool.h>
 
 #include "../../runtime/common.h"
+#include "../../runtime/thread.h"
 
 typedef struct RBTK_GAME {
     rbtk_game_funs funs;
     size_t state_count;
     RBTK_GAME_STATE *states[RBTK_MAX_GAME_STATES];
     RBTK_GAME_STATE* current_state;
+    size_t suspended_count;
+    RBTK_GAME_STATE *suspended[RBTK_MAX_GAME_STATES];
+    struct {
+        RBTK_GRAPHICS *scene;
+        RBTK_GRAPHICS *cache;
+        bool valid;
+    } suspended_frame;
     long double last_update;
+    long double tick_ms;
+    long double unsimulated_ms;
+    float alpha;
+    struct {
+        RBTK_THREAD_POOL *pool;
+        RBTK_JOB *job;
+        RBTK_GAME_STATE *state;
+        void *args;
+    } preload;
     bool running;
     bool stopped;
 } RBTK_GAME;
@@ -49,6 +66,15 @@ typedef struct RBTK_GAME_STATE {
     rbtk_game_state_funs funs;
 } RBTK_GAME_STATE;
 
+RBTK_PRIVATE void
+priv_rbtk_update_game_preload(RBTK_GAME *game, bool wait);
+
+RBTK_PRIVATE void
+priv_rbtk_cancel_game_preload(RBTK_GAME *game);
+
+RBTK_PRIVATE void
+priv_rbtk_render_suspended_game_states(RBTK_GAME *game, float alpha);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -134,12 +134,14 @@ typedef struct RBTK_SPRITE_ANIME {
     size_t num_frames;
     RBTK_SPRITE **frames;
     long double *durations;
-    long double timer;
     bool loop;
     bool ping_pong;
-    bool backwards;
-    bool finished;
-    size_t current_frame;
+    struct {
+        long double timer;
+        bool backwards;
+        bool finished;
+        size_t current_frame;
+    } playback;
     struct {
         float x;
         float y;
@@ -165,6 +167,11 @@ priv_rbtk_add_window(RBTK_WINDOW *plat);
 RBTK_PRIVATE RBTK_NO_DISCARD RBTK_WINDOW *
 priv_rbtk_create_window(unsigned int width, unsigned int height);
 
+RBTK_PRIVATE void
+priv_rbtk_get_sprite_matrices(RBTK_GRAPHICS *scene, RBTK_SPRITE *sprite,
+    float x, float y, float z,
+    mat4 model_matrix, mat4 view_matrix, mat4 proj_matrix);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
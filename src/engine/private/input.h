@@ -40,12 +40,78 @@ typedef struct PLAT_RBTK_IO_DEVICE PLAT_RBTK_IO_DEVICE;
 RBTK_FORWARD_DECLARATION
 typedef struct PLAT_RBTK_IO_FEATURE PLAT_RBTK_IO_FEATURE;
 
+/*
+ * The most I/O features which can be added to devices, across all of them.
+ * Each feature is given a dense index below this the first time it is added
+ * to a device. Devices use this index to find the state of a feature.
+ */
+#define RBTK_MAX_IO_FEATURES 256
+
+/*
+ * Used as the index of an I/O feature which has yet to be added to any
+ * device. Features are statically initialized with this.
+ */
+#define RBTK_IO_FEATURE_NO_INDEX SIZE_MAX
+
+/*
+ * The size of the event queue of each I/O device. This must be a power of
+ * two. If more events than this are received between two updates of the
+ * device, the newest ones are dropped.
+ */
+#define RBTK_IO_EVENT_QUEUE_SIZE 256
+
+typedef struct rbtk_io_event {
+    RBTK_IO_FEATURE *feature;
+    bool pressed;
+    long double time;
+} rbtk_io_event;
+
+typedef struct rbtk_io_replayed_feature {
+    rbtk_io_feature_type type;
+    rbtk_io_feature_state *state; /* NULL if device lacks it */
+} rbtk_io_replayed_feature;
+
 typedef struct RBTK_IO_DEVICE {
     PLAT_RBTK_IO_DEVICE *plat;
     rbtk_io_device_type type;
     size_t max_features;
     size_t num_features;
-    rbtk_io_feature_state **states;
+
+    /*
+     * The states of every feature added to the device are kept next to
+     * each other in the order they were added. To find the state of a
+     * feature, its index is used to look up which slot it is in. Slots
+     * of features which have not been added are RBTK_IO_FEATURE_NO_INDEX.
+     */
+    rbtk_io_feature_state *states;
+    size_t slots[RBTK_MAX_IO_FEATURES];
+
+    /*
+     * Events are pushed by the platform (from its input callbacks) and
+     * popped when the device is updated. There is only ever one producer
+     * and one consumer, so the queue does not need a lock.
+     */
+    struct {
+        rbtk_io_event events[RBTK_IO_EVENT_QUEUE_SIZE];
+        volatile size_t head;
+        volatile size_t tail;
+    } queue;
+
+    struct {
+        RBTK_OUT_STREAM *out;
+        size_t num_features;
+        long double start;
+    } recording;
+
+    struct {
+        RBTK_IN_STREAM *in;
+        size_t num_features;
+        rbtk_io_replayed_feature *features;
+        long double start;
+    } replay;
+
+    struct RBTK_IO_DEVICE *prev;
+    struct RBTK_IO_DEVICE *next;
 } RBTK_IO_DEVICE;
 
 /*
@@ -57,6 +123,7 @@ typedef struct RBTK_IO_FEATURE {
     PLAT_RBTK_IO_FEATURE **plat;
     const char *id;
     rbtk_io_feature_type type;
+    size_t index;
 } RBTK_IO_FEATURE;
 
 RBTK_NO_DISCARD bool
@@ -65,6 +132,19 @@ priv_rbtk_input_init(void);
 RBTK_NO_DISCARD bool
 priv_rbtk_input_terminate(void);
 
+RBTK_PRIVATE RBTK_NO_DISCARD RBTK_IO_DEVICE *
+priv_rbtk_get_io_devices(void);
+
+RBTK_PRIVATE bool
+priv_rbtk_push_io_event(RBTK_IO_DEVICE *device, RBTK_IO_FEATURE *feature,
+    bool pressed, long double time);
+
+RBTK_PRIVATE RBTK_NO_DISCARD bool
+priv_rbtk_input_awaits_gpu(void);
+
+RBTK_PRIVATE void
+priv_rbtk_input_presented(long double presented, long double completed);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
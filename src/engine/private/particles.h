@@ -0,0 +1,63 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_PRIVATE_PARTICLES_H_
+#define RBTK_ENGINE_PRIVATE_PARTICLES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include "../particles.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../../runtime/common.h"
+
+/*
+ * Each field of the particles is kept in its own array, all of which are
+ * carved out of the same block of memory. The capacity is rounded up to
+ * a whole number of lanes, so updates never have to handle a remainder.
+ */
+typedef struct RBTK_PARTICLES {
+    size_t capacity;
+    size_t count;
+    float gravity_x;
+    float gravity_y;
+    bool fade;
+
+    float *x;
+    float *y;
+    float *x_speed;
+    float *y_speed;
+    float *life;
+    float *inv_lifetime; /* 1.0f / the life the particle started with */
+    float *alpha;
+} RBTK_PARTICLES;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_PRIVATE_PARTICLES_H_ */
@@ -0,0 +1,67 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_PRIVATE_TILEMAP_H_
+#define RBTK_ENGINE_PRIVATE_TILEMAP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include "../tilemap.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../../runtime/common.h"
+
+#define RBTK_SENSOR_DIR_COUNT 4
+
+/*
+ * For each way a sensor can look, how far solid ground reaches into the
+ * tile from the opposite side. A sensor looking down, for example, hits
+ * ground which reaches up from the bottom of the tile. These are indexed
+ * by the column (or row) of pixels the sensor is in.
+ */
+typedef struct rbtk_tile_collision {
+    uint8_t extents[RBTK_SENSOR_DIR_COUNT][RBTK_TILE_SIZE];
+} rbtk_tile_collision;
+
+typedef struct RBTK_TILESET {
+    size_t tile_count;
+    rbtk_tile_collision *collision;
+    rbtk_tile_angle *angles;
+} RBTK_TILESET;
+
+typedef struct RBTK_TILEMAP {
+    const RBTK_TILESET *tileset;
+    size_t width;
+    size_t height;
+    uint16_t *tiles;
+} RBTK_TILEMAP;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_PRIVATE_TILEMAP_H_ */
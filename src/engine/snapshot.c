@@ -0,0 +1,412 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "snapshot.h"
+#include "./private/snapshot.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio.h"
+#include "graphics.h"
+
+#include "./private/audio.h"
+#include "./private/graphics.h"
+
+#include "../runtime/common.h"
+#include "../runtime/time.h"
+
+#define REQUIRE_INITIALIZED_OR_RETURN(_value)       \
+    if (!initialized) {                             \
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE, \
+            "snapshot module not initialized");     \
+        return (_value);                            \
+    }
+
+#define DEFAULT_RANDOM_SEED 0x6B6C6569746F72ULL /* "kleitor" */
+
+struct snapshot_region {
+    void *data;
+    size_t size;
+};
+
+/*
+ * The offset is kept in milliseconds, as that is what the sound is put
+ * back to. Whether the sound was playing is kept along with it, since a
+ * restored sound which was stopped must not be left playing.
+ */
+struct sound_record {
+    long double offset_ms;
+    rbtk_sound_state state;
+};
+
+static struct snapshot_region regions[RBTK_MAX_SNAPSHOT_REGIONS];
+static size_t region_count;
+static size_t regions_size;
+
+static RBTK_SOUND *sounds[RBTK_MAX_SNAPSHOT_SOUNDS];
+static size_t sound_count;
+
+/*
+ * Changed every time something is added to or removed from snapshots. A
+ * snapshot remembers the layout it was taken with, and cannot be restored
+ * once the layout is different, as its contents would no longer line up.
+ */
+static size_t layout;
+
+static uint64_t random_state;
+static bool initialized;
+
+RBTK_PRIVATE RBTK_NO_DISCARD bool
+priv_rbtk_snapshot_init(void)
+{
+    if (initialized) {
+        return true;
+    }
+
+    region_count = 0;
+    regions_size = 0;
+    sound_count = 0;
+    layout = 1; /* zero is never taken */
+    random_state = DEFAULT_RANDOM_SEED;
+
+    initialized = true;
+    return true;
+}
+
+RBTK_PRIVATE RBTK_NO_DISCARD bool
+priv_rbtk_snapshot_terminate(void)
+{
+    if (!initialized) {
+        return true;
+    }
+
+    region_count = 0;
+    regions_size = 0;
+    sound_count = 0;
+
+    initialized = false;
+    return true;
+}
+
+static size_t
+find_region(const void *data)
+{
+    for (size_t i = 0; i < region_count; i++) {
+        if (regions[i].data == data) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_add_snapshot_region(void *data, size_t size)
+{
+    assert(data);
+    assert(size > 0);
+    REQUIRE_INITIALIZED_OR_RETURN(false);
+
+    if (find_region(data) != SIZE_MAX) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE,
+            "region already added to snapshots");
+        return false;
+    }
+    else if (region_count >= RBTK_MAX_SNAPSHOT_REGIONS) {
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "max snapshot region count reached");
+        return false;
+    }
+
+    regions[region_count].data = data;
+    regions[region_count].size = size;
+    region_count += 1;
+    regions_size += size;
+    layout += 1;
+    return true;
+}
+
+void
+rbtk_remove_snapshot_region(const void *data)
+{
+    assert(data);
+
+    size_t index = find_region(data);
+    if (index == SIZE_MAX) {
+        return; /* never added */
+    }
+
+    /*
+     * Regions are moved down rather than swapped with the last one, so
+     * the order of the rest (and as such, where they are in a snapshot)
+     * stays the same.
+     */
+    regions_size -= regions[index].size;
+    region_count -= 1;
+    memmove(&regions[index], &regions[index + 1],
+        (region_count - index) * sizeof(*regions));
+    layout += 1;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_add_snapshot_anime(RBTK_SPRITE_ANIME *anime)
+{
+    assert(anime);
+    return rbtk_add_snapshot_region(&anime->playback,
+        sizeof(anime->playback));
+}
+
+void
+rbtk_remove_snapshot_anime(RBTK_SPRITE_ANIME *anime)
+{
+    assert(anime);
+    rbtk_remove_snapshot_region(&anime->playback);
+}
+
+static size_t
+find_sound(const RBTK_SOUND *sound)
+{
+    for (size_t i = 0; i < sound_count; i++) {
+        if (sounds[i] == sound) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_add_snapshot_sound(RBTK_SOUND *sound)
+{
+    assert(sound);
+    REQUIRE_INITIALIZED_OR_RETURN(false);
+
+    if (find_sound(sound) != SIZE_MAX) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE,
+            "sound already added to snapshots");
+        return false;
+    }
+    else if (sound->type != RBTK_SOUND_TYPE_BUFFERED) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_ARGUMENT,
+            "only buffered sounds can be added to snapshots");
+        return false;
+    }
+    else if (sound_count >= RBTK_MAX_SNAPSHOT_SOUNDS) {
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "max snapshot sound count reached");
+        return false;
+    }
+
+    sounds[sound_count] = sound;
+    sound_count += 1;
+    layout += 1;
+    return true;
+}
+
+void
+rbtk_remove_snapshot_sound(RBTK_SOUND *sound)
+{
+    assert(sound);
+
+    size_t index = find_sound(sound);
+    if (index == SIZE_MAX) {
+        return; /* never added */
+    }
+
+    sound_count -= 1;
+    memmove(&sounds[index], &sounds[index + 1],
+        (sound_count - index) * sizeof(*sounds));
+    layout += 1;
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_get_snapshot_size(void)
+{
+    return sizeof(random_state) + regions_size
+        + sound_count * sizeof(struct sound_record);
+}
+
+RBTK_NO_DISCARD RBTK_SNAPSHOT *
+rbtk_create_snapshot(void)
+{
+    REQUIRE_INITIALIZED_OR_RETURN(NULL);
+
+    RBTK_SNAPSHOT *snapshot = NULL;
+    RBTK_MALLOC_OR_RETURN(&snapshot, NULL,
+        "could not allocate memory for snapshot");
+
+    size_t capacity = rbtk_get_snapshot_size();
+    unsigned char *data = malloc(capacity);
+    if (!data) {
+        free(snapshot);
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate memory for snapshot data");
+        return NULL;
+    }
+
+    snapshot->layout = 0; /* not yet taken */
+    snapshot->capacity = capacity;
+    snapshot->size = 0;
+    snapshot->data = data;
+    return snapshot;
+}
+
+void
+rbtk_destroy_snapshot(RBTK_SNAPSHOT *snapshot)
+{
+    if (snapshot) {
+        free(snapshot->data);
+        free(snapshot);
+    }
+}
+
+RBTK_NO_DISCARD bool
+rbtk_take_snapshot(RBTK_SNAPSHOT *snapshot)
+{
+    assert(snapshot);
+    REQUIRE_INITIALIZED_OR_RETURN(false);
+
+    size_t size = rbtk_get_snapshot_size();
+    if (size > snapshot->capacity) {
+        unsigned char *data = realloc(snapshot->data, size);
+        if (!data) {
+            rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+                "could not grow snapshot data");
+            return false;
+        }
+        snapshot->data = data;
+        snapshot->capacity = size;
+    }
+
+    unsigned char *out = snapshot->data;
+
+    memcpy(out, &random_state, sizeof(random_state));
+    out += sizeof(random_state);
+
+    for (size_t i = 0; i < region_count; i++) {
+        memcpy(out, regions[i].data, regions[i].size);
+        out += regions[i].size;
+    }
+
+    for (size_t i = 0; i < sound_count; i++) {
+        struct sound_record record;
+        record.offset_ms = rbtk_get_sound_offset(sounds[i], RBTK_MILLIS);
+        record.state = rbtk_get_sound_state(sounds[i]);
+        memcpy(out, &record, sizeof(record));
+        out += sizeof(record);
+    }
+
+    snapshot->size = size;
+    snapshot->layout = layout;
+    return true;
+}
+
+static void
+restore_sound(RBTK_SOUND *sound, const struct sound_record *record)
+{
+    /*
+     * The state is put back first. Stopping a sound rewinds it, and so
+     * the offset must be set once it is playing or paused again.
+     */
+    rbtk_sound_state state = rbtk_get_sound_state(sound);
+    switch (record->state) {
+    case RBTK_SOUND_STATE_STOPPED:
+        if (state != RBTK_SOUND_STATE_STOPPED) {
+            rbtk_stop_sound(sound);
+        }
+        return; /* stopped sounds have no offset */
+    case RBTK_SOUND_STATE_PLAYING:
+        if (state != RBTK_SOUND_STATE_PLAYING) {
+            rbtk_play_sound(sound);
+        }
+        break;
+    case RBTK_SOUND_STATE_PAUSED:
+        if (state == RBTK_SOUND_STATE_STOPPED) {
+            rbtk_play_sound(sound);
+        }
+        if (state != RBTK_SOUND_STATE_PAUSED) {
+            rbtk_pause_sound(sound);
+        }
+        break;
+    }
+
+    rbtk_set_sound_offset(sound, RBTK_MILLIS, record->offset_ms);
+}
+
+RBTK_NO_DISCARD bool
+rbtk_restore_snapshot(const RBTK_SNAPSHOT *snapshot)
+{
+    assert(snapshot);
+    REQUIRE_INITIALIZED_OR_RETURN(false);
+
+    if (snapshot->layout == 0) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE,
+            "snapshot was never taken");
+        return false;
+    }
+    else if (snapshot->layout != layout) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE,
+            "snapshot contents changed since it was taken");
+        return false;
+    }
+
+    const unsigned char *in = snapshot->data;
+
+    memcpy(&random_state, in, sizeof(random_state));
+    in += sizeof(random_state);
+
+    for (size_t i = 0; i < region_count; i++) {
+        memcpy(regions[i].data, in, regions[i].size);
+        in += regions[i].size;
+    }
+
+    for (size_t i = 0; i < sound_count; i++) {
+        struct sound_record record;
+        memcpy(&record, in, sizeof(record));
+        restore_sound(sounds[i], &record);
+        in += sizeof(record);
+    }
+
+    return true;
+}
+
+void
+rbtk_seed_random(uint64_t seed)
+{
+    random_state = seed;
+}
+
+RBTK_NO_DISCARD uint32_t
+rbtk_random(void)
+{
+    /*
+     * This is SplitMix64. Its whole state is a single counter, which any
+     * value is a valid seed for, and which is trivial to snapshot.
+     */
+    uint64_t z = (random_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (uint32_t) ((z ^ (z >> 31)) >> 32);
+}
@@ -0,0 +1,311 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_SNAPSHOT_H_
+#define RBTK_ENGINE_SNAPSHOT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+ * @file
+ * @brief The public API for the game engine's snapshot module.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "audio.h"
+#include "graphics.h"
+
+#include "../runtime/common.h"
+#include "../runtime/error.h"
+
+/*!
+ * @defgroup engine_snapshot Snapshots
+ * @brief The game engine's snapshot module.
+ *
+ * A snapshot is a copy of everything a game needs to simulate from a given
+ * point, kept in a single contiguous buffer. Restoring a snapshot puts the
+ * game back exactly as it was when the snapshot was taken. This is used
+ * for save states, rewinding, and rolling back a game to simulate it
+ * again (e.g., when late input arrives).
+ *
+ * What goes into a snapshot is registered ahead of time. Games register
+ * the memory their states keep their data in, as well as any animations
+ * and sounds which should be restored with them. The engine's random
+ * number generator is always part of a snapshot, so a game which only
+ * uses it for random numbers replays the same after a restore.
+ *
+ * Taking and restoring a snapshot is only a matter of copying memory, and
+ * does not allocate once the snapshot is large enough. As such, it is
+ * cheap enough to do every frame.
+ *
+ * @see rbtk_add_snapshot_region(void *, size_t)
+ * @see rbtk_take_snapshot(RBTK_SNAPSHOT *)
+ * @see rbtk_restore_snapshot(const RBTK_SNAPSHOT *)
+ *
+ * @{
+ */
+
+/*!
+ * @brief The maximum number of memory regions in a snapshot.
+ *
+ * @note This limit is arbitrary. Feel free to increase this value if need
+ * be. Animations count towards this limit.
+ */
+#define RBTK_MAX_SNAPSHOT_REGIONS 128
+
+/*!
+ * @brief The maximum number of sounds in a snapshot.
+ *
+ * @note This limit is arbitrary. Feel free to increase this value if need
+ * be.
+ */
+#define RBTK_MAX_SNAPSHOT_SOUNDS 32
+
+/*!
+ * @brief A copy of the state of a game.
+ *
+ * @see rbtk_create_snapshot(void)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_SNAPSHOT RBTK_SNAPSHOT;
+
+/*!
+ * @brief Adds a region of memory to snapshots.
+ *
+ * The memory is copied as is. As such, it should not contain any pointers
+ * to memory which may not exist when the snapshot is restored.
+ *
+ * @param[in] data The memory to add.
+ * @param[in] size The size of the memory in bytes.
+ * @return `true` on success, `false` on failure.
+ *
+ * @pointer_lifetime The memory must remain valid until it is removed with
+ * #rbtk_remove_snapshot_region(const void *) or until the engine is
+ * terminated.
+ *
+ * @debugging This function asserts that `data` is not `NULL` and that
+ * `size` is not `0`.
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE, If the engine is not initialized;
+ *                                <br>If the region was already added.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If the maximum number of regions
+ *                                    have already been added.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD bool
+rbtk_add_snapshot_region(void *data, size_t size);
+
+/*!
+ * @brief Removes a region of memory from snapshots.
+ *
+ * @note If the region was never added, this function is a no-op.
+ *
+ * @param[in] data The memory to remove.
+ *
+ * @debugging This function asserts that `data` is not `NULL`.
+ */
+void
+rbtk_remove_snapshot_region(const void *data);
+
+/*!
+ * @brief Adds the playback of an animation to snapshots.
+ *
+ * Only the playback of the animation is kept, which is its current frame,
+ * its timer, and which way it is playing. Its frames and settings are not.
+ *
+ * @param[in] anime The animation to add.
+ * @return `true` on success, `false` on failure.
+ *
+ * @pointer_lifetime The animation is removed from snapshots once it is
+ * destroyed.
+ *
+ * @debugging This function asserts that `anime` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE, If the engine is not initialized;
+ *                                <br>If the animation was already added.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If the maximum number of regions
+ *                                    have already been added.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD bool
+rbtk_add_snapshot_anime(RBTK_SPRITE_ANIME *anime);
+
+/*!
+ * @brief Removes the playback of an animation from snapshots.
+ *
+ * @note If the animation was never added, this function is a no-op.
+ *
+ * @param[in] anime The animation to remove.
+ *
+ * @debugging This function asserts that `anime` is not `NULL`.
+ */
+void
+rbtk_remove_snapshot_anime(RBTK_SPRITE_ANIME *anime);
+
+/*!
+ * @brief Adds the playback of a sound to snapshots.
+ *
+ * The offset of the sound, and whether it is playing, paused, or stopped,
+ * are kept. Only buffered sounds can be added. Streamed sounds only hold a
+ * small part of their audio at a time, and so cannot seek freely.
+ *
+ * @param[in] sound The sound to add.
+ * @return `true` on success, `false` on failure.
+ *
+ * @pointer_lifetime The sound is removed from snapshots once it is closed.
+ *
+ * @debugging This function asserts that `sound` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE,    If the engine is not initialized;
+ *                                   <br>If the sound was already added.}
+ * @signal{#RBTK_ERROR_ILLEGAL_ARGUMENT, If `sound` is not buffered.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY,    If the maximum number of sounds
+ *                                       have already been added.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD bool
+rbtk_add_snapshot_sound(RBTK_SOUND *sound);
+
+/*!
+ * @brief Removes the playback of a sound from snapshots.
+ *
+ * @note If the sound was never added, this function is a no-op.
+ *
+ * @param[in] sound The sound to remove.
+ *
+ * @debugging This function asserts that `sound` is not `NULL`.
+ */
+void
+rbtk_remove_snapshot_sound(RBTK_SOUND *sound);
+
+/*!
+ * @brief Returns the size of a snapshot.
+ *
+ * @return The number of bytes needed to hold everything currently added
+ *         to snapshots.
+ */
+RBTK_NO_DISCARD size_t
+rbtk_get_snapshot_size(void);
+
+/*!
+ * @brief Creates a snapshot.
+ *
+ * The snapshot is empty until it is taken. Its buffer is allocated for
+ * everything currently added to snapshots. If more is added later, the
+ * buffer is grown the next time the snapshot is taken.
+ *
+ * @return The created snapshot, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until it is destroyed
+ * with #rbtk_destroy_snapshot(RBTK_SNAPSHOT *).
+ *
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE, If the engine is not initialized.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If memory for the snapshot could
+ *                                    not be allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD RBTK_SNAPSHOT *
+rbtk_create_snapshot(void);
+
+/*!
+ * @brief Destroys a snapshot.
+ *
+ * @param[in] snapshot The snapshot to destroy. If `NULL`, this function is
+ *                     a no-op.
+ */
+void
+rbtk_destroy_snapshot(RBTK_SNAPSHOT *snapshot);
+
+/*!
+ * @brief Takes a snapshot.
+ *
+ * Everything currently added to snapshots is copied into the snapshot,
+ * replacing whatever it held before.
+ *
+ * @param[in] snapshot The snapshot to write to.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `snapshot` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If the snapshot needed to grow and
+ *                                    memory could not be allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD bool
+rbtk_take_snapshot(RBTK_SNAPSHOT *snapshot);
+
+/*!
+ * @brief Restores a snapshot.
+ *
+ * Everything which was added to snapshots when the snapshot was taken is
+ * put back as it was.
+ *
+ * @param[in] snapshot The snapshot to restore.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `snapshot` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE, If the snapshot was never taken;
+ *                                <br>If anything was added to or removed
+ *                                    from snapshots since it was taken.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD bool
+rbtk_restore_snapshot(const RBTK_SNAPSHOT *snapshot);
+
+/*!
+ * @brief Seeds the engine's random number generator.
+ *
+ * @note The generator is seeded with a fixed value when the engine is
+ * initialized. As such, random numbers are the same from run to run
+ * unless seeded otherwise (e.g., with the current time).
+ *
+ * @param[in] seed The seed to use.
+ */
+void
+rbtk_seed_random(uint64_t seed);
+
+/*!
+ * @brief Returns a random number from the engine.
+ *
+ * The state of the generator is part of every snapshot. Restoring one
+ * causes the same numbers to be returned again.
+ *
+ * @return A random number.
+ */
+RBTK_NO_DISCARD uint32_t
+rbtk_random(void);
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_SNAPSHOT_H_ */
@@ -0,0 +1,426 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "tilemap.h"
+#include "./private/tilemap.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../libraries/stb_image.h"
+
+#include "../runtime/asset.h"
+#include "../runtime/common.h"
+#include "../runtime/stream.h"
+
+#define SOLID_ALPHA 0x00 /* any alpha above this is solid */
+
+/*
+ * Converts an angle in radians to 256ths of a full turn. Angles wrap, so
+ * a negative angle is the same as the one a full turn above it.
+ */
+static rbtk_tile_angle
+to_tile_angle(long double radians)
+{
+    long turns = lroundl(radians * 128.0L / 3.14159265358979323846L);
+    return (rbtk_tile_angle) (turns & 0xFF);
+}
+
+/*
+ * Tiles outside of a tilemap may be at negative positions. These must be
+ * rounded down to find the tile, rather than towards zero.
+ */
+static int32_t
+tile_of(int32_t pixel)
+{
+    return pixel >= 0 ? pixel / RBTK_TILE_SIZE
+        : -((RBTK_TILE_SIZE - 1 - pixel) / RBTK_TILE_SIZE);
+}
+
+RBTK_NO_DISCARD RBTK_TILESET *
+rbtk_create_tileset(size_t tile_count)
+{
+    assert(tile_count > 0);
+    assert(tile_count <= (size_t) UINT16_MAX + 1);
+
+    RBTK_TILESET *tileset = NULL;
+    RBTK_MALLOC_OR_RETURN(&tileset, NULL,
+        "could not allocate memory for tileset");
+
+    tileset->tile_count = tile_count;
+    tileset->collision = calloc(tile_count, sizeof(*tileset->collision));
+    tileset->angles = calloc(tile_count, sizeof(*tileset->angles));
+    if (!tileset->collision || !tileset->angles) {
+        rbtk_destroy_tileset(tileset);
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate memory for tile collision");
+        return NULL;
+    }
+
+    return tileset;
+}
+
+RBTK_NO_DISCARD RBTK_TILESET *
+rbtk_load_tileset(RBTK_ASSET *asset)
+{
+    assert(asset);
+
+    RBTK_IN_STREAM *in = rbtk_open_asset_in_stream(asset);
+    if (!in) {
+        return NULL;
+    }
+
+    RBTK_TILESET *tileset = rbtk_read_tileset(in);
+    rbtk_close_in_stream(in);
+    return tileset;
+}
+
+RBTK_NO_DISCARD RBTK_TILESET *
+rbtk_read_tileset(RBTK_IN_STREAM *in)
+{
+    assert(in);
+
+    size_t buffer_size = 0;
+    unsigned char *buffer = rbtk_buffer_remaining(in, &buffer_size);
+    if (!buffer) {
+        return NULL;
+    }
+
+    int width, height, channels;
+    stbi_uc *img = stbi_load_from_memory(buffer, (int) buffer_size,
+        &width, &height, &channels, 4);
+    free(buffer);
+    if (!img) {
+        rbtk_signal_error(RBTK_ERROR_IO,
+            "could not decode tileset image");
+        return NULL;
+    }
+
+    size_t columns = (size_t) width / RBTK_TILE_SIZE;
+    size_t rows = (size_t) height / RBTK_TILE_SIZE;
+    if (columns == 0 || rows == 0) {
+        stbi_image_free(img);
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_ARGUMENT,
+            "tileset image is smaller than a tile");
+        return NULL;
+    }
+
+    size_t tile_count = columns * rows;
+    if (tile_count > (size_t) UINT16_MAX + 1) {
+        tile_count = (size_t) UINT16_MAX + 1;
+    }
+
+    RBTK_TILESET *tileset = rbtk_create_tileset(tile_count);
+    if (!tileset) {
+        stbi_image_free(img);
+        return NULL;
+    }
+
+    /* the first tile is always empty, so it is skipped */
+    uint8_t mask[RBTK_TILE_SIZE * RBTK_TILE_SIZE];
+    for (size_t tile = 1; tile < tile_count; tile++) {
+        size_t left = (tile % columns) * RBTK_TILE_SIZE;
+        size_t top = (tile / columns) * RBTK_TILE_SIZE;
+        for (size_t y = 0; y < RBTK_TILE_SIZE; y++) {
+            for (size_t x = 0; x < RBTK_TILE_SIZE; x++) {
+                size_t pixel = (top + y) * (size_t) width + (left + x);
+                mask[y * RBTK_TILE_SIZE + x] =
+                    img[pixel * 4 + 3] > SOLID_ALPHA;
+            }
+        }
+        rbtk_build_tile_collision(tileset, (uint16_t) tile, mask);
+    }
+
+    stbi_image_free(img);
+    return tileset;
+}
+
+void
+rbtk_destroy_tileset(RBTK_TILESET *tileset)
+{
+    if (tileset) {
+        free(tileset->collision);
+        free(tileset->angles);
+        free(tileset);
+    }
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_get_tile_count(const RBTK_TILESET *tileset)
+{
+    assert(tileset);
+    return tileset->tile_count;
+}
+
+static rbtk_tile_angle
+get_surface_angle(const rbtk_tile_collision *collision)
+{
+    const uint8_t *floor = collision->extents[RBTK_SENSOR_DOWN];
+    const uint8_t *ceiling = collision->extents[RBTK_SENSOR_UP];
+
+    /*
+     * The slope is taken between the first and last columns which have
+     * any ground in them. This way, a slope which only covers part of a
+     * tile is not made any steeper (or shallower) than it really is.
+     */
+    bool has_floor = false;
+    const uint8_t *surface = floor;
+    for (size_t x = 0; x < RBTK_TILE_SIZE; x++) {
+        has_floor |= floor[x] > 0;
+    }
+    if (!has_floor) {
+        surface = ceiling;
+    }
+
+    size_t left = 0;
+    while (left < RBTK_TILE_SIZE && surface[left] == 0) {
+        left += 1;
+    }
+    size_t right = RBTK_TILE_SIZE;
+    while (right > left && surface[right - 1] == 0) {
+        right -= 1;
+    }
+    if (right - left < 2) {
+        return has_floor ? 0x00 : 0x80; /* no slope to speak of */
+    }
+
+    long double dx = (long double) (right - 1 - left);
+    long double dy = (long double) surface[right - 1] - surface[left];
+
+    /*
+     * A ceiling is walked upside down, from right to left. So, its angle
+     * is that of the line going the other way.
+     */
+    return has_floor ? to_tile_angle(atan2l(dy, dx))
+        : to_tile_angle(atan2l(dy, -dx));
+}
+
+void
+rbtk_build_tile_collision(RBTK_TILESET *tileset, uint16_t tile,
+    const uint8_t *mask)
+{
+    assert(tileset);
+    assert(mask);
+    assert(tile < tileset->tile_count);
+
+    rbtk_tile_collision *collision = &tileset->collision[tile];
+
+    /*
+     * Ground only counts if it reaches all the way from the side of the
+     * tile. This matches how heights are stored in the original games,
+     * where terrain is always attached to one side of its tile.
+     */
+    for (int i = 0; i < RBTK_TILE_SIZE; i++) {
+        uint8_t *down = &collision->extents[RBTK_SENSOR_DOWN][i];
+        uint8_t *up = &collision->extents[RBTK_SENSOR_UP][i];
+        uint8_t *right = &collision->extents[RBTK_SENSOR_RIGHT][i];
+        uint8_t *left = &collision->extents[RBTK_SENSOR_LEFT][i];
+        *down = *up = *right = *left = 0;
+
+        const int last = RBTK_TILE_SIZE - 1;
+        while (*down < RBTK_TILE_SIZE
+            && mask[(last - *down) * RBTK_TILE_SIZE + i]) {
+            *down += 1;
+        }
+        while (*up < RBTK_TILE_SIZE
+            && mask[*up * RBTK_TILE_SIZE + i]) {
+            *up += 1;
+        }
+        while (*right < RBTK_TILE_SIZE
+            && mask[i * RBTK_TILE_SIZE + (last - *right)]) {
+            *right += 1;
+        }
+        while (*left < RBTK_TILE_SIZE
+            && mask[i * RBTK_TILE_SIZE + *left]) {
+            *left += 1;
+        }
+    }
+
+    tileset->angles[tile] = get_surface_angle(collision);
+}
+
+RBTK_NO_DISCARD rbtk_tile_angle
+rbtk_get_tile_angle(const RBTK_TILESET *tileset, uint16_t tile)
+{
+    assert(tileset);
+    assert(tile < tileset->tile_count);
+    return tileset->angles[tile];
+}
+
+void
+rbtk_set_tile_angle(RBTK_TILESET *tileset, uint16_t tile,
+    rbtk_tile_angle angle)
+{
+    assert(tileset);
+    assert(tile < tileset->tile_count);
+    tileset->angles[tile] = angle;
+}
+
+RBTK_NO_DISCARD RBTK_TILEMAP *
+rbtk_create_tilemap(const RBTK_TILESET *tileset, size_t width,
+    size_t height)
+{
+    assert(tileset);
+    assert(width > 0);
+    assert(height > 0);
+
+    RBTK_TILEMAP *tilemap = NULL;
+    RBTK_MALLOC_OR_RETURN(&tilemap, NULL,
+        "could not allocate memory for tilemap");
+
+    tilemap->tileset = tileset;
+    tilemap->width = width;
+    tilemap->height = height;
+    tilemap->tiles = calloc(width * height, sizeof(*tilemap->tiles));
+    if (!tilemap->tiles) {
+        free(tilemap);
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "could not allocate memory for tiles");
+        return NULL;
+    }
+
+    return tilemap;
+}
+
+void
+rbtk_destroy_tilemap(RBTK_TILEMAP *tilemap)
+{
+    if (tilemap) {
+        free(tilemap->tiles);
+        free(tilemap);
+    }
+}
+
+void
+rbtk_get_tilemap_size(const RBTK_TILEMAP *tilemap,
+    size_t *width, size_t *height)
+{
+    assert(tilemap);
+    assert(width || height);
+    if (width) {
+        *width = tilemap->width;
+    }
+    if (height) {
+        *height = tilemap->height;
+    }
+}
+
+RBTK_NO_DISCARD uint16_t
+rbtk_get_tile(const RBTK_TILEMAP *tilemap, int32_t x, int32_t y)
+{
+    assert(tilemap);
+
+    if (x < 0 || y < 0 || (size_t) x >= tilemap->width
+        || (size_t) y >= tilemap->height) {
+        return RBTK_EMPTY_TILE;
+    }
+    return tilemap->tiles[(size_t) y * tilemap->width + (size_t) x];
+}
+
+void
+rbtk_set_tile(RBTK_TILEMAP *tilemap, int32_t x, int32_t y, uint16_t tile)
+{
+    assert(tilemap);
+    assert(x >= 0 && (size_t) x < tilemap->width);
+    assert(y >= 0 && (size_t) y < tilemap->height);
+    assert(tile < tilemap->tileset->tile_count);
+    tilemap->tiles[(size_t) y * tilemap->width + (size_t) x] = tile;
+}
+
+static void
+cast_sensor(const RBTK_TILEMAP *tilemap, const rbtk_sensor *sensor,
+    rbtk_sensor_hit *hit)
+{
+    const RBTK_TILESET *tileset = tilemap->tileset;
+    bool vertical = sensor->dir == RBTK_SENSOR_DOWN
+        || sensor->dir == RBTK_SENSOR_UP;
+    int32_t step = sensor->dir == RBTK_SENSOR_DOWN
+        || sensor->dir == RBTK_SENSOR_RIGHT ? 1 : -1;
+
+    /*
+     * Work along the axis the sensor looks down, and across the other one.
+     * The offset is how far into its tile the sensor is, measured from
+     * the side it looks from.
+     */
+    int32_t along = vertical ? sensor->y : sensor->x;
+    int32_t across = vertical ? sensor->x : sensor->y;
+    int32_t along_tile = tile_of(along);
+    int32_t across_tile = tile_of(across);
+    int32_t pixel = along - along_tile * RBTK_TILE_SIZE;
+    int32_t offset = step > 0 ? pixel : RBTK_TILE_SIZE - 1 - pixel;
+    size_t column = (size_t) (across - across_tile * RBTK_TILE_SIZE);
+
+#define TILE_AT(_k)                                               \
+    (vertical                                                     \
+        ? rbtk_get_tile(tilemap, across_tile,                     \
+            along_tile + (_k) * step)                             \
+        : rbtk_get_tile(tilemap, along_tile + (_k) * step,        \
+            across_tile))
+#define EXTENT_OF(_tile) \
+    (tileset->collision[(_tile)].extents[sensor->dir][column])
+
+    int32_t k = 0;
+    uint16_t tile = TILE_AT(0);
+    int32_t extent = EXTENT_OF(tile);
+
+    if (extent == 0) {
+        /* nothing here, so look in the next tile */
+        k = 1;
+        tile = TILE_AT(1);
+        extent = EXTENT_OF(tile);
+    }
+    else if (extent == RBTK_TILE_SIZE) {
+        /* buried, so the surface may be in the tile before this one */
+        uint16_t prev_tile = TILE_AT(-1);
+        int32_t prev_extent = EXTENT_OF(prev_tile);
+        if (prev_extent > 0) {
+            k = -1;
+            tile = prev_tile;
+            extent = prev_extent;
+        }
+    }
+
+#undef TILE_AT
+#undef EXTENT_OF
+
+    hit->found = extent > 0;
+    hit->distance = k * RBTK_TILE_SIZE + RBTK_TILE_SIZE - extent - offset;
+    hit->angle = tileset->angles[tile];
+    hit->tile = tile;
+}
+
+void
+rbtk_cast_sensors(const RBTK_TILEMAP *tilemap, const rbtk_sensor *sensors,
+    rbtk_sensor_hit *hits, size_t count)
+{
+    assert(tilemap);
+    assert((sensors && hits) || count == 0);
+
+    for (size_t i = 0; i < count; i++) {
+        cast_sensor(tilemap, &sensors[i], &hits[i]);
+    }
+}
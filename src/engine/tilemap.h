@@ -0,0 +1,377 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_ENGINE_TILEMAP_H_
+#define RBTK_ENGINE_TILEMAP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+ * @file
+ * @brief The public API for the game engine's tilemap module.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../runtime/asset.h"
+#include "../runtime/common.h"
+#include "../runtime/error.h"
+
+/*!
+ * @defgroup engine_tilemap Tilemaps
+ * @brief The game engine's tilemap module.
+ *
+ * A tilemap is a grid of tiles which makes up the terrain of a level.
+ * What each tile looks like to collision is described by a tileset.
+ *
+ * Rather than checking the pixels of a tile during collision, a tileset
+ * stores how far solid ground reaches into each tile. For every side of a
+ * tile, this is kept as one byte for each row or column of pixels. Each
+ * tile also has an angle, which is the slope of its surface. These are
+ * worked out once, from the collision mask of each tile, when the tileset
+ * is loaded.
+ *
+ * Collision is checked with sensors, which look for the nearest surface in
+ * a straight line from a point. A sensor only ever looks at two tiles.
+ * When the tile it starts in is empty it also looks at the next one, and
+ * when the tile is full it also looks at the one before. As such, many
+ * sensors can be cast for every object, every tick.
+ *
+ * @see rbtk_load_tileset(RBTK_ASSET *)
+ * @see rbtk_cast_sensors(const RBTK_TILEMAP *, const rbtk_sensor *,
+ *      rbtk_sensor_hit *, size_t)
+ *
+ * @{
+ */
+
+/*!
+ * @brief The width and height of a tile, in pixels.
+ */
+#define RBTK_TILE_SIZE 16
+
+/*!
+ * @brief The tile which is always empty.
+ *
+ * Tiles outside of a tilemap are also considered to be this tile.
+ */
+#define RBTK_EMPTY_TILE 0
+
+/*!
+ * @brief The angle of a tile, in 256ths of a full turn.
+ *
+ * An angle of `0x00` is a flat floor. Angles increase counterclockwise, as
+ * seen on screen. For example, `0x40` is a wall facing left and `0x80` is
+ * a flat ceiling.
+ */
+typedef uint8_t rbtk_tile_angle;
+
+/*!
+ * @brief The way a sensor looks for a surface.
+ */
+typedef enum rbtk_sensor_dir {
+    RBTK_SENSOR_DOWN,  /*!< Looks for a floor.               */
+    RBTK_SENSOR_UP,    /*!< Looks for a ceiling.             */
+    RBTK_SENSOR_RIGHT, /*!< Looks for a wall to the right.   */
+    RBTK_SENSOR_LEFT,  /*!< Looks for a wall to the left.    */
+} rbtk_sensor_dir;
+
+/*!
+ * @brief Where a sensor is cast from, and which way.
+ */
+typedef struct rbtk_sensor {
+    int32_t x;           /*!< The X-axis position, in pixels. */
+    int32_t y;           /*!< The Y-axis position, in pixels. */
+    rbtk_sensor_dir dir; /*!< The way the sensor looks.       */
+} rbtk_sensor;
+
+/*!
+ * @brief What a sensor found.
+ */
+typedef struct rbtk_sensor_hit {
+    bool found;            /*!< If a surface was found at all.        */
+    int32_t distance;      /*!< Pixels to the surface. If negative,
+                                the sensor is inside the ground, and
+                                this is how far it must move back.    */
+    rbtk_tile_angle angle; /*!< The angle of the surface.             */
+    uint16_t tile;         /*!< The tile the surface is in.           */
+} rbtk_sensor_hit;
+
+/*!
+ * @brief The collision of every tile which can be placed in a tilemap.
+ *
+ * @see rbtk_create_tileset(size_t)
+ * @see rbtk_load_tileset(RBTK_ASSET *)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_TILESET RBTK_TILESET;
+
+/*!
+ * @brief A grid of tiles.
+ *
+ * @see rbtk_create_tilemap(const RBTK_TILESET *, size_t, size_t)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_TILEMAP RBTK_TILEMAP;
+
+/*!
+ * @brief Creates a tileset with every tile empty.
+ *
+ * @param[in] tile_count The number of tiles in the tileset.
+ * @return The created tileset, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until it is destroyed
+ * with #rbtk_destroy_tileset(RBTK_TILESET *).
+ *
+ * @debugging This function asserts that `tile_count` is not `0` and not
+ * greater than `UINT16_MAX + 1`.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If memory for the tileset could not
+ *                                    be allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD RBTK_TILESET *
+rbtk_create_tileset(size_t tile_count);
+
+/*!
+ * @brief Loads a tileset from an image of collision masks.
+ *
+ * The image is split into tiles from left to right, then top to bottom.
+ * Any pixel which is not fully transparent is solid. The first tile is
+ * always #RBTK_EMPTY_TILE, and is left empty regardless of its pixels.
+ *
+ * @param[in] asset The image to load.
+ * @return The loaded tileset, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until it is destroyed
+ * with #rbtk_destroy_tileset(RBTK_TILESET *).
+ *
+ * @debugging This function asserts that `asset` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO,               If the image could not be read.}
+ * @signal{#RBTK_ERROR_ILLEGAL_ARGUMENT, If the image is smaller than a
+ *                                       tile.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY,    If memory for the tileset could
+ *                                       not be allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD RBTK_TILESET *
+rbtk_load_tileset(RBTK_ASSET *asset);
+
+/*!
+ * @brief Reads a tileset from a stream of an image of collision masks.
+ *
+ * This behaves the same as #rbtk_load_tileset(RBTK_ASSET *), except the
+ * image is read from a stream which has already been opened. Since it does
+ * not touch the asset system, it is safe to call from a worker thread.
+ *
+ * @param[in] in The stream to read the image from. This is read until its
+ *               end, but is not closed.
+ * @return The read tileset, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until it is destroyed
+ * with #rbtk_destroy_tileset(RBTK_TILESET *).
+ *
+ * @debugging This function asserts that `in` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO,               If the image could not be read.}
+ * @signal{#RBTK_ERROR_ILLEGAL_ARGUMENT, If the image is smaller than a
+ *                                       tile.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY,    If memory for the tileset could
+ *                                       not be allocated.}
+ * @enderrors
+ *
+ * @see rbtk_load_tileset(RBTK_ASSET *)
+ */
+RBTK_NO_DISCARD RBTK_TILESET *
+rbtk_read_tileset(RBTK_IN_STREAM *in);
+
+/*!
+ * @brief Destroys a tileset.
+ *
+ * @attention It is an unchecked runtime error to destroy a tileset which
+ * is still used by a tilemap.
+ *
+ * @param[in] tileset The tileset to destroy. If `NULL`, this function is
+ *                    a no-op.
+ */
+void
+rbtk_destroy_tileset(RBTK_TILESET *tileset);
+
+/*!
+ * @brief Returns the number of tiles in a tileset.
+ *
+ * @param[in] tileset The tileset to query.
+ * @return The number of tiles.
+ *
+ * @debugging This function asserts that `tileset` is not `NULL`.
+ */
+RBTK_NO_DISCARD size_t
+rbtk_get_tile_count(const RBTK_TILESET *tileset);
+
+/*!
+ * @brief Works out the collision of a tile from its mask.
+ *
+ * The angle of the tile is worked out from the slope of its floor. If it
+ * has no floor, the slope of its ceiling is used instead.
+ *
+ * @param[in] tileset The tileset to update.
+ * @param[in] tile    The tile to update.
+ * @param[in] mask    The mask of the tile. This is #RBTK_TILE_SIZE rows
+ *                    of #RBTK_TILE_SIZE bytes each, from top to bottom.
+ *                    A non-zero byte is a solid pixel.
+ *
+ * @debugging This function asserts that `tileset` and `mask` are not
+ * `NULL`, and that `tile` is less than the number of tiles.
+ */
+void
+rbtk_build_tile_collision(RBTK_TILESET *tileset, uint16_t tile,
+    const uint8_t *mask);
+
+/*!
+ * @brief Returns the angle of a tile.
+ *
+ * @param[in] tileset The tileset to query.
+ * @param[in] tile    The tile to query.
+ * @return The angle of the tile.
+ *
+ * @debugging This function asserts that `tileset` is not `NULL`, and that
+ * `tile` is less than the number of tiles.
+ */
+RBTK_NO_DISCARD rbtk_tile_angle
+rbtk_get_tile_angle(const RBTK_TILESET *tileset, uint16_t tile);
+
+/*!
+ * @brief Sets the angle of a tile.
+ *
+ * This overrides the angle worked out from the mask of the tile.
+ *
+ * @param[in] tileset The tileset to update.
+ * @param[in] tile    The tile to update.
+ * @param[in] angle   The angle of the tile.
+ *
+ * @debugging This function asserts that `tileset` is not `NULL`, and that
+ * `tile` is less than the number of tiles.
+ */
+void
+rbtk_set_tile_angle(RBTK_TILESET *tileset, uint16_t tile,
+    rbtk_tile_angle angle);
+
+/*!
+ * @brief Creates a tilemap with every tile empty.
+ *
+ * @param[in] tileset The tileset the tiles come from.
+ * @param[in] width   The width of the tilemap, in tiles.
+ * @param[in] height  The height of the tilemap, in tiles.
+ * @return The created tilemap, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until it is destroyed
+ * with #rbtk_destroy_tilemap(RBTK_TILEMAP *). The tileset must outlive
+ * the tilemap.
+ *
+ * @debugging This function asserts that `tileset` is not `NULL`, and that
+ * `width` and `height` are not `0`.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, If memory for the tilemap could not
+ *                                    be allocated.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD RBTK_TILEMAP *
+rbtk_create_tilemap(const RBTK_TILESET *tileset, size_t width,
+    size_t height);
+
+/*!
+ * @brief Destroys a tilemap.
+ *
+ * @param[in] tilemap The tilemap to destroy. If `NULL`, this function is
+ *                    a no-op.
+ */
+void
+rbtk_destroy_tilemap(RBTK_TILEMAP *tilemap);
+
+/*!
+ * @brief Returns the size of a tilemap.
+ *
+ * @param[in]  tilemap The tilemap to query.
+ * @param[out] width   The width, in tiles.
+ * @param[out] height  The height, in tiles.
+ *
+ * @debugging This function asserts that `tilemap` and that at least one
+ * of the dimensions are not `NULL`.
+ */
+void
+rbtk_get_tilemap_size(const RBTK_TILEMAP *tilemap,
+    size_t *width, size_t *height);
+
+/*!
+ * @brief Returns a tile in a tilemap.
+ *
+ * @param[in] tilemap The tilemap to query.
+ * @param[in] x       The column of the tile.
+ * @param[in] y       The row of the tile.
+ * @return The tile, #RBTK_EMPTY_TILE if it is outside of the tilemap.
+ *
+ * @debugging This function asserts that `tilemap` is not `NULL`.
+ */
+RBTK_NO_DISCARD uint16_t
+rbtk_get_tile(const RBTK_TILEMAP *tilemap, int32_t x, int32_t y);
+
+/*!
+ * @brief Sets a tile in a tilemap.
+ *
+ * @param[in] tilemap The tilemap to update.
+ * @param[in] x       The column of the tile.
+ * @param[in] y       The row of the tile.
+ * @param[in] tile    The tile to place.
+ *
+ * @debugging This function asserts that `tilemap` is not `NULL`, that the
+ * tile is inside of the tilemap, and that `tile` is in its tileset.
+ */
+void
+rbtk_set_tile(RBTK_TILEMAP *tilemap, int32_t x, int32_t y, uint16_t tile);
+
+/*!
+ * @brief Casts a batch of sensors.
+ *
+ * @param[in]  tilemap The tilemap to cast the sensors in.
+ * @param[in]  sensors The sensors to cast.
+ * @param[out] hits    Where to write what each sensor found.
+ * @param[in]  count   The number of sensors.
+ *
+ * @debugging This function asserts that `tilemap` is not `NULL`, and that
+ * `sensors` and `hits` are not `NULL` if `count` is not `0`.
+ */
+void
+rbtk_cast_sensors(const RBTK_TILEMAP *tilemap, const rbtk_sensor *sensors,
+    rbtk_sensor_hit *hits, size_t count);
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_ENGINE_TILEMAP_H_ */
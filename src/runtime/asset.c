@@ -32,6 +32,7 @@
 
 #include "common.h"
 #include "error.h"
+#include "stats.h"
 #include "stream.h"
 
 #define REQUIRE_INITIALIZED_OR_RETURN(_value)       \
@@ -49,6 +50,7 @@ struct loaded_asset {
 
 static struct loaded_asset *assets_head;
 static struct loaded_asset *assets_tail;
+static RBTK_STAT *loaded_stat;
 static bool initialized;
 
 static RBTK_ASSET *
@@ -105,6 +107,9 @@ load_asset(const char *name)
     loaded->next = NULL;
 
     RBTK_DLL_PUSH(assets_head, assets_tail, loaded);
+    if (loaded_stat) {
+        rbtk_count_stat(loaded_stat, 1.0L);
+    }
     return asset;
 }
 
@@ -119,6 +124,9 @@ priv_rbtk_asset_init(void)
         return false;
     }
 
+    /* a missing stat is not fatal, loads are just not counted */
+    loaded_stat = rbtk_get_stat("asset.loaded", RBTK_STAT_TYPE_COUNTER);
+
     initialized = true;
     return true;
 }
@@ -134,6 +142,8 @@ priv_rbtk_asset_terminate(void)
         return false;
     }
 
+    loaded_stat = NULL;
+
     initialized = false;
     return true;
 }
@@ -0,0 +1,803 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "compress.h"
+#include "./private/compress.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "error.h"
+#include "stream.h"
+
+/*
+ * Reading compressed data one byte at a time from the wrapped stream would
+ * mean a call through a function pointer for every byte. Instead, it is
+ * read in blocks of this size.
+ */
+#define INPUT_BLOCK_SIZE 4096
+
+#define KOSINSKI_WINDOW_SIZE 0x2000
+#define KOSINSKI_WINDOW_MASK (KOSINSKI_WINDOW_SIZE - 1)
+
+#define NEMESIS_TILE_SIZE   32 /* 8x8 pixels, four bits each */
+#define NEMESIS_ROW_SIZE    4
+#define NEMESIS_INLINE_CODE 0x3F
+#define NEMESIS_TABLE_END   0xFF
+
+#define ENIGMA_FLAG_COUNT 5
+
+typedef struct input {
+    RBTK_IN_STREAM *in;
+    size_t pos;
+    size_t len;
+    unsigned char data[INPUT_BLOCK_SIZE];
+} input;
+
+/*
+ * Nemesis and Enigma read their data most significant bit first. Past the
+ * end of the data, zeroes are shifted in. How many of these were shifted
+ * in is kept, so reading past the end can be told apart from a code which
+ * happens to end on the last bit.
+ */
+typedef struct bit_reader {
+    uint32_t bits;
+    unsigned count;
+    unsigned padding;
+} bit_reader;
+
+/*
+ * Every decompressing stream starts with this, so the same functions can
+ * drain output for all of them. Formats which output more than one byte
+ * at a time write it to the stage first if the caller asked for less.
+ */
+typedef struct decoder {
+    input input;
+    bool finished;
+    unsigned char stage[NEMESIS_ROW_SIZE];
+    size_t stage_pos;
+    size_t stage_len;
+} decoder;
+
+typedef bool (*decode_unit_fun)(decoder *dec, unsigned char *out);
+
+typedef struct kosinski_src {
+    decoder base;
+    bool started;
+    uint16_t desc;
+    unsigned desc_bits;
+    size_t copy_len;
+    size_t copy_dist;
+    size_t pos;
+    unsigned char window[KOSINSKI_WINDOW_SIZE];
+} kosinski_src;
+
+typedef struct nemesis_code {
+    uint8_t nibble;
+    uint8_t count;
+    uint8_t length; /* zero if no code starts with these bits */
+} nemesis_code;
+
+typedef struct nemesis_src {
+    decoder base;
+    bit_reader reader;
+    bool xor_mode;
+    size_t rows_left;
+    uint32_t prev_row;
+    uint8_t run_nibble;
+    uint8_t run_left;
+    nemesis_code codes[256];
+} nemesis_src;
+
+typedef enum enigma_mode {
+    ENIGMA_COPY_INCREMENT,
+    ENIGMA_COPY_COMMON,
+    ENIGMA_INLINE_REPEAT,
+    ENIGMA_INLINE_INCREMENT,
+    ENIGMA_INLINE_DECREMENT,
+    ENIGMA_INLINE_EACH,
+} enigma_mode;
+
+typedef struct enigma_src {
+    decoder base;
+    bit_reader reader;
+    unsigned packet_bits;
+    uint8_t flag_mask;
+    uint16_t increment;
+    uint16_t common;
+    enigma_mode mode;
+    unsigned run_left;
+    uint16_t value;
+} enigma_src;
+
+static short
+next_byte(input *input)
+{
+    if (input->pos >= input->len) {
+        size_t read = rbtk_read_bytes(input->in, input->data, 0,
+            sizeof(input->data));
+        input->pos = 0;
+        input->len = read == SIZE_MAX ? 0 : read;
+        if (input->len == 0) {
+            return EOF;
+        }
+    }
+    return input->data[input->pos++];
+}
+
+static void
+fill_bits(bit_reader *reader, input *input, unsigned count)
+{
+    assert(count <= 24);
+    while (reader->count < count) {
+        short next = next_byte(input);
+        if (next < 0) {
+            next = 0x00;
+            reader->padding += 8;
+        }
+        reader->bits = (reader->bits << 8) | (uint32_t) next;
+        reader->count += 8;
+    }
+}
+
+static uint32_t
+peek_bits(bit_reader *reader, input *input, unsigned count)
+{
+    fill_bits(reader, input, count);
+    return (reader->bits >> (reader->count - count))
+        & ((UINT32_C(1) << count) - 1);
+}
+
+/*
+ * Returns false if any of the bits read were past the end of the data.
+ */
+static bool
+skip_bits(bit_reader *reader, unsigned count)
+{
+    assert(count <= reader->count);
+    reader->count -= count;
+    return reader->count >= reader->padding;
+}
+
+static bool
+read_bits(bit_reader *reader, input *input, unsigned count,
+    uint32_t *value)
+{
+    *value = peek_bits(reader, input, count);
+    return skip_bits(reader, count);
+}
+
+static bool
+fail_decode(decoder *dec, const char *msg)
+{
+    dec->finished = true;
+    rbtk_signal_error(RBTK_ERROR_IO, msg);
+    return false;
+}
+
+/*
+ * Drains as much output as the caller asked for, a unit at a time. Whole
+ * units are written straight to the caller's buffer, and only the last
+ * one is staged if it does not fit.
+ */
+static size_t
+decode_units(decoder *dec, decode_unit_fun decode_unit, size_t unit_size,
+    unsigned char *out, size_t len)
+{
+    size_t done = 0;
+
+    while (done < len && dec->stage_pos < dec->stage_len) {
+        out[done++] = dec->stage[dec->stage_pos++];
+    }
+
+    while (!dec->finished && len - done >= unit_size) {
+        if (!decode_unit(dec, out + done)) {
+            return done;
+        }
+        done += unit_size;
+    }
+
+    if (!dec->finished && done < len && decode_unit(dec, dec->stage)) {
+        dec->stage_len = unit_size;
+        dec->stage_pos = 0;
+        while (done < len) {
+            out[done++] = dec->stage[dec->stage_pos++];
+        }
+    }
+
+    return done;
+}
+
+static RBTK_IN_STREAM *
+open_decoder(RBTK_IN_STREAM *in, rbtk_in_stream_funs funs, decoder *dec)
+{
+    dec->input.in = in;
+
+    RBTK_IN_STREAM *out = rbtk_open_in_stream(funs, dec);
+    if (!out) {
+        free(dec);
+        return NULL;
+    }
+    return out;
+}
+
+static bool
+close_decoder(RBTK_UNUSED RBTK_IN_STREAM *in, decoder *dec)
+{
+    assert(in && dec);
+    bool closed = rbtk_close_in_stream(dec->input.in);
+    free(dec);
+    return closed;
+}
+
+static short
+read_decoded_byte(RBTK_IN_STREAM *in, RBTK_UNUSED decoder *dec)
+{
+    assert(in && dec);
+    unsigned char byte;
+    if (rbtk_read_bytes(in, &byte, 0, 1) < 1) {
+        return EOF;
+    }
+    return byte;
+}
+
+/*
+ * Kosinski reads its flags from a little-endian word, least significant
+ * bit first. The next word is read as soon as the last bit of the current
+ * one is taken, even if it comes before data that is still to be read for
+ * the current command. This is how the original decompressor did it.
+ */
+static void
+load_kosinski_flags(kosinski_src *src)
+{
+    short lo = next_byte(&src->base.input);
+    short hi = next_byte(&src->base.input);
+    if (lo >= 0 && hi >= 0) {
+        src->desc = (uint16_t) (lo | (hi << 8));
+        src->desc_bits = 16;
+    }
+}
+
+static short
+next_kosinski_flag(kosinski_src *src)
+{
+    if (src->desc_bits == 0) {
+        return EOF;
+    }
+
+    short flag = src->desc & 1;
+    src->desc >>= 1;
+    src->desc_bits -= 1;
+    if (src->desc_bits == 0) {
+        load_kosinski_flags(src);
+    }
+
+    return flag;
+}
+
+/*
+ * Reads the next command. Literals are written straight to the window,
+ * while matches only set up the copy, which is done by the caller.
+ */
+static bool
+next_kosinski_command(kosinski_src *src)
+{
+    input *input = &src->base.input;
+
+    if (!src->started) {
+        src->started = true;
+        load_kosinski_flags(src);
+    }
+
+    short flag = next_kosinski_flag(src);
+    if (flag < 0) {
+        return fail_decode(&src->base, "Kosinski data is truncated");
+    }
+
+    if (flag) {
+        short literal = next_byte(input);
+        if (literal < 0) {
+            return fail_decode(&src->base, "Kosinski data is truncated");
+        }
+        src->window[src->pos & KOSINSKI_WINDOW_MASK] =
+            (unsigned char) literal;
+        src->copy_len = 1;
+        src->copy_dist = 0;
+        return true;
+    }
+
+    flag = next_kosinski_flag(src);
+    if (flag < 0) {
+        return fail_decode(&src->base, "Kosinski data is truncated");
+    }
+
+    if (flag) {
+        short lo = next_byte(input);
+        short hi = next_byte(input);
+        if (lo < 0 || hi < 0) {
+            return fail_decode(&src->base, "Kosinski data is truncated");
+        }
+
+        src->copy_dist = KOSINSKI_WINDOW_SIZE
+            - (size_t) (((hi & 0xF8) << 5) | lo);
+        src->copy_len = hi & 0x07;
+        if (src->copy_len > 0) {
+            src->copy_len += 2;
+        }
+        else {
+            short count = next_byte(input);
+            if (count < 0) {
+                return fail_decode(&src->base,
+                    "Kosinski data is truncated");
+            }
+            else if (count == 0) {
+                src->base.finished = true;
+                return false;
+            }
+            else if (count == 1) {
+                src->copy_len = 0; /* does nothing */
+                return true;
+            }
+            src->copy_len = (size_t) count + 1;
+        }
+    }
+    else {
+        short hi = next_kosinski_flag(src);
+        short lo = next_kosinski_flag(src);
+        short offset = next_byte(input);
+        if (hi < 0 || lo < 0 || offset < 0) {
+            return fail_decode(&src->base, "Kosinski data is truncated");
+        }
+        src->copy_len = (size_t) ((hi << 1) | lo) + 2;
+        src->copy_dist = 0x100 - (size_t) offset;
+    }
+
+    if (src->copy_dist > src->pos) {
+        return fail_decode(&src->base,
+            "Kosinski data refers to data before its start");
+    }
+    return true;
+}
+
+/*
+ * Copies as much of the current match as will fit, without wrapping past
+ * the end of the window. When the match is at least as far back as it is
+ * long, the bytes being copied cannot overlap with the ones being written,
+ * so it is done as a single move. Otherwise, it repeats a short pattern,
+ * and must be done one byte at a time.
+ */
+static size_t
+copy_kosinski_match(kosinski_src *src, unsigned char *out, size_t len)
+{
+    size_t to = src->pos & KOSINSKI_WINDOW_MASK;
+    size_t count = src->copy_len < len ? src->copy_len : len;
+    if (count > KOSINSKI_WINDOW_SIZE - to) {
+        count = KOSINSKI_WINDOW_SIZE - to;
+    }
+
+    if (src->copy_dist > 0) {
+        size_t from = (src->pos - src->copy_dist) & KOSINSKI_WINDOW_MASK;
+        if (count > KOSINSKI_WINDOW_SIZE - from) {
+            count = KOSINSKI_WINDOW_SIZE - from;
+        }
+
+        if (src->copy_dist >= count) {
+            memmove(&src->window[to], &src->window[from], count);
+        }
+        else {
+            for (size_t i = 0; i < count; i++) {
+                src->window[to + i] = src->window[from + i];
+            }
+        }
+    }
+
+    memcpy(out, &src->window[to], count);
+    src->pos += count;
+    src->copy_len -= count;
+    return count;
+}
+
+static size_t
+read_kosinski_bytes(RBTK_UNUSED RBTK_IN_STREAM *in, kosinski_src *src,
+    void *buf, size_t off, size_t len)
+{
+    assert(in && src && buf);
+
+    unsigned char *out = (unsigned char *) buf + off;
+    size_t done = 0;
+    while (done < len) {
+        if (src->copy_len == 0) {
+            if (src->base.finished || !next_kosinski_command(src)) {
+                break;
+            }
+            continue;
+        }
+        done += copy_kosinski_match(src, out + done, len - done);
+    }
+
+    memset(out + done, 0x00, len - done);
+    return done;
+}
+
+static const rbtk_in_stream_funs kosinski_in_stream_funs = {
+    .close           = (rbtk_in_stream_close_fun)           close_decoder,
+    .available_bytes = (rbtk_in_stream_available_bytes_fun) RBTK_UNIMPLEMENTED,
+    .read_byte       = (rbtk_in_stream_read_byte_fun)       read_decoded_byte,
+    .read_bytes      = (rbtk_in_stream_read_bytes_fun)      read_kosinski_bytes,
+    .skip_bytes      = (rbtk_in_stream_skip_bytes_fun)      RBTK_DEFAULT_IMPL,
+    .seek_to         = (rbtk_in_stream_seek_to_fun)         RBTK_UNIMPLEMENTED
+};
+
+RBTK_NO_DISCARD RBTK_IN_STREAM *
+rbtk_open_kosinski_in_stream(RBTK_IN_STREAM *in)
+{
+    assert(in);
+
+    kosinski_src *src = NULL;
+    RBTK_MALLOC_OR_RETURN(&src, NULL,
+        "could not allocate memory for Kosinski stream");
+    RBTK_ZERO_MEMORY(src);
+
+    return open_decoder(in, kosinski_in_stream_funs, &src->base);
+}
+
+/*
+ * The code table maps a code to the nibble it stands for, and how many
+ * times to repeat it. No code is longer than eight bits, so every eight
+ * bit value that starts with a code is filled in. This way, a code is
+ * found with a single lookup of the next eight bits.
+ */
+static bool
+read_nemesis_codes(nemesis_src *src)
+{
+    input *input = &src->base.input;
+    uint8_t nibble = 0;
+
+    short next = next_byte(input);
+    while (next != NEMESIS_TABLE_END) {
+        if (next < 0) {
+            return false;
+        }
+
+        if (next & 0x80) {
+            nibble = next & 0x0F;
+            next = next_byte(input);
+            continue;
+        }
+
+        uint8_t count = (uint8_t) (((next >> 4) & 0x07) + 1);
+        uint8_t length = next & 0x0F;
+        short code = next_byte(input);
+        if (code < 0 || length == 0 || length > 8
+            || (code >> length) != 0) {
+            return false;
+        }
+
+        unsigned shift = 8 - length;
+        for (unsigned i = 0; i < (1u << shift); i++) {
+            nemesis_code *entry = &src->codes[(code << shift) | i];
+            entry->nibble = nibble;
+            entry->count = count;
+            entry->length = length;
+        }
+
+        next = next_byte(input);
+    }
+
+    return true;
+}
+
+static bool
+next_nemesis_run(nemesis_src *src)
+{
+    bit_reader *reader = &src->reader;
+    input *input = &src->base.input;
+
+    uint32_t prefix = peek_bits(reader, input, 8);
+    if ((prefix >> 2) == NEMESIS_INLINE_CODE) {
+        uint32_t inline_run;
+        skip_bits(reader, 6);
+        if (!read_bits(reader, input, 7, &inline_run)) {
+            return fail_decode(&src->base, "Nemesis data is truncated");
+        }
+        src->run_left = (uint8_t) ((inline_run >> 4) + 1);
+        src->run_nibble = inline_run & 0x0F;
+        return true;
+    }
+
+    const nemesis_code *code = &src->codes[prefix];
+    if (code->length == 0) {
+        return fail_decode(&src->base, "Nemesis data has unknown code");
+    }
+    else if (!skip_bits(reader, code->length)) {
+        return fail_decode(&src->base, "Nemesis data is truncated");
+    }
+
+    src->run_left = code->count;
+    src->run_nibble = code->nibble;
+    return true;
+}
+
+static bool
+decode_nemesis_row(decoder *dec, unsigned char *out)
+{
+    nemesis_src *src = (nemesis_src *) dec;
+    if (src->rows_left == 0) {
+        dec->finished = true;
+        return false;
+    }
+
+    uint32_t row = 0;
+    for (int i = 0; i < 8; i++) {
+        if (src->run_left == 0 && !next_nemesis_run(src)) {
+            return false;
+        }
+        row = (row << 4) | src->run_nibble;
+        src->run_left -= 1;
+    }
+
+    /* in XOR mode, each row only stores what changed from the last one */
+    if (src->xor_mode) {
+        row ^= src->prev_row;
+    }
+    src->prev_row = row;
+    src->rows_left -= 1;
+
+    out[0] = (unsigned char) (row >> 24);
+    out[1] = (unsigned char) (row >> 16);
+    out[2] = (unsigned char) (row >> 8);
+    out[3] = (unsigned char) row;
+    return true;
+}
+
+static size_t
+available_nemesis_bytes(RBTK_UNUSED RBTK_IN_STREAM *in, nemesis_src *src)
+{
+    assert(in && src);
+    decoder *dec = &src->base;
+    return src->rows_left * NEMESIS_ROW_SIZE
+        + (dec->stage_len - dec->stage_pos);
+}
+
+static size_t
+read_nemesis_bytes(RBTK_UNUSED RBTK_IN_STREAM *in, nemesis_src *src,
+    void *buf, size_t off, size_t len)
+{
+    assert(in && src && buf);
+    unsigned char *out = (unsigned char *) buf + off;
+    size_t done = decode_units(&src->base, decode_nemesis_row,
+        NEMESIS_ROW_SIZE, out, len);
+    memset(out + done, 0x00, len - done);
+    return done;
+}
+
+static const rbtk_in_stream_funs nemesis_in_stream_funs = {
+    .close           = (rbtk_in_stream_close_fun)           close_decoder,
+    .available_bytes = (rbtk_in_stream_available_bytes_fun) available_nemesis_bytes,
+    .read_byte       = (rbtk_in_stream_read_byte_fun)       read_decoded_byte,
+    .read_bytes      = (rbtk_in_stream_read_bytes_fun)      read_nemesis_bytes,
+    .skip_bytes      = (rbtk_in_stream_skip_bytes_fun)      RBTK_DEFAULT_IMPL,
+    .seek_to         = (rbtk_in_stream_seek_to_fun)         RBTK_UNIMPLEMENTED
+};
+
+RBTK_NO_DISCARD RBTK_IN_STREAM *
+rbtk_open_nemesis_in_stream(RBTK_IN_STREAM *in)
+{
+    assert(in);
+
+    nemesis_src *src = NULL;
+    RBTK_MALLOC_OR_RETURN(&src, NULL,
+        "could not allocate memory for Nemesis stream");
+    RBTK_ZERO_MEMORY(src);
+    src->base.input.in = in;
+
+    short hi = next_byte(&src->base.input);
+    short lo = next_byte(&src->base.input);
+    if (hi < 0 || lo < 0 || !read_nemesis_codes(src)) {
+        free(src);
+        rbtk_signal_error(RBTK_ERROR_IO,
+            "Nemesis header or code table is corrupt");
+        return NULL;
+    }
+
+    uint16_t header = (uint16_t) ((hi << 8) | lo);
+    src->xor_mode = (header & 0x8000) != 0;
+    src->rows_left = (size_t) (header & 0x7FFF)
+        * (NEMESIS_TILE_SIZE / NEMESIS_ROW_SIZE);
+
+    return open_decoder(in, nemesis_in_stream_funs, &src->base);
+}
+
+/*
+ * An inline value is made up of a flag bit for each flag in the mask from
+ * the header, followed by the bits of the tile index. Flags which are not
+ * in the mask are always clear.
+ */
+static bool
+read_enigma_value(enigma_src *src, uint16_t *value)
+{
+    static const unsigned flag_shifts[ENIGMA_FLAG_COUNT] = {
+        15, 14, 13, 12, 11 /* priority, palette, Y-flip, X-flip */
+    };
+
+    bit_reader *reader = &src->reader;
+    input *input = &src->base.input;
+
+    uint32_t result = 0;
+    for (int i = 0; i < ENIGMA_FLAG_COUNT; i++) {
+        uint32_t flag = 0;
+        bool present = src->flag_mask & (0x10 >> i);
+        if (present && !read_bits(reader, input, 1, &flag)) {
+            return false;
+        }
+        result |= flag << flag_shifts[i];
+    }
+
+    uint32_t index = 0;
+    if (src->packet_bits > 0
+        && !read_bits(reader, input, src->packet_bits, &index)) {
+        return false;
+    }
+
+    *value = (uint16_t) (result | index);
+    return true;
+}
+
+static bool
+next_enigma_run(enigma_src *src)
+{
+    bit_reader *reader = &src->reader;
+    input *input = &src->base.input;
+
+    uint32_t mode, count;
+    if (!read_bits(reader, input, 1, &mode)) {
+        return fail_decode(&src->base, "Enigma data is truncated");
+    }
+
+    if (mode == 0) {
+        if (!read_bits(reader, input, 1, &mode)
+            || !read_bits(reader, input, 4, &count)) {
+            return fail_decode(&src->base, "Enigma data is truncated");
+        }
+        src->mode = mode ? ENIGMA_COPY_COMMON : ENIGMA_COPY_INCREMENT;
+        src->run_left = count + 1;
+        return true;
+    }
+
+    if (!read_bits(reader, input, 2, &mode)
+        || !read_bits(reader, input, 4, &count)) {
+        return fail_decode(&src->base, "Enigma data is truncated");
+    }
+
+    src->mode = ENIGMA_INLINE_REPEAT + mode;
+    if (src->mode == ENIGMA_INLINE_EACH && count == 0x0F) {
+        src->base.finished = true;
+        return false;
+    }
+
+    src->run_left = count + 1;
+    if (src->mode != ENIGMA_INLINE_EACH
+        && !read_enigma_value(src, &src->value)) {
+        return fail_decode(&src->base, "Enigma data is truncated");
+    }
+    return true;
+}
+
+static bool
+decode_enigma_word(decoder *dec, unsigned char *out)
+{
+    enigma_src *src = (enigma_src *) dec;
+    if (src->run_left == 0 && !next_enigma_run(src)) {
+        return false;
+    }
+
+    uint16_t word = 0;
+    switch (src->mode) {
+    case ENIGMA_COPY_INCREMENT:
+        word = src->increment++;
+        break;
+    case ENIGMA_COPY_COMMON:
+        word = src->common;
+        break;
+    case ENIGMA_INLINE_REPEAT:
+        word = src->value;
+        break;
+    case ENIGMA_INLINE_INCREMENT:
+        word = src->value++;
+        break;
+    case ENIGMA_INLINE_DECREMENT:
+        word = src->value--;
+        break;
+    case ENIGMA_INLINE_EACH:
+        if (!read_enigma_value(src, &word)) {
+            return fail_decode(dec, "Enigma data is truncated");
+        }
+        break;
+    }
+    src->run_left -= 1;
+
+    out[0] = (unsigned char) (word >> 8);
+    out[1] = (unsigned char) word;
+    return true;
+}
+
+static size_t
+read_enigma_bytes(RBTK_UNUSED RBTK_IN_STREAM *in, enigma_src *src,
+    void *buf, size_t off, size_t len)
+{
+    assert(in && src && buf);
+    unsigned char *out = (unsigned char *) buf + off;
+    size_t done = decode_units(&src->base, decode_enigma_word,
+        sizeof(uint16_t), out, len);
+    memset(out + done, 0x00, len - done);
+    return done;
+}
+
+static const rbtk_in_stream_funs enigma_in_stream_funs = {
+    .close           = (rbtk_in_stream_close_fun)           close_decoder,
+    .available_bytes = (rbtk_in_stream_available_bytes_fun) RBTK_UNIMPLEMENTED,
+    .read_byte       = (rbtk_in_stream_read_byte_fun)       read_decoded_byte,
+    .read_bytes      = (rbtk_in_stream_read_bytes_fun)      read_enigma_bytes,
+    .skip_bytes      = (rbtk_in_stream_skip_bytes_fun)      RBTK_DEFAULT_IMPL,
+    .seek_to         = (rbtk_in_stream_seek_to_fun)         RBTK_UNIMPLEMENTED
+};
+
+RBTK_NO_DISCARD RBTK_IN_STREAM *
+rbtk_open_enigma_in_stream(RBTK_IN_STREAM *in)
+{
+    assert(in);
+
+    enigma_src *src = NULL;
+    RBTK_MALLOC_OR_RETURN(&src, NULL,
+        "could not allocate memory for Enigma stream");
+    RBTK_ZERO_MEMORY(src);
+    src->base.input.in = in;
+
+    short header[6];
+    for (int i = 0; i < 6; i++) {
+        header[i] = next_byte(&src->base.input);
+        if (header[i] < 0) {
+            free(src);
+            rbtk_signal_error(RBTK_ERROR_IO, "Enigma header is truncated");
+            return NULL;
+        }
+    }
+
+    if (header[0] > 11 || header[1] > 0x1F) {
+        free(src);
+        rbtk_signal_error(RBTK_ERROR_IO, "Enigma header is corrupt");
+        return NULL;
+    }
+
+    src->packet_bits = (unsigned) header[0];
+    src->flag_mask = (uint8_t) header[1];
+    src->increment = (uint16_t) ((header[2] << 8) | header[3]);
+    src->common = (uint16_t) ((header[4] << 8) | header[5]);
+
+    return open_decoder(in, enigma_in_stream_funs, &src->base);
+}
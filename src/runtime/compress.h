@@ -0,0 +1,141 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_COMPRESS_H_
+#define RBTK_COMPRESS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+ * @file
+ * @brief The public API for the program's compression module.
+ */
+
+#include "common.h"
+#include "stream.h"
+
+/*!
+ * @defgroup compress Compressed Streams
+ *
+ * @brief The program's compression module.
+ *
+ * The original games stored most of their data compressed, using formats
+ * made for the hardware of the time. This module provides input streams
+ * which decompress this data as it is read, so that level data can be
+ * loaded straight from the same compact files.
+ *
+ * Each stream wraps another input stream, which the compressed data is
+ * read from. Data is read from the wrapped stream in large blocks, and is
+ * only decompressed as far as the caller reads. When a decompressing
+ * stream is closed, the stream it wraps is closed as well.
+ *
+ * The supported formats are:
+ * - Kosinski, an LZ77 format used for chunks, blocks and other level data.
+ * - Nemesis, an entropy coded format used for tile art.
+ * - Enigma, a run-length format used for tile maps.
+ *
+ * Corrupt or truncated data is reported with #RBTK_ERROR_IO, after which
+ * the stream acts as if it has ended.
+ *
+ * @see rbtk_open_kosinski_in_stream(RBTK_IN_STREAM *)
+ * @see rbtk_open_nemesis_in_stream(RBTK_IN_STREAM *)
+ * @see rbtk_open_enigma_in_stream(RBTK_IN_STREAM *)
+ *
+ * @{
+ */
+
+/*!
+ * @brief Opens an input stream which decompresses Kosinski data.
+ *
+ * @param[in] in The stream to read compressed data from. This stream is
+ *               closed when the returned stream is closed.
+ * @return The opened stream or `NULL` on error.
+ *
+ * @pointer_lifetime The returned stream owns @p in, which must not be
+ *                   read from or closed by the caller.
+ * @debugging This function asserts that @p in is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
+ * @enderrors
+ *
+ * @see rbtk_close_in_stream(RBTK_IN_STREAM *)
+ */
+RBTK_NO_DISCARD RBTK_IN_STREAM *
+rbtk_open_kosinski_in_stream(RBTK_IN_STREAM *in);
+
+/*!
+ * @brief Opens an input stream which decompresses Nemesis data.
+ *
+ * Nemesis data is made up of 8x8 tiles, with four bits for each pixel.
+ * The number of tiles is known from the start, so the returned stream
+ * supports #rbtk_available_bytes(RBTK_IN_STREAM *).
+ *
+ * @param[in] in The stream to read compressed data from. This stream is
+ *               closed when the returned stream is closed.
+ * @return The opened stream or `NULL` on error.
+ *
+ * @pointer_lifetime The returned stream owns @p in, which must not be
+ *                   read from or closed by the caller.
+ * @debugging This function asserts that @p in is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO, If the header or code table is corrupt.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
+ * @enderrors
+ *
+ * @see rbtk_close_in_stream(RBTK_IN_STREAM *)
+ */
+RBTK_NO_DISCARD RBTK_IN_STREAM *
+rbtk_open_nemesis_in_stream(RBTK_IN_STREAM *in);
+
+/*!
+ * @brief Opens an input stream which decompresses Enigma data.
+ *
+ * Enigma data is a tile map, where each entry is a big-endian 16-bit word.
+ * The returned stream outputs these words as they were, two bytes each.
+ *
+ * @param[in] in The stream to read compressed data from. This stream is
+ *               closed when the returned stream is closed.
+ * @return The opened stream or `NULL` on error.
+ *
+ * @pointer_lifetime The returned stream owns @p in, which must not be
+ *                   read from or closed by the caller.
+ * @debugging This function asserts that @p in is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO, If the header is corrupt.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
+ * @enderrors
+ *
+ * @see rbtk_close_in_stream(RBTK_IN_STREAM *)
+ */
+RBTK_NO_DISCARD RBTK_IN_STREAM *
+rbtk_open_enigma_in_stream(RBTK_IN_STREAM *in);
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_COMPRESS_H_ */
@@ -23,10 +23,15 @@
  */
 #if defined(__linux__)
 
+#define _GNU_SOURCE /* for pthread_timedjoin_np() */
+
 #include "thread.h"
 
+#include <errno.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 
 #define _MULTI_THREADED
 #include <pthread.h>
@@ -37,6 +42,11 @@ typedef struct PLAT_RBTK_THREAD {
     pthread_t handle;
 } PLAT_RBTK_THREAD;
 
+typedef struct PLAT_RBTK_LOCK {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} PLAT_RBTK_LOCK;
+
 static __thread RBTK_THREAD *thread_tls;
 static PLAT_RBTK_THREAD plat_main_thread;
 static bool initialized;
@@ -47,9 +57,12 @@ start_thread(void *params) {
 
     thread_tls = thread;
 
-    thread->running = true;
+    /*
+     * The thread may be destroyed as soon as the entrypoint returns, so it
+     * must not be touched afterwards. Joining the thread is what marks it
+     * as no longer running.
+     */
     thread->entrypoint(thread->params);
-    thread->running = false;
 
     return NULL;
 }
@@ -114,9 +127,15 @@ plat_rbtk_destroy_thread(RBTK_THREAD *thread)
 {
     PLAT_RBTK_THREAD *plat = thread->plat;
     if (thread->running) {
+        /* detach as well, or the thread is never cleaned up */
         pthread_cancel(plat->handle);
+        pthread_detach(plat->handle);
         thread->running = false;
     }
+    if (plat != &plat_main_thread) {
+        free(plat);
+        thread->plat = NULL;
+    }
     return true;
 }
 
@@ -184,6 +203,46 @@ plat_rbtk_stop_thread(RBTK_THREAD *thread)
             "failed to terminate POSIX thread");
         return false;
     }
+    pthread_detach(plat->handle);
+    thread->running = false;
+    return true;
+}
+
+RBTK_PLATFORM bool
+plat_rbtk_join_thread(RBTK_THREAD *thread)
+{
+    assert(thread);
+    PLAT_RBTK_THREAD *plat = thread->plat;
+    if (pthread_join(plat->handle, NULL)) {
+        rbtk_signal_error(RBTK_ERROR_PLATFORM,
+            "failed to join POSIX thread");
+        return false;
+    }
+    thread->running = false;
+    return true;
+}
+
+RBTK_PLATFORM bool
+plat_rbtk_join_thread_within(RBTK_THREAD *thread, long double millis)
+{
+    assert(thread);
+    PLAT_RBTK_THREAD *plat = thread->plat;
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    long long nanos = deadline.tv_nsec + (long long) (millis * 1000000.0L);
+    deadline.tv_sec += (time_t) (nanos / 1000000000LL);
+    deadline.tv_nsec = (long) (nanos % 1000000000LL);
+
+    int result = pthread_timedjoin_np(plat->handle, NULL, &deadline);
+    if (result == ETIMEDOUT) {
+        return false;
+    }
+    else if (result) {
+        rbtk_signal_error(RBTK_ERROR_PLATFORM,
+            "failed to join POSIX thread");
+        return false;
+    }
     thread->running = false;
     return true;
 }
@@ -223,5 +282,98 @@ plat_rbtk_get_thread_storage(RBTK_THREAD_STORAGE_KEY *key)
     return NULL;
 }
 
-#endif
+RBTK_PLATFORM RBTK_NO_DISCARD size_t
+plat_rbtk_get_processor_count(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (size_t) count : 1;
+}
 
+RBTK_PLATFORM RBTK_NO_DISCARD bool
+plat_rbtk_create_lock(RBTK_LOCK *lock)
+{
+    assert(lock);
+
+    PLAT_RBTK_LOCK *plat = NULL;
+    RBTK_MALLOC_OR_RETURN(&plat, false,
+        "failed to allocate memory for POSIX lock");
+
+    if (pthread_mutex_init(&plat->mutex, NULL)) {
+        free(plat);
+        rbtk_signal_error(RBTK_ERROR_PLATFORM,
+            "failed to create POSIX mutex");
+        return false;
+    }
+
+    if (pthread_cond_init(&plat->cond, NULL)) {
+        pthread_mutex_destroy(&plat->mutex);
+        free(plat);
+        rbtk_signal_error(RBTK_ERROR_PLATFORM,
+            "failed to create POSIX condition variable");
+        return false;
+    }
+
+    lock->plat = plat;
+    return true;
+}
+
+RBTK_PLATFORM void
+plat_rbtk_destroy_lock(RBTK_LOCK *lock)
+{
+    assert(lock);
+    PLAT_RBTK_LOCK *plat = lock->plat;
+    pthread_cond_destroy(&plat->cond);
+    pthread_mutex_destroy(&plat->mutex);
+    free(plat);
+}
+
+RBTK_PLATFORM void
+plat_rbtk_acquire_lock(RBTK_LOCK *lock)
+{
+    assert(lock);
+    pthread_mutex_lock(&lock->plat->mutex);
+}
+
+RBTK_PLATFORM void
+plat_rbtk_release_lock(RBTK_LOCK *lock)
+{
+    assert(lock);
+    pthread_mutex_unlock(&lock->plat->mutex);
+}
+
+RBTK_PLATFORM void
+plat_rbtk_await_lock(RBTK_LOCK *lock)
+{
+    assert(lock);
+    PLAT_RBTK_LOCK *plat = lock->plat;
+    pthread_cond_wait(&plat->cond, &plat->mutex);
+}
+
+RBTK_PLATFORM void
+plat_rbtk_notify_lock(RBTK_LOCK *lock, bool all)
+{
+    assert(lock);
+    PLAT_RBTK_LOCK *plat = lock->plat;
+    if (all) {
+        pthread_cond_broadcast(&plat->cond);
+    }
+    else {
+        pthread_cond_signal(&plat->cond);
+    }
+}
+
+RBTK_PLATFORM RBTK_NO_DISCARD size_t
+plat_rbtk_atomic_load(const volatile size_t *ptr)
+{
+    assert(ptr);
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+RBTK_PLATFORM void
+plat_rbtk_atomic_store(volatile size_t *ptr, size_t value)
+{
+    assert(ptr);
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+#endif
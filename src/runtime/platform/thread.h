@@ -68,6 +68,12 @@ plat_rbtk_start_thread(RBTK_THREAD *thread);
 RBTK_PLATFORM RBTK_NO_DISCARD bool
 plat_rbtk_stop_thread(RBTK_THREAD *thread);
 
+RBTK_PLATFORM bool
+plat_rbtk_join_thread(RBTK_THREAD *thread);
+
+RBTK_PLATFORM bool
+plat_rbtk_join_thread_within(RBTK_THREAD *thread, long double millis);
+
 RBTK_PLATFORM RBTK_NO_DISCARD bool
 plat_rbtk_create_thread_storage(RBTK_THREAD_STORAGE_KEY *key);
 
@@ -80,6 +86,33 @@ plat_rbtk_get_thread_storage(RBTK_THREAD_STORAGE_KEY *key);
 RBTK_PLATFORM void
 plat_rbtk_yield_thread(RBTK_THREAD *thread);
 
+RBTK_PLATFORM RBTK_NO_DISCARD size_t
+plat_rbtk_get_processor_count(void);
+
+RBTK_PLATFORM RBTK_NO_DISCARD bool
+plat_rbtk_create_lock(RBTK_LOCK *lock);
+
+RBTK_PLATFORM void
+plat_rbtk_destroy_lock(RBTK_LOCK *lock);
+
+RBTK_PLATFORM void
+plat_rbtk_acquire_lock(RBTK_LOCK *lock);
+
+RBTK_PLATFORM void
+plat_rbtk_release_lock(RBTK_LOCK *lock);
+
+RBTK_PLATFORM void
+plat_rbtk_await_lock(RBTK_LOCK *lock);
+
+RBTK_PLATFORM void
+plat_rbtk_notify_lock(RBTK_LOCK *lock, bool all);
+
+RBTK_PLATFORM RBTK_NO_DISCARD size_t
+plat_rbtk_atomic_load(const volatile size_t *ptr);
+
+RBTK_PLATFORM void
+plat_rbtk_atomic_store(volatile size_t *ptr, size_t value);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
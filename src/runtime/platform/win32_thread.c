@@ -43,6 +43,11 @@ typedef struct PLAT_RBTK_THREAD {
     HANDLE handle;
 } PLAT_RBTK_THREAD;
 
+typedef struct PLAT_RBTK_LOCK {
+    CRITICAL_SECTION section;
+    CONDITION_VARIABLE cond;
+} PLAT_RBTK_LOCK;
+
 struct storage_block {
     void *data;
     struct storage_block *next;
@@ -63,9 +68,12 @@ start_thread(LPVOID params) {
 
     TlsSetValue(thread_tls_index, thread);
 
-    thread->running = true;
+    /*
+     * The thread may be destroyed as soon as the entrypoint returns, so it
+     * must not be touched afterwards. Joining the thread is what marks it
+     * as no longer running.
+     */
     thread->entrypoint(thread->params);
-    thread->running = false;
 
     return EXIT_SUCCESS;
 }
@@ -154,6 +162,13 @@ plat_rbtk_destroy_thread(RBTK_THREAD *thread)
         TerminateThread(plat->handle, 0);
         thread->running = false;
     }
+    if (plat != &plat_main_thread) {
+        if (plat->handle) {
+            CloseHandle(plat->handle);
+        }
+        free(plat);
+        thread->plat = NULL;
+    }
     return true;
 }
 
@@ -226,6 +241,33 @@ plat_rbtk_stop_thread(RBTK_THREAD *thread)
     return true;
 }
 
+RBTK_PLATFORM bool
+plat_rbtk_join_thread(RBTK_THREAD *thread)
+{
+    assert(thread);
+    return plat_rbtk_join_thread_within(thread, INFINITE);
+}
+
+RBTK_PLATFORM bool
+plat_rbtk_join_thread_within(RBTK_THREAD *thread, long double millis)
+{
+    assert(thread);
+    PLAT_RBTK_THREAD *plat = thread->plat;
+
+    DWORD wait_ms = millis >= INFINITE ? INFINITE : (DWORD) millis;
+    DWORD result = WaitForSingleObject(plat->handle, wait_ms);
+    if (result == WAIT_TIMEOUT) {
+        return false;
+    }
+    else if (result != WAIT_OBJECT_0) {
+        rbtk_signal_error(RBTK_ERROR_PLATFORM,
+            "failed to join Win32 thread");
+        return false;
+    }
+    thread->running = false;
+    return true;
+}
+
 void
 plat_rbtk_yield_thread(RBTK_UNUSED RBTK_THREAD *thread)
 {
@@ -323,4 +365,89 @@ plat_rbtk_get_thread_storage(RBTK_THREAD_STORAGE_KEY *key)
     return tls_storage;
 }
 
+RBTK_PLATFORM RBTK_NO_DISCARD size_t
+plat_rbtk_get_processor_count(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+}
+
+RBTK_PLATFORM RBTK_NO_DISCARD bool
+plat_rbtk_create_lock(RBTK_LOCK *lock)
+{
+    assert(lock);
+
+    PLAT_RBTK_LOCK *plat = NULL;
+    RBTK_MALLOC_OR_RETURN(&plat, false,
+        "failed to allocate memory for Win32 lock");
+
+    InitializeCriticalSection(&plat->section);
+    InitializeConditionVariable(&plat->cond);
+
+    lock->plat = plat;
+    return true;
+}
+
+RBTK_PLATFORM void
+plat_rbtk_destroy_lock(RBTK_LOCK *lock)
+{
+    assert(lock);
+    PLAT_RBTK_LOCK *plat = lock->plat;
+    DeleteCriticalSection(&plat->section);
+    free(plat);
+}
+
+RBTK_PLATFORM void
+plat_rbtk_acquire_lock(RBTK_LOCK *lock)
+{
+    assert(lock);
+    EnterCriticalSection(&lock->plat->section);
+}
+
+RBTK_PLATFORM void
+plat_rbtk_release_lock(RBTK_LOCK *lock)
+{
+    assert(lock);
+    LeaveCriticalSection(&lock->plat->section);
+}
+
+RBTK_PLATFORM void
+plat_rbtk_await_lock(RBTK_LOCK *lock)
+{
+    assert(lock);
+    PLAT_RBTK_LOCK *plat = lock->plat;
+    SleepConditionVariableCS(&plat->cond, &plat->section, INFINITE);
+}
+
+RBTK_PLATFORM void
+plat_rbtk_notify_lock(RBTK_LOCK *lock, bool all)
+{
+    assert(lock);
+    PLAT_RBTK_LOCK *plat = lock->plat;
+    if (all) {
+        WakeAllConditionVariable(&plat->cond);
+    }
+    else {
+        WakeConditionVariable(&plat->cond);
+    }
+}
+
+RBTK_PLATFORM RBTK_NO_DISCARD size_t
+plat_rbtk_atomic_load(const volatile size_t *ptr)
+{
+    assert(ptr);
+    size_t value = *ptr;
+    MemoryBarrier();
+    return value;
+}
+
+RBTK_PLATFORM void
+plat_rbtk_atomic_store(volatile size_t *ptr, size_t value)
+{
+    assert(ptr);
+    MemoryBarrier();
+    *ptr = value;
+}
+
 #endif /* defined(_WIN32) */
@@ -62,6 +62,40 @@ typedef struct RBTK_THREAD_STORAGE_KEY {
     RBTK_THREAD_STORAGE_KEY *next;
 } RBTK_THREAD_STORAGE_KEY;
 
+RBTK_PLATFORM RBTK_FORWARD_DECLARATION
+typedef struct PLAT_RBTK_LOCK PLAT_RBTK_LOCK;
+
+RBTK_PRIVATE
+typedef struct RBTK_LOCK {
+    PLAT_RBTK_LOCK *plat;
+} RBTK_LOCK;
+
+RBTK_PRIVATE
+typedef struct RBTK_JOB {
+    RBTK_THREAD_POOL *pool;
+    rbtk_thread_entrypoint func;
+    void *args;
+    bool done;
+    RBTK_JOB *queue_next;
+    RBTK_JOB *prev;
+    RBTK_JOB *next;
+} RBTK_JOB;
+
+RBTK_PRIVATE
+typedef struct RBTK_THREAD_POOL {
+    RBTK_LOCK *lock;
+    size_t num_workers;
+    size_t live_workers;
+    RBTK_THREAD *workers[RBTK_MAX_THREAD_POOL_SIZE];
+    bool shutdown;
+    RBTK_JOB *queue_head;
+    RBTK_JOB *queue_tail;
+    RBTK_JOB *jobs_head;
+    RBTK_JOB *jobs_tail;
+    RBTK_THREAD_POOL *prev;
+    RBTK_THREAD_POOL *next;
+} RBTK_THREAD_POOL;
+
 RBTK_PRIVATE RBTK_NO_DISCARD bool
 priv_rbtk_thread_init(void);
 
@@ -27,6 +27,7 @@
 
 #include "./private/asset.h"
 #include "./private/error.h"
+#include "./private/stats.h"
 #include "./private/thread.h"
 
 static bool initialized;
@@ -45,6 +46,10 @@ rbtk_init_runtime(void)
         fprintf(stderr, "Failed to initialize thread module.\n");
         rbtk_abort_if_error();
     }
+    if (!priv_rbtk_stats_init()) {
+        fprintf(stderr, "Failed to initialize stats module.\n");
+        rbtk_abort_if_error();
+    }
     if (!priv_rbtk_asset_init()) {
         fprintf(stderr, "Failed to initialize asset module.\n");
         rbtk_abort_if_error();
@@ -61,6 +66,10 @@ rbtk_terminate_runtime(void)
         fprintf(stderr, "Failed to terminate asset module.\n");
         rbtk_abort_if_error();
     }
+    if (!priv_rbtk_stats_terminate()) {
+        fprintf(stderr, "Failed to terminate stats module.\n");
+        rbtk_abort_if_error();
+    }
     if (!priv_rbtk_thread_terminate()) {
         fprintf(stderr, "Failed to terminate thread module.\n");
         rbtk_abort_if_error();
@@ -38,6 +38,7 @@ extern "C" {
 #include "asset.h"
 #include "common.h"
 #include "error.h"
+#include "stats.h"
 #include "thread.h"
 
 /*!
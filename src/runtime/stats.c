@@ -0,0 +1,303 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "stats.h"
+#include "./private/stats.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "error.h"
+#include "thread.h"
+
+#define REQUIRE_INITIALIZED_OR_RETURN(_value)       \
+    if (!initialized) {                             \
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE, \
+            "stats module not initialized");        \
+        return (_value);                            \
+    }
+
+static RBTK_STAT *stats[RBTK_MAX_STATS];
+static size_t num_stats;
+static RBTK_LOCK *stats_lock;
+static bool initialized;
+
+RBTK_NO_DISCARD bool
+priv_rbtk_stats_init(void)
+{
+    if (initialized) {
+        return true;
+    }
+
+    stats_lock = rbtk_create_lock();
+    if (!stats_lock) {
+        return false;
+    }
+
+    num_stats = 0;
+
+    initialized = true;
+    return true;
+}
+
+RBTK_NO_DISCARD bool
+priv_rbtk_stats_terminate(void)
+{
+    if (!initialized) {
+        return true;
+    }
+
+    for (size_t i = 0; i < num_stats; i++) {
+        free(stats[i]);
+        stats[i] = NULL;
+    }
+    num_stats = 0;
+
+    rbtk_destroy_lock(stats_lock);
+    stats_lock = NULL;
+
+    initialized = false;
+    return true;
+}
+
+RBTK_NO_DISCARD RBTK_STAT *
+rbtk_get_stat(const char *name, rbtk_stat_type type)
+{
+    assert(name);
+    REQUIRE_INITIALIZED_OR_RETURN(NULL);
+
+    rbtk_acquire_lock(stats_lock);
+
+    for (size_t i = 0; i < num_stats; i++) {
+        RBTK_STAT *stat = stats[i];
+        if (!strncmp(stat->name, name, RBTK_STAT_NAME_MAX_LENGTH - 1)) {
+            assert(stat->type == type);
+            rbtk_release_lock(stats_lock);
+            return stat;
+        }
+    }
+
+    if (num_stats >= RBTK_MAX_STATS) {
+        rbtk_release_lock(stats_lock);
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE,
+            "maximum number of stats registered");
+        return NULL;
+    }
+
+    RBTK_STAT *stat = calloc(1, sizeof(*stat));
+    if (!stat) {
+        rbtk_release_lock(stats_lock);
+        rbtk_signal_error(RBTK_ERROR_OUT_OF_MEMORY,
+            "failed to allocate memory for stat");
+        return NULL;
+    }
+
+    strncpy(stat->name, name, RBTK_STAT_NAME_MAX_LENGTH);
+    stat->name[RBTK_STAT_NAME_MAX_LENGTH - 1] = '\0';
+    stat->type = type;
+
+    stats[num_stats++] = stat;
+    rbtk_release_lock(stats_lock);
+    return stat;
+}
+
+RBTK_NO_DISCARD RBTK_STATS
+rbtk_get_stats(size_t *count)
+{
+    assert(count);
+    if (!initialized) {
+        *count = 0;
+        return stats;
+    }
+
+    /* stats may be registered from another thread at the same time */
+    rbtk_acquire_lock(stats_lock);
+    *count = num_stats;
+    rbtk_release_lock(stats_lock);
+    return stats;
+}
+
+RBTK_NO_DISCARD const char *
+rbtk_get_stat_name(const RBTK_STAT *stat)
+{
+    assert(stat);
+    return stat->name;
+}
+
+RBTK_NO_DISCARD rbtk_stat_type
+rbtk_get_stat_type(const RBTK_STAT *stat)
+{
+    assert(stat);
+    return stat->type;
+}
+
+static void
+update_stat(RBTK_STAT *stat, long double value)
+{
+    rbtk_acquire_lock(stats_lock);
+
+    if (stat->count == 0 || value > stat->max) {
+        stat->max = value;
+    }
+    stat->total += value;
+    stat->count += 1;
+
+    /*
+     * For counters, it is the running total which is of interest. That
+     * is what gets stored as the value. For everything else, it is the
+     * value which was given most recently.
+     */
+    if (stat->type == RBTK_STAT_TYPE_COUNTER) {
+        stat->value = stat->total;
+    }
+    else {
+        stat->value = value;
+    }
+
+    stat->history[stat->history_pos] = value;
+    stat->history_pos = (stat->history_pos + 1) % RBTK_STAT_HISTORY_LENGTH;
+    if (stat->history_len < RBTK_STAT_HISTORY_LENGTH) {
+        stat->history_len += 1;
+    }
+
+    rbtk_release_lock(stats_lock);
+}
+
+void
+rbtk_count_stat(RBTK_STAT *stat, long double amount)
+{
+    assert(stat);
+    assert(stat->type == RBTK_STAT_TYPE_COUNTER);
+    update_stat(stat, amount);
+}
+
+void
+rbtk_set_stat(RBTK_STAT *stat, long double value)
+{
+    assert(stat);
+    assert(stat->type == RBTK_STAT_TYPE_GAUGE);
+    update_stat(stat, value);
+}
+
+void
+rbtk_sample_stat(RBTK_STAT *stat, long double sample)
+{
+    assert(stat);
+    assert(stat->type == RBTK_STAT_TYPE_SAMPLE);
+    update_stat(stat, sample);
+}
+
+RBTK_NO_DISCARD long double
+rbtk_get_stat_value(RBTK_STAT *stat)
+{
+    assert(stat);
+    rbtk_acquire_lock(stats_lock);
+    long double value = stat->value;
+    rbtk_release_lock(stats_lock);
+    return value;
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_get_stat_count(RBTK_STAT *stat)
+{
+    assert(stat);
+    rbtk_acquire_lock(stats_lock);
+    size_t count = stat->count;
+    rbtk_release_lock(stats_lock);
+    return count;
+}
+
+RBTK_NO_DISCARD long double
+rbtk_get_stat_mean(RBTK_STAT *stat)
+{
+    assert(stat);
+    rbtk_acquire_lock(stats_lock);
+    long double mean = 0.0L;
+    if (stat->count > 0) {
+        mean = stat->total / stat->count;
+    }
+    rbtk_release_lock(stats_lock);
+    return mean;
+}
+
+RBTK_NO_DISCARD long double
+rbtk_get_stat_max(RBTK_STAT *stat)
+{
+    assert(stat);
+    rbtk_acquire_lock(stats_lock);
+    long double max = stat->max;
+    rbtk_release_lock(stats_lock);
+    return max;
+}
+
+static int
+compare_history(const void *a, const void *b)
+{
+    long double lhs = *(const long double *) a;
+    long double rhs = *(const long double *) b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+RBTK_NO_DISCARD long double
+rbtk_get_stat_percentile(RBTK_STAT *stat, long double percentile)
+{
+    assert(stat);
+    assert(percentile >= 0.0L && percentile <= 100.0L);
+
+    long double sorted[RBTK_STAT_HISTORY_LENGTH];
+
+    rbtk_acquire_lock(stats_lock);
+    size_t len = stat->history_len;
+    memcpy(sorted, stat->history, len * sizeof(*sorted));
+    rbtk_release_lock(stats_lock);
+
+    if (len == 0) {
+        return 0.0L;
+    }
+
+    /*
+     * Sorting a copy of the history each time is not cheap. However, the
+     * history is small, and percentiles are usually only wanted every so
+     * often (e.g., when displaying or dumping stats).
+     */
+    qsort(sorted, len, sizeof(*sorted), compare_history);
+    size_t index = (size_t) (percentile / 100.0L * (len - 1) + 0.5L);
+    return sorted[index];
+}
+
+void
+rbtk_reset_stat(RBTK_STAT *stat)
+{
+    assert(stat);
+    rbtk_acquire_lock(stats_lock);
+    stat->value = 0.0L;
+    stat->total = 0.0L;
+    stat->max = 0.0L;
+    stat->count = 0;
+    stat->history_len = 0;
+    stat->history_pos = 0;
+    rbtk_release_lock(stats_lock);
+}
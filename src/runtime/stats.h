@@ -0,0 +1,292 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RBTK_STATS_H_
+#define RBTK_STATS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+ * @file
+ * @brief The public API for the program's stats module.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "common.h"
+
+/*!
+ * @defgroup stats Statistics
+ *
+ * @brief The program's stats module.
+ * @pre   Initialize the stats module.
+ * @post  Terminate the stats module.
+ *
+ * This module keeps track of named measurements taken while the program
+ * runs, such as how long a task took or how many times something happened.
+ * Other modules register their stats here so they can be inspected in one
+ * place (e.g., by a debug overlay) without knowing where they came from.
+ *
+ * All functions in this module are safe to call from any thread.
+ *
+ * @see rbtk_get_stat(const char *, rbtk_stat_type)
+ *
+ * @{
+ */
+
+/*!
+ * @brief The maximum length of a stat name in bytes, including the `NULL`
+ *        terminator.
+ *
+ * @note This length is arbitrary. Feel free to increase this value if need
+ * be. However, ensure it is a power of two (e.g., `64` or `128`).
+ */
+#define RBTK_STAT_NAME_MAX_LENGTH 64
+
+/*!
+ * @brief The maximum number of stats which can be registered.
+ *
+ * @note This limit is arbitrary. Feel free to increase this value if need
+ * be. However, ensure it is a power of two (e.g., `64` or `128`).
+ */
+#define RBTK_MAX_STATS 128
+
+/*!
+ * @brief The number of recent samples kept by a stat for percentiles.
+ *
+ * @note This limit is arbitrary. Feel free to increase this value if need
+ * be. However, ensure it is a power of two (e.g., `64` or `128`).
+ */
+#define RBTK_STAT_HISTORY_LENGTH 256
+
+/*!
+ * @brief A named measurement.
+ *
+ * @see rbtk_get_stat(const char *, rbtk_stat_type)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_STAT RBTK_STAT;
+
+/*!
+ * @brief An array of stats.
+ *
+ * @see rbtk_get_stats(size_t *)
+ */
+typedef RBTK_STAT *const * RBTK_STATS;
+
+/*!
+ * @brief Describes how a stat is measured.
+ */
+typedef enum rbtk_stat_type {
+    RBTK_STAT_TYPE_COUNTER, /*!< A running total, such as an event count. */
+    RBTK_STAT_TYPE_GAUGE,   /*!< A value which is set, such as a level.   */
+    RBTK_STAT_TYPE_SAMPLE,  /*!< A series of samples, such as timings.    */
+} rbtk_stat_type;
+
+/*!
+ * @brief Gets a stat, registering it if it does not exist.
+ *
+ * Looking up a stat by name is not free. Callers which update a stat often
+ * should get it once and keep the returned pointer around.
+ *
+ * A stat which fails to register should not be treated as fatal by the
+ * caller. Rather, the stat should simply go unrecorded. This way, running
+ * out of stats never stops a module from working.
+ *
+ * @param[in] name The name of the stat. By convention, this is prefixed by
+ *                 the name of the module it belongs to (e.g., `"audio."`).
+ *                 Any name which exceeds the maximum length is cut off.
+ * @param[in] type How the stat is measured.
+ * @return The stat, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until the stats module is
+ * terminated. It is an unchecked runtime error to free it.
+ *
+ * @debugging This function asserts that `name` is not `NULL` and that if
+ * the stat already exists, it was registered with the same type.
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE, If the stats module is not initialized;
+ *                                <br>If the maximum number of stats have
+ *                                    already been registered.}
+ * @enderrors
+ */
+RBTK_NO_DISCARD RBTK_STAT *
+rbtk_get_stat(const char *name, rbtk_stat_type type);
+
+/*!
+ * @brief Returns all registered stats.
+ *
+ * @param[out] count Where to write the number of stats.
+ * @return The registered stats, in the order they were registered.
+ *
+ * @pointer_lifetime The returned pointer is valid until the stats module is
+ * terminated. It is an unchecked runtime error to free it.
+ *
+ * @debugging This function asserts that `count` is not `NULL`.
+ */
+RBTK_NO_DISCARD RBTK_STATS
+rbtk_get_stats(size_t *count);
+
+/*!
+ * @brief Returns the name of a stat.
+ *
+ * @param[in] stat The stat to query.
+ * @return The stat name.
+ *
+ * @pointer_lifetime The contents of the returned pointer are managed by
+ * the stats module. It is an unchecked runtime error to free it.
+ *
+ * @debugging This function asserts that `stat` is not `NULL`.
+ */
+RBTK_NO_DISCARD const char *
+rbtk_get_stat_name(const RBTK_STAT *stat);
+
+/*!
+ * @brief Returns how a stat is measured.
+ *
+ * @param[in] stat The stat to query.
+ * @return The stat type.
+ *
+ * @debugging This function asserts that `stat` is not `NULL`.
+ */
+RBTK_NO_DISCARD rbtk_stat_type
+rbtk_get_stat_type(const RBTK_STAT *stat);
+
+/*!
+ * @brief Adds to the total of a counter.
+ *
+ * @param[in] stat   The stat to update.
+ * @param[in] amount The amount to add.
+ *
+ * @debugging This function asserts that `stat` is not `NULL` and that it
+ * is a counter.
+ */
+void
+rbtk_count_stat(RBTK_STAT *stat, long double amount);
+
+/*!
+ * @brief Sets the value of a gauge.
+ *
+ * @param[in] stat  The stat to update.
+ * @param[in] value The new value.
+ *
+ * @debugging This function asserts that `stat` is not `NULL` and that it
+ * is a gauge.
+ */
+void
+rbtk_set_stat(RBTK_STAT *stat, long double value);
+
+/*!
+ * @brief Records a sample.
+ *
+ * @param[in] stat   The stat to update.
+ * @param[in] sample The sample to record.
+ *
+ * @debugging This function asserts that `stat` is not `NULL` and that it
+ * is a sample stat.
+ */
+void
+rbtk_sample_stat(RBTK_STAT *stat, long double sample);
+
+/*!
+ * @brief Returns the current value of a stat.
+ *
+ * @param[in] stat The stat to query.
+ * @return The total of a counter, the value of a gauge, or the latest
+ * sample of a sample stat.
+ *
+ * @debugging This function asserts that `stat` is not `NULL`.
+ */
+RBTK_NO_DISCARD long double
+rbtk_get_stat_value(RBTK_STAT *stat);
+
+/*!
+ * @brief Returns the number of times a stat was updated.
+ *
+ * @param[in] stat The stat to query.
+ * @return The number of updates since the stat was last reset.
+ *
+ * @debugging This function asserts that `stat` is not `NULL`.
+ */
+RBTK_NO_DISCARD size_t
+rbtk_get_stat_count(RBTK_STAT *stat);
+
+/*!
+ * @brief Returns the mean of all updates to a stat.
+ *
+ * @param[in] stat The stat to query.
+ * @return The mean of each value given to the stat since it was last
+ * reset, `0` if there were none.
+ *
+ * @debugging This function asserts that `stat` is not `NULL`.
+ */
+RBTK_NO_DISCARD long double
+rbtk_get_stat_mean(RBTK_STAT *stat);
+
+/*!
+ * @brief Returns the largest value given to a stat.
+ *
+ * @param[in] stat The stat to query.
+ * @return The largest value given to the stat since it was last reset,
+ * `0` if there were none.
+ *
+ * @debugging This function asserts that `stat` is not `NULL`.
+ */
+RBTK_NO_DISCARD long double
+rbtk_get_stat_max(RBTK_STAT *stat);
+
+/*!
+ * @brief Returns a percentile of the recent values given to a stat.
+ *
+ * Only the last #RBTK_STAT_HISTORY_LENGTH values are considered.
+ *
+ * @param[in] stat       The stat to query.
+ * @param[in] percentile The percentile, from `0` to `100`.
+ * @return The value at the percentile, `0` if there were none.
+ *
+ * @debugging This function asserts that `stat` is not `NULL` and that
+ * `percentile` is between `0` and `100`.
+ */
+RBTK_NO_DISCARD long double
+rbtk_get_stat_percentile(RBTK_STAT *stat, long double percentile);
+
+/*!
+ * @brief Resets a stat back to its initial state.
+ *
+ * @param[in] stat The stat to reset.
+ *
+ * @debugging This function asserts that `stat` is not `NULL`.
+ */
+void
+rbtk_reset_stat(RBTK_STAT *stat);
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RBTK_STATS_H_ */
@@ -498,8 +498,10 @@ rbtk_read_memory_stream_bytes(RBTK_UNUSED RBTK_IN_STREAM *in,
     }
 
     unsigned char *buf_bytes = buf;
-    memcpy(buf_bytes + off, src->addr, cpy_len);
+    unsigned char *src_bytes = src->addr;
+    memcpy(buf_bytes + off, src_bytes + src->pos, cpy_len);
     memset(buf_bytes + off + cpy_len, 0x00, len - cpy_len);
+    src->pos += cpy_len;
 
     return cpy_len;
 }
@@ -531,7 +533,7 @@ rbtk_seek_memory_stream_to(RBTK_UNUSED RBTK_IN_STREAM *in,
     else {
         src->pos = pos;
     }
-    return pos;
+    return src->pos;
 }
 
 const rbtk_in_stream_funs rbtk_file_in_stream_funs = {
@@ -551,3 +553,265 @@ const rbtk_in_stream_funs rbtk_memory_in_stream_funs = {
     .skip_bytes      = (rbtk_in_stream_skip_bytes_fun)      rbtk_skip_memory_stream_bytes,
     .seek_to         = (rbtk_in_stream_seek_to_fun)         rbtk_seek_memory_stream_to
 };
+
+typedef struct RBTK_OUT_STREAM {
+    rbtk_out_stream_funs funs;
+    void *dst;
+} RBTK_OUT_STREAM;
+
+static bool
+rbtk_no_op_close_out_stream(RBTK_UNUSED RBTK_OUT_STREAM *out,
+    RBTK_UNUSED void *dst)
+{
+    return true;
+}
+
+static size_t
+rbtk_default_write_bytes(RBTK_OUT_STREAM *out,
+    RBTK_UNUSED void *dst, const void *buf, size_t off, size_t len)
+{
+    const unsigned char *buf_bytes = buf;
+    size_t written = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (!rbtk_write_byte(out, buf_bytes[off + i])) {
+            break;
+        }
+        written += 1;
+    }
+    return written;
+}
+
+static bool
+rbtk_no_op_flush_out_stream(RBTK_UNUSED RBTK_OUT_STREAM *out,
+    RBTK_UNUSED void *dst)
+{
+    return true;
+}
+
+RBTK_NO_DISCARD RBTK_OUT_STREAM *
+rbtk_open_out_stream(rbtk_out_stream_funs funs, void *dst)
+{
+    assert(funs.close       != (rbtk_out_stream_close_fun)       RBTK_DEFAULT_IMPL);
+    assert(funs.close       != (rbtk_out_stream_close_fun)       RBTK_UNIMPLEMENTED);
+    assert(funs.write_byte  != (rbtk_out_stream_write_byte_fun)  RBTK_NO_OP);
+    assert(funs.write_byte  != (rbtk_out_stream_write_byte_fun)  RBTK_DEFAULT_IMPL);
+    assert(funs.write_byte  != (rbtk_out_stream_write_byte_fun)  RBTK_UNIMPLEMENTED);
+    assert(funs.write_bytes != (rbtk_out_stream_write_bytes_fun) RBTK_NO_OP);
+    assert(funs.write_bytes != (rbtk_out_stream_write_bytes_fun) RBTK_UNIMPLEMENTED);
+    assert(funs.flush       != (rbtk_out_stream_flush_fun)       RBTK_DEFAULT_IMPL);
+    assert(funs.flush       != (rbtk_out_stream_flush_fun)       RBTK_UNIMPLEMENTED);
+    assert(dst);
+
+    RBTK_OUT_STREAM *out = NULL;
+    RBTK_MALLOC_OR_RETURN(&out, NULL, NULL);
+
+    if (!funs.close) {
+        funs.close = rbtk_no_op_close_out_stream;
+    }
+
+    if (funs.write_bytes == (rbtk_out_stream_write_bytes_fun) RBTK_DEFAULT_IMPL) {
+        funs.write_bytes = rbtk_default_write_bytes;
+    }
+    if (!funs.flush) {
+        funs.flush = rbtk_no_op_flush_out_stream;
+    }
+
+    out->funs = funs;
+    out->dst = dst;
+
+    return out;
+}
+
+bool
+rbtk_close_out_stream(RBTK_OUT_STREAM *out)
+{
+    assert(out);
+    if (!out->funs.flush(out, out->dst)) {
+        return false;
+    }
+    if (!out->funs.close(out, out->dst)) {
+        return false;
+    }
+    free(out);
+    return true;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_write_byte(RBTK_OUT_STREAM *out, unsigned char byte)
+{
+    assert(out);
+    return out->funs.write_byte(out, out->dst, byte);
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_write_bytes(RBTK_OUT_STREAM *out, const void *buf,
+    size_t off, size_t len)
+{
+    assert(out && buf);
+    return out->funs.write_bytes(out, out->dst, buf, off, len);
+}
+
+bool
+rbtk_flush_out_stream(RBTK_OUT_STREAM *out)
+{
+    assert(out);
+    return out->funs.flush(out, out->dst);
+}
+
+RBTK_NO_DISCARD RBTK_OUT_STREAM *
+rbtk_open_file_out_stream(const char *filepath)
+{
+    assert(filepath);
+
+    rbtk_file_out_stream_dst *dst = NULL;
+    RBTK_MALLOC_OR_RETURN(&dst, NULL, NULL);
+
+    FILE *file = fopen(filepath, "wb");
+    if (!file) {
+        free(dst);
+        rbtk_signal_error(RBTK_ERROR_IO,
+            "call to fopen() failed, is the path writable?");
+        return NULL;
+    }
+
+    dst->file = file;
+
+    RBTK_OUT_STREAM *out = rbtk_open_out_stream(
+        rbtk_file_out_stream_funs, dst);
+    if (!out) {
+        fclose(file);
+        free(dst);
+        return NULL;
+    }
+    return out;
+}
+
+bool
+rbtk_close_file_out_stream(RBTK_UNUSED RBTK_OUT_STREAM *out,
+    rbtk_file_out_stream_dst *dst)
+{
+    assert(out && dst);
+    if (fclose(dst->file)) {
+        rbtk_signal_error(RBTK_ERROR_IO, "call to fclose() failed");
+        return false;
+    }
+    free(dst);
+    return true;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_write_file_stream_byte(RBTK_UNUSED RBTK_OUT_STREAM *out,
+    rbtk_file_out_stream_dst *dst, unsigned char byte)
+{
+    assert(out && dst);
+    if (fwrite(&byte, sizeof(byte), 1, dst->file) != 1) {
+        rbtk_signal_error(RBTK_ERROR_IO, "call to fwrite() failed");
+        return false;
+    }
+    return true;
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_write_file_stream_bytes(RBTK_UNUSED RBTK_OUT_STREAM *out,
+    rbtk_file_out_stream_dst *dst, const void *buf, size_t off, size_t len)
+{
+    assert(out && dst && buf);
+    const unsigned char *buf_bytes = buf;
+    size_t written = fwrite(buf_bytes + off,
+        sizeof(unsigned char), len, dst->file);
+    if (written < len) {
+        rbtk_signal_error(RBTK_ERROR_IO, "call to fwrite() failed");
+    }
+    return written;
+}
+
+bool
+rbtk_flush_file_out_stream(RBTK_UNUSED RBTK_OUT_STREAM *out,
+    rbtk_file_out_stream_dst *dst)
+{
+    assert(out && dst);
+    if (fflush(dst->file)) {
+        rbtk_signal_error(RBTK_ERROR_IO, "call to fflush() failed");
+        return false;
+    }
+    return true;
+}
+
+RBTK_NO_DISCARD RBTK_OUT_STREAM *
+rbtk_open_memory_out_stream(void *addr, size_t len)
+{
+    assert(addr);
+
+    rbtk_memory_out_stream_dst *dst = NULL;
+    RBTK_MALLOC_OR_RETURN(&dst, NULL, NULL);
+
+    dst->addr = addr;
+    dst->len = len;
+    dst->pos = 0;
+
+    RBTK_OUT_STREAM *out = rbtk_open_out_stream(
+        rbtk_memory_out_stream_funs, dst);
+    if (!out) {
+        free(dst);
+        return NULL;
+    }
+    return out;
+}
+
+bool
+rbtk_close_memory_out_stream(RBTK_UNUSED RBTK_OUT_STREAM *out,
+    rbtk_memory_out_stream_dst *dst)
+{
+    assert(out && dst);
+    free(dst);
+    return true;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_write_memory_stream_byte(RBTK_UNUSED RBTK_OUT_STREAM *out,
+    rbtk_memory_out_stream_dst *dst, unsigned char byte)
+{
+    assert(out && dst);
+    if (dst->pos >= dst->len) {
+        return false;
+    }
+
+    unsigned char *bytes = dst->addr;
+    bytes[dst->pos] = byte;
+    dst->pos += 1;
+
+    return true;
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_write_memory_stream_bytes(RBTK_UNUSED RBTK_OUT_STREAM *out,
+    rbtk_memory_out_stream_dst *dst, const void *buf, size_t off, size_t len)
+{
+    assert(out && dst && buf);
+
+    size_t cpy_len = len;
+    if (cpy_len > dst->len - dst->pos) {
+        cpy_len = dst->len - dst->pos;
+    }
+
+    const unsigned char *buf_bytes = buf;
+    unsigned char *dst_bytes = dst->addr;
+    memcpy(dst_bytes + dst->pos, buf_bytes + off, cpy_len);
+    dst->pos += cpy_len;
+
+    return cpy_len;
+}
+
+const rbtk_out_stream_funs rbtk_file_out_stream_funs = {
+    .close       = (rbtk_out_stream_close_fun)       rbtk_close_file_out_stream,
+    .write_byte  = (rbtk_out_stream_write_byte_fun)  rbtk_write_file_stream_byte,
+    .write_bytes = (rbtk_out_stream_write_bytes_fun) rbtk_write_file_stream_bytes,
+    .flush       = (rbtk_out_stream_flush_fun)       rbtk_flush_file_out_stream
+};
+
+const rbtk_out_stream_funs rbtk_memory_out_stream_funs = {
+    .close       = (rbtk_out_stream_close_fun)       rbtk_close_memory_out_stream,
+    .write_byte  = (rbtk_out_stream_write_byte_fun)  rbtk_write_memory_stream_byte,
+    .write_bytes = (rbtk_out_stream_write_bytes_fun) rbtk_write_memory_stream_bytes,
+    .flush       = (rbtk_out_stream_flush_fun)       RBTK_NO_OP
+};
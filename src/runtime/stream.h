@@ -732,6 +732,395 @@ extern const rbtk_in_stream_funs rbtk_file_in_stream_funs;
  */
 extern const rbtk_in_stream_funs rbtk_memory_in_stream_funs;
 
+/*!
+ * @brief An output stream.
+ *
+ * Output streams provide an interface for writing data to a variety of
+ * different destinations. They are the counterpart of input streams.
+ *
+ * @note All streams must accept data as *unsigned bytes* (`unsigned char`).
+ *
+ * @see rbtk_open_out_stream(rbtk_out_stream_funs, void *)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_OUT_STREAM RBTK_OUT_STREAM;
+
+/*!
+ * @brief Function that closes an output stream.
+ *
+ * @param[in] out The output stream.
+ * @param[in] dst The stream's data destination.
+ * @return `true` on success, `false` on failure.
+ *
+ * @implementation This may be an #RBTK_NO_OP.
+ *
+ * @debugging Implementors should assert that `out` and `dst` are not
+ * `NULL`.
+ *
+ * @see rbtk_close_out_stream(RBTK_OUT_STREAM *)
+ */
+typedef RBTK_ABSTRACT_FUNC RBTK_NO_DISCARD bool
+(*rbtk_out_stream_close_fun)(RBTK_OUT_STREAM *out, void *dst);
+
+/*!
+ * @brief Function that writes a single byte to an output stream.
+ *
+ * @param[in] out  The output stream.
+ * @param[in] dst  The stream's data destination.
+ * @param[in] byte The byte to write.
+ * @return `true` on success, `false` on failure.
+ *
+ * @implementation This must be implemented.
+ *
+ * @debugging Implementors should assert that `out` and `dst` are not
+ * `NULL`.
+ *
+ * @see rbtk_write_byte(RBTK_OUT_STREAM *, unsigned char)
+ */
+typedef RBTK_ABSTRACT_FUNC RBTK_NO_DISCARD bool
+(*rbtk_out_stream_write_byte_fun)(RBTK_OUT_STREAM *out, void *dst,
+    unsigned char byte);
+
+/*!
+ * @brief Function that writes a number of bytes to an output stream.
+ *
+ * @param[in] out The output stream.
+ * @param[in] dst The stream's data destination.
+ * @param[in] buf The buffer to write from.
+ * @param[in] off The offset to begin reading at.
+ * @param[in] len The number of bytes to write.
+ * @return The number of bytes actually written.
+ *
+ * @implementation This may be #RBTK_DEFAULT_IMPL.
+ * <p>
+ * The default implementation uses #rbtk_write_byte(RBTK_OUT_STREAM *,
+ * unsigned char) to write each byte. Implementors are encouraged to
+ * implement this if it will achieve faster write times than the default.
+ *
+ * @debugging Implementors should assert that `out`, `dst`, and `buf`
+ * are not `NULL`.
+ *
+ * @see rbtk_write_bytes(RBTK_OUT_STREAM *, const void *, size_t, size_t)
+ */
+typedef RBTK_DEFAULT_FUNC RBTK_NO_DISCARD size_t
+(*rbtk_out_stream_write_bytes_fun)(RBTK_OUT_STREAM *out, void *dst,
+    const void *buf, size_t off, size_t len);
+
+/*!
+ * @brief Function that flushes buffered data of an output stream.
+ *
+ * @param[in] out The output stream.
+ * @param[in] dst The stream's data destination.
+ * @return `true` on success, `false` on failure.
+ *
+ * @implementation This may be an #RBTK_NO_OP.
+ *
+ * @debugging Implementors should assert that `out` and `dst` are not
+ * `NULL`.
+ *
+ * @see rbtk_flush_out_stream(RBTK_OUT_STREAM *)
+ */
+typedef RBTK_ABSTRACT_FUNC RBTK_NO_DISCARD bool
+(*rbtk_out_stream_flush_fun)(RBTK_OUT_STREAM *out, void *dst);
+
+/*!
+ * @brief Functions for implementing an output stream.
+ *
+ * @see rbtk_open_out_stream(rbtk_out_stream_funs, void *)
+ */
+typedef struct rbtk_out_stream_funs {
+    rbtk_out_stream_close_fun       close;
+    rbtk_out_stream_write_byte_fun  write_byte;
+    rbtk_out_stream_write_bytes_fun write_bytes;
+    rbtk_out_stream_flush_fun       flush;
+} rbtk_out_stream_funs;
+
+/*!
+ * @brief Destination type for a file output stream.
+ *
+ * @see rbtk_open_file_out_stream(const char *)
+ */
+typedef struct rbtk_file_out_stream_dst {
+    FILE *file;
+} rbtk_file_out_stream_dst;
+
+/*!
+ * @brief Destination type for a memory output stream.
+ *
+ * @see rbtk_open_memory_out_stream(void *, size_t)
+ */
+typedef struct rbtk_memory_out_stream_dst {
+    void *addr;
+    size_t len;
+    size_t pos;
+} rbtk_memory_out_stream_dst;
+
+/*!
+ * @brief Opens an output stream.
+ *
+ * @param[in] funs The output stream functions.
+ * @param[in] dst  The output stream destination data.
+ * @return The opened output stream or `NULL` on error.
+ *
+ * @debugging This function asserts that the functions in `funs` meet
+ * their implementation requirements and that `dst` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
+ * @enderrors
+ *
+ * @see rbtk_close_out_stream(RBTK_OUT_STREAM *)
+ */
+RBTK_NO_DISCARD RBTK_OUT_STREAM *
+rbtk_open_out_stream(rbtk_out_stream_funs funs, void *dst);
+
+/*!
+ * @brief Closes an output stream.
+ *
+ * Any buffered data is flushed before the stream is closed.
+ *
+ * @param[in] out The output stream.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `out` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO, If an I/O error occurs.}
+ * @enderrors
+ */
+bool
+rbtk_close_out_stream(RBTK_OUT_STREAM *out);
+
+/*!
+ * @brief Writes a single byte to an output stream.
+ *
+ * @param[in] out  The output stream.
+ * @param[in] byte The byte to write.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `out` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO, If an I/O error occurs.}
+ * @enderrors
+ *
+ * @see rbtk_write_bytes(RBTK_OUT_STREAM *, const void *, size_t, size_t)
+ */
+RBTK_NO_DISCARD bool
+rbtk_write_byte(RBTK_OUT_STREAM *out, unsigned char byte);
+
+/*!
+ * @brief Writes multiple bytes from a buffer to an output stream.
+ *
+ * @attention This function may not write the requested number of bytes.
+ * This is usually caused by the destination being full.
+ *
+ * @param[in] out The output stream.
+ * @param[in] buf The buffer to write bytes from.
+ * @param[in] off The offset to start reading at.
+ * @param[in] len The number of bytes to write.
+ * @return The number of bytes actually written.
+ *
+ * @debugging This function asserts that `out` and `buf` are not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO, If an I/O error occurs.}
+ * @enderrors
+ *
+ * @see rbtk_write_byte(RBTK_OUT_STREAM *, unsigned char)
+ */
+RBTK_NO_DISCARD size_t
+rbtk_write_bytes(RBTK_OUT_STREAM *out, const void *buf,
+    size_t off, size_t len);
+
+/*!
+ * @brief Flushes any buffered data of an output stream.
+ *
+ * @param[in] out The output stream.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `out` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO, If an I/O error occurs.}
+ * @enderrors
+ */
+bool
+rbtk_flush_out_stream(RBTK_OUT_STREAM *out);
+
+/*!
+ * @brief Opens a file output stream.
+ *
+ * The file is opened using `fopen()` from the C standard library, and
+ * is opened in `wb` (write binary) mode. This file will be closed with
+ * `fclose()` when the stream is closed.
+ *
+ * @param[in] filepath The path of the file to open.
+ * @return The opened stream, `NULL` on error.
+ *
+ * @debugging This function asserts that `filepath` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO, If an I/O error occurs.}
+ * @enderrors
+ *
+ * @see rbtk_open_out_stream(rbtk_out_stream_funs, void *)
+ */
+RBTK_NO_DISCARD RBTK_OUT_STREAM *
+rbtk_open_file_out_stream(const char *filepath);
+
+/*!
+ * @brief Closes a file output stream.
+ *
+ * @param[in] out The file output stream.
+ * @param[in] dst The stream's destination file.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `out` and `dst` are not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO, If an I/O error occurs.}
+ * @enderrors
+ *
+ * @see rbtk_close_out_stream(RBTK_OUT_STREAM *)
+ */
+bool
+rbtk_close_file_out_stream(RBTK_OUT_STREAM *out,
+    rbtk_file_out_stream_dst *dst);
+
+/*!
+ * @brief Writes a single byte to a file output stream.
+ *
+ * @param[in] out  The file output stream.
+ * @param[in] dst  The stream's destination file.
+ * @param[in] byte The byte to write.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `out` and `dst` are not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO, If an I/O error occurs.}
+ * @enderrors
+ *
+ * @see rbtk_write_byte(RBTK_OUT_STREAM *, unsigned char)
+ */
+RBTK_NO_DISCARD bool
+rbtk_write_file_stream_byte(RBTK_OUT_STREAM *out,
+    rbtk_file_out_stream_dst *dst, unsigned char byte);
+
+/*!
+ * @brief Writes multiple bytes from a buffer to a file output stream.
+ *
+ * @param[in] out The file output stream.
+ * @param[in] dst The stream's destination file.
+ * @param[in] buf The buffer to write bytes from.
+ * @param[in] off The offset to start reading at.
+ * @param[in] len The number of bytes to write.
+ * @return The number of bytes actually written.
+ *
+ * @debugging This function asserts that `out`, `dst` and `buf` are not
+ * `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO, If an I/O error occurs.}
+ * @enderrors
+ *
+ * @see rbtk_write_bytes(RBTK_OUT_STREAM *, const void *, size_t, size_t)
+ */
+RBTK_NO_DISCARD size_t
+rbtk_write_file_stream_bytes(RBTK_OUT_STREAM *out,
+    rbtk_file_out_stream_dst *dst, const void *buf, size_t off, size_t len);
+
+/*!
+ * @brief Flushes a file output stream.
+ *
+ * @param[in] out The file output stream.
+ * @param[in] dst The stream's destination file.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `out` and `dst` are not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_IO, If an I/O error occurs.}
+ * @enderrors
+ *
+ * @see rbtk_flush_out_stream(RBTK_OUT_STREAM *)
+ */
+bool
+rbtk_flush_file_out_stream(RBTK_OUT_STREAM *out,
+    rbtk_file_out_stream_dst *dst);
+
+/*!
+ * @brief Opens a memory output stream.
+ *
+ * @param[in] addr The memory address to start writing to.
+ * @param[in] len  The number of bytes available at the memory address.
+ * @return The opened stream.
+ *
+ * @debugging This function asserts that `addr` is not `NULL`.
+ *
+ * @see rbtk_open_out_stream(rbtk_out_stream_funs, void *)
+ */
+RBTK_NO_DISCARD RBTK_OUT_STREAM *
+rbtk_open_memory_out_stream(void *addr, size_t len);
+
+/*!
+ * @brief Closes a memory output stream.
+ *
+ * @param[in] out The memory output stream.
+ * @param[in] dst The stream's destination address.
+ * @return `true`, this cannot fail.
+ *
+ * @debugging This function asserts that `out` and `dst` are not `NULL`.
+ *
+ * @see rbtk_close_out_stream(RBTK_OUT_STREAM *)
+ */
+bool
+rbtk_close_memory_out_stream(RBTK_OUT_STREAM *out,
+    rbtk_memory_out_stream_dst *dst);
+
+/*!
+ * @brief Writes a single byte to a memory output stream.
+ *
+ * @param[in] out  The memory output stream.
+ * @param[in] dst  The stream's destination address.
+ * @param[in] byte The byte to write.
+ * @return `true` on success, `false` if the memory is full.
+ *
+ * @debugging This function asserts that `out` and `dst` are not `NULL`.
+ *
+ * @see rbtk_write_byte(RBTK_OUT_STREAM *, unsigned char)
+ */
+RBTK_NO_DISCARD bool
+rbtk_write_memory_stream_byte(RBTK_OUT_STREAM *out,
+    rbtk_memory_out_stream_dst *dst, unsigned char byte);
+
+/*!
+ * @brief Writes multiple bytes from a buffer to a memory output stream.
+ *
+ * @attention This function may not write the requested number of bytes.
+ * This occurs when the memory is full.
+ *
+ * @param[in] out The memory output stream.
+ * @param[in] dst The stream's destination address.
+ * @param[in] buf The buffer to write bytes from.
+ * @param[in] off The offset to start reading at.
+ * @param[in] len The number of bytes to write.
+ * @return The number of bytes actually written.
+ *
+ * @debugging This function asserts that `out`, `dst` and `buf` are not
+ * `NULL`.
+ *
+ * @see rbtk_write_bytes(RBTK_OUT_STREAM *, const void *, size_t, size_t)
+ */
+RBTK_NO_DISCARD size_t
+rbtk_write_memory_stream_bytes(RBTK_OUT_STREAM *out,
+    rbtk_memory_out_stream_dst *dst, const void *buf, size_t off, size_t len);
+
+/*!
+ * @brief The functions which implement a file output stream.
+ *
+ * @see rbtk_open_file_out_stream(const char *)
+ */
+extern const rbtk_out_stream_funs rbtk_file_out_stream_funs;
+
+/*!
+ * @brief The functions which implement a memory output stream.
+ *
+ * @see rbtk_open_memory_out_stream(void *, size_t)
+ */
+extern const rbtk_out_stream_funs rbtk_memory_out_stream_funs;
+
 /*! @} */
 
 #ifdef __cplusplus
@@ -27,6 +27,7 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -63,9 +64,14 @@ static RBTK_THREAD *threads_head;
 static RBTK_THREAD *threads_tail;
 static RBTK_THREAD_STORAGE_KEY *keys_head;
 static RBTK_THREAD_STORAGE_KEY *keys_tail;
+static RBTK_THREAD_POOL *pools_head;
+static RBTK_THREAD_POOL *pools_tail;
 static size_t next_thread_id;
 static bool initialized;
 
+static void
+destroy_thread_pool(RBTK_THREAD_POOL *pool);
+
 RBTK_NO_DISCARD bool
 priv_rbtk_thread_init(void)
 {
@@ -81,6 +87,8 @@ priv_rbtk_thread_init(void)
     threads_tail = NULL;
     keys_head = NULL;
     keys_tail = NULL;
+    pools_head = NULL;
+    pools_tail = NULL;
     next_thread_id = 1;
 
     initialized = true;
@@ -94,6 +102,18 @@ priv_rbtk_thread_terminate(void)
         return true;
     }
 
+    /*
+     * Pools must be shut down before their workers are destroyed below.
+     * Any jobs which were never awaited are released here, as the caller
+     * has no way of doing so once the module is gone.
+     */
+    RBTK_THREAD_POOL *cur_pool = pools_head;
+    while (cur_pool) {
+        RBTK_THREAD_POOL *next = cur_pool->next;
+        destroy_thread_pool(cur_pool);
+        cur_pool = next;
+    }
+
     if (!plat_rbtk_thread_terminate()) {
         return false;
     }
@@ -127,6 +147,8 @@ priv_rbtk_thread_terminate(void)
     threads_tail = NULL;
     keys_head = NULL;
     keys_tail = NULL;
+    pools_head = NULL;
+    pools_tail = NULL;
     next_thread_id = 1;
 
     initialized = false;
@@ -240,6 +262,14 @@ RBTK_NO_DISCARD bool
 rbtk_thread_is_alive(RBTK_THREAD *thread)
 {
     assert(thread);
+
+    /*
+     * A thread is only known to have died once it has been joined. If it
+     * has already returned, this joins it without waiting.
+     */
+    if (thread->running && thread != rbtk_current_thread()) {
+        plat_rbtk_join_thread_within(thread, 0.0L);
+    }
     return thread->running;
 }
 
@@ -332,7 +362,9 @@ rbtk_join_thread(RBTK_THREAD *thread)
 {
     assert(thread);
     assert(thread != rbtk_current_thread());
-    while (thread->running);
+    if (thread->running) {
+        plat_rbtk_join_thread(thread);
+    }
 }
 
 bool
@@ -345,14 +377,8 @@ rbtk_join_thread_within(RBTK_THREAD *thread, rbtk_time_unit unit,
         return true;
     }
 
-    long double begin_wait = rbtk_time(unit);
-    while (rbtk_time(unit) - begin_wait < timeout) {
-        if (!thread->running) {
-            return true;
-        }
-    }
-
-    return false;
+    long double millis = rbtk_convert_time(unit, RBTK_MILLIS, timeout);
+    return plat_rbtk_join_thread_within(thread, millis);
 }
 
 RBTK_NO_DISCARD RBTK_THREAD_STORAGE_KEY *
@@ -399,4 +425,298 @@ rbtk_get_thread_storage(RBTK_THREAD_STORAGE_KEY *key)
     return plat_rbtk_get_thread_storage(key);
 }
 
+RBTK_NO_DISCARD size_t
+rbtk_get_processor_count(void)
+{
+    size_t count = plat_rbtk_get_processor_count();
+    return count > 0 ? count : 1;
+}
+
+RBTK_NO_DISCARD RBTK_LOCK *
+rbtk_create_lock(void)
+{
+    REQUIRE_INITIALIZED_OR_RETURN(NULL);
+
+    RBTK_LOCK *lock;
+    RBTK_MALLOC_OR_RETURN(&lock, NULL,
+        "failed to allocate memory for lock");
+
+    if (!plat_rbtk_create_lock(lock)) {
+        free(lock);
+        return NULL;
+    }
+
+    return lock;
+}
+
+void
+rbtk_destroy_lock(RBTK_LOCK *lock)
+{
+    assert(lock);
+    plat_rbtk_destroy_lock(lock);
+    free(lock);
+}
+
+void
+rbtk_acquire_lock(RBTK_LOCK *lock)
+{
+    assert(lock);
+    plat_rbtk_acquire_lock(lock);
+}
+
+void
+rbtk_release_lock(RBTK_LOCK *lock)
+{
+    assert(lock);
+    plat_rbtk_release_lock(lock);
+}
+
+void
+rbtk_await_lock(RBTK_LOCK *lock)
+{
+    assert(lock);
+    plat_rbtk_await_lock(lock);
+}
+
+void
+rbtk_notify_lock(RBTK_LOCK *lock, bool all)
+{
+    assert(lock);
+    plat_rbtk_notify_lock(lock, all);
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_atomic_load(const volatile size_t *ptr)
+{
+    assert(ptr);
+    return plat_rbtk_atomic_load(ptr);
+}
+
+void
+rbtk_atomic_store(volatile size_t *ptr, size_t value)
+{
+    assert(ptr);
+    plat_rbtk_atomic_store(ptr, value);
+}
+
+static void
+run_pool_worker(void *args)
+{
+    RBTK_THREAD_POOL *pool = args;
+
+    rbtk_acquire_lock(pool->lock);
+    for (;;) {
+        while (!pool->queue_head && !pool->shutdown) {
+            rbtk_await_lock(pool->lock);
+        }
+
+        if (pool->shutdown) {
+            break; /* pool is being destroyed */
+        }
+
+        RBTK_JOB *job = pool->queue_head;
+        pool->queue_head = job->queue_next;
+        if (!pool->queue_head) {
+            pool->queue_tail = NULL;
+        }
+
+        /*
+         * Release the lock while the job is running. Otherwise, the other
+         * workers would be unable to take jobs from the queue, and we would
+         * be no better off than running each job on a single thread.
+         */
+        rbtk_release_lock(pool->lock);
+        job->func(job->args);
+        rbtk_acquire_lock(pool->lock);
+
+        job->done = true;
+        rbtk_notify_lock(pool->lock, true);
+    }
+
+    pool->live_workers -= 1;
+    rbtk_notify_lock(pool->lock, true);
+    rbtk_release_lock(pool->lock);
+}
+
+static void
+destroy_thread_pool(RBTK_THREAD_POOL *pool)
+{
+    assert(pool);
+
+    rbtk_acquire_lock(pool->lock);
+    pool->shutdown = true;
+    rbtk_notify_lock(pool->lock, true);
+    while (pool->live_workers > 0) {
+        rbtk_await_lock(pool->lock);
+    }
+    rbtk_release_lock(pool->lock);
+
+    /*
+     * At this point, each worker has left its loop and released the lock
+     * for the last time. They must still be joined before being destroyed,
+     * as a worker may not have returned yet.
+     */
+    for (size_t i = 0; i < pool->num_workers; i++) {
+        rbtk_join_thread(pool->workers[i]);
+        rbtk_destroy_thread(pool->workers[i]);
+    }
+
+    RBTK_JOB *job = pool->jobs_head;
+    while (job) {
+        RBTK_JOB *next = job->next;
+        free(job);
+        job = next;
+    }
+
+    RBTK_DLL_REMOVE(pools_head, pools_tail, pool);
+    rbtk_destroy_lock(pool->lock);
+    free(pool);
+}
+
+RBTK_NO_DISCARD RBTK_THREAD_POOL *
+rbtk_create_thread_pool(const char *name, size_t thread_count)
+{
+    assert(name);
+    REQUIRE_INITIALIZED_OR_RETURN(NULL);
+
+    if (thread_count == 0) {
+        thread_count = rbtk_get_processor_count();
+    }
+    if (thread_count > RBTK_MAX_THREAD_POOL_SIZE) {
+        thread_count = RBTK_MAX_THREAD_POOL_SIZE;
+    }
+
+    RBTK_THREAD_POOL *pool;
+    RBTK_MALLOC_OR_RETURN(&pool, NULL,
+        "failed to allocate memory for thread pool");
+    RBTK_ZERO_MEMORY(pool);
+
+    pool->lock = rbtk_create_lock();
+    if (!pool->lock) {
+        free(pool);
+        return NULL;
+    }
+
+    RBTK_DLL_PUSH(pools_head, pools_tail, pool);
+
+    /*
+     * Count each worker as live before it is started. This way, if one
+     * fails to start, destroying the pool will not wait for a worker that
+     * never existed. Workers which did start will see the shutdown flag.
+     */
+    for (size_t i = 0; i < thread_count; i++) {
+        char worker_name[RBTK_THREAD_NAME_MAX_LENGTH];
+        snprintf(worker_name, sizeof(worker_name), "%s-%zu", name, i);
+
+        RBTK_THREAD *worker = rbtk_create_thread(worker_name,
+            run_pool_worker, pool);
+        if (!worker) {
+            destroy_thread_pool(pool);
+            return NULL;
+        }
+
+        rbtk_thread_set_daemon(worker, true);
+        pool->workers[pool->num_workers++] = worker;
+
+        rbtk_acquire_lock(pool->lock);
+        pool->live_workers += 1;
+        rbtk_release_lock(pool->lock);
+
+        if (!rbtk_start_thread(worker)) {
+            rbtk_acquire_lock(pool->lock);
+            pool->live_workers -= 1;
+            rbtk_release_lock(pool->lock);
+            destroy_thread_pool(pool);
+            return NULL;
+        }
+    }
+
+    return pool;
+}
+
+bool
+rbtk_destroy_thread_pool(RBTK_THREAD_POOL *pool)
+{
+    assert(pool);
+
+    if (pool->jobs_head) {
+        rbtk_signal_error(RBTK_ERROR_ILLEGAL_STATE,
+            "thread pool has jobs which were not awaited");
+        return false;
+    }
+
+    destroy_thread_pool(pool);
+    return true;
+}
+
+RBTK_NO_DISCARD size_t
+rbtk_get_thread_pool_size(const RBTK_THREAD_POOL *pool)
+{
+    assert(pool);
+    return pool->num_workers;
+}
+
+RBTK_NO_DISCARD RBTK_JOB *
+rbtk_submit_job(RBTK_THREAD_POOL *pool, rbtk_thread_entrypoint func,
+    void *args)
+{
+    assert(pool);
+    assert(func);
+
+    RBTK_JOB *job;
+    RBTK_MALLOC_OR_RETURN(&job, NULL,
+        "failed to allocate memory for job");
+
+    job->pool = pool;
+    job->func = func;
+    job->args = args;
+    job->done = false;
+    job->queue_next = NULL;
+    job->prev = NULL;
+    job->next = NULL;
+
+    rbtk_acquire_lock(pool->lock);
+
+    RBTK_DLL_PUSH(pool->jobs_head, pool->jobs_tail, job);
+    if (!pool->queue_head) {
+        pool->queue_head = job;
+    }
+    else {
+        pool->queue_tail->queue_next = job;
+    }
+    pool->queue_tail = job;
+
+    rbtk_notify_lock(pool->lock, false);
+    rbtk_release_lock(pool->lock);
+
+    return job;
+}
+
+RBTK_NO_DISCARD bool
+rbtk_job_is_done(RBTK_JOB *job)
+{
+    assert(job);
+    RBTK_THREAD_POOL *pool = job->pool;
+    rbtk_acquire_lock(pool->lock);
+    bool done = job->done;
+    rbtk_release_lock(pool->lock);
+    return done;
+}
+
+void
+rbtk_await_job(RBTK_JOB *job)
+{
+    assert(job);
+    RBTK_THREAD_POOL *pool = job->pool;
+
+    rbtk_acquire_lock(pool->lock);
+    while (!job->done) {
+        rbtk_await_lock(pool->lock);
+    }
+    RBTK_DLL_REMOVE(pool->jobs_head, pool->jobs_tail, job);
+    rbtk_release_lock(pool->lock);
+
+    free(job);
+}
+
 RBTK_THREAD *const RBTK_MAIN_THREAD = &main_thread;
@@ -449,6 +449,274 @@ rbtk_destroy_thread_storage(RBTK_THREAD_STORAGE_KEY *key);
 RBTK_NO_DISCARD void *
 rbtk_get_thread_storage(RBTK_THREAD_STORAGE_KEY *key);
 
+/*!
+ * @brief Returns the number of processors available to the program.
+ *
+ * @return The number of logical processors, at least `1`.
+ */
+RBTK_NO_DISCARD size_t
+rbtk_get_processor_count(void);
+
+/*!
+ * @brief A mutual exclusion lock with a built-in condition.
+ *
+ * Only one thread may hold a lock at a time. While holding it, a thread may
+ * also wait on the lock for another thread to notify it. This makes a lock
+ * suitable for both guarding shared memory and signalling between threads.
+ *
+ * @see rbtk_create_lock(void)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_LOCK RBTK_LOCK;
+
+/*!
+ * @brief Creates a lock.
+ *
+ * @return The newly created lock, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until the lock is
+ * destroyed via #rbtk_destroy_lock(RBTK_LOCK *). It is an unchecked
+ * runtime error to free it.
+ *
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE, If the thread module is not initialized.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
+ * @signal{#RBTK_ERROR_PLATFORM,      If a platform specific error occurred.}
+ * @enderrors
+ *
+ * @see rbtk_destroy_lock(RBTK_LOCK *)
+ */
+RBTK_NO_DISCARD RBTK_LOCK *
+rbtk_create_lock(void);
+
+/*!
+ * @brief Destroys a lock.
+ *
+ * @attention It is an unchecked runtime error to destroy a lock which is
+ * currently held or waited on by any thread.
+ *
+ * @param[in] lock The lock to destroy.
+ *
+ * @debugging This function asserts that `lock` is not `NULL`.
+ */
+void
+rbtk_destroy_lock(RBTK_LOCK *lock);
+
+/*!
+ * @brief Acquires a lock, waiting until it is available.
+ *
+ * @param[in] lock The lock to acquire.
+ *
+ * @debugging This function asserts that `lock` is not `NULL`.
+ *
+ * @see rbtk_release_lock(RBTK_LOCK *)
+ */
+void
+rbtk_acquire_lock(RBTK_LOCK *lock);
+
+/*!
+ * @brief Releases a lock held by the calling thread.
+ *
+ * @param[in] lock The lock to release.
+ *
+ * @debugging This function asserts that `lock` is not `NULL`.
+ *
+ * @see rbtk_acquire_lock(RBTK_LOCK *)
+ */
+void
+rbtk_release_lock(RBTK_LOCK *lock);
+
+/*!
+ * @brief Waits on a lock until another thread notifies it.
+ * @pre   Acquire the lock.
+ *
+ * The lock is released while waiting and acquired again before returning.
+ * Wake-ups may be spurious, so callers should always re-check the condition
+ * they are waiting on in a loop.
+ *
+ * @param[in] lock The lock to wait on, must be held by the calling thread.
+ *
+ * @debugging This function asserts that `lock` is not `NULL`.
+ *
+ * @see rbtk_notify_lock(RBTK_LOCK *, bool)
+ */
+void
+rbtk_await_lock(RBTK_LOCK *lock);
+
+/*!
+ * @brief Wakes threads waiting on a lock.
+ *
+ * @param[in] lock The lock to notify.
+ * @param[in] all  `true` to wake every waiting thread, `false` to wake
+ *                 only one of them.
+ *
+ * @debugging This function asserts that `lock` is not `NULL`.
+ *
+ * @see rbtk_await_lock(RBTK_LOCK *)
+ */
+void
+rbtk_notify_lock(RBTK_LOCK *lock, bool all);
+
+/*!
+ * @brief Atomically loads a value shared between threads.
+ *
+ * This has acquire semantics. Any memory written by another thread before
+ * it stored the value via #rbtk_atomic_store(volatile size_t *, size_t)
+ * is visible to the calling thread once this returns.
+ *
+ * @param[in] ptr The value to load.
+ * @return The loaded value.
+ *
+ * @debugging This function asserts that `ptr` is not `NULL`.
+ */
+RBTK_NO_DISCARD size_t
+rbtk_atomic_load(const volatile size_t *ptr);
+
+/*!
+ * @brief Atomically stores a value shared between threads.
+ *
+ * This has release semantics, and is the counterpart of
+ * #rbtk_atomic_load(const volatile size_t *). Together, they are enough
+ * to build a single producer, single consumer queue without a lock.
+ *
+ * @param[in] ptr   The value to store to.
+ * @param[in] value The value to store.
+ *
+ * @debugging This function asserts that `ptr` is not `NULL`.
+ */
+void
+rbtk_atomic_store(volatile size_t *ptr, size_t value);
+
+/*!
+ * @brief The maximum number of threads in a thread pool.
+ *
+ * @note This limit is arbitrary. Feel free to increase this value if need
+ * be. However, ensure it is a power of two (e.g., `64` or `128`).
+ */
+#define RBTK_MAX_THREAD_POOL_SIZE 64
+
+/*!
+ * @brief A group of worker threads which run submitted jobs.
+ *
+ * @see rbtk_create_thread_pool(const char *, size_t)
+ * @see rbtk_submit_job(RBTK_THREAD_POOL *, rbtk_thread_entrypoint, void *)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_THREAD_POOL RBTK_THREAD_POOL;
+
+/*!
+ * @brief A unit of work submitted to a thread pool.
+ *
+ * @see rbtk_submit_job(RBTK_THREAD_POOL *, rbtk_thread_entrypoint, void *)
+ * @see rbtk_await_job(RBTK_JOB *)
+ */
+RBTK_FORWARD_DECLARATION
+typedef struct RBTK_JOB RBTK_JOB;
+
+/*!
+ * @brief Creates a thread pool.
+ * @post  Destroy the thread pool.
+ *
+ * The workers of a pool are daemons, and are started immediately. Jobs
+ * are run in the order they were submitted, but may finish in any order.
+ *
+ * @param[in] name         The name of the pool. Each worker is named after
+ *                         the pool, followed by its index.
+ * @param[in] thread_count The number of workers, `0` for one per processor.
+ *                         Any count which exceeds the maximum pool size
+ *                         shall be cut off.
+ * @return The newly created thread pool, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until the pool is
+ * destroyed via #rbtk_destroy_thread_pool(RBTK_THREAD_POOL *) or the
+ * thread module is terminated. It is an unchecked runtime error to free it.
+ *
+ * @debugging This function asserts that `name` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE, If the thread module is not initialized.}
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
+ * @signal{#RBTK_ERROR_PLATFORM,      If a platform specific error occurred.}
+ * @enderrors
+ *
+ * @see rbtk_destroy_thread_pool(RBTK_THREAD_POOL *)
+ */
+RBTK_NO_DISCARD RBTK_THREAD_POOL *
+rbtk_create_thread_pool(const char *name, size_t thread_count);
+
+/*!
+ * @brief Destroys a thread pool.
+ * @pre   Await all jobs submitted to the pool.
+ *
+ * This waits for each worker to finish its current job before stopping it.
+ *
+ * @param[in] pool The thread pool to destroy.
+ * @return `true` on success, `false` on failure.
+ *
+ * @debugging This function asserts that `pool` is not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_ILLEGAL_STATE, If a job of the pool was not awaited.}
+ * @enderrors
+ */
+bool
+rbtk_destroy_thread_pool(RBTK_THREAD_POOL *pool);
+
+/*!
+ * @brief Returns the number of workers in a thread pool.
+ *
+ * @param[in] pool The thread pool to query.
+ * @return The number of workers in the pool.
+ *
+ * @debugging This function asserts that `pool` is not `NULL`.
+ */
+RBTK_NO_DISCARD size_t
+rbtk_get_thread_pool_size(const RBTK_THREAD_POOL *pool);
+
+/*!
+ * @brief Submits a job to a thread pool.
+ * @post  Await the job.
+ *
+ * @param[in] pool The thread pool to run the job on.
+ * @param[in] func The job function, run on one of the pool's workers.
+ * @param[in] args The arguments for `func`, may be `NULL`.
+ * @return The submitted job, `NULL` on failure.
+ *
+ * @pointer_lifetime The returned pointer is valid until the job is awaited
+ * via #rbtk_await_job(RBTK_JOB *). It is an unchecked runtime error to
+ * free it.
+ *
+ * @debugging This function asserts that `pool` and `func` are not `NULL`.
+ * @errors
+ * @signal{#RBTK_ERROR_OUT_OF_MEMORY, On memory allocation failure.}
+ * @enderrors
+ *
+ * @see rbtk_job_is_done(RBTK_JOB *)
+ */
+RBTK_NO_DISCARD RBTK_JOB *
+rbtk_submit_job(RBTK_THREAD_POOL *pool, rbtk_thread_entrypoint func,
+    void *args);
+
+/*!
+ * @brief Returns if a job has finished running.
+ *
+ * @param[in] job The job to query.
+ * @return `true` if the job is done, `false` otherwise.
+ *
+ * @debugging This function asserts that `job` is not `NULL`.
+ */
+RBTK_NO_DISCARD bool
+rbtk_job_is_done(RBTK_JOB *job);
+
+/*!
+ * @brief Waits for a job to finish, then releases it.
+ *
+ * @param[in] job The job to await. This pointer is no longer valid once
+ *                this function returns.
+ *
+ * @debugging This function asserts that `job` is not `NULL`.
+ */
+void
+rbtk_await_job(RBTK_JOB *job);
+
 /*!
  * @brief A pointer to the main thread of this program.
  *
@@ -23,4 +23,89 @@
  */
 #include "sonic_game.h"
 
-const rbtk_game_state_funs sonic_load_state_funs = { 0 };
+#include <math.h>
+
+/*
+ * The loading screen is a pulsing icon in the bottom right corner of the
+ * screen. It is kept tiny, so that it can be shown right away while the
+ * next state is being preloaded in the background.
+ */
+#define ICON_SCALE      0.5f
+#define ICON_SIZE       (64.0f * ICON_SCALE)
+#define ICON_MARGIN     8.0f
+#define ICON_X          (SONIC_SCREEN_WIDTH - ICON_SIZE - ICON_MARGIN)
+#define ICON_Y          (SONIC_SCREEN_HEIGHT - ICON_SIZE - ICON_MARGIN)
+#define PULSE_PERIOD_MS 1000.0L
+
+static RBTK_SPRITE *icon;
+static long double elapsed_ms;
+
+static void
+init_state(RBTK_UNUSED RBTK_GAME *game, RBTK_UNUSED RBTK_GAME_STATE *state)
+{
+    RBTK_ASSET *asset = rbtk_get_asset("icon.png");
+    if (!asset) {
+        return; /* show a blank loading screen */
+    }
+
+    icon = rbtk_load_sprite(asset);
+    if (icon) {
+        rbtk_scale_sprite(icon, ICON_SCALE, ICON_SCALE, 1.0f);
+    }
+}
+
+static void
+deinit_state(RBTK_UNUSED RBTK_GAME *game,
+        RBTK_UNUSED RBTK_GAME_STATE *state)
+{
+    rbtk_unload_sprite(icon);
+    icon = NULL;
+}
+
+/*
+ * The state to load next is given as the entrance argument. It is entered
+ * by the engine as soon as it has finished preloading.
+ */
+static void
+enter_state(RBTK_GAME *game, RBTK_UNUSED RBTK_GAME_STATE *state,
+        void *args)
+{
+    elapsed_ms = 0.0L;
+
+    RBTK_GAME_STATE *next = args;
+    if (next) {
+        rbtk_preload_game_state(game, next, NULL);
+    }
+}
+
+static void
+update_state(RBTK_UNUSED RBTK_GAME *game,
+        RBTK_UNUSED RBTK_GAME_STATE *state, long double delta_ms)
+{
+    elapsed_ms += delta_ms;
+}
+
+static void
+render_state(RBTK_UNUSED RBTK_GAME *game,
+        RBTK_UNUSED RBTK_GAME_STATE *state, float alpha)
+{
+    if (!icon) {
+        return; /* nothing to render */
+    }
+
+    /* fade the icon in and out, smoothing between updates */
+    long double time_ms = elapsed_ms + alpha * (1000.0L / SONIC_TICK_RATE);
+    long double phase = fmodl(time_ms, PULSE_PERIOD_MS) / PULSE_PERIOD_MS;
+    float pulse = (float) (phase < 0.5L ? phase * 2.0L : 2.0L - phase * 2.0L);
+
+    rbtk_set_sprite_alpha(icon, pulse);
+    rbtk_draw_sprite(sonic_globals.scene, icon, ICON_X, ICON_Y, 0.0f);
+}
+
+const rbtk_game_state_funs sonic_load_state_funs = {
+    .init = init_state,
+    .deinit = deinit_state,
+    .enter = enter_state,
+    .update = update_state,
+    .render = render_state,
+};
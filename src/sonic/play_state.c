@@ -23,4 +23,159 @@
  */
 #include "sonic_game.h"
 
-const rbtk_game_state_funs sonic_play_state_funs = { 0 };
+#include "../engine/activation.h"
+#include "../engine/camera.h"
+#include "../engine/entity.h"
+
+/*
+ * A level is the present of an act, plus everything in it which moves.
+ * Only the objects near the camera exist as entities. The activator turns
+ * the rest into entities as the camera gets close to them.
+ */
+#define MAX_LEVEL_ENTITIES 512
+#define PLAYER_START_X     64.0f
+#define PLAYER_START_Y     96.0f
+
+static struct {
+    sonic_period_data period;
+    RBTK_CAMERA_CONTROLLER *camera;
+    RBTK_WORLD *world;
+    RBTK_ACTIVATOR *activator;
+    rbtk_entity player;
+} level;
+
+static rbtk_entity
+spawn_object(RBTK_WORLD *world, const rbtk_spawn *spawn,
+    RBTK_UNUSED void *args)
+{
+    return rbtk_create_entity(world, spawn->x, spawn->y);
+}
+
+static const rbtk_activator_funs object_funs = {
+    .spawn = spawn_object,
+};
+
+static void
+unload_level(void)
+{
+    rbtk_destroy_activator(level.activator);
+    rbtk_destroy_world(level.world);
+    rbtk_destroy_camera_controller(level.camera);
+    sonic_unload_period(&level.period);
+    memset(&level, 0x00, sizeof(level));
+}
+
+static bool
+load_level(const char *act)
+{
+    if (!sonic_travel_to_period(act, SONIC_PRESENT, &level.period)) {
+        return false;
+    }
+
+    rbtk_camera_rules rules;
+    rbtk_get_sonic_camera_rules(&rules, SONIC_SCREEN_WIDTH);
+    level.camera = rbtk_create_camera_controller(sonic_globals.scene, &rules);
+    if (!level.camera) {
+        return false;
+    }
+
+    size_t width, height;
+    rbtk_get_tilemap_size(level.period.tilemap, &width, &height);
+    rbtk_box bounds = {
+        .min_x = 0.0f,
+        .min_y = 0.0f,
+        .max_x = (float) (width * RBTK_TILE_SIZE),
+        .max_y = (float) (height * RBTK_TILE_SIZE),
+    };
+    rbtk_set_camera_bounds(level.camera, &bounds);
+    rbtk_center_camera_on(level.camera, PLAYER_START_X, PLAYER_START_Y);
+
+    level.world = rbtk_create_world(MAX_LEVEL_ENTITIES);
+    if (!level.world) {
+        return false;
+    }
+
+    level.player = rbtk_create_entity(level.world,
+        PLAYER_START_X, PLAYER_START_Y);
+    if (level.player == RBTK_NO_ENTITY) {
+        return false;
+    }
+
+    /*
+     * The acts do not have object layouts yet, so there is nothing to
+     * spawn. The activator has no margin of its own, as the activation
+     * window of the camera view is already wider than the screen.
+     */
+    level.activator = rbtk_create_activator(level.world, NULL, 0, 0.0f,
+        &object_funs, NULL);
+    return level.activator != NULL;
+}
+
+/*
+ * The act to play is given as the entrance argument. If it fails to load,
+ * the level is left empty.
+ */
+static void
+enter_state(RBTK_UNUSED RBTK_GAME *game,
+        RBTK_UNUSED RBTK_GAME_STATE *state, void *args)
+{
+    const char *act = args;
+    if (!act || !load_level(act)) {
+        unload_level();
+    }
+}
+
+static void
+exit_state(RBTK_UNUSED RBTK_GAME *game,
+        RBTK_UNUSED RBTK_GAME_STATE *state)
+{
+    unload_level();
+}
+
+static void
+update_state(RBTK_UNUSED RBTK_GAME *game,
+        RBTK_UNUSED RBTK_GAME_STATE *state,
+        RBTK_UNUSED long double delta_ms)
+{
+    if (!level.activator) {
+        return; /* the level failed to load */
+    }
+
+    rbtk_move_entities(level.world);
+
+    rbtk_entity_arrays arrays = rbtk_get_entity_arrays(level.world);
+    size_t player = rbtk_get_entity_index(level.world, level.player);
+    rbtk_camera_target target = {
+        .x = arrays.x[player],
+        .y = arrays.y[player],
+        .x_speed = arrays.vel_x[player],
+        .ground_speed = arrays.vel_x[player],
+        .grounded = true,
+    };
+    rbtk_update_camera_controller(level.camera, &target);
+
+    /* the camera has moved, so objects which came into view can spawn */
+    const rbtk_camera_view *view = rbtk_get_camera_view(level.camera);
+    rbtk_update_activator(level.activator,
+        view->active.min_x, view->active.max_x);
+}
+
+static void
+render_state(RBTK_UNUSED RBTK_GAME *game,
+        RBTK_UNUSED RBTK_GAME_STATE *state, float alpha)
+{
+    if (!level.activator) {
+        return; /* the level failed to load */
+    }
+
+    const rbtk_camera_view *view = rbtk_get_camera_view(level.camera);
+    rbtk_draw_entities(sonic_globals.scene, level.world, NULL,
+        &view->rect, alpha);
+}
+
+const rbtk_game_state_funs sonic_play_state_funs = {
+    .enter = enter_state,
+    .exit = exit_state,
+    .update = update_state,
+    .render = render_state,
+};
@@ -23,17 +23,291 @@
  */
 #include "sonic_game.h"
 
+#include <assert.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "../engine/engine.h"
+#include "../engine/hitch.h"
+#include "../engine/overlay.h"
+
+#include "../libraries/stb_image.h"
 
 #include "../runtime/runtime.h"
 
 sonic_globals_type sonic_globals;
 sonic_assets_type sonic_assets;
 
+#define MAX_SOUND_REQUESTS 16
+
+/*
+ * Set from the command line. When recording, the keyboard is written to
+ * the given file every frame. When replaying, the keyboard is read from
+ * the given file instead, until the recording ends.
+ */
+static const char *record_input_path;
+static const char *replay_input_path;
+static RBTK_OUT_STREAM *record_input;
+static RBTK_IN_STREAM *replay_input;
+
+/*
+ * Set from the command line. When non-zero, the game is run headless for
+ * this many frames, after which its throughput is printed.
+ */
+static size_t headless_frames;
+
+/*
+ * Set from the command line. When non-zero, frames taking this many times
+ * longer than the median are written to a trace in the current directory.
+ */
+static long double hitch_multiple;
+
+static bool
+open_sound(sonic_sound_request *request)
+{
+    if (request->src) {
+        return true; /* already opened */
+    }
+
+    RBTK_ASSET *asset = rbtk_require_asset(request->path);
+    RBTK_IN_STREAM *in = rbtk_open_asset_in_stream(asset);
+    if (!in) {
+        return false; /* error opening input stream */
+    }
+
+    RBTK_AUDIO_SOURCE *src = rbtk_source_ogg(in);
+    if (!src) {
+        rbtk_close_in_stream(in);
+        return false; /* error sourcing OGG file */
+    }
+
+    request->in = in;
+    request->src = src;
+    return true;
+}
+
+void
+sonic_open_sounds(size_t count, sonic_sound_request requests[])
+{
+    for (size_t i = 0; i < count; i++) {
+        if (!*requests[i].dest) {
+            open_sound(&requests[i]);
+        }
+    }
+}
+
+/*
+ * Unlike the others, this does not touch the asset or audio systems, and
+ * so it is safe to call from a worker thread. The sounds must have been
+ * opened beforehand with sonic_open_sounds().
+ */
+void
+sonic_decode_sounds(size_t count, sonic_sound_request requests[])
+{
+    for (size_t i = 0; i < count; i++) {
+        if (requests[i].src && !rbtk_decode_audio_source(requests[i].src)) {
+            fprintf(stderr, "Failed to decode %s.\n", requests[i].path);
+        }
+    }
+}
+
+void
+sonic_buffer_sounds(size_t count, sonic_sound_request requests[])
+{
+    assert(count <= MAX_SOUND_REQUESTS);
+
+    size_t num_srcs = 0;
+    RBTK_AUDIO_SOURCE *srcs[MAX_SOUND_REQUESTS];
+    RBTK_IN_STREAM *ins[MAX_SOUND_REQUESTS];
+    RBTK_SOUND **dests[MAX_SOUND_REQUESTS];
+
+    for (size_t i = 0; i < count; i++) {
+        if (*requests[i].dest) {
+            continue; /* sound already buffered */
+        }
+        else if (!open_sound(&requests[i])) {
+            continue; /* error opening sound */
+        }
+
+        srcs[num_srcs] = requests[i].src;
+        ins[num_srcs] = requests[i].in;
+        dests[num_srcs] = requests[i].dest;
+        num_srcs += 1;
+
+        requests[i].src = NULL;
+        requests[i].in = NULL;
+    }
+
+    /*
+     * Buffer every sound in one batch, so that they are all decoded at the
+     * same time. Sounds which failed to buffer are left as NULL, the same
+     * as if they were buffered one by one with sonic_buffer_sound(). Any
+     * sounds decoded by sonic_decode_sounds() skip straight to buffering.
+     */
+    RBTK_SOUND *sounds[MAX_SOUND_REQUESTS];
+    if (!rbtk_buffer_sounds(srcs, num_srcs, sounds)) {
+        fprintf(stderr, "Failed to buffer some sounds.\n");
+    }
+
+    for (size_t i = 0; i < num_srcs; i++) {
+        if (!sounds[i]) {
+            rbtk_close_audio_source(srcs[i]);
+        }
+        rbtk_close_in_stream(ins[i]);
+        *dests[i] = sounds[i];
+    }
+}
+
+void
+sonic_discard_sounds(size_t count, sonic_sound_request requests[])
+{
+    for (size_t i = 0; i < count; i++) {
+        if (requests[i].src) {
+            rbtk_close_audio_source(requests[i].src);
+            rbtk_close_in_stream(requests[i].in);
+            requests[i].src = NULL;
+            requests[i].in = NULL;
+        }
+    }
+}
+
+void
+sonic_request_frames(sonic_sprite_request requests[], RBTK_SPRITE *frames[],
+    size_t frame_count, const char *format)
+{
+    for (size_t i = 0; i < frame_count; i++) {
+        memset(&requests[i], 0x00, sizeof(requests[i]));
+        snprintf(requests[i].path, sizeof(requests[i].path), format, i);
+        requests[i].dest = &frames[i];
+    }
+}
+
+static bool
+open_sprite(sonic_sprite_request *request)
+{
+    if (request->in) {
+        return true; /* already opened */
+    }
+
+    RBTK_ASSET *asset = rbtk_require_asset(request->path);
+    request->in = rbtk_open_asset_in_stream(asset);
+    return request->in != NULL;
+}
+
+static void
+decode_sprite(sonic_sprite_request *request)
+{
+    size_t buffer_size = 0;
+    unsigned char *buffer = rbtk_buffer_remaining(request->in, &buffer_size);
+    rbtk_close_in_stream(request->in);
+    request->in = NULL;
+    if (!buffer) {
+        return;
+    }
+
+    int channels;
+    request->pixels = stbi_load_from_memory(buffer, (int) buffer_size,
+        &request->width, &request->height, &channels, 4);
+    free(buffer);
+}
+
+void
+sonic_open_sprites(size_t count, sonic_sprite_request requests[])
+{
+    for (size_t i = 0; i < count; i++) {
+        if (!*requests[i].dest) {
+            open_sprite(&requests[i]);
+        }
+    }
+}
+
+/*
+ * Like sonic_decode_sounds(), this only decodes the images into memory.
+ * Nothing is uploaded, and so it is safe to call from a worker thread.
+ */
+void
+sonic_decode_sprites(size_t count, sonic_sprite_request requests[])
+{
+    for (size_t i = 0; i < count; i++) {
+        if (!requests[i].in || requests[i].pixels) {
+            continue;
+        }
+        decode_sprite(&requests[i]);
+        if (!requests[i].pixels) {
+            fprintf(stderr, "Failed to decode %s.\n", requests[i].path);
+        }
+    }
+}
+
+/*
+ * Sprites which were not decoded beforehand are decoded here, on the
+ * calling thread. Sprites which failed to load are left as NULL.
+ */
+void
+sonic_upload_sprites(size_t count, sonic_sprite_request requests[])
+{
+    for (size_t i = 0; i < count; i++) {
+        sonic_sprite_request *request = &requests[i];
+        if (!*request->dest && !request->pixels && open_sprite(request)) {
+            decode_sprite(request);
+        }
+
+        if (!*request->dest && request->pixels) {
+            *request->dest = rbtk_create_sprite(
+                (unsigned int) request->width,
+                (unsigned int) request->height, request->pixels);
+        }
+    }
+    sonic_discard_sprites(count, requests);
+}
+
+void
+sonic_discard_sprites(size_t count, sonic_sprite_request requests[])
+{
+    for (size_t i = 0; i < count; i++) {
+        if (requests[i].in) {
+            rbtk_close_in_stream(requests[i].in);
+            requests[i].in = NULL;
+        }
+        if (requests[i].pixels) {
+            stbi_image_free(requests[i].pixels);
+            requests[i].pixels = NULL;
+        }
+    }
+}
+
+/*
+ * The frames are owned by the animation once it is created. If it cannot
+ * be created, they are unloaded instead.
+ */
+RBTK_SPRITE_ANIME *
+sonic_create_sprite_anime(RBTK_SPRITE *frames[], size_t frame_count,
+    long double duration, rbtk_time_unit unit)
+{
+    assert(frame_count > 0);
+    assert(duration > 0);
+
+    RBTK_SPRITE_ANIME *anime = rbtk_create_sprite_anime(frame_count);
+    long double frame_duration = duration / frame_count;
+    for (size_t i = 0; anime && i < frame_count; i++) {
+        if (!frames[i] || !rbtk_add_sprite_to_anime(anime, frames[i],
+                frame_duration, unit)) {
+            rbtk_destroy_sprite_anime(anime, false);
+            anime = NULL;
+        }
+    }
+
+    if (!anime) {
+        for (size_t i = 0; i < frame_count; i++) {
+            rbtk_unload_sprite(frames[i]);
+        }
+    }
+    memset(frames, 0x00, frame_count * sizeof(*frames));
+    return anime;
+}
+
 static void
 create_game(RBTK_GAME *game)
 {
@@ -41,6 +315,9 @@ create_game(RBTK_GAME *game)
     memset(&sonic_globals, 0x00, sizeof(sonic_globals));
     memset(&sonic_assets, 0x00, sizeof(sonic_assets));
 
+    /* the Genesis updates once per vertical blank */
+    rbtk_set_game_tick_rate(game, SONIC_TICK_RATE);
+
     RBTK_GAME_STATE *title =
         rbtk_create_game_state(sonic_title_state_funs);
     rbtk_add_game_state(game, title);
@@ -81,24 +358,61 @@ start_game(RBTK_GAME *game)
         proj, SONIC_WINDOW_WIDTH, SONIC_WINDOW_HEIGHT);
 
     rbtk_bind_scene_to_window(window, scene);
+    rbtk_set_game_scene(game, scene);
 
     sonic_globals.window = window;
     sonic_globals.scene = scene;
 
-    rbtk_enter_game_state(game, sonic_globals.states.title, NULL);
+    if (record_input_path) {
+        record_input = rbtk_open_file_out_stream(record_input_path);
+        if (!record_input
+            || !rbtk_record_io_device(rbtk_io_keyboard, record_input)) {
+            fprintf(stderr, "Failed to record input to %s.\n",
+                record_input_path);
+        }
+    }
+
+    if (replay_input_path) {
+        replay_input = rbtk_open_file_in_stream(replay_input_path);
+        if (!replay_input
+            || !rbtk_replay_io_device(rbtk_io_keyboard, replay_input)) {
+            fprintf(stderr, "Failed to replay input from %s.\n",
+                replay_input_path);
+        }
+    }
+
+    /* the load state preloads the title state, then enters it */
+    rbtk_enter_game_state(game, sonic_globals.states.load,
+        sonic_globals.states.title);
     rbtk_show_window(window);
 }
 
 static void
 stop_game(RBTK_UNUSED RBTK_GAME *game)
 {
-    /* nothing to do here yet */
+    if (record_input) {
+        rbtk_record_io_device(rbtk_io_keyboard, NULL);
+        rbtk_close_out_stream(record_input);
+        record_input = NULL;
+    }
+
+    if (replay_input) {
+        rbtk_replay_io_device(rbtk_io_keyboard, NULL);
+        rbtk_close_in_stream(replay_input);
+        replay_input = NULL;
+    }
+
+    sonic_stop_prefetching();
 }
 
 static void
 pre_update(RBTK_UNUSED RBTK_GAME *game, RBTK_UNUSED long double delta)
 {
     rbtk_update_io_device(rbtk_io_keyboard);
+
+    if (rbtk_io_keyboard_state->f3->just_pressed) {
+        rbtk_show_stats_overlay(!rbtk_stats_overlay_is_shown());
+    }
 }
 
 static void
@@ -108,17 +422,20 @@ post_update(RBTK_UNUSED RBTK_GAME *game, RBTK_UNUSED long double delta)
         rbtk_stop_game(game);
         return; /* do no more processing */
     }
+
+    sonic_update_prefetch();
 }
 
 static void
-pre_render(RBTK_UNUSED RBTK_GAME *game)
+pre_render(RBTK_UNUSED RBTK_GAME *game, RBTK_UNUSED float alpha)
 {
     rbtk_clear_window_scene(sonic_globals.window);
 }
 
 static void
-post_render(RBTK_UNUSED RBTK_GAME *game)
+post_render(RBTK_UNUSED RBTK_GAME *game, RBTK_UNUSED float alpha)
 {
+    rbtk_draw_stats_overlay(sonic_globals.scene);
     rbtk_render_window_scene(sonic_globals.window);
 }
 
@@ -133,14 +450,62 @@ const rbtk_game_funs sonic_game_funs = {
     .post_render = post_render,
 };
 
+static void
+print_headless_report(void)
+{
+    rbtk_headless_report report = rbtk_get_headless_report();
+    if (report.frames == 0) {
+        return; /* nothing was run */
+    }
+
+    long double frames = (long double) report.frames;
+    printf("Ran %zu frames headless.\n", report.frames);
+    printf("  update: %8.4Lf ms/frame, %10.1Lf frames/s\n",
+        report.update_ms / frames,
+        report.update_ms > 0.0L ? frames * 1000.0L / report.update_ms : 0.0L);
+    printf("  render: %8.4Lf ms/frame, %10.1Lf frames/s\n",
+        report.render_ms / frames,
+        report.render_ms > 0.0L ? frames * 1000.0L / report.render_ms : 0.0L);
+}
+
 RBTK_NO_DISCARD int
-rbtk_runtime_main(RBTK_UNUSED int argc, RBTK_UNUSED const char *argv[])
+rbtk_runtime_main(int argc, const char *argv[])
 {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (!strcmp(argv[i], "--record-input")) {
+            record_input_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--replay-input")) {
+            replay_input_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--headless")) {
+            headless_frames = strtoul(argv[++i], NULL, 10);
+        }
+        else if (!strcmp(argv[i], "--hitch-capture")) {
+            hitch_multiple = strtold(argv[++i], NULL);
+        }
+        else if (!strcmp(argv[i], "--shadow-budget")) {
+            size_t mib = strtoul(argv[++i], NULL, 10);
+            sonic_set_shadow_budget(mib * 1024 * 1024);
+        }
+    }
+
+    if (headless_frames > 0 && !rbtk_set_engine_headless(headless_frames)) {
+        fprintf(stderr, "Failed to enable headless mode.\n");
+        rbtk_abort_if_error();
+    }
+
     if (!rbtk_engine_init()) {
         fprintf(stderr, "Failed to initialize game engine.\n");
         rbtk_abort_if_error();
     }
 
+    if (hitch_multiple > 0.0L
+        && !rbtk_set_hitch_capture(hitch_multiple, NULL)) {
+        fprintf(stderr, "Failed to enable hitch capture.\n");
+        rbtk_abort_if_error();
+    }
+
     RBTK_GAME *game = rbtk_create_game(sonic_game_funs);
     if (!game) {
         fprintf(stderr, "Failed to create game.\n");
@@ -152,6 +517,10 @@ rbtk_runtime_main(RBTK_UNUSED int argc, RBTK_UNUSED const char *argv[])
         rbtk_abort_if_error();
     }
 
+    if (headless_frames > 0) {
+        print_headless_report();
+    }
+
     if (!rbtk_engine_terminate()) {
         fprintf(stderr, "Failed to terminate game engine.\n");
         rbtk_abort_if_error();
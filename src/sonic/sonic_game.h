@@ -32,6 +32,7 @@
 #include <string.h>
 
 #include "../engine/engine.h"
+#include "../engine/tilemap.h"
 
 #define SONIC_WINDOW_WIDTH  1024
 #define SONIC_WINDOW_HEIGHT 768
@@ -39,6 +40,8 @@
 #define SONIC_SCREEN_WIDTH  256
 #define SONIC_SCREEN_HEIGHT 224
 
+#define SONIC_TICK_RATE 60.0L
+
 #define sonic_load_sprite(_object, _name)                             \
     do {                                                              \
         if (!sonic_assets.sprites._object._name) {                    \
@@ -170,6 +173,73 @@
 #define sonic_close_sfx(_object, _name)     \
     sonic_close_sound(sfx, _object, _name)
 
+typedef struct sonic_sound_request {
+    const char *path;
+    RBTK_SOUND **dest;
+    RBTK_IN_STREAM *in;     /* set by sonic_open_sounds() */
+    RBTK_AUDIO_SOURCE *src; /* set by sonic_open_sounds() */
+} sonic_sound_request;
+
+#define sonic_request_sound(_category, _object, _name)         \
+    ((sonic_sound_request) {                                   \
+        .path = #_category "/" #_object "/" #_name ".ogg",     \
+        .dest = &sonic_assets._category._object._name,         \
+    })
+
+#define sonic_request_ost(_object, _name)    \
+    sonic_request_sound(ost, _object, _name)
+#define sonic_request_sfx(_object, _name)    \
+    sonic_request_sound(sfx, _object, _name)
+
+#define SONIC_MAX_SPRITE_PATH_LENGTH 128
+
+typedef struct sonic_sprite_request {
+    char path[SONIC_MAX_SPRITE_PATH_LENGTH];
+    RBTK_SPRITE **dest;
+    RBTK_IN_STREAM *in;    /* set by sonic_open_sprites() */
+    unsigned char *pixels; /* set by sonic_decode_sprites() */
+    int width;
+    int height;
+} sonic_sprite_request;
+
+#define sonic_request_sprite(_object, _name)                  \
+    ((sonic_sprite_request) {                                 \
+        .path = "sprites/" #_object "/" #_name ".png",        \
+        .dest = &sonic_assets.sprites._object._name,          \
+    })
+
+#define sonic_request_sprite_frames(_requests, _frames, _frame_count,  \
+                                    _object, _name)                    \
+    sonic_request_frames((_requests), (_frames), (_frame_count),       \
+        "sprites/" #_object "/" #_name "/" #_name "_%zu.png")
+
+/*
+ * Each act of Sonic CD has a past, a present and a future. Only one of
+ * these is resident at a time, but the one the player is about to travel
+ * to is prefetched in the background as a shadow. Whatever of the shadow
+ * fits in its memory budget is ready ahead of time, the rest is loaded
+ * when the player travels.
+ */
+#define SONIC_MAX_ACT_NAME_LENGTH   64
+#define SONIC_DEFAULT_SHADOW_BUDGET ((size_t) 64 * 1024 * 1024)
+
+typedef enum sonic_time_period {
+    SONIC_PAST,
+    SONIC_PRESENT,
+    SONIC_FUTURE,
+} sonic_time_period;
+
+typedef struct sonic_period_data {
+    char act[SONIC_MAX_ACT_NAME_LENGTH];
+    sonic_time_period period;
+    RBTK_TILESET *tileset;
+    RBTK_TILEMAP *tilemap;
+    RBTK_SPRITE *atlas;
+    RBTK_SOUND *music;
+    RBTK_IN_STREAM *music_in; /* only set when the music is streamed */
+    size_t size;              /* bytes counted against the budget */
+} sonic_period_data;
+
 typedef struct sonic_globals_type {
     RBTK_WINDOW *window;
     RBTK_GRAPHICS *scene;
@@ -227,6 +297,63 @@ typedef struct sonic_assets_type {
 extern sonic_globals_type sonic_globals;
 extern sonic_assets_type sonic_assets;
 
+void
+sonic_open_sounds(size_t count, sonic_sound_request requests[]);
+
+void
+sonic_decode_sounds(size_t count, sonic_sound_request requests[]);
+
+void
+sonic_buffer_sounds(size_t count, sonic_sound_request requests[]);
+
+void
+sonic_discard_sounds(size_t count, sonic_sound_request requests[]);
+
+void
+sonic_request_frames(sonic_sprite_request requests[], RBTK_SPRITE *frames[],
+    size_t frame_count, const char *format);
+
+void
+sonic_open_sprites(size_t count, sonic_sprite_request requests[]);
+
+void
+sonic_decode_sprites(size_t count, sonic_sprite_request requests[]);
+
+void
+sonic_upload_sprites(size_t count, sonic_sprite_request requests[]);
+
+void
+sonic_discard_sprites(size_t count, sonic_sprite_request requests[]);
+
+RBTK_SPRITE_ANIME *
+sonic_create_sprite_anime(RBTK_SPRITE *frames[], size_t frame_count,
+    long double duration, rbtk_time_unit unit);
+
+void
+sonic_set_shadow_budget(size_t bytes);
+
+bool
+sonic_prefetch_period(const char *act, sonic_time_period period);
+
+void
+sonic_update_prefetch(void);
+
+bool
+sonic_prefetch_is_ready(void);
+
+void
+sonic_discard_prefetch(void);
+
+void
+sonic_stop_prefetching(void);
+
+bool
+sonic_travel_to_period(const char *act, sonic_time_period period,
+    sonic_period_data *resident);
+
+void
+sonic_unload_period(sonic_period_data *data);
+
 extern const rbtk_game_funs sonic_game_funs;
 extern const rbtk_game_state_funs sonic_title_state_funs;
 extern const rbtk_game_state_funs sonic_load_state_funs;
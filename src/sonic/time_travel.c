@@ -0,0 +1,630 @@
+/*
+ * the MIT License (MIT)
+ *
+ * Copyright (c) 2023 Trent Summerlin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * the above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "sonic_game.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../engine/tilemap.h"
+#include "../libraries/stb_image.h"
+#include "../runtime/compress.h"
+#include "../runtime/thread.h"
+
+#define MAX_PATH_LENGTH  256
+#define LAYOUT_TILE_MASK 0x07FF /* the rest are flags, which are unused */
+#define BYTES_PER_PIXEL  4
+
+static const char *const period_names[] = {
+    [SONIC_PAST]    = "past",
+    [SONIC_PRESENT] = "present",
+    [SONIC_FUTURE]  = "future",
+};
+
+/*
+ * The files of a time period are opened on the main thread, since the
+ * asset system is not safe to use from a worker. Only reading them is done
+ * in the background. The music is read into memory by the worker, and is
+ * decoded from there.
+ */
+typedef struct period_files {
+    RBTK_IN_STREAM *collision;
+    RBTK_IN_STREAM *layout;
+    RBTK_IN_STREAM *art;
+    RBTK_IN_STREAM *music_in;
+    unsigned char *music_ogg;
+    RBTK_IN_STREAM *music_ogg_in;
+    RBTK_AUDIO_SOURCE *music;
+} period_files;
+
+static struct {
+    size_t budget;
+    RBTK_THREAD_POOL *pool;
+    RBTK_JOB *job;
+    bool active;
+    bool ready;
+    period_files files;
+    unsigned char *art_pixels; /* set by the worker, uploaded after */
+    int art_width;
+    int art_height;
+    bool music_fits;
+    sonic_period_data data;
+} shadow = {
+    .budget = SONIC_DEFAULT_SHADOW_BUDGET,
+};
+
+static bool
+format_path(char *path, const char *format, const char *act,
+    sonic_time_period period)
+{
+    int len = snprintf(path, MAX_PATH_LENGTH, format, act,
+        period_names[period]);
+    return len > 0 && len < MAX_PATH_LENGTH;
+}
+
+static RBTK_IN_STREAM *
+open_period_file(const char *format, const char *act,
+    sonic_time_period period)
+{
+    char path[MAX_PATH_LENGTH];
+    if (!format_path(path, format, act, period)) {
+        return NULL;
+    }
+
+    RBTK_ASSET *asset = rbtk_get_asset(path);
+    return asset ? rbtk_open_asset_in_stream(asset) : NULL;
+}
+
+static void
+close_period_files(period_files *files)
+{
+    if (files->collision) {
+        rbtk_close_in_stream(files->collision);
+    }
+    if (files->layout) {
+        rbtk_close_in_stream(files->layout);
+    }
+    if (files->art) {
+        rbtk_close_in_stream(files->art);
+    }
+    if (files->music) {
+        rbtk_close_audio_source(files->music);
+    }
+    if (files->music_ogg_in) {
+        rbtk_close_in_stream(files->music_ogg_in);
+    }
+    free(files->music_ogg);
+    if (files->music_in) {
+        rbtk_close_in_stream(files->music_in);
+    }
+    memset(files, 0x00, sizeof(*files));
+}
+
+/*
+ * The collision and layout are required, since the act cannot be played
+ * without them. The art and music are optional.
+ */
+static bool
+open_period_files(period_files *files, const char *act,
+    sonic_time_period period)
+{
+    files->collision = open_period_file("levels/%s/%s/collision.png",
+        act, period);
+    files->layout = open_period_file("levels/%s/%s/layout.eni",
+        act, period);
+    files->art = open_period_file("levels/%s/%s/art.png", act, period);
+    files->music_in = open_period_file("ost/%s/%s.ogg", act, period);
+
+    if (!files->collision || !files->layout) {
+        close_period_files(files);
+        return false;
+    }
+    return true;
+}
+
+static size_t
+get_tileset_size(const RBTK_TILESET *tileset)
+{
+    /* one byte per row or column for each side, plus the angle */
+    size_t tile_size = 4 * RBTK_TILE_SIZE + sizeof(rbtk_tile_angle);
+    return rbtk_get_tile_count(tileset) * tile_size;
+}
+
+static bool
+read_u16_be(RBTK_IN_STREAM *in, uint16_t *value)
+{
+    short hi = rbtk_read_byte(in);
+    short lo = rbtk_read_byte(in);
+    if (hi < 0 || hi > 0xFF || lo < 0 || lo > 0xFF) {
+        return false;
+    }
+    *value = (uint16_t) ((hi << 8) | lo);
+    return true;
+}
+
+/*
+ * A layout is its width and height in tiles, as big-endian words, followed
+ * by the tiles themselves as Enigma data. The layout stream is closed once
+ * it has been read, along with the Enigma stream that wraps it.
+ */
+static RBTK_TILEMAP *
+read_layout(const RBTK_TILESET *tileset, RBTK_IN_STREAM *layout,
+    size_t *size)
+{
+    uint16_t width, height;
+    if (!read_u16_be(layout, &width) || !read_u16_be(layout, &height)
+        || width == 0 || height == 0) {
+        rbtk_close_in_stream(layout);
+        fprintf(stderr, "Layout has no size.\n");
+        return NULL;
+    }
+
+    RBTK_IN_STREAM *in = rbtk_open_enigma_in_stream(layout);
+    if (!in) {
+        rbtk_close_in_stream(layout);
+        return NULL;
+    }
+
+    RBTK_TILEMAP *tilemap = rbtk_create_tilemap(tileset, width, height);
+    if (!tilemap) {
+        rbtk_close_in_stream(in);
+        return NULL;
+    }
+
+    size_t tile_count = rbtk_get_tile_count(tileset);
+    for (int32_t y = 0; y < height; y++) {
+        for (int32_t x = 0; x < width; x++) {
+            uint16_t tile = RBTK_EMPTY_TILE;
+            if (!read_u16_be(in, &tile)) {
+                break; /* the rest of the layout is left empty */
+            }
+            tile &= LAYOUT_TILE_MASK;
+            rbtk_set_tile(tilemap, x, y,
+                tile < tile_count ? tile : RBTK_EMPTY_TILE);
+        }
+    }
+
+    rbtk_close_in_stream(in);
+    *size = (size_t) width * height * sizeof(uint16_t);
+    return tilemap;
+}
+
+/*
+ * Returns how many frames an Ogg Vorbis file decodes to. This is the
+ * granule position of its last page, so nothing needs to be decoded to
+ * find it. Zero is returned if the file has no such page.
+ */
+static uint64_t
+get_ogg_frame_count(const unsigned char *ogg, size_t size)
+{
+    const size_t header_size = 27; /* the fixed part of a page header */
+    for (size_t off = size; off >= header_size; off--) {
+        const unsigned char *page = ogg + off - header_size;
+        if (memcmp(page, "OggS", 4)) {
+            continue;
+        }
+
+        uint64_t granule = 0;
+        for (int i = 7; i >= 0; i--) {
+            granule = (granule << 8) | page[6 + i];
+        }
+        if (granule != UINT64_MAX) {
+            return granule; /* a page with no packet end has no position */
+        }
+    }
+    return 0;
+}
+
+/*
+ * Opens the music of a period from memory, and returns how large it will
+ * be once decoded. Zero is returned if the music could not be opened.
+ */
+static size_t
+open_music(period_files *files)
+{
+    size_t ogg_size = 0;
+    files->music_ogg = rbtk_buffer_remaining(files->music_in, &ogg_size);
+    rbtk_close_in_stream(files->music_in);
+    files->music_in = NULL;
+    if (!files->music_ogg) {
+        return 0;
+    }
+
+    files->music_ogg_in = rbtk_open_memory_in_stream(files->music_ogg,
+        ogg_size);
+    if (files->music_ogg_in) {
+        files->music = rbtk_source_ogg(files->music_ogg_in);
+    }
+    if (!files->music) {
+        return 0;
+    }
+
+    const rbtk_audio_source_info *info =
+        rbtk_get_audio_source_info(files->music);
+    size_t frame_size = info->channel_count * (info->bits_per_sample / 8);
+    return (size_t) get_ogg_frame_count(files->music_ogg, ogg_size)
+        * frame_size;
+}
+
+/*
+ * Everything here is done on a worker thread. The layout comes first, as
+ * the act cannot be played without it, then the art, then the music. The
+ * art and music are only decoded if they will fit in what is left of the
+ * budget, so decoding them never goes over it. Anything which is dropped is
+ * loaded when the player travels instead.
+ */
+static void
+run_prefetch_job(RBTK_UNUSED void *args)
+{
+    period_files *files = &shadow.files;
+    sonic_period_data *data = &shadow.data;
+    size_t used = 0;
+
+    data->tileset = rbtk_read_tileset(files->collision);
+    if (data->tileset) {
+        size_t layout_size = 0;
+        data->tilemap = read_layout(data->tileset, files->layout,
+            &layout_size);
+        files->layout = NULL; /* closed by read_layout() */
+        used = get_tileset_size(data->tileset) + layout_size;
+    }
+
+    if (used > shadow.budget) {
+        rbtk_destroy_tilemap(data->tilemap);
+        rbtk_destroy_tileset(data->tileset);
+        data->tilemap = NULL;
+        data->tileset = NULL;
+        used = 0;
+    }
+
+    if (files->art) {
+        size_t buffer_size = 0;
+        unsigned char *buffer =
+            rbtk_buffer_remaining(files->art, &buffer_size);
+
+        int width, height, channels;
+        if (buffer && stbi_info_from_memory(buffer, (int) buffer_size,
+                &width, &height, &channels)) {
+            size_t art_size = (size_t) width * (size_t) height
+                * BYTES_PER_PIXEL;
+            if (used + art_size <= shadow.budget) {
+                shadow.art_pixels = stbi_load_from_memory(buffer,
+                    (int) buffer_size, &shadow.art_width,
+                    &shadow.art_height, &channels, BYTES_PER_PIXEL);
+            }
+            if (shadow.art_pixels) {
+                used += art_size;
+            }
+        }
+        free(buffer);
+    }
+
+    /* music which will not fit is streamed instead */
+    if (files->music_in) {
+        size_t music_size = open_music(files);
+        shadow.music_fits = music_size > 0
+            && used + music_size <= shadow.budget
+            && rbtk_decode_audio_source(files->music);
+        if (shadow.music_fits) {
+            used += rbtk_get_decoded_audio_size(files->music);
+        }
+    }
+
+    data->size = used;
+}
+
+/*
+ * Hands what the worker prepared over to the graphics and audio systems.
+ * This must be done on the main thread, after the job is done.
+ */
+static void
+finish_prefetch(void)
+{
+    sonic_period_data *data = &shadow.data;
+    period_files *files = &shadow.files;
+
+    if (shadow.art_pixels) {
+        data->atlas = rbtk_create_sprite((unsigned int) shadow.art_width,
+            (unsigned int) shadow.art_height, shadow.art_pixels);
+        stbi_image_free(shadow.art_pixels);
+        shadow.art_pixels = NULL;
+    }
+
+    if (files->music && shadow.music_fits) {
+        data->music = rbtk_buffer_sound(files->music);
+        if (data->music) {
+            files->music = NULL; /* owned by the sound now */
+        }
+    }
+
+    close_period_files(files);
+    shadow.ready = true;
+}
+
+void
+sonic_set_shadow_budget(size_t bytes)
+{
+    shadow.budget = bytes;
+}
+
+bool
+sonic_prefetch_period(const char *act, sonic_time_period period)
+{
+    assert(act);
+
+    if (shadow.active && shadow.data.period == period
+        && !strcmp(shadow.data.act, act)) {
+        return true; /* already prefetching this period */
+    }
+
+    sonic_discard_prefetch();
+    if (strlen(act) >= SONIC_MAX_ACT_NAME_LENGTH
+        || !open_period_files(&shadow.files, act, period)) {
+        fprintf(stderr, "Failed to open %s (%s) for prefetching.\n",
+            act, period_names[period]);
+        return false;
+    }
+
+    strcpy(shadow.data.act, act);
+    shadow.data.period = period;
+    shadow.active = true;
+
+    /*
+     * The pool is kept around after the first prefetch, so it is ready for
+     * the next one. If a job cannot be submitted, the period is prefetched
+     * on the calling thread instead. This is a stall, but it is better than
+     * not prefetching at all.
+     */
+    if (!shadow.pool) {
+        shadow.pool = rbtk_create_thread_pool("sonic-prefetch", 1);
+    }
+    if (shadow.pool) {
+        shadow.job = rbtk_submit_job(shadow.pool, run_prefetch_job, NULL);
+    }
+    if (!shadow.job) {
+        run_prefetch_job(NULL);
+        finish_prefetch();
+    }
+
+    return true;
+}
+
+void
+sonic_update_prefetch(void)
+{
+    if (shadow.job && rbtk_job_is_done(shadow.job)) {
+        rbtk_await_job(shadow.job);
+        shadow.job = NULL;
+        finish_prefetch();
+    }
+}
+
+bool
+sonic_prefetch_is_ready(void)
+{
+    return shadow.active && shadow.ready;
+}
+
+void
+sonic_discard_prefetch(void)
+{
+    if (shadow.job) {
+        rbtk_await_job(shadow.job);
+        shadow.job = NULL;
+    }
+
+    if (shadow.art_pixels) {
+        stbi_image_free(shadow.art_pixels);
+        shadow.art_pixels = NULL;
+    }
+
+    close_period_files(&shadow.files);
+    sonic_unload_period(&shadow.data);
+    shadow.music_fits = false;
+    shadow.active = false;
+    shadow.ready = false;
+}
+
+void
+sonic_stop_prefetching(void)
+{
+    sonic_discard_prefetch();
+    if (shadow.pool) {
+        rbtk_destroy_thread_pool(shadow.pool);
+        shadow.pool = NULL;
+    }
+}
+
+/*
+ * Loads whatever a time period is missing, on the calling thread. When
+ * the period was prefetched, this is only what did not fit in the budget.
+ */
+static bool
+complete_period(sonic_period_data *data)
+{
+    const char *act = data->act;
+    sonic_time_period period = data->period;
+
+    if (!data->tilemap) {
+        /* a tileset the prefetch already read is reused */
+        RBTK_IN_STREAM *collision = NULL;
+        if (!data->tileset) {
+            collision = open_period_file("levels/%s/%s/collision.png",
+                act, period);
+        }
+        RBTK_IN_STREAM *layout = open_period_file(
+            "levels/%s/%s/layout.eni", act, period);
+
+        if (collision && layout) {
+            data->tileset = rbtk_read_tileset(collision);
+            if (data->tileset) {
+                data->size += get_tileset_size(data->tileset);
+            }
+        }
+        if (data->tileset && layout) {
+            size_t layout_size = 0;
+            data->tilemap = read_layout(data->tileset, layout,
+                &layout_size);
+            layout = NULL; /* closed by read_layout() */
+            data->size += layout_size;
+        }
+
+        if (collision) {
+            rbtk_close_in_stream(collision);
+        }
+        if (layout) {
+            rbtk_close_in_stream(layout);
+        }
+        if (!data->tilemap) {
+            return false;
+        }
+    }
+
+    char path[MAX_PATH_LENGTH];
+    if (!data->atlas
+        && format_path(path, "levels/%s/%s/art.png", act, period)) {
+        RBTK_ASSET *asset = rbtk_get_asset(path);
+        if (asset) {
+            data->atlas = rbtk_load_sprite(asset);
+        }
+        if (data->atlas) {
+            unsigned int width, height;
+            rbtk_get_sprite_size(data->atlas, &width, &height);
+            data->size += (size_t) width * height * BYTES_PER_PIXEL;
+        }
+    }
+
+    /* music which did not fit is streamed, so it takes no time to load */
+    if (!data->music) {
+        RBTK_IN_STREAM *in = open_period_file("ost/%s/%s.ogg", act, period);
+        RBTK_AUDIO_SOURCE *src = in ? rbtk_source_ogg(in) : NULL;
+        data->music = src ? rbtk_stream_sound(src) : NULL;
+
+        if (data->music) {
+            data->music_in = in;
+        }
+        else {
+            if (src) {
+                rbtk_close_audio_source(src);
+            }
+            if (in) {
+                rbtk_close_in_stream(in);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool
+sonic_travel_to_period(const char *act, sonic_time_period period,
+    sonic_period_data *resident)
+{
+    assert(act);
+    assert(resident);
+
+    if (strlen(act) >= SONIC_MAX_ACT_NAME_LENGTH) {
+        return false;
+    }
+
+    sonic_period_data next = { 0 };
+    if (shadow.active && shadow.data.period == period
+        && !strcmp(shadow.data.act, act)) {
+        /* this only stalls if the prefetch has not finished yet */
+        if (shadow.job) {
+            rbtk_await_job(shadow.job);
+            shadow.job = NULL;
+        }
+        if (!shadow.ready) {
+            finish_prefetch();
+        }
+
+        next = shadow.data;
+        memset(&shadow.data, 0x00, sizeof(shadow.data));
+        shadow.active = false;
+        shadow.ready = false;
+    }
+    else {
+        sonic_discard_prefetch();
+        strcpy(next.act, act);
+        next.period = period;
+    }
+
+    if (!complete_period(&next)) {
+        fprintf(stderr, "Failed to load %s (%s).\n", act,
+            period_names[period]);
+        sonic_unload_period(&next);
+        return false;
+    }
+
+    sonic_period_data prev = *resident;
+    *resident = next;
+
+    /*
+     * Where the player came from becomes the new shadow if it fits, so
+     * travelling straight back is just as quick. Streamed music cannot be
+     * rewound, so it is closed and streamed again if they do.
+     */
+    if (!prev.tilemap || prev.size > shadow.budget) {
+        sonic_unload_period(&prev);
+        return true;
+    }
+
+    if (prev.music_in) {
+        rbtk_close_sound(prev.music);
+        rbtk_close_in_stream(prev.music_in);
+        prev.music = NULL;
+        prev.music_in = NULL;
+    }
+    else if (prev.music) {
+        rbtk_stop_sound(prev.music);
+    }
+
+    shadow.data = prev;
+    shadow.active = true;
+    shadow.ready = true;
+    return true;
+}
+
+void
+sonic_unload_period(sonic_period_data *data)
+{
+    assert(data);
+
+    if (data->music) {
+        rbtk_close_sound(data->music);
+    }
+    if (data->music_in) {
+        rbtk_close_in_stream(data->music_in);
+    }
+    rbtk_unload_sprite(data->atlas);
+    rbtk_destroy_tilemap(data->tilemap);
+    rbtk_destroy_tileset(data->tileset);
+
+    sonic_time_period period = data->period;
+    memset(data, 0x00, sizeof(*data));
+    data->period = period;
+}
@@ -73,6 +73,16 @@ typedef enum sonic_bust_render_mode {
 
 static bool intro_theme_easter_egg;
 
+#define NUM_TITLE_SOUNDS 3
+static sonic_sound_request title_sounds[NUM_TITLE_SOUNDS];
+
+#define NUM_TITLE_STILLS  15
+#define NUM_TITLE_SPRITES (NUM_TITLE_STILLS \
+    + NUM_SONIC_BUST_FRAMES + NUM_FINGER_WAG_FRAMES)
+static sonic_sprite_request title_sprites[NUM_TITLE_SPRITES];
+static RBTK_SPRITE *sonic_bust_frames[NUM_SONIC_BUST_FRAMES];
+static RBTK_SPRITE *finger_wag_frames[NUM_FINGER_WAG_FRAMES];
+
 static struct {
     int state;
     long double suspense_timer;
@@ -641,42 +651,60 @@ init_state(RBTK_UNUSED RBTK_GAME *game, RBTK_UNUSED RBTK_GAME_STATE *state)
     srand((unsigned int) rbtk_time(RBTK_NANOS));
     intro_theme_easter_egg = (rand() % 10 == 0);
 
-    sonic_buffer_sfx(menu, select);
+    /*
+     * The theme tracks take much longer to decode than anything else here.
+     * Only open them for now, they are decoded when this state is preloaded
+     * and buffered once it is entered. If this state is entered without
+     * being preloaded, they are all decoded at once when buffering.
+     */
+    title_sounds[0] = sonic_request_sfx(menu, select);
+    title_sounds[1] = sonic_request_ost(title, title_theme_intro);
+    title_sounds[2] = sonic_request_ost(title, title_theme_loop);
 
     if (intro_theme_easter_egg) {
-        sonic_buffer_ost(title, title_theme_ym2612_intro);
-        sonic_buffer_ost(title, title_theme_ym2612_loop);
-    } else {
-        sonic_buffer_ost(title, title_theme_intro);
-        sonic_buffer_ost(title, title_theme_loop);
+        title_sounds[1] = sonic_request_ost(title, title_theme_ym2612_intro);
+        title_sounds[2] = sonic_request_ost(title, title_theme_ym2612_loop);
     }
 
-    sonic_load_sprite_anime(title, sonic_bust_appear,
-        NUM_SONIC_BUST_FRAMES, SONIC_BUST_APPEAR_DURATION, RBTK_SECS);
-    sonic_load_sprite_anime(title, sonic_finger_wag,
-        NUM_FINGER_WAG_FRAMES, FINGER_WAG_DURATION, RBTK_SECS);
-
-    sonic_load_sprite(title, banner);
-    sonic_load_sprite(title, bg);
-    sonic_load_sprite(title, black);
-    sonic_load_sprite(title, c_sega_1993);
-    sonic_load_sprite(title, clouds);
-    sonic_load_sprite(title, flash);
-    sonic_load_sprite(title, lake);
-    sonic_load_sprite(title, little_planet);
-    sonic_load_sprite(title, medal);
-    sonic_load_sprite(title, press_enter);
-    sonic_load_sprite(title, press_start);
-    sonic_load_sprite(title, sky);
-    sonic_load_sprite(title, sonic_bust);
-    sonic_load_sprite(title, sonic_bust_raised_eyebrow);
-    sonic_load_sprite(title, tm);
+    sonic_open_sounds(NUM_TITLE_SOUNDS, title_sounds);
+
+    /*
+     * The sprites follow the same pattern, except that only uploading
+     * them to the GPU has to wait until this state is entered.
+     */
+    sonic_sprite_request *stills = title_sprites;
+    stills[0] = sonic_request_sprite(title, banner);
+    stills[1] = sonic_request_sprite(title, bg);
+    stills[2] = sonic_request_sprite(title, black);
+    stills[3] = sonic_request_sprite(title, c_sega_1993);
+    stills[4] = sonic_request_sprite(title, clouds);
+    stills[5] = sonic_request_sprite(title, flash);
+    stills[6] = sonic_request_sprite(title, lake);
+    stills[7] = sonic_request_sprite(title, little_planet);
+    stills[8] = sonic_request_sprite(title, medal);
+    stills[9] = sonic_request_sprite(title, press_enter);
+    stills[10] = sonic_request_sprite(title, press_start);
+    stills[11] = sonic_request_sprite(title, sky);
+    stills[12] = sonic_request_sprite(title, sonic_bust);
+    stills[13] = sonic_request_sprite(title, sonic_bust_raised_eyebrow);
+    stills[14] = sonic_request_sprite(title, tm);
+
+    sonic_sprite_request *frames = title_sprites + NUM_TITLE_STILLS;
+    sonic_request_sprite_frames(frames, sonic_bust_frames,
+        NUM_SONIC_BUST_FRAMES, title, sonic_bust_appear);
+    frames += NUM_SONIC_BUST_FRAMES;
+    sonic_request_sprite_frames(frames, finger_wag_frames,
+        NUM_FINGER_WAG_FRAMES, title, sonic_finger_wag);
+
+    sonic_open_sprites(NUM_TITLE_SPRITES, title_sprites);
 }
 
 static void
 deinit_state(RBTK_UNUSED RBTK_GAME *game,
         RBTK_UNUSED RBTK_GAME_STATE *state)
 {
+    sonic_discard_sounds(NUM_TITLE_SOUNDS, title_sounds);
+    sonic_discard_sprites(NUM_TITLE_SPRITES, title_sprites);
     sonic_close_sfx(menu, select);
 
     if (intro_theme_easter_egg) {
@@ -707,9 +735,32 @@ deinit_state(RBTK_UNUSED RBTK_GAME *game,
     sonic_unload_sprite(title, tm);
 }
 
+static void
+preload_state(RBTK_UNUSED RBTK_GAME *game,
+        RBTK_UNUSED RBTK_GAME_STATE *state, RBTK_UNUSED void *args)
+{
+    sonic_decode_sounds(NUM_TITLE_SOUNDS, title_sounds);
+    sonic_decode_sprites(NUM_TITLE_SPRITES, title_sprites);
+}
+
 static void
 enter_state(RBTK_UNUSED RBTK_GAME *game,
         RBTK_UNUSED RBTK_GAME_STATE *state, RBTK_UNUSED void *args) {
+    sonic_buffer_sounds(NUM_TITLE_SOUNDS, title_sounds);
+    sonic_upload_sprites(NUM_TITLE_SPRITES, title_sprites);
+
+    if (!sonic_assets.sprites.title.sonic_bust_appear) {
+        sonic_assets.sprites.title.sonic_bust_appear =
+            sonic_create_sprite_anime(sonic_bust_frames,
+                NUM_SONIC_BUST_FRAMES, SONIC_BUST_APPEAR_DURATION,
+                RBTK_SECS);
+    }
+    if (!sonic_assets.sprites.title.sonic_finger_wag) {
+        sonic_assets.sprites.title.sonic_finger_wag =
+            sonic_create_sprite_anime(finger_wag_frames,
+                NUM_FINGER_WAG_FRAMES, FINGER_WAG_DURATION, RBTK_SECS);
+    }
+
     init_sonic_bust();
     init_intro();
     init_outro();
@@ -753,7 +804,7 @@ update_state(RBTK_UNUSED RBTK_GAME *game,
 
 static void
 render_state(RBTK_UNUSED RBTK_GAME *game,
-        RBTK_UNUSED RBTK_GAME_STATE *state)
+        RBTK_UNUSED RBTK_GAME_STATE *state, RBTK_UNUSED float alpha)
 {
     if (intro_sequence.state != INTRO_STATE_DONE) {
         render_intro(sonic_globals.scene);
@@ -767,6 +818,7 @@ render_state(RBTK_UNUSED RBTK_GAME *game,
 const rbtk_game_state_funs sonic_title_state_funs = {
     .init = init_state,
     .deinit = deinit_state,
+    .preload = preload_state,
     .enter = enter_state,
     .exit = exit_state,
     .update = update_state,